@@ -200,16 +200,16 @@ void updateEvent(Output& out,
   if(_copy_data){
     if(!_ad->force_size){
       if(_p.get_data_length() == _e.getSize())
-        memcpy(_e.getPayload().data(),_p.get_data_ptr(),_e.getSize());
+        memcpy(_e.getMutablePayload().data(),_p.get_data_ptr(),_e.getSize());
       else
         out.fatal(CALL_INFO,-1,
                   "Sizes do not match\n");
     }
     else{
       if(_p.get_data_length() <= _e.getSize())
-        memcpy(_e.getPayload().data(),_p.get_data_ptr(),_p.get_data_length());
+        memcpy(_e.getMutablePayload().data(),_p.get_data_ptr(),_p.get_data_length());
       else                                            
-        memcpy(_e.getPayload().data(),_p.get_data_ptr(),_e.getSize());
+        memcpy(_e.getMutablePayload().data(),_p.get_data_ptr(),_e.getSize());
     }
   }
 }
@@ -264,7 +264,7 @@ void loadPayload(Output& out,
                  SST::MemHierarchy::MemEvent& _e,
                  void *_src,
                  uint32_t _length){
-  memcpy(_e.getPayload().data(),_src,_length);
+  memcpy(_e.getMutablePayload().data(),_src,_length);
 }
 template<>
 void storePayload(Output& out,
@@ -101,7 +101,7 @@ void MEMemTest::readData(Event_t* _ev,Address_t _address) {
   memcpy(&data[_address%max_index],_ev->getPayload().data(),payload_size);
   cout << "Read Data :";
   cout << hex << setfill('0');
-  uint8_t* temp=_ev->getPayload().data();
+  const uint8_t* temp=_ev->getPayload().data();
   assert(_ev->getAddr() == last_address);
   for(unsigned int i=0;i<payload_size;++i){
     //assert(temp[i] == buffer[i]);
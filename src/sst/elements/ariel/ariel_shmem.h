@@ -17,11 +17,14 @@
 #define SST_ARIEL_SHMEM_H 1
 
 #include <inttypes.h>
+#include <string.h>
+#include <vector>
 
 #include <sst/core/interprocess/ipctunnel.h>
 #include "ariel_inst_class.h"
 
 #define ARIEL_MAX_PAYLOAD_SIZE 64
+#define ARIEL_BATCH_SIZE 496
 
 namespace SST {
 namespace ArielComponent {
@@ -44,6 +47,15 @@ enum ArielShmemCmd_t {
     ARIEL_OUTPUT_STATS = 140,
     ARIEL_FLUSHLINE_INSTRUCTION = 154,
     ARIEL_FENCE_INSTRUCTION = 155,
+    ARIEL_PERFORM_BATCH = 160,
+    ARIEL_SAMPLE_PHASE = 170,
+};
+
+/* Phases of sampled simulation, see ARIEL_SAMPLE_PHASE */
+enum ArielSamplePhase {
+    ARIEL_SAMPLE_FFWD = 0,
+    ARIEL_SAMPLE_WARM = 1,
+    ARIEL_SAMPLE_DETAIL = 2,
 };
 
 struct ArielCommand {
@@ -91,9 +103,252 @@ struct ArielCommand {
         struct {
             uint64_t vaddr;
         } flushline;
+        struct {
+            uint32_t count;
+            uint32_t size;
+            uint8_t  data[ARIEL_BATCH_SIZE];
+        } batch;
+        struct {
+            uint32_t phase;
+            uint64_t skipped;   // Instructions fast-forwarded since the last phase change
+        } sample;
     };
 };
 
+/*
+ * ARIEL_PERFORM_BATCH commands carry a run of instructions from one
+ * thread as packed records.  Each record starts with a flags byte, with
+ * the instruction class in the high four bits.  A record with no access
+ * flags is a no-op.  Otherwise the flags are followed by the SIMD
+ * element count, then for the read and then the write: the access size
+ * and the distance from the previous address in the batch, as varints.
+ * Writes with ARIEL_REC_PAYLOAD set end with min(size, 64) data bytes.
+ *
+ * A record with ARIEL_REC_MARKER set is a cache line flush or a fence
+ * instead, with the ArielRecordMarker in the high four bits.  A flush
+ * is followed by the distance to the line address as a varint.
+ */
+enum ArielRecordFlags {
+    ARIEL_REC_READ = 1,
+    ARIEL_REC_WRITE = 2,
+    ARIEL_REC_PAYLOAD = 4,
+    ARIEL_REC_MARKER = 8,
+};
+
+enum ArielRecordMarker {
+    ARIEL_MARKER_FLUSH = 1,
+    ARIEL_MARKER_FENCE = 2,
+};
+
+#define ARIEL_REC_MAX_SIZE (2 + 2 * (5 + 10) + ARIEL_MAX_PAYLOAD_SIZE)
+
+struct ArielInstRecord {
+    uint32_t flags;
+    uint32_t marker;        // ArielRecordMarker if flags is ARIEL_REC_MARKER
+    uint32_t instClass;
+    uint32_t simdElemCount;
+    uint64_t readAddr;
+    uint32_t readSize;
+    uint64_t writeAddr;
+    uint32_t writeSize;
+    const uint8_t* payload;
+};
+
+class ArielBatchWriter {
+public:
+    ArielBatchWriter() {
+        cmd.command = ARIEL_PERFORM_BATCH;
+        cmd.instPtr = 0;
+        clear();
+    }
+
+    bool empty() const { return cmd.batch.count == 0; }
+    bool full() const { return cmd.batch.size + ARIEL_REC_MAX_SIZE > ARIEL_BATCH_SIZE; }
+    const ArielCommand& command() const { return cmd; }
+
+    void clear() {
+        cmd.batch.count = 0;
+        cmd.batch.size = 0;
+        lastAddr = 0;
+    }
+
+    void addNoOp() {
+        cmd.batch.data[cmd.batch.size++] = 0;
+        cmd.batch.count++;
+    }
+
+    /* Call full() first, as for addInstruction */
+    void addFlush(uint64_t addr) {
+        cmd.batch.data[cmd.batch.size++] = (uint8_t) ((ARIEL_MARKER_FLUSH << 4) | ARIEL_REC_MARKER);
+        putAddress(addr);
+        cmd.batch.count++;
+    }
+
+    void addFence() {
+        cmd.batch.data[cmd.batch.size++] = (uint8_t) ((ARIEL_MARKER_FENCE << 4) | ARIEL_REC_MARKER);
+        cmd.batch.count++;
+    }
+
+    /* Call full() first: a record must fit in the space left.  Returns
+     * the space reserved for the write payload, which the caller fills
+     * in, or NULL if payload is false. */
+    uint8_t* addInstruction(uint32_t instClass, uint32_t simdElemCount,
+            bool read, uint64_t readAddr, uint32_t readSize,
+            bool write, uint64_t writeAddr, uint32_t writeSize, bool payload) {
+        uint8_t* flags = &cmd.batch.data[cmd.batch.size];
+        *flags = (uint8_t) (instClass << 4);
+        cmd.batch.data[cmd.batch.size + 1] = (uint8_t) simdElemCount;
+        cmd.batch.size += 2;
+
+        if ( read ) {
+            *flags |= ARIEL_REC_READ;
+            putAccess(readAddr, readSize);
+        }
+        uint8_t* payloadData = NULL;
+        if ( write ) {
+            *flags |= ARIEL_REC_WRITE;
+            putAccess(writeAddr, writeSize);
+            if ( payload ) {
+                *flags |= ARIEL_REC_PAYLOAD;
+                payloadData = &cmd.batch.data[cmd.batch.size];
+                cmd.batch.size += writeSize < ARIEL_MAX_PAYLOAD_SIZE ? writeSize : ARIEL_MAX_PAYLOAD_SIZE;
+            }
+        }
+        cmd.batch.count++;
+        return payloadData;
+    }
+
+private:
+    ArielCommand cmd;
+    uint64_t lastAddr;
+
+    void putVarint(uint64_t val) {
+        while ( val >= 0x80 ) {
+            cmd.batch.data[cmd.batch.size++] = (uint8_t) (val | 0x80);
+            val >>= 7;
+        }
+        cmd.batch.data[cmd.batch.size++] = (uint8_t) val;
+    }
+
+    void putAddress(uint64_t addr) {
+        // Zig-zag encode the signed distance so nearby addresses are short
+        int64_t delta = (int64_t) (addr - lastAddr);
+        putVarint(((uint64_t) delta << 1) ^ (uint64_t) (delta >> 63));
+        lastAddr = addr;
+    }
+
+    void putAccess(uint64_t addr, uint32_t size) {
+        putVarint(size);
+        putAddress(addr);
+    }
+};
+
+class ArielBatchReader {
+public:
+    /* scratch holds write payloads, it is passed in so it can be reused
+     * across batches */
+    ArielBatchReader(const ArielCommand& ac, std::vector<uint8_t>& scratch) :
+        cmd(ac), pos(0), remaining(ac.batch.count), lastAddr(0), malformed(false), scratch(scratch) {
+        end = ac.batch.size < ARIEL_BATCH_SIZE ? ac.batch.size : ARIEL_BATCH_SIZE;
+    }
+
+    /* Returns false once every record in the batch has been read, or
+     * if a record runs past the end of the batch (see failed()).
+     * rec.payload stays valid until the next call. */
+    bool next(ArielInstRecord& rec) {
+        if ( remaining == 0 || malformed ) return false;
+        remaining--;
+
+        uint8_t flags;
+        if ( !getByte(flags) ) return false;
+        rec.flags = flags & 0xf;
+        rec.marker = 0;
+        rec.instClass = flags >> 4;
+        rec.simdElemCount = 0;
+        rec.payload = NULL;
+        if ( rec.flags == 0 ) return true;
+
+        if ( rec.flags & ARIEL_REC_MARKER ) {
+            rec.marker = rec.instClass;
+            rec.instClass = 0;
+            if ( rec.marker == ARIEL_MARKER_FLUSH ) return getAddress(rec.readAddr);
+            return true;
+        }
+
+        uint8_t simd;
+        if ( !getByte(simd) ) return false;
+        rec.simdElemCount = simd;
+        if ( (rec.flags & ARIEL_REC_READ) && !getAccess(rec.readAddr, rec.readSize) ) return false;
+        if ( rec.flags & ARIEL_REC_WRITE ) {
+            if ( !getAccess(rec.writeAddr, rec.writeSize) ) return false;
+
+            uint32_t len = 0;
+            if ( rec.flags & ARIEL_REC_PAYLOAD ) {
+                len = rec.writeSize < ARIEL_MAX_PAYLOAD_SIZE ? rec.writeSize : ARIEL_MAX_PAYLOAD_SIZE;
+                if ( len > end - pos ) return fail();
+            }
+
+            // Consumers copy writeSize bytes, so always hand back that many
+            if ( scratch.size() < rec.writeSize ) scratch.resize(rec.writeSize);
+            memcpy(scratch.data(), &cmd.batch.data[pos], len);
+            pos += len;
+            memset(scratch.data() + len, 0, rec.writeSize - len);
+            rec.payload = scratch.data();
+        }
+        return true;
+    }
+
+    /* True if next() stopped at a record that did not fit in the batch */
+    bool failed() const { return malformed; }
+
+private:
+    const ArielCommand& cmd;
+    uint32_t pos;
+    uint32_t end;
+    uint32_t remaining;
+    uint64_t lastAddr;
+    bool malformed;
+    std::vector<uint8_t>& scratch;
+
+    bool fail() {
+        malformed = true;
+        return false;
+    }
+
+    bool getByte(uint8_t& byte) {
+        if ( pos >= end ) return fail();
+        byte = cmd.batch.data[pos++];
+        return true;
+    }
+
+    bool getVarint(uint64_t& val) {
+        val = 0;
+        uint8_t byte;
+        for ( int shift = 0; shift < 64; shift += 7 ) {
+            if ( !getByte(byte) ) return false;
+            val |= (uint64_t) (byte & 0x7f) << shift;
+            if ( !(byte & 0x80) ) return true;
+        }
+        return fail();
+    }
+
+    bool getAddress(uint64_t& addr) {
+        uint64_t zz;
+        if ( !getVarint(zz) ) return false;
+        int64_t delta = (int64_t) (zz >> 1) ^ -(int64_t) (zz & 1);
+        lastAddr += delta;
+        addr = lastAddr;
+        return true;
+    }
+
+    bool getAccess(uint64_t& addr, uint32_t& size) {
+        uint64_t val;
+        if ( !getVarint(val) || val > UINT32_MAX ) return fail();
+        size = (uint32_t) val;
+        return getAddress(addr);
+    }
+};
+
 
 struct ArielSharedData {
     size_t numCores;
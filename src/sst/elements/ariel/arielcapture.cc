@@ -0,0 +1,355 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#include <sst_config.h>
+#include "arielcapture.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef HAVE_LIBZ
+#include "zlib.h"
+#endif
+
+using namespace SST::ArielComponent;
+
+static const char ARIEL_CAPTURE_MAGIC[4] = { 'A', 'R', 'L', 'C' };
+static const uint32_t ARIEL_CAPTURE_VERSION = 1;
+
+struct ArielCaptureHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t coreCount;
+    uint32_t reserved;
+};
+
+struct ArielCaptureTrailer {
+    uint64_t indexOffset;
+    uint64_t chunkCount;
+};
+
+/* Bytes of the command union that are stored for ac */
+static size_t commandDataSize(const ArielCommand& ac) {
+    if(ARIEL_PERFORM_BATCH == ac.command) {
+        return 2 * sizeof(uint32_t) + ac.batch.size;
+    }
+    return sizeof(ac.inst);
+}
+
+ArielCaptureWriter::ArielCaptureWriter(Output* out, const std::string& name,
+        uint32_t coreCount, uint32_t chunkSz) :
+        output(out), fileName(name), chunkSize(chunkSz), offset(0),
+        buffers(coreCount), counts(coreCount, 0) {
+
+    captureFile = fopen(fileName.c_str(), "wb");
+    if(NULL == captureFile) {
+        output->fatal(CALL_INFO, -1, "Unable to open Ariel capture file: %s\n", fileName.c_str());
+    }
+
+    ArielCaptureHeader header;
+    memcpy(header.magic, ARIEL_CAPTURE_MAGIC, 4);
+    header.version = ARIEL_CAPTURE_VERSION;
+    header.coreCount = coreCount;
+    header.reserved = 0;
+    fwrite(&header, sizeof(header), 1, captureFile);
+    offset = sizeof(header);
+
+    for(uint32_t i = 0; i < coreCount; ++i) {
+        buffers[i].reserve(chunkSize + sizeof(ArielCommand));
+    }
+}
+
+ArielCaptureWriter::~ArielCaptureWriter() {
+    close();
+}
+
+void ArielCaptureWriter::record(uint32_t core, const ArielCommand& ac) {
+    std::vector<uint8_t>& buffer = buffers[core];
+    const uint32_t command = (uint32_t) ac.command;
+    const size_t dataSize = commandDataSize(ac);
+    const size_t start = buffer.size();
+
+    buffer.resize(start + sizeof(command) + sizeof(ac.instPtr) + dataSize);
+    uint8_t* next = &buffer[start];
+    memcpy(next, &command, sizeof(command));
+    next += sizeof(command);
+    memcpy(next, &ac.instPtr, sizeof(ac.instPtr));
+    next += sizeof(ac.instPtr);
+    memcpy(next, &ac.inst, dataSize);
+
+    counts[core]++;
+
+    if(buffer.size() >= chunkSize) {
+        writeChunk(core);
+    }
+}
+
+void ArielCaptureWriter::writeChunk(uint32_t core) {
+    std::vector<uint8_t>& buffer = buffers[core];
+
+    ArielCaptureChunk chunk;
+    chunk.offset = offset;
+    chunk.core = core;
+    chunk.commands = counts[core];
+    chunk.rawSize = (uint32_t) buffer.size();
+    chunk.storedSize = chunk.rawSize;
+
+    const uint8_t* stored = buffer.data();
+
+#ifdef HAVE_LIBZ
+    std::vector<uint8_t> compressed(compressBound(buffer.size()));
+    uLongf compressedSize = compressed.size();
+    if(Z_OK == compress2(compressed.data(), &compressedSize, buffer.data(), buffer.size(), Z_BEST_SPEED) &&
+            compressedSize < buffer.size()) {
+        chunk.storedSize = (uint32_t) compressedSize;
+        stored = compressed.data();
+    }
+#endif
+
+    if(1 != fwrite(stored, chunk.storedSize, 1, captureFile)) {
+        output->fatal(CALL_INFO, -1, "Error writing Ariel capture file: %s\n", fileName.c_str());
+    }
+
+    offset += chunk.storedSize;
+    index.push_back(chunk);
+
+    buffer.clear();
+    counts[core] = 0;
+}
+
+void ArielCaptureWriter::close() {
+    if(NULL == captureFile) {
+        return;
+    }
+
+    for(uint32_t i = 0; i < buffers.size(); ++i) {
+        if(counts[i] > 0) {
+            writeChunk(i);
+        }
+    }
+
+    ArielCaptureTrailer trailer;
+    trailer.indexOffset = offset;
+    trailer.chunkCount = index.size();
+
+    if(index.size() > 0) {
+        fwrite(index.data(), sizeof(ArielCaptureChunk), index.size(), captureFile);
+    }
+    fwrite(&trailer, sizeof(trailer), 1, captureFile);
+    fwrite(ARIEL_CAPTURE_MAGIC, 4, 1, captureFile);
+    fclose(captureFile);
+    captureFile = NULL;
+
+    output->verbose(CALL_INFO, 1, 0, "Wrote %" PRIu64 " chunks to Ariel capture file %s\n",
+            (uint64_t) index.size(), fileName.c_str());
+}
+
+
+ArielCaptureReader::ArielCaptureReader(Output* out, const std::string& name, uint32_t prefetchCount) :
+        output(out), fileName(name), prefetch(prefetchCount), endedStreams(0), exitRead(false) {
+
+    if(0 == prefetch) {
+        prefetch = 1;
+    }
+
+    fd = open(fileName.c_str(), O_RDONLY);
+    if(fd < 0) {
+        output->fatal(CALL_INFO, -1, "Unable to open Ariel replay file: %s\n", fileName.c_str());
+    }
+
+    ArielCaptureHeader header;
+    if(sizeof(header) != pread(fd, &header, sizeof(header), 0) ||
+            0 != memcmp(header.magic, ARIEL_CAPTURE_MAGIC, 4)) {
+        output->fatal(CALL_INFO, -1, "%s is not an Ariel capture file\n", fileName.c_str());
+    }
+    if(ARIEL_CAPTURE_VERSION != header.version) {
+        output->fatal(CALL_INFO, -1, "Ariel capture file %s has version %" PRIu32 ", expected %" PRIu32 "\n",
+                fileName.c_str(), header.version, ARIEL_CAPTURE_VERSION);
+    }
+
+    const off_t fileSize = lseek(fd, 0, SEEK_END);
+    ArielCaptureTrailer trailer;
+    char endMagic[4];
+    if(fileSize < (off_t) (sizeof(header) + sizeof(trailer) + 4) ||
+            sizeof(trailer) != pread(fd, &trailer, sizeof(trailer), fileSize - sizeof(trailer) - 4) ||
+            4 != pread(fd, endMagic, 4, fileSize - 4) ||
+            0 != memcmp(endMagic, ARIEL_CAPTURE_MAGIC, 4)) {
+        output->fatal(CALL_INFO, -1, "Ariel capture file %s is truncated (was the capture run completed?)\n",
+                fileName.c_str());
+    }
+
+    // The index must fill the space between the last chunk and the trailer
+    const uint64_t indexEnd = fileSize - sizeof(trailer) - 4;
+    if(trailer.indexOffset < sizeof(header) || trailer.indexOffset > indexEnd ||
+            trailer.chunkCount != (indexEnd - trailer.indexOffset) / sizeof(ArielCaptureChunk) ||
+            0 != (indexEnd - trailer.indexOffset) % sizeof(ArielCaptureChunk)) {
+        output->fatal(CALL_INFO, -1, "Ariel capture file %s has a corrupt index\n", fileName.c_str());
+    }
+
+    std::vector<ArielCaptureChunk> index(trailer.chunkCount);
+    const size_t indexSize = sizeof(ArielCaptureChunk) * index.size();
+    if(indexSize > 0 && (ssize_t) indexSize != pread(fd, index.data(), indexSize, trailer.indexOffset)) {
+        output->fatal(CALL_INFO, -1, "Error reading the index of Ariel capture file %s\n", fileName.c_str());
+    }
+
+    // Constructed in place, the streams hold futures so cannot be copied
+    std::vector<CoreStream> coreStreams(header.coreCount);
+    streams.swap(coreStreams);
+    for(auto& chunk : index) {
+        if(chunk.core >= header.coreCount) {
+            output->fatal(CALL_INFO, -1, "Ariel capture file %s has a chunk for core %" PRIu32 " but only %" PRIu32 " cores\n",
+                    fileName.c_str(), chunk.core, header.coreCount);
+        }
+        if(chunk.offset < sizeof(header) || chunk.offset > trailer.indexOffset ||
+                chunk.storedSize > trailer.indexOffset - chunk.offset ||
+                chunk.storedSize > chunk.rawSize || chunk.rawSize > (uint64_t) chunk.commands * sizeof(ArielCommand)) {
+            output->fatal(CALL_INFO, -1, "Ariel capture file %s has a corrupt index\n", fileName.c_str());
+        }
+        streams[chunk.core].chunks.push_back(chunk);
+    }
+
+    for(auto& stream : streams) {
+        stream.nextChunk = 0;
+        stream.loadedChunks = 0;
+        stream.remaining = 0;
+        stream.pos = 0;
+        stream.ended = false;
+        prefetchChunks(stream);
+    }
+
+    output->verbose(CALL_INFO, 1, 0, "Opened Ariel replay file %s, %" PRIu32 " cores in %" PRIu64 " chunks\n",
+            fileName.c_str(), header.coreCount, trailer.chunkCount);
+}
+
+ArielCaptureReader::~ArielCaptureReader() {
+    // Wait for any chunks still loading before closing the file
+    for(auto& stream : streams) {
+        for(auto& chunk : stream.loading) {
+            chunk.wait();
+        }
+    }
+    close(fd);
+}
+
+std::vector<uint8_t> ArielCaptureReader::loadChunk(int fd, ArielCaptureChunk chunk) {
+    std::vector<uint8_t> stored(chunk.storedSize);
+    if((ssize_t) chunk.storedSize != pread(fd, stored.data(), chunk.storedSize, chunk.offset)) {
+        return std::vector<uint8_t>();
+    }
+
+    if(chunk.storedSize == chunk.rawSize) {
+        return stored;
+    }
+
+#ifdef HAVE_LIBZ
+    std::vector<uint8_t> raw(chunk.rawSize);
+    uLongf rawSize = chunk.rawSize;
+    if(Z_OK != uncompress(raw.data(), &rawSize, stored.data(), stored.size()) || rawSize != chunk.rawSize) {
+        return std::vector<uint8_t>();
+    }
+    return raw;
+#else
+    return std::vector<uint8_t>();
+#endif
+}
+
+void ArielCaptureReader::prefetchChunks(CoreStream& stream) {
+    while(stream.loading.size() < prefetch && stream.nextChunk < stream.chunks.size()) {
+        stream.loading.push_back(std::async(std::launch::async, &ArielCaptureReader::loadChunk,
+                fd, stream.chunks[stream.nextChunk]));
+        stream.nextChunk++;
+    }
+}
+
+bool ArielCaptureReader::read(uint32_t core, ArielCommand* ac) {
+    if(core >= streams.size()) {
+        return false;
+    }
+
+    CoreStream& stream = streams[core];
+
+    if(stream.pos >= stream.data.size()) {
+        if(0 != stream.remaining) {
+            output->fatal(CALL_INFO, -1, "Corrupt chunk for core %" PRIu32 " in Ariel replay file %s\n", core, fileName.c_str());
+        }
+        if(stream.loading.empty()) {
+            if(!stream.ended) {
+                stream.ended = true;
+                endedStreams++;
+            }
+            return false;
+        }
+
+        stream.data = stream.loading.front().get();
+        stream.loading.pop_front();
+        stream.remaining = stream.chunks[stream.loadedChunks++].commands;
+        stream.pos = 0;
+        prefetchChunks(stream);
+
+        if(stream.data.empty()) {
+#ifdef HAVE_LIBZ
+            output->fatal(CALL_INFO, -1, "Error reading a chunk of Ariel replay file %s\n", fileName.c_str());
+#else
+            output->fatal(CALL_INFO, -1, "Error reading a chunk of Ariel replay file %s (compressed files need SST built with zlib)\n",
+                    fileName.c_str());
+#endif
+        }
+    }
+
+    uint32_t command;
+    const size_t headerSize = sizeof(command) + sizeof(ac->instPtr);
+    if(0 == stream.remaining || stream.pos + headerSize > stream.data.size()) {
+        output->fatal(CALL_INFO, -1, "Corrupt chunk for core %" PRIu32 " in Ariel replay file %s\n", core, fileName.c_str());
+    }
+
+    const uint8_t* next = &stream.data[stream.pos];
+    memcpy(&command, next, sizeof(command));
+    memcpy(&ac->instPtr, next + sizeof(command), sizeof(ac->instPtr));
+    ac->command = (ArielShmemCmd_t) command;
+    next += headerSize;
+
+    size_t dataSize = sizeof(ac->inst);
+    if(ARIEL_PERFORM_BATCH == ac->command) {
+        if(stream.pos + headerSize + 2 * sizeof(uint32_t) > stream.data.size()) {
+            output->fatal(CALL_INFO, -1, "Corrupt chunk for core %" PRIu32 " in Ariel replay file %s\n", core, fileName.c_str());
+        }
+        uint32_t batchSize;
+        memcpy(&batchSize, next + sizeof(uint32_t), sizeof(batchSize));
+        dataSize = 2 * sizeof(uint32_t) + batchSize;
+    }
+
+    if(stream.pos + headerSize + dataSize > stream.data.size() || dataSize > sizeof(ac->batch)) {
+        output->fatal(CALL_INFO, -1, "Corrupt chunk for core %" PRIu32 " in Ariel replay file %s\n", core, fileName.c_str());
+    }
+
+    memcpy(&ac->inst, next, dataSize);
+    stream.pos += headerSize + dataSize;
+    stream.remaining--;
+
+    if(ARIEL_PERFORM_EXIT == ac->command) {
+        exitRead = true;
+    }
+    return true;
+}
+
+bool ArielCaptureReader::endedWithoutExit() {
+    if(exitRead || endedStreams < streams.size()) {
+        return false;
+    }
+
+    exitRead = true;
+    return true;
+}
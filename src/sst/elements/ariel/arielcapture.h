@@ -0,0 +1,125 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#ifndef _H_SST_ARIEL_CAPTURE
+#define _H_SST_ARIEL_CAPTURE
+
+#include <sst/core/output.h>
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <deque>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "ariel_shmem.h"
+
+namespace SST {
+namespace ArielComponent {
+
+/*
+ * A capture file holds the command stream each core read from the
+ * tunnel.  It starts with a header ("ARLC", version, core count),
+ * followed by chunks of one core's commands, each compressed on its own
+ * when zlib is available.  The file ends with an index of all the
+ * chunks and a trailer giving the offset of the index, so a reader can
+ * go straight to any core's chunks.  Each command is stored as its type,
+ * instruction pointer and only the used part of its union.
+ */
+struct ArielCaptureChunk {
+    uint64_t offset;        // File offset of the chunk data
+    uint32_t core;
+    uint32_t commands;
+    uint32_t rawSize;
+    uint32_t storedSize;    // Equal to rawSize if stored uncompressed
+};
+
+class ArielCaptureWriter {
+
+    public:
+        ArielCaptureWriter(Output* output, const std::string& fileName,
+                uint32_t coreCount, uint32_t chunkSize);
+        ~ArielCaptureWriter();
+
+        void record(uint32_t core, const ArielCommand& ac);
+
+        /* Writes out the partial chunks and the index */
+        void close();
+
+    private:
+        void writeChunk(uint32_t core);
+
+        Output* output;
+        std::string fileName;
+        FILE* captureFile;
+        uint32_t chunkSize;
+        uint64_t offset;
+        std::vector< std::vector<uint8_t> > buffers;
+        std::vector<uint32_t> counts;
+        std::vector<ArielCaptureChunk> index;
+
+};
+
+/*
+ * Replays a capture file.  Chunks are read and decompressed on
+ * background threads, up to prefetch chunks ahead of each core.
+ */
+class ArielCaptureReader {
+
+    public:
+        ArielCaptureReader(Output* output, const std::string& fileName, uint32_t prefetch);
+        ~ArielCaptureReader();
+
+        uint32_t getCoreCount() const { return (uint32_t) streams.size(); }
+
+        /* Returns false at the end of the core's commands */
+        bool read(uint32_t core, ArielCommand* ac);
+
+        /* Returns true, once, when every core's commands have been read
+         * and none was ARIEL_PERFORM_EXIT (the capture run was cut short) */
+        bool endedWithoutExit();
+
+    private:
+        struct CoreStream {
+            std::vector<ArielCaptureChunk> chunks;
+            size_t nextChunk;
+            size_t loadedChunks;
+            uint32_t remaining;     // Commands left in data according to the index
+            std::deque< std::future< std::vector<uint8_t> > > loading;
+            std::vector<uint8_t> data;
+            size_t pos;
+            bool ended;
+        };
+
+        static std::vector<uint8_t> loadChunk(int fd, ArielCaptureChunk chunk);
+        void prefetchChunks(CoreStream& stream);
+
+        Output* output;
+        std::string fileName;
+        int fd;
+        uint32_t prefetch;
+        std::vector<CoreStream> streams;
+        uint32_t endedStreams;
+        bool exitRead;
+
+};
+
+}
+}
+
+#endif
@@ -16,6 +16,8 @@
 #include <sst_config.h>
 #include "arielcore.h"
 
+#include <algorithm>
+
 using namespace SST::OpalComponent;
 
 #define ARIEL_CORE_VERBOSE(LEVEL, OUTPUT) if(verbosity >= (LEVEL)) OUTPUT
@@ -44,12 +46,18 @@ ArielCore::ArielCore(ArielTunnel *tunnel, SimpleMem* coreToCacheLink,
     cacheLineSize = cacheLineSz;
     owner = own;
     memmgr = memMgr;
+    translationCache.resize(params.find<uint32_t>("coretranslatecacheentries", 64));
 
     opal_enabled = false;
+    capture = NULL;
+    replay = NULL;
     writePayloads = params.find<int>("writepayloadtrace") == 0 ? false : true;
 
-    coreQ = new std::queue<ArielEvent*>();
-    pendingTransactions = new std::unordered_map<SimpleMem::Request::id_t, SimpleMem::Request*>();
+    // Room for a full queue plus the events decoded from one more command,
+    // a batch produces at most one event per byte
+    coreQ = new ArielEventRing(maxQLength + ARIEL_BATCH_SIZE,
+            writePayloads ? std::max((uint32_t) cacheLineSize, (uint32_t) ARIEL_MAX_PAYLOAD_SIZE) : 0);
+    pendingTransactions = new ArielTransactionTable(maxPendingTransactions);
     pending_transaction_count = 0;
 
     char* subID = (char*) malloc(sizeof(char) * 32);
@@ -67,6 +75,7 @@ ArielCore::ArielCore(ArielTunnel *tunnel, SimpleMem* coreToCacheLink,
     statInstructionCount = own->registerStatistic<uint64_t>( "instruction_count", subID );
     statCycles = own->registerStatistic<uint64_t>( "cycles", subID );
     statActiveCycles = own->registerStatistic<uint64_t>( "active_cycles", subID );
+    statTranslationCacheHits = own->registerStatistic<uint64_t>( "core_tlb_hits", subID );
 
     statFPSPIns = own->registerStatistic<uint64_t>("fp_sp_ins", subID);
     statFPDPIns = own->registerStatistic<uint64_t>("fp_dp_ins", subID);
@@ -80,6 +89,10 @@ ArielCore::ArielCore(ArielTunnel *tunnel, SimpleMem* coreToCacheLink,
     statFPSPOps = own->registerStatistic<uint64_t>("fp_sp_ops", subID);
     statFPDPOps = own->registerStatistic<uint64_t>("fp_dp_ops", subID);
 
+    statSampleInstructions = own->registerStatistic<uint64_t>("sample_instructions", subID);
+    statSampleCycles = own->registerStatistic<uint64_t>("sample_cycles", subID);
+    statFfwdInstructions = own->registerStatistic<uint64_t>("ffwd_instructions", subID);
+
     free(subID);
 
     std::string traceGenName = params.find<std::string>("tracegen", "");
@@ -100,6 +113,13 @@ ArielCore::ArielCore(ArielTunnel *tunnel, SimpleMem* coreToCacheLink,
     }
 
     currentCycles = 0;
+
+    sampling = false;
+    samplePhase = ARIEL_SAMPLE_DETAIL;
+    samplePhaseStartCycle = 0;
+    samplePhaseStartInsts = 0;
+    sampleFfwdInsts = 0;
+    sampleWarmInsts = 0;
 }
 
 ArielCore::~ArielCore() {
@@ -117,6 +137,9 @@ ArielCore::~ArielCore() {
     if(enableTracing && traceGen) {
         delete traceGen;
     }
+
+    delete coreQ;
+    delete pendingTransactions;
 }
 
 void ArielCore::setOpalLink(Link * opallink) {
@@ -150,7 +173,7 @@ void ArielCore::commitReadEvent(const uint64_t address,
         req->setVirtualAddress(virtAddress);
 
         pending_transaction_count++;
-        pendingTransactions->insert( std::pair<SimpleMem::Request::id_t, SimpleMem::Request*>(req->id, req) );
+        pendingTransactions->insert(req->id);
 
         if(enableTracing) {
                 printTraceEntry(true, (const uint64_t) req->addrs[0], (const uint32_t) length);
@@ -187,7 +210,7 @@ void ArielCore::commitWriteEvent(const uint64_t address,
         }
 
         pending_transaction_count++;
-        pendingTransactions->insert( std::pair<SimpleMem::Request::id_t, SimpleMem::Request*>(req->id, req) );
+        pendingTransactions->insert(req->id);
 
         if(enableTracing) {
             printTraceEntry(false, (const uint64_t) req->addrs[0], (const uint32_t) length);
@@ -210,7 +233,7 @@ void ArielCore::commitFlushEvent(const uint64_t address,
         SimpleMem::Request *req = new SimpleMem::Request(SimpleMem::Request::FlushLineInv, address, length);
         req->addAddress(address);
         pending_transaction_count++;
-        pendingTransactions->insert( std::pair<SimpleMem::Request::id_t, SimpleMem::Request*>(req->id, req) );
+        pendingTransactions->insert(req->id);
 
         cacheLink->sendRequest(req);
         statFlushRequests->addData(1);
@@ -222,13 +245,11 @@ void ArielCore::handleEvent(SimpleMem::Request* event) {
     ARIEL_CORE_VERBOSE(4, output->verbose(CALL_INFO, 4, 0, "Core %" PRIu32 " handling a memory event.\n", coreID));
 
     SimpleMem::Request::id_t mev_id = event->id;
-    auto find_entry = pendingTransactions->find(mev_id);
 
-    if(find_entry != pendingTransactions->end()) {
-        ARIEL_CORE_VERBOSE(4, output->verbose(CALL_INFO, 4, 0, "Correctly identified event in pending transactions, removing from list, before there are: %" PRIu32 " transactions pending.\n",
+    if(pendingTransactions->erase(mev_id)) {
+        ARIEL_CORE_VERBOSE(4, output->verbose(CALL_INFO, 4, 0, "Correctly identified event in pending transactions, removed from list, %" PRIu32 " transactions still pending.\n",
                             (uint32_t) pendingTransactions->size()));
 
-        pendingTransactions->erase(find_entry);
         pending_transaction_count--;
         if(isCoreFenced() && pending_transaction_count == 0)
                 unfence();
@@ -271,6 +292,12 @@ void ArielCore::handleInterruptEvent(SST::Event *event) {
 }
 
 void ArielCore::finishCore() {
+    // Close the sample window the application exited in
+    if(sampling) {
+        endSamplePhase();
+        sampling = false;
+    }
+
     // Close the trace file if we did in fact open it.
     if(enableTracing && traceGen) {
         delete traceGen;
@@ -305,79 +332,102 @@ void ArielCore::unfence()
 }
 
 
-void ArielCore::handleSwitchPoolEvent(ArielSwitchPoolEvent* aSPE) {
-    ARIEL_CORE_VERBOSE(2, output->verbose(CALL_INFO, 2, 0, "Core: %" PRIu32 " set default memory pool to: %" PRIu32 "\n", coreID, aSPE->getPool()));
-    memmgr->setDefaultPool(aSPE->getPool());
+void ArielCore::handleSwitchPoolEvent(const ArielEvent& aSPE) {
+    ARIEL_CORE_VERBOSE(2, output->verbose(CALL_INFO, 2, 0, "Core: %" PRIu32 " set default memory pool to: %" PRIu32 "\n", coreID, aSPE.level));
+    memmgr->setDefaultPool(aSPE.level);
 }
 
 void ArielCore::createSwitchPoolEvent(uint32_t newPool) {
-    ArielSwitchPoolEvent* ev = new ArielSwitchPoolEvent(newPool);
-    coreQ->push(ev);
+    ArielEvent& ev = coreQ->push(SWITCH_POOL);
+    ev.level = newPool;
 
     ARIEL_CORE_VERBOSE(4, output->verbose(CALL_INFO, 4, 0, "Generated a switch pool event on core %" PRIu32 ", new level is: %" PRIu32 "\n", coreID, newPool));
 }
 
 void ArielCore::createNoOpEvent() {
-    ArielNoOpEvent* ev = new ArielNoOpEvent();
-    coreQ->push(ev);
+    coreQ->push(NOOP);
 
     ARIEL_CORE_VERBOSE(4, output->verbose(CALL_INFO, 4, 0, "Generated a No Op event on core %" PRIu32 "\n", coreID));
 }
 
 void ArielCore::createReadEvent(uint64_t address, uint32_t length) {
-    ArielReadEvent* ev = new ArielReadEvent(address, length);
-    coreQ->push(ev);
+    ArielEvent& ev = coreQ->push(READ_ADDRESS);
+    ev.address = address;
+    ev.length = length;
 
     ARIEL_CORE_VERBOSE(4, output->verbose(CALL_INFO, 4, 0, "Generated a READ event, addr=%" PRIu64 ", length=%" PRIu32 "\n", address, length));
 }
 
 void ArielCore::createAllocateEvent(uint64_t vAddr, uint64_t length, uint32_t level, uint64_t instPtr) {
-    ArielAllocateEvent* ev = new ArielAllocateEvent(vAddr, length, level, instPtr);
-    coreQ->push(ev);
+    ArielEvent& ev = coreQ->push(MALLOC);
+    ev.address = vAddr;
+    ev.size = length;
+    ev.level = level;
+    ev.instPtr = instPtr;
 
     ARIEL_CORE_VERBOSE(2, output->verbose(CALL_INFO, 2, 0, "Generated an allocate event, vAddr(map)=%" PRIu64 ", length=%" PRIu64 " in level %" PRIu32 " from IP %" PRIx64 "\n",
                     vAddr, length, level, instPtr));
 }
 
 void ArielCore::createMmapEvent(uint32_t fileID, uint64_t vAddr, uint64_t length, uint32_t level, uint64_t instPtr) {
-    ArielMmapEvent* ev = new ArielMmapEvent(fileID, vAddr, length, level, instPtr);
-    coreQ->push(ev);
+    ArielEvent& ev = coreQ->push(MMAP);
+    ev.fileID = fileID;
+    ev.address = vAddr;
+    ev.size = length;
+    ev.level = level;
+    ev.instPtr = instPtr;
 
     ARIEL_CORE_VERBOSE(2, output->verbose(CALL_INFO, 2, 0, "Generated an mmap event, vAddr(map)=%" PRIu64 ", length=%" PRIu64 " in level %" PRIu32 " from IP %" PRIx64 "\n",
                     vAddr, length, level, instPtr));
 }
 
 void ArielCore::createFreeEvent(uint64_t vAddr) {
-    ArielFreeEvent* ev = new ArielFreeEvent(vAddr);
-    coreQ->push(ev);
+    ArielEvent& ev = coreQ->push(FREE);
+    ev.address = vAddr;
 
     ARIEL_CORE_VERBOSE(2, output->verbose(CALL_INFO, 2, 0, "Generated a free event for virtual address=%" PRIu64 "\n", vAddr));
 }
 
 void ArielCore::createWriteEvent(uint64_t address, uint32_t length, const uint8_t* payload) {
-    ArielWriteEvent* ev = new ArielWriteEvent(address, length, payload);
-    coreQ->push(ev);
+    ArielEvent& ev = coreQ->push(WRITE_ADDRESS);
+    ev.address = address;
+    ev.length = length;
+
+    // Payloads are only kept when they are sent to memory
+    uint8_t* payloadSlot = coreQ->backPayload();
+    if(NULL != payloadSlot) {
+        const uint32_t payloadLength = std::min(length, (uint32_t) ARIEL_MAX_PAYLOAD_SIZE);
+        memcpy(payloadSlot, payload, payloadLength);
+        memset(payloadSlot + payloadLength, 0, coreQ->getPayloadSize() - payloadLength);
+    }
 
     ARIEL_CORE_VERBOSE(4, output->verbose(CALL_INFO, 4, 0, "Generated a WRITE event, addr=%" PRIu64 ", length=%" PRIu32 "\n", address, length));
 }
 
 void ArielCore::createFlushEvent(uint64_t vAddr){
-    ArielFlushEvent *ev = new ArielFlushEvent(vAddr, cacheLineSize);
-    coreQ->push(ev);
+    ArielEvent& ev = coreQ->push(FLUSH);
+    ev.address = vAddr;
+    ev.length = (uint32_t) cacheLineSize;
 
     ARIEL_CORE_VERBOSE(4, output->verbose(CALL_INFO,4,0, "Generated a FLUSH event.\n"));
 }
 
 void ArielCore::createFenceEvent(){
-    ArielFenceEvent *ev = new ArielFenceEvent();
-    coreQ->push(ev);
+    coreQ->push(FENCE);
 
     ARIEL_CORE_VERBOSE(4, output->verbose(CALL_INFO, 4, 0, "Generated a FENCE event.\n"));
 }
 
+void ArielCore::createSamplePhaseEvent(uint32_t phase, uint64_t skipped) {
+    ArielEvent& ev = coreQ->push(SAMPLE_PHASE);
+    ev.level = phase;
+    ev.size = skipped;
+
+    ARIEL_CORE_VERBOSE(4, output->verbose(CALL_INFO, 4, 0, "Generated a SAMPLE_PHASE event, phase=%" PRIu32 ", skipped=%" PRIu64 "\n", phase, skipped));
+}
+
 void ArielCore::createExitEvent() {
-    ArielExitEvent* xEv = new ArielExitEvent();
-    coreQ->push(xEv);
+    coreQ->push(CORE_EXIT);
 
     ARIEL_CORE_VERBOSE(4, output->verbose(CALL_INFO, 4, 0, "Generated an EXIT event.\n"));
 }
@@ -403,6 +453,51 @@ bool ArielCore::hasDrainCompleted() const {
         return false;
 }
 
+void ArielCore::setCapture(ArielCaptureWriter* writer) {
+    capture = writer;
+}
+
+void ArielCore::setReplay(ArielCaptureReader* reader) {
+    replay = reader;
+}
+
+bool ArielCore::readCommandNB(ArielCommand* ac) {
+    if(replay) {
+        if(replay->read(coreID, ac)) {
+            return true;
+        }
+
+        // Without this the cores would wait for commands that never come
+        if(replay->endedWithoutExit()) {
+            output->verbose(CALL_INFO, 0, 0, "WARNING - Ariel replay ended without an exit command (was the capture run cut short?), core %" PRIu32 " is exiting.\n", coreID);
+            ac->command = ARIEL_PERFORM_EXIT;
+            ac->instPtr = 0;
+            return true;
+        }
+        return false;
+    }
+
+    const bool avail = tunnel->readMessageNB(coreID, ac);
+    if(avail && capture) {
+        capture->record(coreID, *ac);
+    }
+    return avail;
+}
+
+void ArielCore::readCommand(ArielCommand* ac) {
+    if(replay) {
+        if(!replay->read(coreID, ac)) {
+            output->fatal(CALL_INFO, -1, "Error: Ariel replay for core %" PRIu32 " ended in the middle of an instruction.\n", coreID);
+        }
+        return;
+    }
+
+    *ac = tunnel->readMessage(coreID);
+    if(capture) {
+        capture->record(coreID, *ac);
+    }
+}
+
 bool ArielCore::refillQueue() {
     ARIEL_CORE_VERBOSE(16, output->verbose(CALL_INFO, 16, 0, "Refilling event queue for core %" PRIu32 "...\n", coreID));
 
@@ -411,7 +506,7 @@ bool ArielCore::refillQueue() {
                             coreID, (uint32_t) coreQ->size(), (uint32_t) maxQLength));
 
         ArielCommand ac;
-        const bool avail = tunnel->readMessageNB(coreID, &ac);
+        const bool avail = readCommandNB(&ac);
 
         if ( !avail ) {
                 ARIEL_CORE_VERBOSE(32, output->verbose(CALL_INFO, 32, 0, "Tunnel claims no data on core: %" PRIu32 "\n", coreID));
@@ -435,33 +530,15 @@ bool ArielCore::refillQueue() {
                 }
                 break;
 
-            case ARIEL_START_INSTRUCTION:
-                if(ARIEL_INST_SP_FP == ac.inst.instClass) {
-                        statFPSPIns->addData(1);
-
-                        if(ac.inst.simdElemCount > 1) {
-                            statFPSPSIMDIns->addData(1);
-                        } else {
-                            statFPSPScalarIns->addData(1);
-                        }
-
-                        if(ac.inst.simdElemCount < 32)
-                            statFPSPOps->addData(ac.inst.simdElemCount);
-                } else if(ARIEL_INST_DP_FP == ac.inst.instClass) {
-                        statFPDPIns->addData(1);
-
-                        if(ac.inst.simdElemCount > 1) {
-                            statFPDPSIMDIns->addData(1);
-                        } else {
-                            statFPDPScalarIns->addData(1);
-                        }
+            case ARIEL_PERFORM_BATCH:
+                decodeBatch(ac);
+                break;
 
-                        if(ac.inst.simdElemCount < 16)
-                            statFPDPOps->addData(ac.inst.simdElemCount);
-                }
+            case ARIEL_START_INSTRUCTION:
+                countInstClass(ac.inst.instClass, ac.inst.simdElemCount);
 
                 while(ac.command != ARIEL_END_INSTRUCTION) {
-                        ac = tunnel->readMessage(coreID);
+                        readCommand(&ac);
 
                         switch(ac.command) {
                             case ARIEL_PERFORM_READ:
@@ -516,6 +593,10 @@ bool ArielCore::refillQueue() {
                 createSwitchPoolEvent(ac.switchPool.pool);
                 break;
 
+            case ARIEL_SAMPLE_PHASE:
+                createSamplePhaseEvent(ac.sample.phase, ac.sample.skipped);
+                break;
+
             case ARIEL_PERFORM_EXIT:
                 createExitEvent();
                 break;
@@ -530,25 +611,109 @@ bool ArielCore::refillQueue() {
     return true;
 }
 
-void ArielCore::handleFreeEvent(ArielFreeEvent* rFE) {
-    output->verbose(CALL_INFO, 4, 0, "Core %" PRIu32 " processing a free event (for virtual address=%" PRIu64 ")\n", coreID, rFE->getVirtualAddress());
+void ArielCore::countInstClass(uint32_t instClass, uint32_t simdElemCount) {
+    if(ARIEL_INST_SP_FP == instClass) {
+            statFPSPIns->addData(1);
 
-    memmgr->freeMalloc(rFE->getVirtualAddress());
+            if(simdElemCount > 1) {
+                statFPSPSIMDIns->addData(1);
+            } else {
+                statFPSPScalarIns->addData(1);
+            }
+
+            if(simdElemCount < 32)
+                statFPSPOps->addData(simdElemCount);
+    } else if(ARIEL_INST_DP_FP == instClass) {
+            statFPDPIns->addData(1);
+
+            if(simdElemCount > 1) {
+                statFPDPSIMDIns->addData(1);
+            } else {
+                statFPDPScalarIns->addData(1);
+            }
+
+            if(simdElemCount < 16)
+                statFPDPOps->addData(simdElemCount);
+    }
+}
+
+void ArielCore::decodeBatch(const ArielCommand& ac) {
+    ARIEL_CORE_VERBOSE(32, output->verbose(CALL_INFO, 32, 0, "Decoding batch of %" PRIu32 " instructions (%" PRIu32 " bytes) on core: %" PRIu32 "\n",
+                        ac.batch.count, ac.batch.size, coreID));
+
+    ArielBatchReader reader(ac, payloadScratch);
+    ArielInstRecord rec;
+
+    while(reader.next(rec)) {
+        if(0 == rec.flags) {
+            createNoOpEvent();
+            continue;
+        }
+
+        if(rec.flags & ARIEL_REC_MARKER) {
+            if(ARIEL_MARKER_FLUSH == rec.marker) {
+                createFlushEvent(rec.readAddr);
+            } else if(ARIEL_MARKER_FENCE == rec.marker) {
+                createFenceEvent();
+            } else {
+                output->fatal(CALL_INFO, -1, "Error: Ariel did not understand batch record marker (%" PRIu32 ") on core %" PRIu32 ".\n",
+                        rec.marker, coreID);
+            }
+            continue;
+        }
+
+        countInstClass(rec.instClass, rec.simdElemCount);
+
+        if(rec.flags & ARIEL_REC_READ) {
+            createReadEvent(rec.readAddr, rec.readSize);
+        }
+
+        if(rec.flags & ARIEL_REC_WRITE) {
+            createWriteEvent(rec.writeAddr, rec.writeSize, rec.payload);
+        }
+    }
+
+    if(reader.failed()) {
+        output->fatal(CALL_INFO, -1, "Error: Ariel received a malformed instruction batch (%" PRIu32 " records in %" PRIu32 " bytes) on core %" PRIu32 ".\n",
+                ac.batch.count, ac.batch.size, coreID);
+    }
+}
+
+void ArielCore::handleFreeEvent(const ArielEvent& rFE) {
+    output->verbose(CALL_INFO, 4, 0, "Core %" PRIu32 " processing a free event (for virtual address=%" PRIu64 ")\n", coreID, rFE.address);
+
+    memmgr->freeMalloc(rFE.address);
 
     if (allocLink) {
         // tell the allocate montior (e.g. mem sieve that a free has occured)
         arielAllocTrackEvent *e =  new arielAllocTrackEvent(arielAllocTrackEvent::FREE,
-                            rFE->getVirtualAddress(), 0, 0, 0);
+                            rFE.address, 0, 0, 0);
 
         allocLink->send(e);
     }
 }
 
-void ArielCore::handleReadRequest(ArielReadEvent* rEv) {
+/*
+ *  Translate through this core's own translation cache before asking the
+ *  memory manager, which is shared by all of the cores
+ */
+uint64_t ArielCore::translateAddress(uint64_t virtAddr) {
+    ArielTranslation translation;
+    if(translationCache.lookup(virtAddr, memmgr->getTranslationEpoch(), &translation)) {
+        statTranslationCacheHits->addData(1);
+        return translation.translate(virtAddr);
+    }
+
+    const uint64_t physAddr = memmgr->translateAddress(virtAddr, &translation);
+    translationCache.insert(virtAddr, translation, memmgr->getTranslationEpoch());
+    return physAddr;
+}
+
+void ArielCore::handleReadRequest(const ArielEvent& rEv) {
     ARIEL_CORE_VERBOSE(4, output->verbose(CALL_INFO, 4, 0, "Core %" PRIu32 " processing a read event...\n", coreID));
 
-    const uint64_t readAddress = rEv->getAddress();
-    const uint64_t readLength  = (uint64_t) rEv->getLength();
+    const uint64_t readAddress = rEv.address;
+    const uint64_t readLength  = (uint64_t) rEv.length;
 
     if(readLength > cacheLineSize) {
         output->verbose(CALL_INFO, 4, 0, "Potential error? request for a read of length=%" PRIu64 " is larger than cache line which is not allowed (coreID=%" PRIu32 ", cache line: %" PRIu64 "\n",
@@ -560,7 +725,7 @@ void ArielCore::handleReadRequest(ArielReadEvent* rEv) {
     // There is a chance that the non-alignment causes an undetected bug if an access spans multiple malloc regions that are contiguous in VA space but non-contiguous in PA space.
     // However, a single access spanning multiple malloc'd regions shouldn't happen...
     // Addresses mapped via first touch are always line/page aligned
-    const uint64_t physAddr = memmgr->translateAddress(readAddress);
+    const uint64_t physAddr = translateAddress(readAddress);
     const uint64_t addr_offset  = physAddr % ((uint64_t) cacheLineSize);
 
     if((addr_offset + readLength) <= cacheLineSize) {
@@ -585,7 +750,7 @@ void ArielCore::handleReadRequest(ArielReadEvent* rEv) {
         const uint64_t rightSize = readLength - leftSize;
 
         const uint64_t physLeftAddr = physAddr;
-        const uint64_t physRightAddr = memmgr->translateAddress(rightAddr);
+        const uint64_t physRightAddr = translateAddress(rightAddr);
 
         ARIEL_CORE_VERBOSE(4, output->verbose(CALL_INFO, 4, 0, "Core %" PRIu32 " issuing split-address read, LeftVAddr=%" PRIu64 ", RightVAddr=%" PRIu64 ", LeftSize=%" PRIu64 ", RightSize=%" PRIu64 ", LeftPhysAddr=%" PRIu64 ", RightPhysAddr=%" PRIu64 "\n",
                             coreID, leftAddr, rightAddr, leftSize, rightSize, physLeftAddr, physRightAddr));
@@ -617,11 +782,11 @@ void ArielCore::handleReadRequest(ArielReadEvent* rEv) {
     statReadRequestSizes->addData(readLength);
 }
 
-void ArielCore::handleWriteRequest(ArielWriteEvent* wEv) {
+void ArielCore::handleWriteRequest(const ArielEvent& wEv, const uint8_t* payload) {
     ARIEL_CORE_VERBOSE(4, output->verbose(CALL_INFO, 4, 0, "Core %" PRIu32 " processing a write event...\n", coreID));
 
-    const uint64_t writeAddress = wEv->getAddress();
-    const uint64_t writeLength  = wEv->getLength();
+    const uint64_t writeAddress = wEv.address;
+    const uint64_t writeLength  = wEv.length;
 
     if(writeLength > cacheLineSize) {
         output->verbose(CALL_INFO, 4, 0, "Potential error? request for a write of length=%" PRIu64 " is larger than cache line which is not allowed (coreID=%" PRIu32 ", cache line: %" PRIu64 "\n",
@@ -630,7 +795,7 @@ void ArielCore::handleWriteRequest(ArielWriteEvent* wEv) {
     }
 
     // See note in handleReadRequest() on alignment issues
-    const uint64_t physAddr = memmgr->translateAddress(writeAddress);
+    const uint64_t physAddr = translateAddress(writeAddress);
     const uint64_t addr_offset  = physAddr % ((uint64_t) cacheLineSize);
 
     // We do not need to perform a split operation
@@ -643,8 +808,7 @@ void ArielCore::handleWriteRequest(ArielWriteEvent* wEv) {
                             coreID, writeAddress, writeLength, physAddr));
 
         if( writePayloads ) {
-            uint8_t* payloadPtr = wEv->getPayload();
-            commitWriteEvent(physAddr, writeAddress, (uint32_t) writeLength, payloadPtr);
+            commitWriteEvent(physAddr, writeAddress, (uint32_t) writeLength, payload);
         } else {
             commitWriteEvent(physAddr, writeAddress, (uint32_t) writeLength, NULL);
         }
@@ -660,7 +824,7 @@ void ArielCore::handleWriteRequest(ArielWriteEvent* wEv) {
         const uint64_t rightSize = writeLength - leftSize;
 
         const uint64_t physLeftAddr = physAddr;
-        const uint64_t physRightAddr = memmgr->translateAddress(rightAddr);
+        const uint64_t physRightAddr = translateAddress(rightAddr);
 
         ARIEL_CORE_VERBOSE(4, output->verbose(CALL_INFO, 4, 0, "Core %" PRIu32 " issuing split-address write, LeftVAddr=%" PRIu64 ", RightVAddr=%" PRIu64 ", LeftSize=%" PRIu64 ", RightSize=%" PRIu64 ", LeftPhysAddr=%" PRIu64 ", RightPhysAddr=%" PRIu64 "\n",
                             coreID, leftAddr, rightAddr, leftSize, rightSize, physLeftAddr, physRightAddr));
@@ -683,10 +847,8 @@ void ArielCore::handleWriteRequest(ArielWriteEvent* wEv) {
         }
 
         if( writePayloads ) {
-            uint8_t* payloadPtr = wEv->getPayload();
-            
-            commitWriteEvent(physLeftAddr, leftAddr, (uint32_t) leftSize, payloadPtr);
-            commitWriteEvent(physRightAddr, rightAddr, (uint32_t) rightSize, &payloadPtr[leftSize]);
+            commitWriteEvent(physLeftAddr, leftAddr, (uint32_t) leftSize, payload);
+            commitWriteEvent(physRightAddr, rightAddr, (uint32_t) rightSize, &payload[leftSize]);
         } else {
             commitWriteEvent(physLeftAddr, leftAddr, (uint32_t) leftSize, NULL);
             commitWriteEvent(physRightAddr, rightAddr, (uint32_t) rightSize, NULL);
@@ -700,29 +862,29 @@ void ArielCore::handleWriteRequest(ArielWriteEvent* wEv) {
 
 
 
-void ArielCore::handleMmapEvent(ArielMmapEvent* aEv) {
+void ArielCore::handleMmapEvent(const ArielEvent& aEv) {
 
     if(opal_enabled) {
         OpalEvent * tse = new OpalEvent(OpalComponent::EventType::MMAP);
-        tse->setHint(aEv->getAllocationLevel());
-        tse->setFileId(aEv->getFileID());
+        tse->setHint(aEv.level);
+        tse->setFileId(aEv.fileID);
         std::cout<<"Before sending to Opal.. file ID is : "<<tse->getFileId()<<std::endl;
         // length should be in multiple of page size
-        tse->setResp(aEv->getVirtualAddress(), 0, aEv->getAllocationLength() );
+        tse->setResp(aEv.address, 0, aEv.size );
         OpalLink->send(tse);
     }
 
 }
 
-void ArielCore::handleAllocationEvent(ArielAllocateEvent* aEv) {
+void ArielCore::handleAllocationEvent(const ArielEvent& aEv) {
     output->verbose(CALL_INFO, 2, 0, "Handling a memory allocation event, vAddr=%" PRIu64 ", length=%" PRIu64 ", at level=%" PRIu32 " with malloc ID=%" PRIu64 "\n",
-                aEv->getVirtualAddress(), aEv->getAllocationLength(), aEv->getAllocationLevel(), aEv->getInstructionPointer());
+                aEv.address, aEv.size, aEv.level, aEv.instPtr);
 
     // If Opal is enabled, make sure you pass these requests to it
     if(opal_enabled) {
         OpalEvent * tse = new OpalEvent(OpalComponent::EventType::HINT);
-        tse->setHint(aEv->getAllocationLevel());
-        tse->setResp(aEv->getVirtualAddress(), 0, aEv->getAllocationLength() );
+        tse->setHint(aEv.level);
+        tse->setResp(aEv.address, 0, aEv.size );
         OpalLink->send(tse);
     }
 
@@ -731,25 +893,25 @@ void ArielCore::handleAllocationEvent(ArielAllocateEvent* aEv) {
         // tell the allocate montior (e.g. mem sieve that an
         // allocation has occured)
         arielAllocTrackEvent *e = new arielAllocTrackEvent(arielAllocTrackEvent::ALLOC,
-                            aEv->getVirtualAddress(),
-                            aEv->getAllocationLength(),
-                            aEv->getAllocationLevel(),
-                            aEv->getInstructionPointer());
+                            aEv.address,
+                            aEv.size,
+                            aEv.level,
+                            aEv.instPtr);
         allocLink->send(e);
     } else {    // As a config convience, we're not supporting allocLink + allocate-on-malloc but there's no real reason not to
-        memmgr->allocateMalloc(aEv->getAllocationLength(), aEv->getAllocationLevel(), aEv->getVirtualAddress());
+        memmgr->allocateMalloc(aEv.size, aEv.level, aEv.address);
     }
 }
 
-void ArielCore::handleFlushEvent(ArielFlushEvent *flEv) {
-    const uint64_t virtualAddress = (uint64_t) flEv->getVirtualAddress();
-    const uint64_t readLength = (uint64_t) flEv->getLength();
+void ArielCore::handleFlushEvent(const ArielEvent& flEv) {
+    const uint64_t virtualAddress = flEv.address;
+    const uint64_t readLength = (uint64_t) flEv.length;
 
-    const uint64_t physAddr = memmgr->translateAddress(virtualAddress);
+    const uint64_t physAddr = translateAddress(virtualAddress);
     commitFlushEvent(physAddr, virtualAddress, (uint32_t) readLength);
 }
 
-void ArielCore::handleFenceEvent(ArielFenceEvent *fEv) {
+void ArielCore::handleFenceEvent(const ArielEvent& fEv) {
     /*  Todo: Should we treat this like the Flush event, and require that the Fence
     *  be put into a transaction queue?  */
     // Possibility A:
@@ -759,7 +921,62 @@ void ArielCore::handleFenceEvent(ArielFenceEvent *fEv) {
     statFenceRequests->addData(1);
 }
 
+void ArielCore::endSamplePhase() {
+    const uint64_t insts = inst_count - samplePhaseStartInsts;
+    const uint64_t cycles = currentCycles - samplePhaseStartCycle;
+
+    if(ARIEL_SAMPLE_DETAIL == samplePhase) {
+        sampleWindows.push_back(std::make_pair(insts, cycles));
+        statSampleInstructions->addData(insts);
+        statSampleCycles->addData(cycles);
+    } else if(ARIEL_SAMPLE_WARM == samplePhase) {
+        sampleWarmInsts += insts;
+    }
+}
+
+void ArielCore::handleSamplePhaseEvent(const ArielEvent& sEv) {
+    ARIEL_CORE_VERBOSE(4, output->verbose(CALL_INFO, 4, 0, "Core %" PRIu32 " enters sample phase %" PRIu32 " after skipping %" PRIu64 " instructions\n",
+                        coreID, sEv.level, sEv.size));
+
+    // The first phase change starts sampling, the instructions before
+    // it are not a sample window
+    if(sampling) {
+        endSamplePhase();
+    }
+    sampling = true;
+
+    sampleFfwdInsts += sEv.size;
+    statFfwdInstructions->addData(sEv.size);
+
+    samplePhase = sEv.level;
+    samplePhaseStartInsts = inst_count;
+    samplePhaseStartCycle = currentCycles;
+}
+
 void ArielCore::printCoreStatistics() {
+    if(sampleWindows.empty()) {
+        return;
+    }
+
+    uint64_t detailInsts = 0;
+    uint64_t detailCycles = 0;
+    for(size_t i = 0; i < sampleWindows.size(); ++i) {
+        output->verbose(CALL_INFO, 1, 0, "Core %" PRIu32 " sample window %" PRIu64 ": %" PRIu64 " instructions in %" PRIu64 " cycles\n",
+                coreID, (uint64_t) i, sampleWindows[i].first, sampleWindows[i].second);
+        detailInsts += sampleWindows[i].first;
+        detailCycles += sampleWindows[i].second;
+    }
+
+    // Extrapolate the detailed windows' CPI over every instruction the
+    // thread executed
+    const uint64_t totalInsts = detailInsts + sampleWarmInsts + sampleFfwdInsts;
+    const double cpi = (detailInsts > 0) ? ((double) detailCycles / (double) detailInsts) : 0.0;
+
+    output->verbose(CALL_INFO, 0, 0, "Core %" PRIu32 " sampled %" PRIu64 " windows: %" PRIu64 " detailed instructions in %" PRIu64
+            " cycles (CPI %.3f), %" PRIu64 " warming, %" PRIu64 " fast-forwarded\n",
+            coreID, (uint64_t) sampleWindows.size(), detailInsts, detailCycles, cpi, sampleWarmInsts, sampleFfwdInsts);
+    output->verbose(CALL_INFO, 0, 0, "Core %" PRIu32 " estimated %" PRIu64 " cycles for %" PRIu64 " instructions\n",
+            coreID, (uint64_t) (cpi * totalInsts), totalInsts);
 }
 
 bool ArielCore::processNextEvent() {
@@ -783,10 +1000,10 @@ bool ArielCore::processNextEvent() {
 
     ARIEL_CORE_VERBOSE(8, output->verbose(CALL_INFO, 8, 0, "Processing next event in core %" PRIu32 "...\n", coreID));
 
-    ArielEvent* nextEvent = coreQ->front();
+    const ArielEvent& nextEvent = coreQ->front();
     bool removeEvent = false;
 
-    switch(nextEvent->getEventType()) {
+    switch(nextEvent.type) {
         case NOOP:
                 ARIEL_CORE_VERBOSE(8, output->verbose(CALL_INFO, 8, 0, "Core %" PRIu32 " next event is NOOP\n", coreID));
                 statInstructionCount->addData(1);
@@ -804,7 +1021,7 @@ bool ArielCore::processNextEvent() {
                     statInstructionCount->addData(1);
                     inst_count++;
                     removeEvent = true;
-                    handleReadRequest(dynamic_cast<ArielReadEvent*>(nextEvent));
+                    handleReadRequest(nextEvent);
                 } else {
                     ARIEL_CORE_VERBOSE(16, output->verbose(CALL_INFO, 16, 0, "Pending transaction queue is currently full for core %" PRIu32 ", core will stall for new events\n", coreID));
                     break;
@@ -820,7 +1037,7 @@ bool ArielCore::processNextEvent() {
                     statInstructionCount->addData(1);
                     inst_count++;
                             removeEvent = true;
-                    handleWriteRequest(dynamic_cast<ArielWriteEvent*>(nextEvent));
+                    handleWriteRequest(nextEvent, coreQ->frontPayload());
                 } else {
                     ARIEL_CORE_VERBOSE(16, output->verbose(CALL_INFO, 16, 0, "Pending transaction queue is currently full for core %" PRIu32 ", core will stall for new events\n", coreID));
                     break;
@@ -840,25 +1057,25 @@ bool ArielCore::processNextEvent() {
         case SWITCH_POOL:
                 ARIEL_CORE_VERBOSE(8, output->verbose(CALL_INFO, 8, 0, "Core %" PRIu32 " next event is a SWITCH_POOL\n", coreID));
                 removeEvent = true;
-                handleSwitchPoolEvent(dynamic_cast<ArielSwitchPoolEvent*>(nextEvent));
+                handleSwitchPoolEvent(nextEvent);
                 break;
 
         case FREE:
                 ARIEL_CORE_VERBOSE(8, output->verbose(CALL_INFO, 8, 0, "Core %" PRIu32 " next event is FREE\n", coreID));
                 removeEvent = true;
-                handleFreeEvent(dynamic_cast<ArielFreeEvent*>(nextEvent));
+                handleFreeEvent(nextEvent);
                 break;
 
         case MALLOC:
                 ARIEL_CORE_VERBOSE(8, output->verbose(CALL_INFO, 8, 0, "Core %" PRIu32 " next event is MALLOC\n", coreID));
                 removeEvent = true;
-                handleAllocationEvent(dynamic_cast<ArielAllocateEvent*>(nextEvent));
+                handleAllocationEvent(nextEvent);
                 break;
 
         case MMAP:
                 ARIEL_CORE_VERBOSE(8, output->verbose(CALL_INFO, 8, 0, "Core %" PRIu32 " next event is MMAP\n", coreID));
                 removeEvent = true;
-                handleMmapEvent(dynamic_cast<ArielMmapEvent*>(nextEvent));
+                handleMmapEvent(nextEvent);
                 break;
 
         case CORE_EXIT:
@@ -874,7 +1091,7 @@ bool ArielCore::processNextEvent() {
                     ARIEL_CORE_VERBOSE(16, output->verbose(CALL_INFO, 16, 0, "Found a FLUSH event, fewer pending transactions than permitted so will process..\n"));
                     statInstructionCount->addData(1);
                     inst_count++;
-                    handleFlushEvent(dynamic_cast<ArielFlushEvent*>(nextEvent));
+                    handleFlushEvent(nextEvent);
                     removeEvent = true;
                 } else {
                     ARIEL_CORE_VERBOSE(16, output->verbose(CALL_INFO, 16, 0, "Pending transaction queue is currently full for core %" PRIu32 ",core will stall for new events\n", coreID));
@@ -884,11 +1101,17 @@ bool ArielCore::processNextEvent() {
         case FENCE:
                 ARIEL_CORE_VERBOSE(8, output->verbose(CALL_INFO, 8, 0, "Core %" PRIu32 " next event is a FENCE\n", coreID));
                 if(!isCoreFenced()) {// If core is fenced, drop this fence - they can be merged
-                    handleFenceEvent(dynamic_cast<ArielFenceEvent*>(nextEvent));
+                    handleFenceEvent(nextEvent);
                 }
                 removeEvent = true;
                 break;
 
+        case SAMPLE_PHASE:
+                ARIEL_CORE_VERBOSE(8, output->verbose(CALL_INFO, 8, 0, "Core %" PRIu32 " next event is a SAMPLE_PHASE\n", coreID));
+                handleSamplePhaseEvent(nextEvent);
+                removeEvent = true;
+                break;
+
         default:
                 output->fatal(CALL_INFO, -4, "Unknown event type has arrived on core %" PRIu32 "\n", coreID);
                 break;
@@ -899,8 +1122,6 @@ bool ArielCore::processNextEvent() {
         ARIEL_CORE_VERBOSE(8, output->verbose(CALL_INFO, 8, 0, "Removing event from pending queue, there are %" PRIu32 " events in the queue before deletion.\n",
                             (uint32_t) coreQ->size()));
         coreQ->pop();
-
-        delete nextEvent;
         return true;
     } else {
         ARIEL_CORE_VERBOSE(8, output->verbose(CALL_INFO, 8, 0, "Event removal was not requested, pending transaction queue length=%" PRIu32 ", maximum transactions: %" PRIu32 "\n",
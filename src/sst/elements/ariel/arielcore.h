@@ -34,23 +34,15 @@
 #include <poll.h>
 
 #include <string>
-#include <queue>
 #include <unordered_map>
 
 #include "arielmemmgr.h"
 #include "arielevent.h"
-#include "arielreadev.h"
-#include "arielwriteev.h"
-#include "arielexitev.h"
-#include "arielallocev.h"
-#include "arielfreeev.h"
-#include "arielnoop.h"
-#include "arielflushev.h"
-#include "arielfenceev.h"
-#include "arielswitchpool.h"
+#include "arieltranstable.h"
 #include "arielalloctrackev.h"
 
 #include "ariel_shmem.h"
+#include "arielcapture.h"
 #include "arieltracegen.h"
 #include <sst/elements/Opal/Opal_Event.h>
 
@@ -92,18 +84,22 @@ class ArielCore {
         void createFlushEvent(uint64_t vAddr);
         void createFenceEvent();
         void createSwitchPoolEvent(uint32_t pool);
+        void createSamplePhaseEvent(uint32_t phase, uint64_t skipped);
 
         void setCacheLink(SimpleMem* newCacheLink, Link* allocLink);
+        void setCapture(ArielCaptureWriter* writer);
+        void setReplay(ArielCaptureReader* reader);
 
         void handleEvent(SimpleMem::Request* event);
-        void handleReadRequest(ArielReadEvent* wEv);
-        void handleWriteRequest(ArielWriteEvent* wEv);
-        void handleAllocationEvent(ArielAllocateEvent* aEv);
-        void handleMmapEvent(ArielMmapEvent* aEv);
-        void handleFreeEvent(ArielFreeEvent* aFE);
-        void handleSwitchPoolEvent(ArielSwitchPoolEvent* aSPE);
-        void handleFlushEvent(ArielFlushEvent *flEv);
-        void handleFenceEvent(ArielFenceEvent *fEv);
+        void handleReadRequest(const ArielEvent& rEv);
+        void handleWriteRequest(const ArielEvent& wEv, const uint8_t* payload);
+        void handleAllocationEvent(const ArielEvent& aEv);
+        void handleMmapEvent(const ArielEvent& aEv);
+        void handleFreeEvent(const ArielEvent& rFE);
+        void handleSwitchPoolEvent(const ArielEvent& aSPE);
+        void handleFlushEvent(const ArielEvent& flEv);
+        void handleFenceEvent(const ArielEvent& fEv);
+        void handleSamplePhaseEvent(const ArielEvent& sEv);
 
         // interrupt handlers
         void handleInterruptEvent(SST::Event *event);
@@ -124,12 +120,19 @@ class ArielCore {
     private:
         bool processNextEvent();
         bool refillQueue();
+        void endSamplePhase();
+        bool readCommandNB(ArielCommand* ac);
+        void readCommand(ArielCommand* ac);
+        void decodeBatch(const ArielCommand& ac);
+        void countInstClass(uint32_t instClass, uint32_t simdElemCount);
+        uint64_t translateAddress(uint64_t virtAddr);
         bool opal_enabled;
         bool writePayloads;
         uint32_t coreID;
         uint32_t maxPendingTransactions;
         Output* output;
-        std::queue<ArielEvent*>* coreQ;
+        ArielEventRing* coreQ;
+        std::vector<uint8_t> payloadScratch;
         bool isStalled;
         bool isHalted;
         bool isFenced;
@@ -137,12 +140,15 @@ class ArielCore {
         Link* allocLink;
         Link* OpalLink;
         ArielTunnel *tunnel;
-        std::unordered_map<SimpleMem::Request::id_t, SimpleMem::Request*>* pendingTransactions;
+        ArielCaptureWriter* capture;
+        ArielCaptureReader* replay;
+        ArielTransactionTable* pendingTransactions;
         uint32_t maxIssuePerCycle;
         uint32_t maxQLength;
         uint64_t cacheLineSize;
         SST::Component* owner;
         ArielMemoryManager* memmgr;
+        ArielTranslationCache translationCache;
         const uint32_t verbosity;
         const uint32_t perform_checks;
         bool enableTracing;
@@ -169,6 +175,7 @@ class ArielCore {
         Statistic<uint64_t>* statInstructionCount;
         Statistic<uint64_t>* statCycles;
         Statistic<uint64_t>* statActiveCycles;
+        Statistic<uint64_t>* statTranslationCacheHits;
 
         Statistic<uint64_t>* statFPDPIns;
         Statistic<uint64_t>* statFPDPSIMDIns;
@@ -181,6 +188,20 @@ class ArielCore {
 
         uint32_t pending_transaction_count;
 
+        // Sampled simulation: the current phase and where it started,
+        // and the (instructions, cycles) of each detailed window
+        bool sampling;
+        uint32_t samplePhase;
+        uint64_t samplePhaseStartCycle;
+        uint64_t samplePhaseStartInsts;
+        uint64_t sampleFfwdInsts;
+        uint64_t sampleWarmInsts;
+        std::vector< std::pair<uint64_t, uint64_t> > sampleWindows;
+
+        Statistic<uint64_t>* statSampleInstructions;
+        Statistic<uint64_t>* statSampleCycles;
+        Statistic<uint64_t>* statFfwdInstructions;
+
 };
 
 }
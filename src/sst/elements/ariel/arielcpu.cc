@@ -178,8 +178,15 @@ ArielCPU::ArielCPU(ComponentId_t id, Params& params) :
 
     free(tool_path);
 
+    // Replay feeds the cores from a capture file instead of a traced application
+    std::string capture_file = params.find<std::string>("capture_file", "");
+    std::string replay_file = params.find<std::string>("replay_file", "");
+    if("" != capture_file && "" != replay_file) {
+        output->fatal(CALL_INFO, -1, "Only one of capture_file and replay_file can be set\n");
+    }
+
     std::string executable = params.find<std::string>("executable", "");
-    if("" == executable) {
+    if("" == executable && "" == replay_file) {
         output->fatal(CALL_INFO, -1, "The input deck did not specify an executable to be run against PIN\n");
     }
 
@@ -206,6 +213,18 @@ ArielCPU::ArielCPU(ComponentId_t id, Params& params) :
     output->verbose(CALL_INFO, 1, 0, "Tracking the stack and dumping on malloc calls is %s.\n",
             keep_malloc_stack_trace == 1 ? "ENABLED" : "DISABLED");
 
+    // Sampled simulation: repeat fast-forward, warm up and detailed windows
+    const uint64_t sample_ffwd = params.find<uint64_t>("sample_ffwd", 0);
+    const uint64_t sample_warmup = params.find<uint64_t>("sample_warmup", 0);
+    const uint64_t sample_detail = params.find<uint64_t>("sample_detail", 0);
+    if(sample_ffwd > 0) {
+        if(0 == sample_detail) {
+            output->fatal(CALL_INFO, -1, "sample_detail must be greater than zero when sample_ffwd is set\n");
+        }
+        output->verbose(CALL_INFO, 1, 0, "Sampling %" PRIu64 " instructions in detail after fast-forwarding %" PRIu64 " and warming %" PRIu64 "\n",
+                sample_detail, sample_ffwd, sample_warmup);
+    }
+
     std::string malloc_map_filename = params.find<std::string>("mallocmapfile", "");
     if (malloc_map_filename == "") {
         output->verbose(CALL_INFO, 1, 0, "Malloc map file is DISABLED\n");
@@ -213,14 +232,18 @@ ArielCPU::ArielCPU(ComponentId_t id, Params& params) :
         output->verbose(CALL_INFO, 1, 0, "Malloc map file is ENABLED, using file '%s'\n", malloc_map_filename.c_str());
     }
 
-    tunnel = new ArielTunnel(id, core_count, maxCoreQueueLen);
-    std::string shmem_region_name = tunnel->getRegionName();
-    output->verbose(CALL_INFO, 1, 0, "Base pipe name: %s\n", shmem_region_name.c_str());
+    std::string shmem_region_name = "";
+    tunnel = NULL;
+    if("" == replay_file) {
+        tunnel = new ArielTunnel(id, core_count, maxCoreQueueLen);
+        shmem_region_name = tunnel->getRegionName();
+        output->verbose(CALL_INFO, 1, 0, "Base pipe name: %s\n", shmem_region_name.c_str());
+    }
 
     appLauncher = params.find<std::string>("launcher", PINTOOL_EXECUTABLE);
 
     const uint32_t launch_param_count = (uint32_t) params.find<uint32_t>("launchparamcount", 0);
-    const uint32_t pin_arg_count = 29 + launch_param_count;
+    const uint32_t pin_arg_count = 35 + launch_param_count;
 
     execute_args = (char**) malloc(sizeof(char*) * (pin_arg_count + app_argc));
 
@@ -297,6 +320,15 @@ ArielCPU::ArielCPU(ComponentId_t id, Params& params) :
     execute_args[arg++] = const_cast<char*>("-d");
     execute_args[arg++] = (char*) malloc(sizeof(char) * 8);
     sprintf(execute_args[arg-1], "%" PRIu32, memmgr->getDefaultPool());
+    execute_args[arg++] = const_cast<char*>("-ff");
+    execute_args[arg++] = (char*) malloc(sizeof(char) * 30);
+    sprintf(execute_args[arg-1], "%" PRIu64, sample_ffwd);
+    execute_args[arg++] = const_cast<char*>("-sw");
+    execute_args[arg++] = (char*) malloc(sizeof(char) * 30);
+    sprintf(execute_args[arg-1], "%" PRIu64, sample_warmup);
+    execute_args[arg++] = const_cast<char*>("-sd");
+    execute_args[arg++] = (char*) malloc(sizeof(char) * 30);
+    sprintf(execute_args[arg-1], "%" PRIu64, sample_detail);
     execute_args[arg++] = const_cast<char*>("--");
     execute_args[arg++] = (char*) malloc(sizeof(char) * (executable.size() + 1));
     strcpy(execute_args[arg-1], executable.c_str());
@@ -364,6 +396,22 @@ ArielCPU::ArielCPU(ComponentId_t id, Params& params) :
     }
 
 
+    capture = NULL;
+    replay = NULL;
+    if("" != capture_file) {
+        const uint32_t chunk_size = params.find<uint32_t>("capture_chunk_size", 1048576);
+        output->verbose(CALL_INFO, 1, 0, "Capturing the command stream to %s\n", capture_file.c_str());
+        capture = new ArielCaptureWriter(output, capture_file, core_count, chunk_size);
+    } else if("" != replay_file) {
+        const uint32_t prefetch = params.find<uint32_t>("replay_prefetch", 2);
+        output->verbose(CALL_INFO, 1, 0, "Replaying the command stream from %s\n", replay_file.c_str());
+        replay = new ArielCaptureReader(output, replay_file, prefetch);
+        if(replay->getCoreCount() != core_count) {
+            output->fatal(CALL_INFO, -1, "Replay file %s was captured with %" PRIu32 " cores but corecount is %" PRIu32 "\n",
+                    replay_file.c_str(), replay->getCoreCount(), core_count);
+        }
+    }
+
     output->verbose(CALL_INFO, 1, 0, "Creating processor cores and cache links...\n");
     cpu_cores = (ArielCore**) malloc( sizeof(ArielCore*) * core_count );
 
@@ -381,6 +429,9 @@ ArielCPU::ArielCPU(ComponentId_t id, Params& params) :
         // Set max number of instructions
         cpu_cores[i]->setMaxInsts(max_insts);
 
+        cpu_cores[i]->setCapture(capture);
+        cpu_cores[i]->setReplay(replay);
+
         // optionally wire up links to allocate trackers (e.g. memSieve)
         if (useAllocTracker) {
             sprintf(link_buffer, "alloc_link_%" PRIu32, i);
@@ -412,6 +463,7 @@ ArielCPU::ArielCPU(ComponentId_t id, Params& params) :
     primaryComponentDoNotEndSim();
 
     stopTicking = true;
+    child_pid = 0;
 
     output->verbose(CALL_INFO, 1, 0, "Completed initialization of the Ariel CPU.\n");
     fflush(stdout);
@@ -420,7 +472,7 @@ ArielCPU::ArielCPU(ComponentId_t id, Params& params) :
 
 void ArielCPU::init(unsigned int phase)
 {
-    if ( phase == 0 ) {
+    if ( phase == 0 && NULL == replay ) {
         output->verbose(CALL_INFO, 1, 0, "Launching PIN...\n");
         // Init the child_pid = 0, this prevents problems in emergencyShutdown()
         // if forkPINChild() calls fatal (i.e. the child_pid would not be set)
@@ -442,6 +494,10 @@ void ArielCPU::finish() {
         cpu_cores[i]->finishCore();
     }
 
+    if(capture) {
+        capture->close();
+    }
+
     output->verbose(CALL_INFO, 1, 0, "Ariel Processor Information:\n");
     output->verbose(CALL_INFO, 1, 0, "Completed at: %" PRIu64 " nanoseconds.\n", (uint64_t) getCurrentSimTimeNano() );
     output->verbose(CALL_INFO, 1, 0, "Ariel Component Statistics (By Core)\n");
@@ -596,8 +652,10 @@ bool ArielCPU::tick( SST::Cycle_t cycle) {
     stopTicking = false;
     output->verbose(CALL_INFO, 16, 0, "Main processor tick, will issue to individual cores...\n");
 
-    tunnel->updateTime(getCurrentSimTimeNano());
-    tunnel->incrementCycles();
+    if(tunnel) {
+        tunnel->updateTime(getCurrentSimTimeNano());
+        tunnel->incrementCycles();
+    }
 
     // Keep ticking unless one of the cores says it is time to stop.
     for(uint32_t i = 0; i < core_count; ++i) {
@@ -623,11 +681,15 @@ ArielCPU::~ArielCPU() {
         delete cpu_cores[i];
     }
 
+    delete capture;
+    delete replay;
     delete tunnel;
 }
 
 void ArielCPU::emergencyShutdown() {
-    tunnel->shutdown(true);
+    if(tunnel) {
+        tunnel->shutdown(true);
+    }
     // If child_pid = 0, dont kill (this would kill all processes of the group)
     if (child_pid != 0) {
         kill(child_pid, SIGKILL);
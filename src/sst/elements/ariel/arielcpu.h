@@ -73,7 +73,15 @@ class ArielCPU : public SST::Component {
         {"clock", "Clock rate at which events are generated and processed", "1GHz"},
         {"tracegen", "Select the trace generator for Ariel (which records traced memory operations", ""},
         {"memmgr", "Memory manager to use for address translation", "ariel.MemoryManagerSimple"},
+        {"coretranslatecacheentries", "Entries in each core's translation cache in front of the memory manager (rounded up to a power of two)", "64"},
         {"writepayloadtrace", "Trace write payloads and put real memory contents into the memory system", "0"},
+        {"sample_ffwd", "Instructions each thread fast-forwards between sample windows, 0 disables sampling", "0"},
+        {"sample_warmup", "Instructions simulated to warm caches before each sample window, not counted in the window", "0"},
+        {"sample_detail", "Instructions simulated in detail in each sample window", "0"},
+        {"capture_file", "Record the command stream read by each core to this file, for use with replay_file", ""},
+        {"capture_chunk_size", "Bytes of one core's commands compressed together in the capture file", "1048576"},
+        {"replay_file", "Feed the cores from a file written with capture_file instead of launching the executable", ""},
+        {"replay_prefetch", "Number of chunks per core read and decompressed ahead on background threads when replaying", "2"},
         {"opal_enabled", "If enabled, MLM allocation hints will be communicated to the centralized memory manager", "0"},
 	{"opal_latency", "latency to communicate to the centralized memory manager", "32ps"})
 
@@ -103,6 +111,10 @@ class ArielCPU : public SST::Component {
         { "fp_sp_scalar_ins",     "Statistic for counting SP-FP Non-SIMD instructons", "instructions", 1 },
         { "fp_sp_ops",            "Statistic for counting SP-FP operations (inst * SIMD width)", "instructions", 1 },
         { "cycles",               "Statistic for counting cycles of the Ariel core.", "cycles", 1 },
+        { "core_tlb_hits",        "Translations hit in the core's translation cache, these do not reach the memory manager", "hits", 2 },
+        { "sample_instructions",  "Instructions in each detailed sample window", "instructions", 1 },
+        { "sample_cycles",        "Cycles taken by each detailed sample window", "cycles", 1 },
+        { "ffwd_instructions",    "Instructions fast-forwarded between sample windows", "instructions", 1 },
         { "active_cycles",        "Statistic for counting active cycles (cycles not idle) of the Ariel core.", "cycles", 1 })
         
         /* Ariel class */
@@ -128,6 +140,8 @@ class ArielCPU : public SST::Component {
 
         uint32_t core_count;
         ArielTunnel* tunnel;
+        ArielCaptureWriter* capture;
+        ArielCaptureReader* replay;
         bool stopTicking;
         bool opal_enabled;
         std::string appLauncher;
@@ -17,7 +17,9 @@
 #ifndef _H_SST_ARIEL_EVENT
 #define _H_SST_ARIEL_EVENT
 
-
+#include <stdint.h>
+#include <string.h>
+#include <vector>
 
 namespace SST {
 namespace ArielComponent {
@@ -34,15 +36,107 @@ enum ArielEventType {
     FREE,
     SWITCH_POOL,
     FLUSH,
-    FENCE
+    FENCE,
+    SAMPLE_PHASE
+};
+
+/*
+ * An event queued on a core.  Which fields are used depends on the type:
+ *   READ_ADDRESS, WRITE_ADDRESS, FLUSH: address, length
+ *   MALLOC, MMAP: address, size, level, instPtr (and fileID for MMAP)
+ *   FREE: address
+ *   SWITCH_POOL: level is the new pool
+ *   SAMPLE_PHASE: level is the phase, size the instructions skipped
+ */
+struct ArielEvent {
+    ArielEventType type;
+    uint32_t length;
+    uint32_t level;
+    uint32_t fileID;
+    uint64_t address;
+    uint64_t size;
+    uint64_t instPtr;
 };
 
-class ArielEvent {
+/*
+ * FIFO of events in a power of two sized circular buffer, with an
+ * optional payload slot per event for write data.  It is sized for the
+ * core's queue depth plus the events one command can add, so it only
+ * grows (by doubling) if an instruction produces more events than that.
+ */
+class ArielEventRing {
 
     public:
-        ArielEvent();
-        virtual ~ArielEvent();
-        virtual ArielEventType getEventType() const = 0;
+        ArielEventRing(uint32_t capacity, uint32_t payloadSz) :
+                head(0), count(0), payloadSize(payloadSz) {
+            uint32_t size = 1;
+            while(size < capacity) {
+                size <<= 1;
+            }
+
+            events.resize(size);
+            payloads.resize(size * payloadSize);
+            mask = size - 1;
+        }
+
+        bool empty() const { return 0 == count; }
+        size_t size() const { return count; }
+        uint32_t getPayloadSize() const { return payloadSize; }
+
+        ArielEvent& front() { return events[head]; }
+
+        /* Write data for the front event, NULL if payloads are not kept */
+        uint8_t* frontPayload() {
+            return payloadSize ? &payloads[head * payloadSize] : NULL;
+        }
+
+        /* Appends an event, the caller fills in the returned slot */
+        ArielEvent& push(ArielEventType type) {
+            if(count == events.size()) {
+                grow();
+            }
+
+            ArielEvent& ev = events[(head + count) & mask];
+            ev.type = type;
+            count++;
+            return ev;
+        }
+
+        /* Payload slot for the event just pushed, NULL if payloads are not kept */
+        uint8_t* backPayload() {
+            return payloadSize ? &payloads[((head + count - 1) & mask) * payloadSize] : NULL;
+        }
+
+        void pop() {
+            head = (head + 1) & mask;
+            count--;
+        }
+
+    private:
+        void grow() {
+            std::vector<ArielEvent> newEvents(events.size() * 2);
+            std::vector<uint8_t> newPayloads(newEvents.size() * payloadSize);
+
+            for(size_t i = 0; i < count; ++i) {
+                const size_t slot = (head + i) & mask;
+                newEvents[i] = events[slot];
+                if(payloadSize) {
+                    memcpy(&newPayloads[i * payloadSize], &payloads[slot * payloadSize], payloadSize);
+                }
+            }
+
+            events.swap(newEvents);
+            payloads.swap(newPayloads);
+            head = 0;
+            mask = events.size() - 1;
+        }
+
+        std::vector<ArielEvent> events;
+        std::vector<uint8_t> payloads;
+        size_t head;
+        size_t count;
+        size_t mask;
+        uint32_t payloadSize;
 
 };
 
@@ -27,6 +27,8 @@
 #include <vector>
 #include <unordered_map>
 
+#include "arielpagetable.h"
+
 using namespace SST;
 using namespace SST::RNG;
 
@@ -46,12 +48,12 @@ class ArielMemoryManager : public SubComponent {
     #define ARIEL_ELI_MEMMGR_PARAMS {"verbose", "Verbosity for debugging. Increased numbers for increased verbosity.", "0"},\
         {"vtop_translate",  "Set to yes to perform virt-phys translation (TLB) or no to disable", "yes"},\
         {"pagemappolicy",   "Select the page mapping policy for Ariel [LINEAR|RANDOMIZED]", "LINEAR"},\
-        {"translatecacheentries", "Keep a translation cache of this many entries to improve emulated core performance", "4096"}
+        {"translatecacheentries", "Keep a translation cache of this many entries (rounded up to a power of two) to improve emulated core performance", "4096"}
 
     #define ARIEL_ELI_MEMMGR_STATS { "tlb_hits", "Hits in the simple Ariel TLB", "hits", 2 },\
         { "tlb_evicts",           "Number of evictions in the simple Ariel TLB", "evictions", 2 },\
         { "tlb_translate_queries","Number of TLB translations performed", "translations", 2 },\
-        { "tlb_shootdown",        "Number of TLB clears because of page-frees", "shootdowns", 2 },\
+        { "tlb_shootdown",        "Number of TLB clears because a malloc or free changed the mapping of translated addresses", "shootdowns", 2 },\
         { "tlb_page_allocs",      "Number of pages allocated by the memory manager", "pages", 2 }
 
         /* Constructor
@@ -87,8 +89,9 @@ class ArielMemoryManager : public SubComponent {
             }
 
             // Set up translation cache
-            translationCache = new std::unordered_map<uint64_t, uint64_t>();
             translationCacheEntries = (uint32_t) params.find<uint32_t>("translatecacheentries", 4096);
+            translationCache.resize(translationCacheEntries);
+            translationEpoch = 1;
 
             /* Statistics used by all memory managers; managers may also have their own */
         } // End constructor
@@ -103,8 +106,19 @@ class ArielMemoryManager : public SubComponent {
             return 0;
         }
 
-        /** Request to translate an address, allocates if not found. */
-        virtual uint64_t translateAddress(uint64_t virtAddr) = 0;
+        /** Request to translate an address, allocates if not found.
+         *  Also returns the translation covering virtAddr so callers can cache it. */
+        virtual uint64_t translateAddress(uint64_t virtAddr, ArielTranslation* translation) = 0;
+
+        uint64_t translateAddress(uint64_t virtAddr) {
+            ArielTranslation translation;
+            return translateAddress(virtAddr, &translation);
+        }
+
+        /** Changes whenever existing translations become invalid (mallocs and frees) */
+        uint64_t getTranslationEpoch() const {
+            return translationEpoch;
+        }
 
         /** Request to allocate a malloc, not supported by all memory managers */
         virtual bool allocateMalloc(const uint64_t size, const uint32_t level, const uint64_t virtualAddress) {
@@ -131,8 +145,10 @@ class ArielMemoryManager : public SubComponent {
         Statistic<uint64_t>* statTranslationShootdown;
         Statistic<uint64_t>* statPageAllocationCount;
 
-        std::unordered_map<uint64_t, uint64_t>* translationCache;
+        ArielTranslationCache translationCache;
+        ArielTranslatedRanges translatedRanges;
         uint32_t translationCacheEntries;
+        uint64_t translationEpoch;
         bool translationEnabled;
         ArielPageMappingPolicy mapPolicy;
 
@@ -178,7 +194,13 @@ class ArielMemoryManager : public SubComponent {
             }
         }
 
-        void populatePageTable(std::string popFilePath, std::unordered_map<uint64_t, uint64_t> * pageTable, std::deque<uint64_t>* freePagePool, uint64_t pageSize) {
+        void checkPageSize(uint64_t pageSize) {
+            if (0 == pageSize || 0 != (pageSize & (pageSize - 1))) {
+                output->fatal(CALL_INFO, -1, "Page size %" PRIu64 " is not a power of two\n", pageSize);
+            }
+        }
+
+        void populatePageTable(std::string popFilePath, ArielPageTable* pageTable, std::deque<uint64_t>* freePagePool, uint64_t pageSize) {
             FILE * popFile = fopen(popFilePath.c_str(), "rt");
             uint64_t pinAddr = 0;
 
@@ -202,21 +224,36 @@ class ArielMemoryManager : public SubComponent {
                 output->verbose(CALL_INFO, 4, 0, "Pinning address %" PRIu64 " (physical=%" PRIu64 "\n",
                             pinAddr, freePhysical);
 
-                pageTable->insert( std::pair<uint64_t, uint64_t>( pinAddr, freePhysical ) );
+                pageTable->insert(pinAddr, freePhysical);
             }
 
             fclose(popFile);
         }
 
-        void cacheTranslation(uint64_t virtualA, uint64_t physicalA) {
-            // Remove the oldest entry if we do not have enough slots TODO is begin() really the oldest...?
-            if(translationCache->size() == translationCacheEntries) {
-            statTranslationCacheEvict->addData(1);
-            translationCache->erase(translationCache->begin());
+        bool findCachedTranslation(uint64_t virtAddr, ArielTranslation* translation) {
+            if (translationCache.lookup(virtAddr, translationEpoch, translation)) {
+                statTranslationCacheHits->addData(1);
+                return true;
             }
+            return false;
+        }
 
-            // Insert the translated entry into the cache
-            translationCache->insert(std::pair<uint64_t, uint64_t>(virtualA, physicalA));
+        /* Every translation handed out goes through here so the ranges the caches may hold are known */
+        void cacheTranslation(uint64_t virtAddr, const ArielTranslation& translation) {
+            if (translationCache.insert(virtAddr, translation, translationEpoch)) {
+                statTranslationCacheEvict->addData(1);
+            }
+            translatedRanges.add(translation);
+        }
+
+        /* Drops every cached translation, here and in the cores, if any covers part of the range */
+        void invalidateTranslations(uint64_t virtStart, uint64_t length) {
+            if (!translatedRanges.overlaps(virtStart, length)) {
+                return;
+            }
+            statTranslationShootdown->addData(1);
+            translationEpoch++;
+            translatedRanges.clear();
         }
 
 };
@@ -15,6 +15,7 @@
 
 #include <sst_config.h>
 #include <stdio.h>
+#include <algorithm>
 
 #include "arielmemmgr_malloc.h"
 
@@ -33,10 +34,9 @@ ArielMemoryManagerMalloc::ArielMemoryManagerMalloc(SST::Component* owner, Params
 
     // PageAllocation and PageTable structures
     pageAllocations = (std::unordered_map<uint64_t, uint64_t>**) malloc(sizeof(std::unordered_map<uint64_t, uint64_t>*) * memoryLevels);
-    pageTables = (std::unordered_map<uint64_t, uint64_t>**) malloc(sizeof(std::unordered_map<uint64_t, uint64_t>*) * memoryLevels);
+    pageTables = (ArielPageTable**) malloc(sizeof(ArielPageTable*) * memoryLevels);
     for (uint32_t i = 0; i <memoryLevels; ++i) {
         pageAllocations[i] = new std::unordered_map<uint64_t, uint64_t>();
-        pageTables[i] = new std::unordered_map<uint64_t, uint64_t>();
     }
 
     // Initialize data structures
@@ -47,6 +47,8 @@ ArielMemoryManagerMalloc::ArielMemoryManagerMalloc(SST::Component* owner, Params
         sprintf(level_buffer, "pagesize%" PRIu32, i);
         pageSizes[i] = (uint64_t) params.find<uint64_t>(level_buffer, 4096);
         output->verbose(CALL_INFO, 2, 0, "Level %" PRIu32 " page size is %" PRIu64 "\n", i, pageSizes[i]);
+        checkPageSize(pageSizes[i]);
+        pageTables[i] = new ArielPageTable(pageSizes[i]);
 
         // Page count
         sprintf(level_buffer, "pagecount%" PRIu32, i);
@@ -84,6 +86,10 @@ ArielMemoryManagerMalloc::ArielMemoryManagerMalloc(SST::Component* owner, Params
 }
 
 ArielMemoryManagerMalloc::~ArielMemoryManagerMalloc() {
+    for (uint32_t i = 0; i < memoryLevels; ++i) {
+        delete pageTables[i];
+    }
+    free(pageTables);
 }
 
 
@@ -147,7 +153,7 @@ void ArielMemoryManagerMalloc::allocate(const uint64_t size, const uint32_t leve
         const uint64_t nextPhysPage = freePages[level]->front();
         freePages[level]->pop_front();
 
-        pageTables[level]->insert( std::pair<uint64_t, uint64_t>(nextVirtPage, nextPhysPage) );
+        pageTables[level]->insert(nextVirtPage, nextPhysPage);
 
         output->verbose(CALL_INFO, 4, 0, "Allocating memory page, physical page=%" PRIu64 ", virtual page=%" PRIu64 "\n",
                 nextPhysPage, nextVirtPage);
@@ -176,16 +182,19 @@ bool ArielMemoryManagerMalloc::allocateMalloc(const uint64_t size, const uint32_
     output->verbose(CALL_INFO, 4, 0, "Allocate malloc received. VA: %" PRIu64 ". Size: %" PRIu64 ". Level: %" PRIu32 ".\n", virtualAddress, size, level);
 
     // Check whether a malloc mapping already exists (i.e., we missed a free)
-    std::map<uint64_t, uint64_t>::iterator it = mallocTranslations.upper_bound(virtualAddress);
-    if (it == mallocTranslations.begin()) it = mallocTranslations.end();
-    else if (!mallocTranslations.empty()) it--;
-
-    if (it != mallocTranslations.end() && it->first <= virtualAddress) {
-        uint64_t primaryAddr = mallocPrimaryVAMap.find(it->first)->second;
-        if (virtualAddress < primaryAddr + (mallocInformation.find(primaryAddr)->second).size) {
-            output->verbose(CALL_INFO, 4, 0, "Found conflicting malloc, freeing address %" PRIu64 "\n", primaryAddr);
-            freeMalloc(primaryAddr);
-        }
+    std::map<uint64_t, mallocInfo>::iterator it = findMalloc(virtualAddress);
+    if (it != mallocRanges.end()) {
+        output->verbose(CALL_INFO, 4, 0, "Found conflicting malloc, freeing address %" PRIu64 "\n", it->first);
+        freeMalloc(it->first);
+    }
+
+    // Also free any that start inside the new range so ranges stay disjoint
+    it = mallocRanges.lower_bound(virtualAddress);
+    while (it != mallocRanges.end() && it->first < virtualAddress + size) {
+        const uint64_t conflictAddr = it->first;
+        ++it;
+        output->verbose(CALL_INFO, 4, 0, "Found conflicting malloc, freeing address %" PRIu64 "\n", conflictAddr);
+        freeMalloc(conflictAddr);
     }
 
     // Allocate new page(s). Round malloc to nearest whole page TODO fix so we can map partial pages -> needs a local VA->Ariel_VA mapping
@@ -199,25 +208,22 @@ bool ArielMemoryManagerMalloc::allocateMalloc(const uint64_t size, const uint32_
     }
 
     // Allocate the pages
-    std::unordered_set<uint64_t>* virtualPages = new std::unordered_set<uint64_t>;
-    uint64_t nextVirtPage = virtualAddress;
-    uint64_t firstPhysAddr, lastPhysAddr;
-    firstPhysAddr = freePages[level]->front();
+    mallocInfo& info = mallocRanges[virtualAddress];
+    info.size = size;
+    info.level = level;
+    info.physPages.reserve(pageCount);
     for (uint64_t i = 0; i != pageCount; i++) {
-        uint64_t nextPhysPage = freePages[level]->front();
-        mallocTranslations.insert(std::make_pair(nextVirtPage, nextPhysPage));
-        mallocPrimaryVAMap.insert(std::make_pair(nextVirtPage, virtualAddress));
+        info.physPages.push_back(freePages[level]->front());
         freePages[level]->pop_front();
-        virtualPages->insert(nextVirtPage);
-        nextVirtPage += pageSizes[level];
-        lastPhysAddr = nextPhysPage;
     }
 
-    output->verbose(CALL_INFO, 4, 0, "Malloc mapped %" PRIu64 " to [%" PRIu64 ", %" PRIu64 "] (%" PRIu64 " pages).\n", virtualAddress, firstPhysAddr, lastPhysAddr, pageCount);
+    if (pageCount > 0) {
+        output->verbose(CALL_INFO, 4, 0, "Malloc mapped %" PRIu64 " to [%" PRIu64 ", %" PRIu64 "] (%" PRIu64 " pages).\n", virtualAddress, info.physPages.front(), info.physPages.back(), pageCount);
+    }
+
+    // The malloc takes priority over any demand mapped pages it covers
+    invalidateTranslations(virtualAddress, size);
 
-    // Record malloc
-    mallocInformation.insert(std::make_pair(virtualAddress, mallocInfo(size, level, virtualPages)));
-    
     statBytesAlloc[level]->addData(size);
     return true;
 }
@@ -226,91 +232,117 @@ bool ArielMemoryManagerMalloc::allocateMalloc(const uint64_t size, const uint32_
 void ArielMemoryManagerMalloc::freeMalloc(const uint64_t virtualAddress) {
     output->verbose(CALL_INFO, 4, 0, "Freeing %" PRIu64 "\n", virtualAddress);
     
-    // Lookup VA in mallocInformation
-    std::map<uint64_t, mallocInfo>::iterator it = mallocInformation.find(virtualAddress);
-    if (it == mallocInformation.end()) return;
+    // Lookup VA in mallocRanges
+    std::map<uint64_t, mallocInfo>::iterator it = mallocRanges.find(virtualAddress);
+    if (it == mallocRanges.end()) return;
     
     statBytesFree[it->second.level]->addData(it->second.size);
 
-    // Free each VA in mallocInformation from mallocTranslations & mallocPrimaryVAMap TODO fix so that mapping stays but address is available for future mallocs
-    std::unordered_set<uint64_t>* myKeys = (it->second.VAKeys);
-    for (std::unordered_set<uint64_t>::iterator vaIt = myKeys->begin(); vaIt != myKeys->end(); vaIt++) {
-        mallocPrimaryVAMap.erase(*vaIt);
-        freePages[(it->second).level]->push_front(mallocTranslations.find(*vaIt)->second);
-        mallocTranslations.erase(*vaIt);
+    // Return the pages to the pool TODO fix so that mapping stays but address is available for future mallocs
+    std::vector<uint64_t>& physPages = it->second.physPages;
+    for (std::vector<uint64_t>::reverse_iterator pageIt = physPages.rbegin(); pageIt != physPages.rend(); pageIt++) {
+        freePages[(it->second).level]->push_front(*pageIt);
+    }
+
+    const uint64_t size = it->second.size;
+    mallocRanges.erase(it);
+    invalidateTranslations(virtualAddress, size);
+}
+
+
+/*
+ *  Find the malloc whose range holds virtAddr, or mallocRanges.end()
+ */
+std::map<uint64_t, ArielMemoryManagerMalloc::mallocInfo>::iterator ArielMemoryManagerMalloc::findMalloc(const uint64_t virtAddr) {
+    return findArielRange(mallocRanges, virtAddr);
+}
+
+
+/*
+ *  Shrinks a demand page translation so it does not cover any malloc, which
+ *  take priority. virtAddr is outside every malloc.
+ */
+void ArielMemoryManagerMalloc::clipToMallocs(const uint64_t virtAddr, ArielTranslation* translation) {
+    uint64_t start = translation->virtStart;
+    uint64_t end = translation->virtStart + translation->length;
+
+    std::map<uint64_t, mallocInfo>::iterator next = mallocRanges.upper_bound(virtAddr);
+    if (next != mallocRanges.end() && next->first < end) {
+        end = next->first;
+    }
+    if (next != mallocRanges.begin()) {
+        --next;
+        const uint64_t prevEnd = next->first + next->second.size;
+        if (prevEnd > start) start = prevEnd;
     }
 
-    // Remove mallocInformation entry
-    delete myKeys;
-    mallocInformation.erase(virtualAddress);
+    translation->physStart += start - translation->virtStart;
+    translation->virtStart = start;
+    translation->length = end - start;
 }
 
 
-uint64_t ArielMemoryManagerMalloc::translateAddress(uint64_t virtAddr) {
+uint64_t ArielMemoryManagerMalloc::translateAddress(uint64_t virtAddr, ArielTranslation* translation) {
     // If translation is disabled, then just return address
     if( ! translationEnabled ) {
+        translation->virtStart = 0;
+        translation->length = (uint64_t) -1;
+        translation->physStart = 0;
         return virtAddr;
     }
 
     // Keep track of how many translations we are performing
     statTranslationQueries->addData(1);
 
-    uint64_t physAddr = (uint64_t) -1;
     bool found = false;
 
     output->verbose(CALL_INFO, 4, 0, "Page Table: translate virtual address %" PRIu64 "\n", virtAddr);
 
     // Check the translation cache otherwise carry on
-    auto checkCache = translationCache->find(virtAddr);
-    if(checkCache != translationCache->end()) {
-        statTranslationCacheHits->addData(1);
-        return checkCache->second;
+    if(findCachedTranslation(virtAddr, translation)) {
+        return translation->translate(virtAddr);
     }
 
     // Check malloc mappings
-    if (!mallocTranslations.empty()) {
-        std::map<uint64_t, uint64_t>::iterator it = mallocTranslations.upper_bound(virtAddr);
-        if (it == mallocTranslations.begin()) it = mallocTranslations.end();
-        else it--;
-
-        if (it != mallocTranslations.end() && (it->first <= virtAddr)) {
-            uint64_t primaryAddr = mallocPrimaryVAMap.find(it->first)->second;
-            if (virtAddr < (primaryAddr + (mallocInformation.find(primaryAddr)->second).size)) {
-                uint64_t offset = virtAddr - it->first;
-                physAddr = offset + it->second;
-                found = true;
-            }
+    if (!mallocRanges.empty()) {
+        std::map<uint64_t, mallocInfo>::iterator it = findMalloc(virtAddr);
+
+        if (it != mallocRanges.end()) {
+            // Malloc pages start at the malloc's VA so need not be page aligned
+            const uint64_t pageSize = pageSizes[it->second.level];
+            const uint64_t page = (virtAddr - it->first) / pageSize;
+            const uint64_t pageOffset = page * pageSize;
+
+            translation->virtStart = it->first + pageOffset;
+            translation->length = std::min(pageSize, it->second.size - pageOffset);
+            translation->physStart = it->second.physPages[page];
+            found = true;
         }
     }
 
     // We will have to search every memory level to find where the address lies
-    for(uint32_t i = 0; i < memoryLevels; ++i) {
-        if (!found) {
-        std::unordered_map<uint64_t, uint64_t>::iterator page_itr;
+    for(uint32_t i = 0; i < memoryLevels && !found; ++i) {
         const uint64_t pageSize = pageSizes[i];
-            const uint64_t page_offset = virtAddr % pageSize;
+        const uint64_t page_offset = virtAddr & (pageSize - 1);
         const uint64_t page_start = virtAddr - page_offset;
+        uint64_t phys_start;
 
-        page_itr = pageTables[i]->find(page_start);
-
-            if (page_itr != pageTables[i]->end()) {
-                // Located
-            physAddr = page_itr->second + page_offset;
-
-                output->verbose(CALL_INFO, 4, 0, "Page table hit: virtual address=%" PRIu64 " hit in level: %" PRIu32 ", virtual page start=%" PRIu64 ", virtual end=%" PRIu64 ", translates to phys page start=%" PRIu64 " translates to: phys address: %" PRIu64 " (offset added to phys start=%" PRIu64 ")\n",
-                    virtAddr, i, page_itr->first, page_itr->first + pageSize, page_itr->second, physAddr, page_offset);
+        if (pageTables[i]->find(virtAddr, &phys_start)) {
+            // Located
+            output->verbose(CALL_INFO, 4, 0, "Page table hit: virtual address=%" PRIu64 " hit in level: %" PRIu32 ", virtual page start=%" PRIu64 ", virtual end=%" PRIu64 ", translates to phys page start=%" PRIu64 " translates to: phys address: %" PRIu64 " (offset added to phys start=%" PRIu64 ")\n",
+                virtAddr, i, page_start, page_start + pageSize, phys_start, phys_start + page_offset, page_offset);
 
+            translation->virtStart = page_start;
+            translation->length = pageSize;
+            translation->physStart = phys_start;
+            clipToMallocs(virtAddr, translation);
             found = true;
-            break;
-        }
-        } else {
-            break;
         }
     }
 
     if(found) {
-        cacheTranslation(virtAddr, physAddr);
-        return physAddr;
+        cacheTranslation(virtAddr, *translation);
+        return translation->translate(virtAddr);
     } else {
         output->verbose(CALL_INFO, 4, 0, "Page table miss for virtual address: %" PRIu64 "\n", virtAddr);
 
@@ -338,7 +370,7 @@ uint64_t ArielMemoryManagerMalloc::translateAddress(uint64_t virtAddr) {
             }
 
         // Now attempt to refind it
-        const uint64_t newPhysAddr = translateAddress(virtAddr);
+        const uint64_t newPhysAddr = translateAddress(virtAddr, translation);
 
         output->verbose(CALL_INFO, 4, 0, "Page allocation routine mapped to address: %" PRIu64 "\n", newPhysAddr );
 
@@ -25,6 +25,7 @@
 
 #include <stdint.h>
 #include <deque>
+#include <map>
 #include <vector>
 #include <unordered_map>
 
@@ -43,7 +44,7 @@ class ArielMemoryManagerMalloc : public ArielMemoryManager {
 #define ARIEL_MEMMGR_MALLOC_ELI_PARAMS ARIEL_ELI_MEMMGR_PARAMS,\
             {"memorylevels",    "Number of memory levels in the system", "1"},\
             {"defaultlevel",    "Default memory level", "0"},\
-            {"pagesize%(memorylevels)d", "Page size for memory Level x", "4096"},\
+            {"pagesize%(memorylevels)d", "Page size for memory Level x, a power of two. 2MB (2097152) and 1GB (1073741824) pages shorten page table walks", "4096"},\
             {"pagecount%(memorylevels)d", "Page count for memory Level x", "131072"},\
             {"page_populate_%(memorylevels)d", "Pre-populate/partially pre-populate a page table for a level in memory, this is the file to read in.", ""}
 #define ARIEL_MEMMGR_MALLOC_ELI_STATS ARIEL_ELI_MEMMGR_STATS, \
@@ -61,7 +62,8 @@ class ArielMemoryManagerMalloc : public ArielMemoryManager {
         void setDefaultPool(uint32_t pool);
         uint32_t getDefaultPool();
 
-        uint64_t translateAddress(uint64_t virtAddr);
+        using ArielMemoryManager::translateAddress;
+        uint64_t translateAddress(uint64_t virtAddr, ArielTranslation* translation);
         void printStats();
 
         void freeMalloc(const uint64_t vAddr);
@@ -74,13 +76,14 @@ class ArielMemoryManagerMalloc : public ArielMemoryManager {
         struct mallocInfo {
             uint64_t size;
             uint32_t level;
-            std::unordered_set<uint64_t>* VAKeys;
-            mallocInfo(uint64_t size, uint32_t level, std::unordered_set<uint64_t>* VAKeys) : size(size), level(level), VAKeys(VAKeys) {};
+            std::vector<uint64_t> physPages;    // Physical page backing each page of the malloc, in VA order
         };
 
-        std::map<uint64_t, uint64_t> mallocPrimaryVAMap;    // Map VA of each PA to the primary VA of the malloc -> used to find the mallocInfo
-        std::map<uint64_t, uint64_t> mallocTranslations;    // Map VA to PA for mallocs -> primary lookup
-        std::map<uint64_t, mallocInfo> mallocInformation;   // Map mallocID to information about the malloc -> use for frees/allocs
+        std::map<uint64_t, mallocInfo>::iterator findMalloc(const uint64_t virtAddr);
+        void clipToMallocs(const uint64_t virtAddr, ArielTranslation* translation);
+
+        // Mallocs never overlap so ordering them by start VA gives an interval tree
+        std::map<uint64_t, mallocInfo> mallocRanges;
 
         uint32_t defaultLevel;
         uint32_t memoryLevels;
@@ -88,7 +91,7 @@ class ArielMemoryManagerMalloc : public ArielMemoryManager {
 
         std::deque<uint64_t>** freePages;
         std::unordered_map<uint64_t, uint64_t>** pageAllocations;
-        std::unordered_map<uint64_t, uint64_t>** pageTables;
+        ArielPageTable** pageTables;
 
         std::vector<Statistic<uint64_t>* > statBytesAlloc;
         std::vector<Statistic<uint64_t>* > statBytesFree;
@@ -25,6 +25,8 @@ ArielMemoryManagerSimple::ArielMemoryManagerSimple(SST::Component* owner, Params
     
     pageSize = (uint64_t) params.find<uint64_t>("pagesize0", 4096);
     output->verbose(CALL_INFO, 2, 0, "Page size is %" PRIu64 "\n", pageSize);
+    checkPageSize(pageSize);
+    pageTable = new ArielPageTable(pageSize);
 
     uint64_t pageCount = (uint64_t) params.find<uint64_t>("pagecount0", 131072);
     output->verbose(CALL_INFO, 2, 0, "Page count is %" PRIu64 "\n", pageCount);
@@ -40,12 +42,13 @@ ArielMemoryManagerSimple::ArielMemoryManagerSimple(SST::Component* owner, Params
     std::string popFilePath = params.find<std::string>("page_populate_0", "");
     if (popFilePath != "") {
         output->verbose(CALL_INFO, 1, 0, "Populating page table from %s...\n", popFilePath.c_str());
-        populatePageTable(popFilePath, &pageTable, &freePages, pageSize);
+        populatePageTable(popFilePath, pageTable, &freePages, pageSize);
     }
     
 }
 
 ArielMemoryManagerSimple::~ArielMemoryManagerSimple() {
+    delete pageTable;
 }
 
 
@@ -77,7 +80,7 @@ void ArielMemoryManagerSimple::allocate(const uint64_t size, const uint32_t leve
         const uint64_t nextPhysPage = freePages.front();
         freePages.pop_front();
 
-        pageTable.insert( std::pair<uint64_t, uint64_t>(nextVirtPage, nextPhysPage) );
+        pageTable->insert(nextVirtPage, nextPhysPage);
 
         output->verbose(CALL_INFO, 4, 0, "Allocating memory page, physical page=%" PRIu64 ", virtual page=%" PRIu64 "\n",
                 nextPhysPage, nextVirtPage);
@@ -90,9 +93,12 @@ void ArielMemoryManagerSimple::allocate(const uint64_t size, const uint32_t leve
 
 }
 
-uint64_t ArielMemoryManagerSimple::translateAddress(uint64_t virtAddr) {
+uint64_t ArielMemoryManagerSimple::translateAddress(uint64_t virtAddr, ArielTranslation* translation) {
     // If translation is disabled, then just return address
     if( ! translationEnabled ) {
+        translation->virtStart = 0;
+        translation->length = (uint64_t) -1;
+        translation->physStart = 0;
         return virtAddr;
     }
 
@@ -102,33 +108,32 @@ uint64_t ArielMemoryManagerSimple::translateAddress(uint64_t virtAddr) {
     output->verbose(CALL_INFO, 4, 0, "Page Table: translate virtual address %" PRIu64 "\n", virtAddr);
 
     // Check the translation cache otherwise carry on
-    auto checkCache = translationCache->find(virtAddr);
-    if(checkCache != translationCache->end()) {
-        statTranslationCacheHits->addData(1);
-        return checkCache->second;
+    if(findCachedTranslation(virtAddr, translation)) {
+        return translation->translate(virtAddr);
     }
 
-    std::unordered_map<uint64_t, uint64_t>::iterator page_itr;
-    const uint64_t page_offset = virtAddr % pageSize;
+    const uint64_t page_offset = virtAddr & (pageSize - 1);
     const uint64_t page_start = virtAddr - page_offset;
+    uint64_t phys_start;
 
-    page_itr = pageTable.find(page_start);
-
-    if(page_itr != pageTable.end()) {
+    if(pageTable->find(virtAddr, &phys_start)) {
         // Located
-        uint64_t physAddr = page_itr->second + page_offset;
+        uint64_t physAddr = phys_start + page_offset;
 
         output->verbose(CALL_INFO, 4, 0, "Page table hit: virtual address=%" PRIu64 " hit, virtual page start=%" PRIu64 ", virtual end=%" PRIu64 ", translates to phys page start=%" PRIu64 " translates to: phys address: %" PRIu64 " (offset added to phys start=%" PRIu64 ")\n",
-                virtAddr, page_itr->first, page_itr->first + pageSize, page_itr->second, physAddr, page_offset);
+                virtAddr, page_start, page_start + pageSize, phys_start, physAddr, page_offset);
 
-        cacheTranslation(virtAddr, physAddr);
+        translation->virtStart = page_start;
+        translation->length = pageSize;
+        translation->physStart = phys_start;
+        cacheTranslation(virtAddr, *translation);
         return physAddr;
 
     } else {
         output->verbose(CALL_INFO, 4, 0, "Page table miss for virtual address: %" PRIu64 "\n", virtAddr);
 
         // We did not find the address in memory, that means we should allocate it one from our default pool
-        uint64_t offset = virtAddr % pageSize;
+        uint64_t offset = page_offset;
 
         output->verbose(CALL_INFO, 4, 0, "Page offset calculation (generating a new page allocation request) for address %" PRIu64 ", offset=%" PRIu64 ", requesting virtual map to address: %" PRIu64 "\n",
                 virtAddr, offset, (virtAddr - offset));
@@ -137,7 +142,7 @@ uint64_t ArielMemoryManagerSimple::translateAddress(uint64_t virtAddr) {
         allocate(8, 0, virtAddr - offset);
 
         // Now attempt to refind it
-        const uint64_t newPhysAddr = translateAddress(virtAddr);
+        const uint64_t newPhysAddr = translateAddress(virtAddr, translation);
 
         output->verbose(CALL_INFO, 4, 0, "Page allocation routine mapped to address: %" PRIu64 "\n", newPhysAddr );
 
@@ -152,10 +157,10 @@ void ArielMemoryManagerSimple::printStats() {
     output->output("Page Table Sizes:\n");
 
     output->output("- Map entries         %" PRIu32 "\n",
-        (uint32_t) pageTable.size());
+        (uint32_t) pageTable->size());
 
     output->output("Page Table Coverages:\n");
 
     output->output("- Bytes               %" PRIu64 "\n",
-        ((uint64_t) pageTable.size()) * ((uint64_t) pageSize));
+        ((uint64_t) pageTable->size()) * ((uint64_t) pageSize));
 }
@@ -41,7 +41,7 @@ class ArielMemoryManagerSimple : public ArielMemoryManager {
                 "Simple allocate-on-first touch memory manager", "SST::ArielComponent::ArielMemoryManager")
 
 #define MEMMGR_SIMPLE_ELI_PARAMS ARIEL_ELI_MEMMGR_PARAMS,\
-            {"pagesize0", "Page size", "4096"},\
+            {"pagesize0", "Page size, a power of two. 2MB (2097152) and 1GB (1073741824) pages shorten page table walks", "4096"},\
             {"pagecount0", "Page count", "131072"},\
             {"page_populate_0", "Pre-populate/partially pre-poulate the page table, this is the file to read in.", ""}
 
@@ -52,7 +52,8 @@ class ArielMemoryManagerSimple : public ArielMemoryManager {
         ArielMemoryManagerSimple(SST::Component* owner, Params& params);
         ~ArielMemoryManagerSimple();
 
-        uint64_t translateAddress(uint64_t virtAddr);
+        using ArielMemoryManager::translateAddress;
+        uint64_t translateAddress(uint64_t virtAddr, ArielTranslation* translation);
         void printStats();
 
     private:
@@ -61,7 +62,7 @@ class ArielMemoryManagerSimple : public ArielMemoryManager {
         uint64_t pageSize;
         std::deque<uint64_t> freePages;
 
-        std::unordered_map<uint64_t, uint64_t> pageTable;
+        ArielPageTable* pageTable;
 };
 
 }
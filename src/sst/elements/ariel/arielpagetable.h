@@ -0,0 +1,277 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#ifndef _H_ARIEL_PAGE_TABLE
+#define _H_ARIEL_PAGE_TABLE
+
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include <vector>
+
+namespace SST {
+namespace ArielComponent {
+
+/*
+ * A run of virtual addresses mapped to contiguous physical addresses,
+ * normally one page (or the part of a page a malloc covers)
+ */
+struct ArielTranslation {
+    uint64_t virtStart;
+    uint64_t length;
+    uint64_t physStart;
+
+    bool contains(uint64_t virtAddr) const {
+        return (virtAddr - virtStart) < length;
+    }
+
+    uint64_t translate(uint64_t virtAddr) const {
+        return physStart + (virtAddr - virtStart);
+    }
+};
+
+/*
+ * Direct mapped cache of translations, indexed by the 4KB virtual
+ * block of the address.  Entries are tagged with the epoch they were
+ * filled in, so a memory manager can drop every cached translation by
+ * moving to a new epoch.
+ */
+class ArielTranslationCache {
+
+    public:
+        ArielTranslationCache(uint32_t entries = 64) {
+            resize(entries);
+        }
+
+        /* Rounds entries up to a power of two and empties the cache */
+        void resize(uint32_t entries) {
+            uint32_t size = 1;
+            while(size < entries) {
+                size <<= 1;
+            }
+
+            Entry empty;
+            memset(&empty, 0, sizeof(empty));
+            cache.assign(size, empty);
+            mask = size - 1;
+        }
+
+        bool lookup(uint64_t virtAddr, uint64_t epoch, ArielTranslation* translation) const {
+            const Entry& entry = cache[(virtAddr >> 12) & mask];
+            if(entry.epoch == epoch && entry.translation.contains(virtAddr)) {
+                *translation = entry.translation;
+                return true;
+            }
+            return false;
+        }
+
+        /* Returns true if a valid translation was evicted */
+        bool insert(uint64_t virtAddr, const ArielTranslation& translation, uint64_t epoch) {
+            Entry& entry = cache[(virtAddr >> 12) & mask];
+            const bool evict = (entry.epoch == epoch && entry.translation.length > 0);
+            entry.translation = translation;
+            entry.epoch = epoch;
+            return evict;
+        }
+
+    private:
+        struct Entry {
+            ArielTranslation translation;
+            uint64_t epoch;
+        };
+
+        std::vector<Entry> cache;
+        uint64_t mask;
+
+};
+
+/*
+ * Translations handed out since the caches were last invalidated, so
+ * a change to the mappings only needs to invalidate them if it
+ * overlaps one.  Translations are disjoint so each starts after the
+ * previous one ends.
+ */
+class ArielTranslatedRanges {
+
+    public:
+        void add(const ArielTranslation& translation) {
+            ranges.insert(std::make_pair(translation.virtStart, translation.virtStart + translation.length));
+        }
+
+        /* Whether any translation overlaps [virtStart, virtStart + length) */
+        bool overlaps(uint64_t virtStart, uint64_t length) const {
+            if(0 == length) {
+                return false;
+            }
+
+            // The last range starting before the end is the only candidate
+            std::map<uint64_t, uint64_t>::const_iterator it = ranges.lower_bound(virtStart + length);
+            if(it == ranges.begin()) {
+                return false;
+            }
+            --it;
+            return it->second > virtStart;
+        }
+
+        void clear() {
+            ranges.clear();
+        }
+
+        size_t size() const {
+            return ranges.size();
+        }
+
+    private:
+        std::map<uint64_t, uint64_t> ranges;    // Start -> end
+
+};
+
+/*
+ * Finds the entry whose range holds virtAddr in a map of disjoint
+ * ranges keyed by start address; the mapped type must have a size
+ * member.  Returns ranges.end() if no range holds virtAddr.
+ */
+template<typename RangeInfo>
+typename std::map<uint64_t, RangeInfo>::iterator findArielRange(std::map<uint64_t, RangeInfo>& ranges, uint64_t virtAddr) {
+    typename std::map<uint64_t, RangeInfo>::iterator it = ranges.upper_bound(virtAddr);
+    if(it == ranges.begin()) {
+        return ranges.end();
+    }
+    --it;
+
+    if(virtAddr - it->first < it->second.size) {
+        return it;
+    }
+    return ranges.end();
+}
+
+/*
+ * Radix tree page table keyed by virtual page number, 512 entries
+ * (9 bits) per level.  The page size must be a power of two; larger
+ * pages (2MB, 1GB) leave fewer page number bits and so fewer levels
+ * to walk.  The last leaf used is remembered since accesses usually
+ * stay within its 512 pages.
+ */
+class ArielPageTable {
+
+    public:
+        ArielPageTable(uint64_t pageSz) : pageSize(pageSz), pageShift(0), entries(0) {
+            while((((uint64_t) 1) << pageShift) < pageSize) {
+                pageShift++;
+            }
+
+            levels = (64 - pageShift + ARIEL_PT_LEVEL_BITS - 1) / ARIEL_PT_LEVEL_BITS;
+            root = new Node();
+            lastLeaf = NULL;
+            lastLeafTag = 0;
+        }
+
+        ~ArielPageTable() {
+            freeNode(root, levels);
+        }
+
+        uint64_t getPageSize() const { return pageSize; }
+
+        /* Number of pages mapped */
+        uint64_t size() const { return entries; }
+
+        /* Finds the physical start of the page holding virtAddr */
+        bool find(uint64_t virtAddr, uint64_t* physPage) {
+            const uint64_t vpn = virtAddr >> pageShift;
+            Node* leaf = findLeaf(vpn, false);
+            if(NULL == leaf) {
+                return false;
+            }
+
+            const uint64_t entry = leaf->entry[vpn & ARIEL_PT_LEVEL_MASK];
+            if(0 == entry) {
+                return false;
+            }
+
+            *physPage = entry - 1;
+            return true;
+        }
+
+        /* Maps the page starting at virtPage, replacing any existing mapping */
+        void insert(uint64_t virtPage, uint64_t physPage) {
+            const uint64_t vpn = virtPage >> pageShift;
+            Node* leaf = findLeaf(vpn, true);
+            uint64_t& entry = leaf->entry[vpn & ARIEL_PT_LEVEL_MASK];
+            if(0 == entry) {
+                entries++;
+            }
+            // Leaf entries hold the physical page plus one so zero is unmapped
+            entry = physPage + 1;
+        }
+
+    private:
+        static const uint32_t ARIEL_PT_LEVEL_BITS = 9;
+        static const uint64_t ARIEL_PT_LEVEL_MASK = (1 << ARIEL_PT_LEVEL_BITS) - 1;
+
+        /* Interior entries are pointers to the next level, leaves are pages */
+        struct Node {
+            uint64_t entry[1 << ARIEL_PT_LEVEL_BITS];
+            Node() { memset(entry, 0, sizeof(entry)); }
+        };
+
+        Node* findLeaf(uint64_t vpn, bool create) {
+            const uint64_t tag = vpn >> ARIEL_PT_LEVEL_BITS;
+            if(NULL != lastLeaf && tag == lastLeafTag) {
+                return lastLeaf;
+            }
+
+            Node* node = root;
+            for(uint32_t shift = (levels - 1) * ARIEL_PT_LEVEL_BITS; shift > 0; shift -= ARIEL_PT_LEVEL_BITS) {
+                uint64_t& next = node->entry[(vpn >> shift) & ARIEL_PT_LEVEL_MASK];
+                if(0 == next) {
+                    if(!create) {
+                        return NULL;
+                    }
+                    next = (uint64_t) (uintptr_t) new Node();
+                }
+                node = (Node*) (uintptr_t) next;
+            }
+
+            lastLeaf = node;
+            lastLeafTag = tag;
+            return node;
+        }
+
+        void freeNode(Node* node, uint32_t level) {
+            if(level > 1) {
+                for(uint32_t i = 0; i <= ARIEL_PT_LEVEL_MASK; ++i) {
+                    if(0 != node->entry[i]) {
+                        freeNode((Node*) (uintptr_t) node->entry[i], level - 1);
+                    }
+                }
+            }
+            delete node;
+        }
+
+        uint64_t pageSize;
+        uint32_t pageShift;
+        uint32_t levels;
+        uint64_t entries;
+        Node* root;
+        Node* lastLeaf;
+        uint64_t lastLeafTag;
+
+};
+
+}
+}
+
+#endif
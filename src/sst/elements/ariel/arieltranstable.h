@@ -0,0 +1,118 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#ifndef _H_SST_ARIEL_TRANS_TABLE
+#define _H_SST_ARIEL_TRANS_TABLE
+
+#include <stdint.h>
+#include <vector>
+
+namespace SST {
+namespace ArielComponent {
+
+/*
+ * Set of the request ids a core has outstanding.  Ids index an open
+ * addressed table (linear probing, at most half full) that is
+ * allocated once.  A core's ids come from a shared counter so are
+ * close together, which spreads them well over the slots.
+ */
+class ArielTransactionTable {
+
+    public:
+        ArielTransactionTable(uint32_t maxPending) : count(0) {
+            uint32_t size = 16;
+            while(size < maxPending * 4) {
+                size <<= 1;
+            }
+            resize(size);
+        }
+
+        size_t size() const { return count; }
+
+        void insert(uint64_t id) {
+            // A split request can take a core past its maximum, so keep room
+            if((count + 1) * 2 > ids.size()) {
+                resize(ids.size() * 2);
+            }
+
+            size_t slot = id & mask;
+            while(used[slot]) {
+                slot = (slot + 1) & mask;
+            }
+
+            ids[slot] = id;
+            used[slot] = 1;
+            count++;
+        }
+
+        /* Returns false if id was not outstanding */
+        bool erase(uint64_t id) {
+            size_t slot = id & mask;
+            while(used[slot] && ids[slot] != id) {
+                slot = (slot + 1) & mask;
+            }
+
+            if(!used[slot]) {
+                return false;
+            }
+
+            // Shift later entries of the probe run back over the hole
+            size_t hole = slot;
+            size_t next = (slot + 1) & mask;
+            while(used[next]) {
+                const size_t home = ids[next] & mask;
+                if(((next - home) & mask) >= ((next - hole) & mask)) {
+                    ids[hole] = ids[next];
+                    hole = next;
+                }
+                next = (next + 1) & mask;
+            }
+
+            used[hole] = 0;
+            count--;
+            return true;
+        }
+
+    private:
+        void resize(size_t size) {
+            std::vector<uint64_t> oldIds;
+            std::vector<uint8_t> oldUsed;
+            oldIds.swap(ids);
+            oldUsed.swap(used);
+
+            ids.assign(size, 0);
+            used.assign(size, 0);
+            mask = size - 1;
+            count = 0;
+
+            for(size_t i = 0; i < oldIds.size(); ++i) {
+                if(oldUsed[i]) {
+                    insert(oldIds[i]);
+                }
+            }
+        }
+
+        std::vector<uint64_t> ids;
+        std::vector<uint8_t> used;
+        size_t count;
+        size_t mask;
+
+};
+
+}
+}
+
+#endif
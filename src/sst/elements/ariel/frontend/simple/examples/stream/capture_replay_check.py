@@ -0,0 +1,137 @@
+#!/usr/bin/env python
+#
+# Checks Ariel's capture_file and replay_file.  Runs stream with its
+# command stream captured, replays the capture and compares the core
+# statistics of the two runs.  Then replays a truncated copy and a copy
+# with a corrupt index and checks that sst fails with an error naming
+# the problem rather than crashing or running on.  Last it replays a
+# copy without the exit command, as left by a capture run that was cut
+# short, which must end with a warning instead of idling forever.
+#
+# Needs the stream binary (make stream) and SST_ROOT set as for
+# runstream.py.
+#
+# Usage: capture_replay_check.py [sst]
+
+import os
+import struct
+import subprocess
+import sys
+
+sstBin = sys.argv[1] if len(sys.argv) > 1 else "sst"
+
+captureFile = "capturestream.arlc"
+badFile = "capturestream_bad.arlc"
+
+# Statistics that depend only on the command stream.  Cycle counts are
+# left out since a captured run stalls whenever the traced application
+# falls behind, which a replay never does.
+compareStats = [
+    "read_requests", "write_requests", "read_request_sizes", "write_request_sizes",
+    "split_read_requests", "split_write_requests", "flush_requests", "fence_requests",
+    "no_ops", "instruction_count", "core_tlb_hits",
+    "fp_sp_ins", "fp_dp_ins", "fp_sp_simd_ins", "fp_dp_simd_ins",
+    "fp_sp_scalar_ins", "fp_dp_scalar_ins", "fp_sp_ops", "fp_dp_ops",
+]
+
+failed = False
+
+def fail(msg):
+    global failed
+    print("FAIL: " + msg)
+    failed = True
+
+def runSst(mode, fileName, statFile):
+    cmd = [sstBin, "capturestream.py", "--model-options=%s %s %s" % (mode, fileName, statFile)]
+    p = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    out = p.communicate()[0]
+    return p.returncode, out
+
+def readStats(statFile):
+    stats = {}
+    with open(statFile) as f:
+        header = [h.strip() for h in f.readline().split(",")]
+        name = header.index("StatisticName")
+        subId = header.index("StatisticSubId")
+        keep = [i for i, h in enumerate(header) if h.split(".")[0] in ("Sum", "SumSQ", "Count", "Min", "Max")]
+        for line in f:
+            row = [v.strip() for v in line.split(",")]
+            if len(row) == len(header) and row[name] in compareStats:
+                stats[(row[name], row[subId])] = [row[i] for i in keep]
+    return stats
+
+def checkFails(desc, data, expect):
+    with open(badFile, "wb") as f:
+        f.write(data)
+    rc, out = runSst("replay", badFile, "capturestream_bad.csv")
+    if rc == 0:
+        fail("replay of a %s file succeeded" % desc)
+    elif expect not in out:
+        fail("replay of a %s file did not report '%s':\n%s" % (desc, expect, out))
+    else:
+        print("PASS: replay of a %s file failed with '%s'" % (desc, expect))
+
+os.environ["OMP_NUM_THREADS"] = "1"
+
+rc, out = runSst("capture", captureFile, "capturestream_capture.csv")
+if rc != 0:
+    print(out)
+    print("FAIL: capture run failed")
+    sys.exit(1)
+
+rc, out = runSst("replay", captureFile, "capturestream_replay.csv")
+if rc != 0:
+    print(out)
+    print("FAIL: replay run failed")
+    sys.exit(1)
+
+captured = readStats("capturestream_capture.csv")
+replayed = readStats("capturestream_replay.csv")
+if not captured or ("instruction_count", "0") not in captured:
+    fail("no core statistics found in capturestream_capture.csv")
+for key in sorted(set(captured.keys()) | set(replayed.keys())):
+    if captured.get(key) != replayed.get(key):
+        fail("%s.%s captured %s replayed %s" % (key[0], key[1], captured.get(key), replayed.get(key)))
+if not failed:
+    print("PASS: replay matches capture on %d statistics" % len(captured))
+
+with open(captureFile, "rb") as f:
+    data = f.read()
+
+checkFails("truncated", data[:len(data) // 2], "is truncated")
+
+# The trailer is the index offset and chunk count followed by the magic
+# number.  Moving the index offset back a byte makes it overlap the
+# last chunk.
+trailer = len(data) - 20
+indexOffset = bytearray(data[trailer:trailer + 8])
+indexOffset[0] = (indexOffset[0] - 1) & 0xff
+checkFails("corrupt index", data[:trailer] + bytes(indexOffset) + data[trailer + 8:], "has a corrupt index")
+
+checkFails("non capture", b"not a capture file" * 8, "is not an Ariel capture file")
+
+# Drop core 0's last chunk, which holds the exit command, from the index.
+# Index entries are offset, core, commands, raw and stored size.
+chunkFormat = "<QIIII"
+chunkSize = struct.calcsize(chunkFormat)
+indexOffset, chunkCount = struct.unpack("<QQ", data[trailer:trailer + 16])
+chunks = [data[indexOffset + i * chunkSize:indexOffset + (i + 1) * chunkSize] for i in range(chunkCount)]
+core0 = [i for i, c in enumerate(chunks) if struct.unpack(chunkFormat, c)[1] == 0]
+if not core0:
+    fail("no chunks for core 0 in %s" % captureFile)
+else:
+    del chunks[core0[-1]]
+    with open(badFile, "wb") as f:
+        f.write(data[:indexOffset] + b"".join(chunks) + struct.pack("<QQ", indexOffset, len(chunks)) + data[-4:])
+    rc, out = runSst("replay", badFile, "capturestream_bad.csv")
+    if rc != 0:
+        fail("replay without an exit command failed:\n%s" % out)
+    elif "ended without an exit command" not in out:
+        fail("replay without an exit command did not warn:\n%s" % out)
+    else:
+        print("PASS: replay without an exit command ended with a warning")
+
+os.remove(badFile)
+
+if failed:
+    sys.exit(1)
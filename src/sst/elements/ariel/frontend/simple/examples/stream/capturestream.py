@@ -0,0 +1,71 @@
+import sst
+import os
+import sys
+
+# Runs stream on one core with the command stream either captured to or
+# replayed from a file.  Used by capture_replay_check.py.
+#
+# Usage: sst capturestream.py --model-options="<capture|replay> <file> <stat csv>"
+
+mode = sys.argv[1] if len(sys.argv) > 1 else "capture"
+captureFile = sys.argv[2] if len(sys.argv) > 2 else "stream.arlc"
+statFile = sys.argv[3] if len(sys.argv) > 3 else "capturestream_" + mode + ".csv"
+
+sst.setProgramOption("timebase", "1ps")
+
+sst_root = os.getenv( "SST_ROOT" )
+
+ariel = sst.Component("a0", "ariel.ariel")
+ariel.addParams({
+        "verbose" : "0",
+        "maxcorequeue" : "256",
+        "maxissuepercycle" : "2",
+        "pipetimeout" : "0",
+        "arielmode" : "1",
+        "memmgr.memorylevels" : "1",
+        "memmgr.defaultlevel" : "0"
+        })
+
+if mode == "capture":
+    ariel.addParams({
+        "executable" : sst_root + "/sst-elements/src/sst/elements/ariel/frontend/simple/examples/stream/stream",
+        "capture_file" : captureFile
+        })
+else:
+    ariel.addParams({
+        "replay_file" : captureFile
+        })
+
+l1cache = sst.Component("l1cache", "memHierarchy.Cache")
+l1cache.addParams({
+        "cache_frequency" : "2 Ghz",
+        "cache_size" : "64 KB",
+        "coherence_protocol" : "MSI",
+        "replacement_policy" : "lru",
+        "associativity" : "8",
+        "access_latency_cycles" : "1",
+        "cache_line_size" : "64",
+        "L1" : "1",
+        "debug" : "0",
+	})
+
+memory = sst.Component("memory", "memHierarchy.MemController")
+memory.addParams({
+        "coherence_protocol" : "MSI",
+        "backend.access_time" : "10ns",
+        "backend.mem_size" : "2048MiB",
+        "clock" : "1GHz",
+        })
+
+cpu_cache_link = sst.Link("cpu_cache_link")
+cpu_cache_link.connect( (ariel, "cache_link_0", "50ps"), (l1cache, "high_network_0", "50ps") )
+
+memory_link = sst.Link("mem_bus_link")
+memory_link.connect( (l1cache, "low_network_0", "50ps"), (memory, "direct_link", "50ps") )
+
+sst.setStatisticLoadLevel(5)
+sst.setStatisticOutput("sst.statOutputCSV", {"filepath" : statFile,
+                                             "separator" : ", "
+                                            })
+
+ariel.enableAllStatistics()
@@ -0,0 +1,68 @@
+import sst
+import os
+import sys
+
+# Runs stream on one core with periodic sampling: each period
+# fast-forwards sample_ffwd instructions, warms the cache with
+# sample_warmup and simulates sample_detail in detail.  Used by
+# sampling_check.py.
+#
+# Usage: sst samplestream.py --model-options="<stat csv> <ffwd> <warmup> <detail>"
+
+statFile = sys.argv[1] if len(sys.argv) > 1 else "samplestream.csv"
+sample_ffwd = sys.argv[2] if len(sys.argv) > 2 else "1000000"
+sample_warmup = sys.argv[3] if len(sys.argv) > 3 else "100000"
+sample_detail = sys.argv[4] if len(sys.argv) > 4 else "100000"
+
+sst.setProgramOption("timebase", "1ps")
+
+sst_root = os.getenv( "SST_ROOT" )
+
+ariel = sst.Component("a0", "ariel.ariel")
+ariel.addParams({
+        "verbose" : "0",
+        "maxcorequeue" : "256",
+        "maxissuepercycle" : "2",
+        "pipetimeout" : "0",
+        "arielmode" : "1",
+        "memmgr.memorylevels" : "1",
+        "memmgr.defaultlevel" : "0",
+        "executable" : sst_root + "/sst-elements/src/sst/elements/ariel/frontend/simple/examples/stream/stream",
+        "sample_ffwd" : sample_ffwd,
+        "sample_warmup" : sample_warmup,
+        "sample_detail" : sample_detail
+        })
+
+l1cache = sst.Component("l1cache", "memHierarchy.Cache")
+l1cache.addParams({
+        "cache_frequency" : "2 Ghz",
+        "cache_size" : "64 KB",
+        "coherence_protocol" : "MSI",
+        "replacement_policy" : "lru",
+        "associativity" : "8",
+        "access_latency_cycles" : "1",
+        "cache_line_size" : "64",
+        "L1" : "1",
+        "debug" : "0",
+	})
+
+memory = sst.Component("memory", "memHierarchy.MemController")
+memory.addParams({
+        "coherence_protocol" : "MSI",
+        "backend.access_time" : "10ns",
+        "backend.mem_size" : "2048MiB",
+        "clock" : "1GHz",
+        })
+
+cpu_cache_link = sst.Link("cpu_cache_link")
+cpu_cache_link.connect( (ariel, "cache_link_0", "50ps"), (l1cache, "high_network_0", "50ps") )
+
+memory_link = sst.Link("mem_bus_link")
+memory_link.connect( (l1cache, "low_network_0", "50ps"), (memory, "direct_link", "50ps") )
+
+sst.setStatisticLoadLevel(5)
+sst.setStatisticOutput("sst.statOutputCSV", {"filepath" : statFile,
+                                             "separator" : ", "
+                                            })
+
+ariel.enableAllStatistics()
@@ -0,0 +1,110 @@
+#!/usr/bin/env python
+#
+# Checks Ariel's sampled simulation (sample_ffwd, sample_warmup and
+# sample_detail).  Runs stream on one core with samplestream.py and
+# checks the statistics against the sampling period:
+#
+#  - the window count, sample_instructions.Count, matches both the
+#    summary Ariel prints and the instructions fast-forwarded, since a
+#    full fast-forward phase comes before every window
+#  - the totals of sample_instructions and ffwd_instructions match the
+#    detailed and fast-forwarded instructions in the summary
+#  - instruction_count, which counts every simulated instruction, is the
+#    detailed plus warming instructions, so nothing fast-forwarded was
+#    simulated and nothing simulated was left out of a phase
+#
+# Window and warming counts are core instructions, where an instruction
+# that reads and writes counts twice and a fence or flush not at all, so
+# only the fast-forwarded instructions, counted by the Pin tool, are
+# checked against the period.
+#
+# Needs the stream binary (make stream) and SST_ROOT set as for
+# runstream.py.
+#
+# Usage: sampling_check.py [sst]
+
+import os
+import re
+import subprocess
+import sys
+
+sstBin = sys.argv[1] if len(sys.argv) > 1 else "sst"
+
+statFile = "samplestream.csv"
+ffwd = 1000000
+warmup = 100000
+detail = 100000
+
+failed = False
+
+def fail(msg):
+    global failed
+    print("FAIL: " + msg)
+    failed = True
+
+def readStats(statFile):
+    stats = {}
+    with open(statFile) as f:
+        header = [h.strip() for h in f.readline().split(",")]
+        name = header.index("StatisticName")
+        subId = header.index("StatisticSubId")
+        sums = [i for i, h in enumerate(header) if h.split(".")[0] == "Sum"][0]
+        counts = [i for i, h in enumerate(header) if h.split(".")[0] == "Count"][0]
+        for line in f:
+            row = [v.strip() for v in line.split(",")]
+            if len(row) == len(header) and row[subId] == "0":
+                stats[row[name]] = (int(row[sums]), int(row[counts]))
+    return stats
+
+os.environ["OMP_NUM_THREADS"] = "1"
+
+cmd = [sstBin, "samplestream.py", "--model-options=%s %d %d %d" % (statFile, ffwd, warmup, detail)]
+p = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+out = p.communicate()[0]
+if p.returncode != 0:
+    print(out)
+    print("FAIL: sampled run failed")
+    sys.exit(1)
+
+summary = re.search(r"Core 0 sampled (\d+) windows: (\d+) detailed instructions in (\d+) cycles "
+                    r"\(CPI [0-9.]+\), (\d+) warming, (\d+) fast-forwarded", out)
+if not summary:
+    print(out)
+    print("FAIL: no sampling summary for core 0")
+    sys.exit(1)
+windows, detailInsts, detailCycles, warmInsts, ffwdInsts = [int(x) for x in summary.groups()]
+
+stats = readStats(statFile)
+for name in ("sample_instructions", "sample_cycles", "ffwd_instructions", "instruction_count"):
+    if name not in stats:
+        fail("no %s statistic for core 0 in %s" % (name, statFile))
+if failed:
+    sys.exit(1)
+
+sampleSum, sampleCount = stats["sample_instructions"]
+ffwdSum = stats["ffwd_instructions"][0]
+
+if windows < 2:
+    fail("only %d sample windows, stream should run for many periods" % windows)
+if sampleCount != windows:
+    fail("sample_instructions has %d windows, summary says %d" % (sampleCount, windows))
+if stats["sample_cycles"][1] != windows:
+    fail("sample_cycles has %d windows, summary says %d" % (stats["sample_cycles"][1], windows))
+# The last window may end the program, or the program may end in the
+# fast-forward after it, but never before a window's fast-forward is done
+if not (windows * ffwd <= ffwdSum <= (windows + 1) * ffwd):
+    fail("%d instructions fast-forwarded does not fit %d windows of %d" % (ffwdSum, windows, ffwd))
+if ffwdSum != ffwdInsts:
+    fail("ffwd_instructions total %d, summary says %d" % (ffwdSum, ffwdInsts))
+if sampleSum != detailInsts:
+    fail("sample_instructions total %d, summary says %d" % (sampleSum, detailInsts))
+if stats["sample_cycles"][0] != detailCycles:
+    fail("sample_cycles total %d, summary says %d" % (stats["sample_cycles"][0], detailCycles))
+if stats["instruction_count"][0] != detailInsts + warmInsts:
+    fail("instruction_count %d is not the %d detailed plus %d warming instructions" %
+         (stats["instruction_count"][0], detailInsts, warmInsts))
+
+if failed:
+    sys.exit(1)
+print("PASS: %d sample windows, %d detailed, %d warming and %d fast-forwarded instructions" %
+      (windows, detailInsts, warmInsts, ffwdInsts))
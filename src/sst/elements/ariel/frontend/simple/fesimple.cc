@@ -79,6 +79,12 @@ KNOB<UINT32> KeepMallocStackTrace(KNOB_MODE_WRITEONCE, "pintool",
     "k", "1", "Should keep shadow stack and dump on malloc calls. 1 = enabled, 0 = disabled");
 KNOB<UINT32> DefaultMemoryPool(KNOB_MODE_WRITEONCE, "pintool",
     "d", "0", "Default SST Memory Pool");
+KNOB<UINT64> SampleFastForward(KNOB_MODE_WRITEONCE, "pintool",
+    "ff", "0", "Instructions to fast-forward between sample windows (0 = sampling disabled)");
+KNOB<UINT64> SampleWarmup(KNOB_MODE_WRITEONCE, "pintool",
+    "sw", "0", "Instructions sent to SST to warm caches before each sample window");
+KNOB<UINT64> SampleDetail(KNOB_MODE_WRITEONCE, "pintool",
+    "sd", "0", "Instructions simulated in detail in each sample window");
 
 #define ARIEL_MAX(a,b) \
    ({ __typeof__ (a) _a = (a); __typeof__ (b) _b = (b); _a > _b ? _a : _b; })
@@ -94,6 +100,19 @@ UINT32 funcProfileLevel;
 UINT32 core_count;
 UINT32 default_pool;
 ArielTunnel *tunnel = NULL;
+ArielBatchWriter* batches = NULL;
+
+// Sampled simulation: each thread cycles through fast-forward, warm up
+// and detailed phases.  Only fast-forwarded instructions are not sent.
+typedef struct {
+    UINT32 phase;
+    UINT64 remaining;
+    UINT64 skipped;
+} ArielSampleState;
+
+bool sampling = false;
+UINT64 samplePhaseLength[3];
+ArielSampleState* sampleState = NULL;
 bool enable_output;
 std::vector<void*> allocated_list;
 PIN_LOCK mainLock;
@@ -265,12 +284,68 @@ VOID InstrumentTrace (TRACE trace, VOID* args)
 /******************** END SHADOW STACK **************************/
 /****************************************************************/
 
+/* Sends the instructions batched up for thread thr */
+VOID FlushBatch(UINT32 thr)
+{
+    if(!batches[thr].empty()) {
+        tunnel->writeMessage(thr, batches[thr].command());
+        batches[thr].clear();
+    }
+}
+
+/* Sends a command, after any instructions batched before it */
+VOID WriteCommand(UINT32 thr, const ArielCommand& ac)
+{
+    if(thr < core_count) {
+        FlushBatch(thr);
+    }
+    tunnel->writeMessage(thr, ac);
+}
+
+/* Reports the instructions fast-forwarded since the last sample window */
+VOID EndSampling(UINT32 thr)
+{
+    if(sampling && sampleState[thr].skipped > 0) {
+        ArielCommand ac;
+        ac.command = ARIEL_SAMPLE_PHASE;
+        ac.instPtr = (uint64_t) 0;
+        ac.sample.phase = ARIEL_SAMPLE_FFWD;
+        ac.sample.skipped = sampleState[thr].skipped;
+        WriteCommand(thr, ac);
+        sampleState[thr].skipped = 0;
+    }
+}
+
+VOID ThreadFini(THREADID thr, const CONTEXT* ctxt, INT32 code, VOID* v)
+{
+    if(thr < core_count) {
+        EndSampling(thr);
+        FlushBatch(thr);
+    }
+}
+
+/* A thread about to make a system call may block in it (futex, join,
+ * I/O), so send what it has batched now.  Otherwise other threads'
+ * later accesses would reach SST ahead of the ones it made before
+ * synchronizing. */
+VOID SyscallEntry(THREADID thr, CONTEXT* ctxt, SYSCALL_STANDARD std, VOID* v)
+{
+    if(thr < core_count) {
+        FlushBatch(thr);
+    }
+}
+
 VOID Fini(INT32 code, VOID* v)
 {
     if(SSTVerbosity.Value() > 0) {
         std::cout << "SSTARIEL: Execution completed, shutting down." << std::endl;
     }
 
+    for(UINT32 thr = 0; thr < core_count; thr++) {
+        EndSampling(thr);
+        FlushBatch(thr);
+    }
+
     ArielCommand ac;
     ac.command = ARIEL_PERFORM_EXIT;
     ac.instPtr = (uint64_t) 0;
@@ -311,84 +386,81 @@ VOID copy(void* dest, const void* input, UINT32 length)
     }
 }
 
+/* Flushes and fences go in the thread's batch like instructions, so
+ * they do not force a partial batch out */
 VOID WriteFlushInstructionMarker(UINT32 thr, ADDRINT ip, ADDRINT vaddr)
 {
-    ArielCommand ac;
-    ac.command = ARIEL_FLUSHLINE_INSTRUCTION; /*  Send the Flush instruction commmand */
-    ac.instPtr = (uint64_t) ip;
-    ac.flushline.vaddr = (uint32_t) vaddr;
-
-    tunnel->writeMessage(thr, ac);
+    if(thr < core_count) {
+        batches[thr].addFlush((uint32_t) vaddr);
+        if(batches[thr].full()) {
+            FlushBatch(thr);
+        }
+    }
 }
 
 VOID WriteFenceInstructionMarker(UINT32 thr, ADDRINT ip)
 {
-    ArielCommand ac;
-    ac.command = ARIEL_FENCE_INSTRUCTION;
-    ac.instPtr = (uint64_t) ip;
-
-    tunnel->writeMessage(thr, ac);
+    if(thr < core_count) {
+        batches[thr].addFence();
+        if(batches[thr].full()) {
+            FlushBatch(thr);
+        }
+    }
 }
 
-VOID WriteInstructionRead(ADDRINT* address, UINT32 readSize, THREADID thr, ADDRINT ip,
-            UINT32 instClass, UINT32 simdOpWidth)
+/* Counts an instruction against thread thr's sample period, moving to
+ * the next phase when the current one is done.  Returns non-zero if the
+ * instruction should be sent to SST. */
+ADDRINT SampleInstruction(THREADID thr)
 {
+    if(!enable_output || thr >= core_count) {
+        return 0;
+    }
 
-    const uint64_t addr64 = (uint64_t) address;
-
-    ArielCommand ac;
-
-    ac.command = ARIEL_PERFORM_READ;
-    ac.instPtr = (uint64_t) ip;
-    ac.inst.addr = addr64;
-    ac.inst.size = readSize;
-    ac.inst.instClass = instClass;
-    ac.inst.simdElemCount = simdOpWidth;
+    ArielSampleState& state = sampleState[thr];
 
-    tunnel->writeMessage(thr, ac);
-}
+    while(0 == state.remaining) {
+        state.phase = (ARIEL_SAMPLE_DETAIL == state.phase) ? ARIEL_SAMPLE_FFWD : state.phase + 1;
+        state.remaining = samplePhaseLength[state.phase];
 
-VOID WriteInstructionWrite(ADDRINT* address, UINT32 writeSize, THREADID thr, ADDRINT ip,
-            UINT32 instClass, UINT32 simdOpWidth)
-{
+        if(state.remaining > 0) {
+            ArielCommand ac;
+            ac.command = ARIEL_SAMPLE_PHASE;
+            ac.instPtr = (uint64_t) 0;
+            ac.sample.phase = state.phase;
+            ac.sample.skipped = state.skipped;
+            WriteCommand(thr, ac);
+            state.skipped = 0;
+        }
+    }
 
-    const uint64_t addr64 = (uint64_t) address;
+    state.remaining--;
 
-    ArielCommand ac;
+    if(ARIEL_SAMPLE_FFWD == state.phase) {
+        state.skipped++;
+        return 0;
+    }
 
-    ac.command = ARIEL_PERFORM_WRITE;
-    ac.instPtr = (uint64_t) ip;
-    ac.inst.addr = addr64;
-    ac.inst.size = writeSize;
-    ac.inst.instClass = instClass;
-    ac.inst.simdElemCount = simdOpWidth;
-    
-    if( writeTrace ) {
-//    	if( writeSize > ARIEL_MAX_PAYLOAD_SIZE ) {
-//    		fprintf(stderr, "Error: Payload exceeds maximum size (%d > %d)\n",
-//    			writeSize, ARIEL_MAX_PAYLOAD_SIZE);
-//    		exit(-1);
-//    	}
-    	PIN_SafeCopy( &ac.inst.payload[0], address, ARIEL_MIN( writeSize, ARIEL_MAX_PAYLOAD_SIZE ) );
-	}
-	
-    tunnel->writeMessage(thr, ac);
+    return 1;
 }
 
-VOID WriteStartInstructionMarker(UINT32 thr, ADDRINT ip)
+VOID BatchInstruction(THREADID thr, UINT32 instClass, UINT32 simdOpWidth,
+            bool read, ADDRINT* readAddr, UINT32 readSize,
+            bool write, ADDRINT* writeAddr, UINT32 writeSize)
 {
-    ArielCommand ac;
-    ac.command = ARIEL_START_INSTRUCTION;
-    ac.instPtr = (uint64_t) ip;
-    tunnel->writeMessage(thr, ac);
-}
+    ArielBatchWriter& batch = batches[thr];
 
-VOID WriteEndInstructionMarker(UINT32 thr, ADDRINT ip)
-{
-    ArielCommand ac;
-    ac.command = ARIEL_END_INSTRUCTION;
-    ac.instPtr = (uint64_t) ip;
-    tunnel->writeMessage(thr, ac);
+    uint8_t* payload = batch.addInstruction(instClass, simdOpWidth,
+            read, (uint64_t) readAddr, readSize,
+            write, (uint64_t) writeAddr, writeSize, write && writeTrace);
+
+    if(payload != NULL) {
+        PIN_SafeCopy(payload, writeAddr, ARIEL_MIN( writeSize, ARIEL_MAX_PAYLOAD_SIZE ));
+    }
+
+    if(batch.full()) {
+        FlushBatch(thr);
+    }
 }
 
 VOID WriteInstructionReadWrite(THREADID thr, ADDRINT* readAddr, UINT32 readSize,
@@ -398,10 +470,8 @@ VOID WriteInstructionReadWrite(THREADID thr, ADDRINT* readAddr, UINT32 readSize,
 
     if(enable_output) {
         if(thr < core_count) {
-            WriteStartInstructionMarker( thr, ip );
-            WriteInstructionRead(  readAddr,  readSize,  thr, ip, instClass, simdOpWidth );
-            WriteInstructionWrite( writeAddr, writeSize, thr, ip, instClass, simdOpWidth );
-            WriteEndInstructionMarker( thr, ip );
+            BatchInstruction(thr, instClass, simdOpWidth,
+                    true, readAddr, readSize, true, writeAddr, writeSize);
         }
     }
 }
@@ -412,9 +482,8 @@ VOID WriteInstructionReadOnly(THREADID thr, ADDRINT* readAddr, UINT32 readSize,
 
     if(enable_output) {
         if(thr < core_count) {
-            WriteStartInstructionMarker(thr, ip);
-            WriteInstructionRead(  readAddr,  readSize,  thr, ip, instClass, simdOpWidth );
-            WriteEndInstructionMarker(thr, ip);
+            BatchInstruction(thr, instClass, simdOpWidth,
+                    true, readAddr, readSize, false, NULL, 0);
         }
     }
 
@@ -424,10 +493,10 @@ VOID WriteNoOp(THREADID thr, ADDRINT ip)
 {
     if(enable_output) {
         if(thr < core_count) {
-            ArielCommand ac;
-            ac.command = ARIEL_NOOP;
-            ac.instPtr = (uint64_t) ip;
-            tunnel->writeMessage(thr, ac);
+            batches[thr].addNoOp();
+            if(batches[thr].full()) {
+                FlushBatch(thr);
+            }
         }
     }
 }
@@ -438,9 +507,8 @@ VOID WriteInstructionWriteOnly(THREADID thr, ADDRINT* writeAddr, UINT32 writeSiz
 
     if(enable_output) {
         if(thr < core_count) {
-            WriteStartInstructionMarker(thr, ip);
-            WriteInstructionWrite(writeAddr, writeSize,  thr, ip, instClass, simdOpWidth);
-            WriteEndInstructionMarker(thr, ip);
+            BatchInstruction(thr, instClass, simdOpWidth,
+                    false, NULL, 0, true, writeAddr, writeSize);
         }
     }
 
@@ -517,8 +585,17 @@ VOID InstrumentInstruction(INS ins, VOID *v)
         }
     }
 
+    // When sampling, the trace routines only run for the instructions
+    // SampleInstruction says to send
+    VOID (*insertCall)(INS, IPOINT, AFUNPTR, ...) = INS_InsertPredicatedCall;
+    if(sampling) {
+        INS_InsertIfPredicatedCall(ins, IPOINT_BEFORE, (AFUNPTR) SampleInstruction,
+                IARG_THREAD_ID, IARG_END);
+        insertCall = INS_InsertThenPredicatedCall;
+    }
+
     if( INS_IsMemoryRead(ins) && INS_IsMemoryWrite(ins) ) {
-        INS_InsertPredicatedCall(ins, IPOINT_BEFORE, (AFUNPTR)
+        insertCall(ins, IPOINT_BEFORE, (AFUNPTR)
                 WriteInstructionReadWrite,
                 IARG_THREAD_ID,
                 IARG_MEMORYREAD_EA, IARG_UINT32, INS_MemoryReadSize(ins),
@@ -528,7 +605,7 @@ VOID InstrumentInstruction(INS ins, VOID *v)
                 IARG_UINT32, simdOpWidth,
                 IARG_END);
     } else if( INS_IsMemoryRead(ins) ) {
-        INS_InsertPredicatedCall(ins, IPOINT_BEFORE, (AFUNPTR)
+        insertCall(ins, IPOINT_BEFORE, (AFUNPTR)
                 WriteInstructionReadOnly,
                 IARG_THREAD_ID,
                 IARG_MEMORYREAD_EA, IARG_UINT32, INS_MemoryReadSize(ins),
@@ -537,7 +614,7 @@ VOID InstrumentInstruction(INS ins, VOID *v)
                 IARG_UINT32, simdOpWidth,
                 IARG_END);
     } else if( INS_IsMemoryWrite(ins) ) {
-        INS_InsertPredicatedCall(ins, IPOINT_BEFORE, (AFUNPTR)
+        insertCall(ins, IPOINT_BEFORE, (AFUNPTR)
                 WriteInstructionWriteOnly,
                 IARG_THREAD_ID,
                 IARG_MEMORYWRITE_EA, IARG_UINT32, INS_MemoryWriteSize(ins),
@@ -546,7 +623,7 @@ VOID InstrumentInstruction(INS ins, VOID *v)
                 IARG_UINT32, simdOpWidth,
                 IARG_END);
     } else {
-        INS_InsertPredicatedCall(ins, IPOINT_BEFORE, (AFUNPTR)
+        insertCall(ins, IPOINT_BEFORE, (AFUNPTR)
                 WriteNoOp,
                 IARG_THREAD_ID,
                 IARG_INST_PTR,
@@ -605,7 +682,7 @@ void mapped_ariel_output_stats()
     ArielCommand ac;
     ac.command = ARIEL_OUTPUT_STATS;
     ac.instPtr = (uint64_t) 0;
-    tunnel->writeMessage(thr, ac);
+    WriteCommand(thr, ac);
 }
 
 // same effect as mapped_ariel_output_stats(), but it also sends a user-defined reference number back
@@ -615,7 +692,7 @@ void mapped_ariel_output_stats_buoy(uint64_t marker)
     ArielCommand ac;
     ac.command = ARIEL_OUTPUT_STATS;
     ac.instPtr = (uint64_t) marker; //user the instruction pointer slot to send the marker number
-    tunnel->writeMessage(thr, ac);
+    WriteCommand(thr, ac);
 }
 
 #if ! defined(__APPLE__)
@@ -678,7 +755,7 @@ int ariel_mlm_memcpy(void* dest, void* source, size_t size) {
     ac.dma_start.dest = ariel_dest;
     ac.dma_start.len = length;
 
-    tunnel->writeMessage(thr, ac);
+    WriteCommand(thr, ac);
 
 #ifdef ARIEL_DEBUG
     fprintf(stderr, "Done with ariel memcpy.\n");
@@ -706,7 +783,7 @@ void ariel_mlm_set_pool(int new_pool)
     ArielCommand ac;
     ac.command = ARIEL_SWITCH_POOL;
     ac.switchPool.pool = newDefaultPool;
-    tunnel->writeMessage(thr, ac);
+    WriteCommand(thr, ac);
 
     // Keep track of the default pool
     default_pool = (UINT32) new_pool;
@@ -761,7 +838,7 @@ void* ariel_mmap_mlm(int fileID, size_t size, int level)
     std::cout<<"File ID at FESIMPLE IS : "<<ac.mlm_mmap.fileID<<std::endl;
     std::cout<<"After ******"<<std::endl;
 
-    tunnel->writeMessage(thr, ac);
+    WriteCommand(thr, ac);
 
 #ifdef ARIEL_DEBUG
     fprintf(stderr, "%u: Ariel mmap_mlm call allocates data at address: 0x%llx\n",
@@ -819,7 +896,7 @@ void* ariel_mlm_malloc(size_t size, int level) {
         ac.mlm_map.alloc_level = allocationLevel;
     }
 
-    tunnel->writeMessage(thr, ac);
+    WriteCommand(thr, ac);
 
 #ifdef ARIEL_DEBUG
     fprintf(stderr, "%u: Ariel mlm_malloc call allocates data at address: 0x%llx\n",
@@ -864,7 +941,7 @@ void ariel_mlm_free(void* ptr)
         ArielCommand ac;
         ac.command = ARIEL_ISSUE_TLM_FREE;
         ac.mlm_free.vaddr = virtAddr;
-        tunnel->writeMessage(thr, ac);
+        WriteCommand(thr, ac);
 
     } else {
         fprintf(stderr, "ARIEL: Call to free in Ariel did not find a matching local allocation, this memory will be leaked.\n");
@@ -916,14 +993,14 @@ VOID ariel_postmalloc_instrument(ADDRINT allocLocation)
                 if (toFast[thr].count == 0) {
                     toFast[thr].valid = false;
                 }
-                tunnel->writeMessage(thr, ac);
+                WriteCommand(thr, ac);
             }
         } else if (shouldOverride) {
             ac.mlm_map.alloc_level = overridePool;
-            tunnel->writeMessage(thr, ac);
+            WriteCommand(thr, ac);
         } else if (InterceptMemAllocations.Value()) {
             ac.mlm_map.alloc_level = allocationLevel;
-            tunnel->writeMessage(thr, ac);
+            WriteCommand(thr, ac);
         }
 
         /*printf("ARIEL: Created a malloc of size: %" PRIu64 " in Ariel\n",
@@ -941,7 +1018,7 @@ VOID ariel_postfree_instrument(ADDRINT allocLocation)
     ArielCommand ac;
     ac.command = ARIEL_ISSUE_TLM_FREE;
     ac.mlm_free.vaddr = virtAddr;
-    tunnel->writeMessage(thr, ac);
+    WriteCommand(thr, ac);
 }
 
 void mapped_ariel_malloc_flag_fortran(int* mallocLocId, int* count, int* level)
@@ -1127,6 +1204,8 @@ int main(int argc, char *argv[])
     //PIN_InitSymbolsAlt(IFUNC_SYMBOLS);
     PIN_InitSymbols();
     PIN_AddFiniFunction(Fini, 0);
+    PIN_AddThreadFiniFunction(ThreadFini, 0);
+    PIN_AddSyscallEntryFunction(SyscallEntry, 0);
 
     PIN_InitLock(&mainLock);
     PIN_InitLock(&mallocIndexLock);
@@ -1169,6 +1248,30 @@ int main(int argc, char *argv[])
     core_count = MaxCoreCount.Value();
 
     tunnel = new ArielTunnel(SSTNamedPipe.Value());
+    batches = new ArielBatchWriter[core_count];
+
+    if(SampleFastForward.Value() > 0) {
+        if(0 == SampleDetail.Value()) {
+            fprintf(stderr, "ARIEL: Sampling needs a detailed window length (-sd) greater than zero\n");
+            return -1;
+        }
+
+        sampling = true;
+        samplePhaseLength[ARIEL_SAMPLE_FFWD] = SampleFastForward.Value();
+        samplePhaseLength[ARIEL_SAMPLE_WARM] = SampleWarmup.Value();
+        samplePhaseLength[ARIEL_SAMPLE_DETAIL] = SampleDetail.Value();
+
+        sampleState = new ArielSampleState[core_count];
+        for(int i = 0; i < core_count; i++) {
+            // Starts in the fast-forward phase on the first instruction
+            sampleState[i].phase = ARIEL_SAMPLE_DETAIL;
+            sampleState[i].remaining = 0;
+            sampleState[i].skipped = 0;
+        }
+
+        fprintf(stderr, "ARIEL: Sampling %" PRIu64 " instructions after fast-forwarding %" PRIu64 " and warming %" PRIu64 "\n",
+                SampleDetail.Value(), SampleFastForward.Value(), SampleWarmup.Value());
+    }
     lastMallocSize = (UINT64*) malloc(sizeof(UINT64) * core_count);
     lastMallocLoc = (UINT64*) malloc(sizeof(UINT64) * core_count);
     mallocIndex = 0;
@@ -0,0 +1,271 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+/*
+ * Round trip and malformed input checks for the packed instruction
+ * records of ARIEL_PERFORM_BATCH commands (ArielBatchWriter and
+ * ArielBatchReader in ariel_shmem.h).
+ */
+
+#include <sst_config.h>
+#include "ariel_shmem.h"
+
+#include <stdio.h>
+
+using namespace SST::ArielComponent;
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if ( !(cond) ) { \
+        fprintf(stderr, "FAIL line %d: ", __LINE__); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+        failures++; \
+    } \
+} while ( 0 )
+
+struct Record {
+    enum { NOOP, INST, FLUSH, FENCE } kind;
+    uint32_t instClass;
+    uint32_t simd;
+    bool read;
+    uint64_t readAddr;
+    uint32_t readSize;
+    bool write;
+    uint64_t writeAddr;
+    uint32_t writeSize;
+    bool payload;
+};
+
+static Record inst(uint32_t instClass, bool read, uint64_t readAddr, uint32_t readSize,
+        bool write, uint64_t writeAddr, uint32_t writeSize, bool payload) {
+    Record r = { Record::INST, instClass, 2, read, readAddr, readSize, write, writeAddr, writeSize, payload };
+    return r;
+}
+
+static Record marker(int kind, uint64_t addr) {
+    Record r = { (kind == ARIEL_MARKER_FLUSH) ? Record::FLUSH : Record::FENCE, 0, 0, false, addr, 0, false, 0, 0, false };
+    return r;
+}
+
+static Record noop() {
+    Record r = { Record::NOOP, 0, 0, false, 0, 0, false, 0, 0, false };
+    return r;
+}
+
+/* Payload byte i of the write of record n */
+static uint8_t payloadByte(size_t n, uint32_t i) {
+    return (uint8_t) (n * 31 + i + 1);
+}
+
+/* Writes the records as the Pin tool does, sending a batch whenever it
+ * is full, and checks no batch overruns its data */
+static std::vector<ArielCommand> encode(const std::vector<Record>& records) {
+    std::vector<ArielCommand> batches;
+    ArielBatchWriter writer;
+
+    for ( size_t n = 0; n < records.size(); n++ ) {
+        const Record& r = records[n];
+        switch ( r.kind ) {
+        case Record::NOOP:
+            writer.addNoOp();
+            break;
+        case Record::FLUSH:
+            writer.addFlush(r.readAddr);
+            break;
+        case Record::FENCE:
+            writer.addFence();
+            break;
+        case Record::INST:
+            {
+            uint8_t* payload = writer.addInstruction(r.instClass, r.simd, r.read, r.readAddr, r.readSize,
+                    r.write, r.writeAddr, r.writeSize, r.payload);
+            CHECK((payload != NULL) == (r.write && r.payload), "record %zu: payload pointer", n);
+            uint32_t len = r.writeSize < ARIEL_MAX_PAYLOAD_SIZE ? r.writeSize : ARIEL_MAX_PAYLOAD_SIZE;
+            for ( uint32_t i = 0; payload && i < len; i++ ) payload[i] = payloadByte(n, i);
+            }
+            break;
+        }
+
+        CHECK(writer.command().batch.size <= ARIEL_BATCH_SIZE, "record %zu: batch overran, %" PRIu32 " bytes",
+                n, writer.command().batch.size);
+        if ( writer.full() ) {
+            CHECK(writer.command().batch.size + ARIEL_REC_MAX_SIZE > ARIEL_BATCH_SIZE, "record %zu: full too early", n);
+            batches.push_back(writer.command());
+            writer.clear();
+        }
+    }
+    if ( !writer.empty() ) batches.push_back(writer.command());
+    return batches;
+}
+
+static void checkRoundTrip(const char* name, const std::vector<Record>& records) {
+    std::vector<ArielCommand> batches = encode(records);
+    std::vector<uint8_t> scratch;
+    size_t n = 0;
+
+    for ( size_t b = 0; b < batches.size(); b++ ) {
+        ArielBatchReader reader(batches[b], scratch);
+        ArielInstRecord rec;
+        while ( reader.next(rec) ) {
+            if ( n >= records.size() ) {
+                CHECK(false, "%s: more records decoded than written", name);
+                return;
+            }
+            const Record& r = records[n];
+            switch ( r.kind ) {
+            case Record::NOOP:
+                CHECK(rec.flags == 0, "%s record %zu: expected a no-op, flags %" PRIu32, name, n, rec.flags);
+                break;
+            case Record::FLUSH:
+                CHECK(rec.flags == ARIEL_REC_MARKER && rec.marker == ARIEL_MARKER_FLUSH, "%s record %zu: expected a flush", name, n);
+                CHECK(rec.readAddr == r.readAddr, "%s record %zu: flush address %" PRIx64 " expected %" PRIx64,
+                        name, n, rec.readAddr, r.readAddr);
+                break;
+            case Record::FENCE:
+                CHECK(rec.flags == ARIEL_REC_MARKER && rec.marker == ARIEL_MARKER_FENCE, "%s record %zu: expected a fence", name, n);
+                break;
+            case Record::INST:
+                CHECK(!(rec.flags & ARIEL_REC_MARKER), "%s record %zu: unexpected marker", name, n);
+                CHECK(rec.instClass == r.instClass && rec.simdElemCount == r.simd, "%s record %zu: class or SIMD width", name, n);
+                CHECK(!!(rec.flags & ARIEL_REC_READ) == r.read && !!(rec.flags & ARIEL_REC_WRITE) == r.write,
+                        "%s record %zu: access flags %" PRIu32, name, n, rec.flags);
+                if ( r.read ) {
+                    CHECK(rec.readAddr == r.readAddr && rec.readSize == r.readSize,
+                            "%s record %zu: read %" PRIx64 "/%" PRIu32 " expected %" PRIx64 "/%" PRIu32,
+                            name, n, rec.readAddr, rec.readSize, r.readAddr, r.readSize);
+                }
+                if ( r.write ) {
+                    CHECK(rec.writeAddr == r.writeAddr && rec.writeSize == r.writeSize,
+                            "%s record %zu: write %" PRIx64 "/%" PRIu32 " expected %" PRIx64 "/%" PRIu32,
+                            name, n, rec.writeAddr, rec.writeSize, r.writeAddr, r.writeSize);
+                    // Bytes past the first 64 are not carried and read back as zero
+                    for ( uint32_t i = 0; i < r.writeSize; i++ ) {
+                        uint8_t expect = (r.payload && i < ARIEL_MAX_PAYLOAD_SIZE) ? payloadByte(n, i) : 0;
+                        if ( rec.payload[i] != expect ) {
+                            CHECK(false, "%s record %zu: payload byte %" PRIu32 " is %d expected %d", name, n, i, rec.payload[i], expect);
+                            break;
+                        }
+                    }
+                }
+                break;
+            }
+            n++;
+        }
+        CHECK(!reader.failed(), "%s: batch %zu reported malformed", name, b);
+    }
+    CHECK(n == records.size(), "%s: decoded %zu records, wrote %zu", name, n, records.size());
+}
+
+static void checkMalformed(const char* name, const ArielCommand& ac) {
+    std::vector<uint8_t> scratch;
+    ArielBatchReader reader(ac, scratch);
+    ArielInstRecord rec;
+    uint32_t records = 0;
+    while ( reader.next(rec) ) records++;
+    CHECK(reader.failed(), "%s: not reported as malformed after %" PRIu32 " records", name, records);
+}
+
+int main(int argc, char* argv[]) {
+    // Every kind of record, with addresses going down as well as up
+    std::vector<Record> mixed;
+    mixed.push_back(noop());
+    mixed.push_back(inst(1, true, 0x7fff0000, 8, false, 0, 0, false));
+    mixed.push_back(inst(2, true, 0x7ffefff8, 8, true, 0x1000, 4, true));
+    mixed.push_back(inst(3, false, 0, 0, true, 0x800, 16, false));
+    mixed.push_back(marker(ARIEL_MARKER_FLUSH, 0x7c0));
+    mixed.push_back(marker(ARIEL_MARKER_FENCE, 0));
+    mixed.push_back(inst(15, true, 0x40, 1, true, 0x0, 2, true));
+    mixed.push_back(noop());
+    checkRoundTrip("mixed", mixed);
+
+    // Full 64 bit addresses and deltas of the whole address space both ways
+    std::vector<Record> wide;
+    wide.push_back(inst(1, true, 0xffffffffffffffc0ULL, 64, true, 0x0, 8, true));
+    wide.push_back(inst(1, true, 0x8000000000000000ULL, 8, true, 0x7fffffffffffffffULL, 1, true));
+    wide.push_back(inst(1, true, 0x1, 8, true, 0xfffffffffffffff8ULL, 8, true));
+    wide.push_back(marker(ARIEL_MARKER_FLUSH, 0xffffffffffffffc0ULL));
+    wide.push_back(marker(ARIEL_MARKER_FLUSH, 0x0));
+    checkRoundTrip("64 bit addresses", wide);
+
+    // Writes longer than ARIEL_MAX_PAYLOAD_SIZE carry only the first 64 bytes
+    std::vector<Record> longWrites;
+    longWrites.push_back(inst(4, false, 0, 0, true, 0x10000, 65, true));
+    longWrites.push_back(inst(4, false, 0, 0, true, 0x20000, 256, true));
+    longWrites.push_back(inst(4, false, 0, 0, true, 0x30000, 256, false));
+    longWrites.push_back(inst(4, false, 0, 0, true, 0x40000, 64, true));
+    checkRoundTrip("long payloads", longWrites);
+
+    // Records of the largest size and single byte records, so batches
+    // fill up at every possible offset
+    std::vector<Record> many;
+    for ( int i = 0; i < 5000; i++ ) {
+        switch ( i % 7 ) {
+        case 0: many.push_back(noop()); break;
+        case 1: many.push_back(marker(ARIEL_MARKER_FENCE, 0)); break;
+        case 2: many.push_back(marker(ARIEL_MARKER_FLUSH, (i & 1) ? 0xffffffffffffffc0ULL : 0x40)); break;
+        default:
+            many.push_back(inst(i & 0xf, true, (i & 1) ? 0x8000000000000000ULL : 0x1,
+                    0xffffffff, true, (i & 1) ? 0x1 : 0xfffffffffffffff0ULL, 64 + i % 3, true));
+            break;
+        }
+    }
+    checkRoundTrip("full boundary", many);
+
+    // More records claimed than the batch holds
+    ArielBatchWriter writer;
+    writer.addInstruction(1, 1, true, 0x1000, 8, false, 0, 0, false);
+    ArielCommand ac = writer.command();
+    ac.batch.count = 2;
+    checkMalformed("short batch", ac);
+
+    // A varint that runs off the end of the batch
+    ac = writer.command();
+    ac.batch.data[ac.batch.size - 1] |= 0x80;
+    checkMalformed("unterminated varint", ac);
+
+    // A varint longer than 64 bits
+    ac = writer.command();
+    ac.batch.count = 1;
+    ac.batch.size = 2 + 11 + 1;
+    ac.batch.data[0] = ARIEL_REC_READ;
+    ac.batch.data[1] = 1;
+    for ( int i = 2; i < 13; i++ ) ac.batch.data[i] = 0xff;
+    ac.batch.data[13] = 0;
+    checkMalformed("overlong varint", ac);
+
+    // A payload longer than the bytes left
+    writer.clear();
+    uint8_t* payload = writer.addInstruction(1, 1, false, 0, 0, true, 0x1000, 64, true);
+    memset(payload, 0xaa, 64);
+    ac = writer.command();
+    ac.batch.size -= 1;
+    checkMalformed("truncated payload", ac);
+
+    // A size larger than the batch data, and garbage records
+    ac = writer.command();
+    ac.batch.size = 0xffffffff;
+    ac.batch.count = 0xffffffff;
+    memset(ac.batch.data, 0xff, sizeof(ac.batch.data));
+    checkMalformed("oversized batch", ac);
+
+    if ( failures ) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return 1;
+    }
+    printf("Batch codec tests passed\n");
+    return 0;
+}
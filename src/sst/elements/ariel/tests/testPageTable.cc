@@ -0,0 +1,192 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+/*
+ * Checks for the memory manager's translation structures in
+ * arielpagetable.h: the radix page table with 4KB, 2MB and 1GB pages,
+ * the malloc range lookup and the translated range tracking used to
+ * decide when cached translations must be dropped.
+ */
+
+#include <sst_config.h>
+#include "arielpagetable.h"
+
+#include <stdio.h>
+#include <inttypes.h>
+
+using namespace SST::ArielComponent;
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if ( !(cond) ) { \
+        fprintf(stderr, "FAIL line %d: ", __LINE__); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+        failures++; \
+    } \
+} while ( 0 )
+
+static void checkMapped(ArielPageTable& table, uint64_t virtAddr, uint64_t expectPhys) {
+    uint64_t phys = 0;
+    const bool found = table.find(virtAddr, &phys);
+    CHECK(found, "page size %" PRIu64 ": 0x%" PRIx64 " not mapped", table.getPageSize(), virtAddr);
+    CHECK(!found || phys == expectPhys, "page size %" PRIu64 ": 0x%" PRIx64 " maps to 0x%" PRIx64 ", expected 0x%" PRIx64,
+            table.getPageSize(), virtAddr, phys, expectPhys);
+}
+
+static void checkUnmapped(ArielPageTable& table, uint64_t virtAddr) {
+    uint64_t phys = 0;
+    CHECK(!table.find(virtAddr, &phys), "page size %" PRIu64 ": 0x%" PRIx64 " should not be mapped",
+            table.getPageSize(), virtAddr);
+}
+
+static void testPageTable(uint64_t pageSize) {
+    ArielPageTable table(pageSize);
+    CHECK(table.getPageSize() == pageSize, "page size %" PRIu64 " reported as %" PRIu64, pageSize, table.getPageSize());
+
+    // First page, a page in the next leaf (512 pages on) and the last page of the address space
+    const uint64_t pages[] = { 0, pageSize * 512, pageSize * 513, ((uint64_t) 1 << 47) - pageSize, ~(pageSize - 1) };
+    const uint32_t count = sizeof(pages) / sizeof(pages[0]);
+
+    checkUnmapped(table, 0);
+    for (uint32_t i = 0; i < count; i++) {
+        table.insert(pages[i], (i + 1) * pageSize);
+    }
+    CHECK(table.size() == count, "page size %" PRIu64 ": %" PRIu64 " pages mapped, expected %u", pageSize, table.size(), count);
+
+    // Alternate between leaves so the remembered leaf is not the one needed
+    for (uint32_t i = 0; i < count; i++) {
+        const uint64_t phys = (i + 1) * pageSize;
+        checkMapped(table, pages[i], phys);
+        checkMapped(table, pages[0], pageSize);
+        checkMapped(table, pages[i] + pageSize - 1, phys);
+        checkMapped(table, pages[i] + pageSize / 2, phys);
+    }
+
+    // Neighbours of mapped pages
+    checkUnmapped(table, pageSize);
+    checkUnmapped(table, pageSize * 511);
+    checkUnmapped(table, pageSize * 514);
+    checkUnmapped(table, ((uint64_t) 1 << 47));
+    checkUnmapped(table, ~(pageSize - 1) - 1);
+
+    // Replacing a mapping does not add a page
+    table.insert(pages[1], 77 * pageSize);
+    checkMapped(table, pages[1] + 5, 77 * pageSize);
+    CHECK(table.size() == count, "page size %" PRIu64 ": remap changed the page count to %" PRIu64, pageSize, table.size());
+}
+
+struct RangeInfo {
+    uint64_t size;
+};
+
+static bool inRange(std::map<uint64_t, RangeInfo>& ranges, uint64_t virtAddr, uint64_t expectStart) {
+    std::map<uint64_t, RangeInfo>::iterator it = findArielRange(ranges, virtAddr);
+    return it != ranges.end() && it->first == expectStart;
+}
+
+static bool inNoRange(std::map<uint64_t, RangeInfo>& ranges, uint64_t virtAddr) {
+    return findArielRange(ranges, virtAddr) == ranges.end();
+}
+
+static void testRangeLookup() {
+    std::map<uint64_t, RangeInfo> ranges;
+    CHECK(inNoRange(ranges, 0), "empty map found a range");
+    CHECK(inNoRange(ranges, 1000), "empty map found a range");
+
+    // [1000, 1100), [1100, 1108) adjacent, a gap, then [4096, 12288) and one ending at the top of memory
+    RangeInfo a = { 100 }, b = { 8 }, c = { 8192 }, d = { 16 };
+    ranges[1000] = a;
+    ranges[1100] = b;
+    ranges[4096] = c;
+    ranges[(uint64_t) 0 - 16] = d;
+
+    CHECK(inNoRange(ranges, 0), "address below every range found one");
+    CHECK(inNoRange(ranges, 999), "address before a range found it");
+    CHECK(inRange(ranges, 1000, 1000), "first byte of a range not found");
+    CHECK(inRange(ranges, 1099, 1000), "last byte of a range not found");
+    CHECK(inRange(ranges, 1100, 1100), "end of a range did not find the adjacent range");
+    CHECK(inRange(ranges, 1107, 1100), "last byte of the adjacent range not found");
+    CHECK(inNoRange(ranges, 1108), "address past a range found one");
+    CHECK(inNoRange(ranges, 4095), "address in a gap found a range");
+    CHECK(inRange(ranges, 4096, 4096), "first byte of a multi-page range not found");
+    CHECK(inRange(ranges, 12287, 4096), "last byte of a multi-page range not found");
+    CHECK(inNoRange(ranges, 12288), "address past a multi-page range found one");
+    CHECK(inRange(ranges, (uint64_t) 0 - 1, (uint64_t) 0 - 16), "last byte of memory not found");
+
+    // Zero sized ranges hold nothing
+    RangeInfo empty = { 0 };
+    ranges[20000] = empty;
+    CHECK(inNoRange(ranges, 20000), "zero sized range found");
+}
+
+static ArielTranslation translation(uint64_t virtStart, uint64_t length) {
+    ArielTranslation t = { virtStart, length, 0 };
+    return t;
+}
+
+static void testTranslatedRanges() {
+    ArielTranslatedRanges ranges;
+    CHECK(!ranges.overlaps(0, 4096), "empty ranges overlap");
+
+    ranges.add(translation(4096, 4096));     // Demand page
+    ranges.add(translation(16384, 100));     // Part of a page covered by a malloc
+    ranges.add(translation(16384, 100));     // Translated again after a cache eviction
+    CHECK(ranges.size() == 2, "%zu ranges tracked, expected 2", ranges.size());
+
+    CHECK(!ranges.overlaps(0, 4096), "range ending at a translation overlaps it");
+    CHECK(ranges.overlaps(0, 4097), "range covering the first byte does not overlap");
+    CHECK(ranges.overlaps(8191, 1), "last byte of a translation does not overlap");
+    CHECK(!ranges.overlaps(8192, 8192), "range between translations overlaps");
+    CHECK(ranges.overlaps(8192, 8193), "range reaching the next translation does not overlap");
+    CHECK(ranges.overlaps(16000, 100000), "range covering a translation does not overlap");
+    CHECK(ranges.overlaps(16400, 8), "range inside a translation does not overlap");
+    CHECK(!ranges.overlaps(16484, 4096), "range after the last translation overlaps");
+    CHECK(!ranges.overlaps(6000, 0), "empty range overlaps");
+
+    ranges.clear();
+    CHECK(!ranges.overlaps(0, 100000), "cleared ranges overlap");
+}
+
+static void testTranslationCache() {
+    ArielTranslationCache cache(4);
+    ArielTranslation found;
+    ArielTranslation page = { 8192, 4096, 65536 };
+
+    CHECK(!cache.lookup(8192, 1, &found), "empty cache hit");
+    CHECK(!cache.insert(8192, page, 1), "insert into an empty entry reported an eviction");
+    CHECK(cache.lookup(12287, 1, &found) && found.translate(12287) == 65536 + 4095, "cached translation not found");
+    CHECK(!cache.lookup(12288, 1, &found), "address outside the cached translation hit");
+    CHECK(!cache.lookup(8192, 2, &found), "translation from an old epoch hit");
+    CHECK(!cache.insert(8192 + 4 * 4096, page, 2), "insert over an old epoch's entry reported an eviction");
+    CHECK(cache.insert(8192, page, 2), "conflicting insert not reported as an eviction");
+}
+
+int main(int argc, char* argv[]) {
+    testPageTable(4096);
+    testPageTable(2 * 1024 * 1024);
+    testPageTable(1024 * 1024 * 1024);
+    testRangeLookup();
+    testTranslatedRanges();
+    testTranslationCache();
+
+    if ( failures ) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("Page table tests passed\n");
+    return 0;
+}
@@ -49,6 +49,7 @@ noc_mesh::noc_mesh(ComponentId_t cid, Params& params) :
     endpoint_locations(0),
     use_dense_map(false),
     dense_map(NULL),
+    optimized(false),
     output(Simulation::getSimulation()->getSimulationOutput())
 {
     // Get the options for the router
@@ -57,6 +58,8 @@ noc_mesh::noc_mesh(ComponentId_t cid, Params& params) :
     use_dense_map = params.find<bool>("use_dense_map",false);
 
     port_priority_equal = params.find<bool>("port_priority_equal",false);
+
+    optimized = params.find<bool>("optimized",false);
     
     // Parse all the timing parameters
 
@@ -161,8 +164,10 @@ noc_mesh::noc_mesh(ComponentId_t cid, Params& params) :
     // Allocate space for all the input buffers
     port_queues = new port_queue_t[local_port_start + local_ports];
     port_busy = new int[local_port_start + local_ports];
+    port_busy_until = new Cycle_t[local_port_start + local_ports];
     for ( int i = 0; i < local_port_start + local_ports; ++i ) {
         port_busy[i] = 0;
+        port_busy_until[i] = 0;
     }
 
     port_credits = new int[local_port_start + local_ports];
@@ -171,50 +176,33 @@ noc_mesh::noc_mesh(ComponentId_t cid, Params& params) :
     }
 }
 
-void
-noc_mesh::route(noc_mesh_event* event)
+int
+noc_mesh::compute_next_port(int x, int y, int egress_port)
 {
     if ( route_y_first ) {
-        // Compute next port
-        if ( event->dest_mesh_loc.second > my_y ) {
-            event->next_port = north_port;
-        }
-        else if ( event->dest_mesh_loc.second < my_y ) {
-            event->next_port = south_port;
-        }
-        else {
-            if ( event->dest_mesh_loc.first > my_x ) {
-                event->next_port = east_port;
-            }
-            else if ( event->dest_mesh_loc.first < my_x) {
-                event->next_port = west_port;
-            }
-            else {
-                event->next_port = event->egress_port;
-            }
-        }    
+        if ( y > my_y ) return north_port;
+        if ( y < my_y ) return south_port;
+        if ( x > my_x ) return east_port;
+        if ( x < my_x ) return west_port;
+        return egress_port;
     }
-
     else {
-        // Compute next port
-        if ( event->dest_mesh_loc.first > my_x ) {
-            event->next_port = east_port;
-        }
-        else if ( event->dest_mesh_loc.first < my_x) {
-            event->next_port = west_port;
-        }
-        else {
-            if ( event->dest_mesh_loc.second > my_y ) {
-                event->next_port = north_port;
-            }
-            else if ( event->dest_mesh_loc.second < my_y) {
-                event->next_port = south_port;
-            }
-            else {
-                event->next_port = event->egress_port;
-            }
-        }
+        if ( x > my_x ) return east_port;
+        if ( x < my_x ) return west_port;
+        if ( y > my_y ) return north_port;
+        if ( y < my_y ) return south_port;
+        return egress_port;
+    }
+}
+
+void
+noc_mesh::route(noc_mesh_event* event)
+{
+    if ( !route_table.empty() ) {
+        event->next_port = route_table[event->encap_ev->request->dest];
+        return;
     }
+    event->next_port = compute_next_port(event->dest_mesh_loc.first, event->dest_mesh_loc.second, event->egress_port);
 }
 
 
@@ -251,21 +239,11 @@ noc_mesh::handle_input_r2r(Event* ev, int port)
     
 }
 
-noc_mesh_event*
-noc_mesh::wrap_incoming_packet(NocPacket* packet) {
-    // Wrap the incoming NocPacket in a noc_mesh_event
-    noc_mesh_event* event = new noc_mesh_event(packet);
-    
-    // Compute the destination router
-    int dest = packet->request->dest;
-
-    if ( dest == SimpleNetwork::INIT_BROADCAST_ADDR ) {
-        event->dest_mesh_loc.first = -1;
-        event->dest_mesh_loc.second = -1;
-        event->egress_port = -1;
-        return event;
-    }
-
+// Computes the router the endpoint dest hangs off of and the port it
+// leaves that router on
+void
+noc_mesh::compute_destination(int dest, int& x, int& y, int& egress_port)
+{
     // Check to see if we have dense addressing
     if ( use_dense_map ) {
         dest = dense_map[dest];
@@ -273,35 +251,50 @@ noc_mesh::wrap_incoming_packet(NocPacket* packet) {
     }
     
     int dest_rtr_id = dest / local_ports;
-    int x = dest_rtr_id % x_size;
-    int y = dest_rtr_id / x_size;
+    x = dest_rtr_id % x_size;
+    y = dest_rtr_id / x_size;
 
     // Compute the egress port.  If this is in the halo, then it will
     // be either north, south, east or west.  If it is not in the halo,
     // it will be one of the local_ports.
     if ( x == 0 ) {
         x = 1;
-        event->egress_port = west_port;
+        egress_port = west_port;
     }
     else if ( x == x_size - 1) {
         x = x_size - 2;
-        event->egress_port = east_port;
+        egress_port = east_port;
     }
     else if ( y == 0 ) {
         y = 1;
-        event->egress_port = south_port;
+        egress_port = south_port;
     }
     else if ( y == y_size - 1 ) {
         y = y_size - 2;
-        event->egress_port = north_port;
+        egress_port = north_port;
     }
     else {
-        event->egress_port = local_port_start + (dest - (((y * x_size) + x ) * local_ports) );
-        // output.output("****** Setting egress port to: %d -> %d, %d, %d, %d\n",event->egress_port,dest,x,x_size,y);
+        egress_port = local_port_start + (dest - (((y * x_size) + x ) * local_ports) );
+        // output.output("****** Setting egress port to: %d -> %d, %d, %d, %d\n",egress_port,dest,x,x_size,y);
     }
+}
+
+noc_mesh_event*
+noc_mesh::wrap_incoming_packet(NocPacket* packet) {
+    // Wrap the incoming NocPacket in a noc_mesh_event
+    noc_mesh_event* event = new noc_mesh_event(packet);
     
-    event->dest_mesh_loc.first = x;
-    event->dest_mesh_loc.second = y;
+    // Compute the destination router
+    int dest = packet->request->dest;
+
+    if ( dest == SimpleNetwork::INIT_BROADCAST_ADDR ) {
+        event->dest_mesh_loc.first = -1;
+        event->dest_mesh_loc.second = -1;
+        event->egress_port = -1;
+        return event;
+    }
+
+    compute_destination(dest, event->dest_mesh_loc.first, event->dest_mesh_loc.second, event->egress_port);
 
     // if ( packet->request->dest == 15 || packet->request->dest == 24 ) {
     //     output.output("dest %lld (%d) routed to router (%d,%d) with egress %d\n",packet->request->dest,dest,x,y,event->egress_port);
@@ -357,9 +350,12 @@ noc_mesh::handle_input_ep2r(Event* ev, int port)
 void noc_mesh::clock_wakeup() {
     Cycle_t time = reregisterClock(clock_tc, my_clock_handler);
     Cycle_t cyclesOff = time - last_time - 1;
-    // Update busy values
-    for ( int i = 0; i < local_port_start + local_ports; ++i) {
-        port_busy[i] = (port_busy[i] < cyclesOff) ? 0 : port_busy[i] - cyclesOff;
+    // Update busy values.  In optimized mode they are cycle stamps and
+    // don't need updating.
+    if ( !optimized ) {
+        for ( int i = 0; i < local_port_start + local_ports; ++i) {
+            port_busy[i] = (port_busy[i] < cyclesOff) ? 0 : port_busy[i] - cyclesOff;
+        }
     }
 
     // unsigned int local_progress = (cyclesOff * local_lru.size()) % (local_lru.size() * 2);
@@ -379,9 +375,11 @@ noc_mesh::clock_handler(Cycle_t cycle)
     last_time = cycle;
     // TraceFunction trace(CALL_INFO);
     // Decrement all the busy values
-    for ( int i = 0; i < local_port_start + local_ports; ++i ) {
-        port_busy[i]--;
-        if (port_busy[i] < 0) port_busy[i] = 0;
+    if ( !optimized ) {
+        for ( int i = 0; i < local_port_start + local_ports; ++i ) {
+            port_busy[i]--;
+            if (port_busy[i] < 0) port_busy[i] = 0;
+        }
     }
 
     bool keepClockOn = false;
@@ -401,7 +399,7 @@ noc_mesh::clock_handler(Cycle_t cycle)
                 int port = event->next_port;
 
                 // Check to see if the port is busy
-                if ( port_busy[port] > 0 ) {
+                if ( port_is_busy(port, cycle) ) {
                     xbar_stalls[port]->addData(1);
                     lru.satisfied(false);
                     keepClockOn = true;
@@ -422,7 +420,8 @@ noc_mesh::clock_handler(Cycle_t cycle)
                     // port_queues[local_port_start + i].pop();
                     port_queues[lru_port].pop();
                     port_credits[port] -= event->encap_ev->getSizeInFlits();
-                    port_busy[port] = event->encap_ev->getSizeInFlits();
+                    if ( optimized ) port_busy_until[port] = cycle + flits;
+                    else port_busy[port] = flits;
                     if ( edge_status & ( 1 << port) ) {
                         ports[port]->send(event->encap_ev);
                         send_bit_count[port]->addData(event->encap_ev->request->size_in_bits);
@@ -505,6 +504,18 @@ void noc_mesh::setup()
         }
     }
     lru_units.back().finalize();
+
+    // Build the routing table.  Endpoint ids are dense if
+    // use_dense_map is set, otherwise they are laid out by router.
+    if ( optimized ) {
+        int num_ids = use_dense_map ? total_endpoints : x_size * y_size * local_ports;
+        route_table.resize(num_ids);
+        for ( int id = 0; id < num_ids; ++id ) {
+            int x, y, egress_port;
+            compute_destination(id, x, y, egress_port);
+            route_table[id] = compute_next_port(x, y, egress_port);
+        }
+    }
 }
 
 void noc_mesh::finish()
@@ -27,10 +27,11 @@
 
 #include <sst/core/statapi/stataccumulator.h>
 
-#include <queue>
+#include <vector>
 
 #include "sst/elements/kingsley/nocEvents.h"
 #include "sst/elements/kingsley/lru_unit.h"
+#include "sst/elements/kingsley/ring_queue.h"
 
 using namespace SST;
 
@@ -60,6 +61,7 @@ public:
         {"port_priority_equal","Set to true to have all port have equal priority (usually endpoint ports have higher priority).","false"},
         {"route_y_first",      "Set to true to rout Y-dimension first.","false"},
         {"use_dense_map",      "Set to true to have a dense network id map instead of the sparse map normally used.","false"},
+        {"optimized",          "Set to true to route with a per destination table built at setup and track port busy time by cycle instead of decrementing counters every cycle.  Results are the same as the default mode.","false"},
         // {"network_inspectors", "Comma separated list of network inspectors to put on output ports.", ""},
     )
 
@@ -111,7 +113,7 @@ private:
     bool route_y_first;
     
     
-    typedef std::queue<noc_mesh_event*> port_queue_t;
+    typedef ring_queue<noc_mesh_event*> port_queue_t;
 
     Clock::Handler<noc_mesh>* my_clock_handler;
     TimeConverter* clock_tc;
@@ -122,12 +124,20 @@ private:
     Link** ports;
     port_queue_t* port_queues;
     int* port_busy;
+    // Used instead of port_busy in optimized mode: cycle at which each
+    // port is free again
+    Cycle_t* port_busy_until;
     int* port_credits;
     int local_ports;
     bool use_dense_map;
     bool port_priority_equal;
     const int* dense_map;
 
+    bool optimized;
+    // Next port for each destination endpoint id, built at setup in
+    // optimized mode
+    std::vector<int> route_table;
+
     std::vector< lru_unit<int> > lru_units;
     // lru_unit<int> local_lru;
     // lru_unit<int> mesh_lru;
@@ -141,7 +151,14 @@ private:
     void handle_input_r2r(Event* ev, int port);
     void handle_input_ep2r(Event* ev, int port);
 
+    void compute_destination(int dest, int& x, int& y, int& egress_port);
+    int compute_next_port(int x, int y, int egress_port);
     void route(noc_mesh_event* event);
+
+    inline bool port_is_busy(int port, Cycle_t cycle) {
+        if ( optimized ) return cycle < port_busy_until[port];
+        return port_busy[port] > 0;
+    }
     
 
     Statistic<uint64_t>** send_bit_count;
@@ -0,0 +1,74 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#ifndef COMPONENTS_KINGSLEY_RING_QUEUE_H
+#define COMPONENTS_KINGSLEY_RING_QUEUE_H
+
+#include <vector>
+
+namespace SST {
+namespace Kingsley {
+
+// FIFO in a power of two sized circular buffer.  Grows by doubling if
+// it fills, so it never allocates once it reaches the steady state
+// depth, unlike std::queue which allocates as it crosses deque blocks.
+template<typename T>
+class ring_queue {
+
+    std::vector<T> data;
+    size_t head;
+    size_t count;
+    size_t mask;
+
+    void grow() {
+        std::vector<T> new_data(data.size() * 2);
+        for ( size_t i = 0; i < count; ++i ) {
+            new_data[i] = data[(head + i) & mask];
+        }
+        data.swap(new_data);
+        head = 0;
+        mask = data.size() - 1;
+    }
+
+public:
+    ring_queue() :
+        data(8),
+        head(0),
+        count(0),
+        mask(7)
+    {
+    }
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    T& front() { return data[head]; }
+
+    void push(const T& val) {
+        if ( count == data.size() ) grow();
+        data[(head + count) & mask] = val;
+        ++count;
+    }
+
+    void pop() {
+        head = (head + 1) & mask;
+        --count;
+    }
+};
+
+}
+}
+
+#endif // COMPONENTS_KINGSLEY_RING_QUEUE_H
@@ -1,5 +1,6 @@
 # Automatically generated SST Python input
 import sst
+import sys
 
 sst.setProgramOption("timebase", "1ps")
 #sst.setProgramOption("stopAtCycle", "1000ns")
@@ -31,6 +32,10 @@ input_buf_size = "64B"
 # ports, as well as on all endpoints
 add_no_cut = False
 
+# noc_mesh_optimized_check.py runs this with --model-options=--optimized
+# to check the optimized router against the same refFile
+optimized = "true" if "--optimized" in sys.argv else "false"
+
 for y in xrange(y_size):
     for x in xrange(x_size):
         rtr = sst.Component("rtr.%d.%d"%(x,y), "kingsley.noc_mesh")
@@ -39,7 +44,8 @@ for y in xrange(y_size):
             "link_bw" : link_bw,
             "input_buf_size" : input_buf_size,
             "flit_size" : flit_size,
-            "use_dense_map" : "true"
+            "use_dense_map" : "true",
+            "optimized" : optimized
             #"port_priority_equal" : "true"
         })
         # wire up mesh connections
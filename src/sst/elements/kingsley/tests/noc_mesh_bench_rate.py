@@ -0,0 +1,73 @@
+#!/usr/bin/env python
+#
+# Copyright 2009-2018 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2018, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+# Runs noc_mesh_benchmark.py with the baseline and optimized routers and
+# prints the packets forwarded per second of run time for each.
+#
+# Usage: noc_mesh_bench_rate.py [x_size] [y_size] [num_messages] [sst]
+#
+# Packets forwarded is the total count of the routers' send_bit_count
+# statistics (one sample per packet sent on a port) read from
+# noc_mesh_bench.csv.  Run time is the run loop time reported by
+# --print-timing-info, or the wall clock time of the sst process if
+# that can not be found.
+
+import csv
+import re
+import subprocess
+import sys
+import time
+
+x_size = sys.argv[1] if len(sys.argv) > 1 else "8"
+y_size = sys.argv[2] if len(sys.argv) > 2 else "8"
+num_messages = sys.argv[3] if len(sys.argv) > 3 else "1000"
+sstBin = sys.argv[4] if len(sys.argv) > 4 else "sst"
+
+statFile = "noc_mesh_bench.csv"
+runTimePattern = re.compile(r'^\s*Run[^:]*:\s*([0-9.eE+-]+)\s*s', re.IGNORECASE)
+
+def packetsForwarded():
+    total = 0
+    with open(statFile) as f:
+        rows = csv.reader(f, skipinitialspace=True)
+        header = [h.strip() for h in next(rows)]
+        name = header.index("StatisticName")
+        count = header.index("Count.u64")
+        for row in rows:
+            if len(row) > count and row[name].strip() == "send_bit_count":
+                total += int(row[count])
+    return total
+
+def run(optimized):
+    cmd = [sstBin, "--print-timing-info", "noc_mesh_benchmark.py",
+           "--model-options=%s %s %s %s" % (x_size, y_size, optimized, num_messages)]
+    start = time.time()
+    out = subprocess.check_output(cmd, universal_newlines=True)
+    runTime = time.time() - start
+    for line in out.splitlines():
+        m = runTimePattern.match(line)
+        if m:
+            runTime = float(m.group(1))
+            break
+    packets = packetsForwarded()
+    rate = packets / runTime if runTime > 0 else 0
+    print("optimized=%-5s  packets forwarded %d  run time %.3f s  %.0f packets/s" % (optimized, packets, runTime, rate))
+    return packets, rate
+
+basePackets, baseRate = run("false")
+optPackets, optRate = run("true")
+
+if basePackets != optPackets:
+    print("WARNING: the two modes forwarded different numbers of packets")
+if baseRate > 0:
+    print("speedup %.2fx" % (optRate / baseRate))
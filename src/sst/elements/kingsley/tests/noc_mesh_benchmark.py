@@ -0,0 +1,113 @@
+# Copyright 2009-2018 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2018, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+# Synthetic traffic benchmark for kingsley.noc_mesh
+#
+# Runs uniform random traffic from merlin.test_nic endpoints over an
+# x_size by y_size mesh, with endpoints on every router and around the
+# halo.  Arguments are passed with --model-options:
+#
+#   sst --print-timing-info noc_mesh_benchmark.py \
+#       --model-options="<x_size> <y_size> <optimized> <num_messages>"
+#
+# For example "8 8 true 1000" runs an 8x8 mesh with the optimized
+# router.  noc_mesh_bench_rate.py runs both modes and prints the
+# packets forwarded per second of run time for each, from the routers'
+# send_bit_count statistics (in noc_mesh_bench.csv).
+
+import sst
+import sys
+
+sst.setProgramOption("timebase", "1ps")
+
+x_size = 8
+y_size = 8
+optimized = "false"
+num_messages = 100
+
+if len(sys.argv) > 1: x_size = int(sys.argv[1])
+if len(sys.argv) > 2: y_size = int(sys.argv[2])
+if len(sys.argv) > 3: optimized = sys.argv[3]
+if len(sys.argv) > 4: num_messages = int(sys.argv[4])
+
+num_endpoints = 1
+num_peers = (num_endpoints * (x_size * y_size)) + (2*x_size) + (2*y_size)
+msg_size = "64B"
+link_bw = "32GB/s"
+flit_size = "32B"
+input_buf_size = "64B"
+
+links = dict()
+def getLink(name1, name2):
+    name = "link.%s:%s"%(name1, name2)
+    if name not in links:
+        links[name] = sst.Link(name)
+    return links[name]
+
+def addEndpoint(rtr_name, ep_name):
+    ep = sst.Component(ep_name, "merlin.test_nic")
+    ep.addParams({
+        "num_peers" : "%d"%(num_peers),
+        "link_bw" : "32GB/s",
+        "linkcontrol_type" : "kingsley.linkcontrol",
+        "message_size" : msg_size,
+        "num_messages" : "%d"%(num_messages)
+    })
+    link = getLink(rtr_name, ep_name)
+    ep.addLink(link, "rtr", "800ps")
+    return link
+
+for y in xrange(y_size):
+    for x in xrange(x_size):
+        name = "rtr.%d.%d"%(x,y)
+        rtr = sst.Component(name, "kingsley.noc_mesh")
+        rtr.addParams({
+            "local_ports" : "%d"%(num_endpoints),
+            "link_bw" : link_bw,
+            "input_buf_size" : input_buf_size,
+            "flit_size" : flit_size,
+            "use_dense_map" : "true",
+            "optimized" : optimized
+        })
+
+        if y != y_size - 1:
+            rtr.addLink(getLink(name, "rtr.%d.%d"%(x,y+1)), "north", "800ps")
+        else:
+            rtr.addLink(addEndpoint(name, "ep0.%d.%d"%(x,y+1)), "north", "800ps")
+
+        if y != 0:
+            rtr.addLink(getLink("rtr.%d.%d"%(x,y-1), name), "south", "800ps")
+        else:
+            rtr.addLink(addEndpoint(name, "ep0.%d.%d"%(x,y-1)), "south", "800ps")
+
+        if x != x_size - 1:
+            rtr.addLink(getLink(name, "rtr.%d.%d"%(x+1,y)), "east", "800ps")
+        else:
+            rtr.addLink(addEndpoint(name, "ep0.%d.%d"%(x+1,y)), "east", "800ps")
+
+        if x != 0:
+            rtr.addLink(getLink("rtr.%d.%d"%(x-1,y), name), "west", "800ps")
+        else:
+            rtr.addLink(addEndpoint(name, "ep0.%d.%d"%(x-1,y)), "west", "800ps")
+
+        for z in xrange(num_endpoints):
+            rtr.addLink(addEndpoint(name, "ep%d.%d.%d"%(z,x,y)), "local%d"%(z), "800ps")
+
+
+sst.setStatisticLoadLevel(9)
+
+sst.setStatisticOutput("sst.statOutputCSV");
+sst.setStatisticOutputOptions({
+    "filepath" : "noc_mesh_bench.csv",
+    "separator" : ", "
+})
+
+sst.enableStatisticForComponentType("kingsley.noc_mesh", "send_bit_count", {"type":"sst.AccumulatorStatistic","rate":"0ns"})
@@ -0,0 +1,68 @@
+#!/usr/bin/env python
+#
+# Copyright 2009-2018 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2018, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+# Checks that noc_mesh with optimized=true behaves exactly as the
+# default router.  noc_mesh_32_test.py is run with
+# --model-options=--optimized and its output compared with
+# refFiles/test_kingsley_noc_mesh_32_test.out.  The router statistics
+# (stats.csv) of the optimized and default runs must also match.
+#
+# Usage: noc_mesh_optimized_check.py [sst]  (from any directory)
+# Exits non-zero on failure.
+
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+sstBin = sys.argv[1] if len(sys.argv) > 1 else "sst"
+testDir = os.path.dirname(os.path.abspath(__file__))
+refFile = os.path.join(testDir, "refFiles", "test_kingsley_noc_mesh_32_test.out")
+
+def run(options):
+    # Each run gets its own directory for stats.csv
+    runDir = tempfile.mkdtemp(prefix="noc_mesh_check")
+    try:
+        cmd = [sstBin, os.path.join(testDir, "noc_mesh_32_test.py")]
+        if options:
+            cmd.append("--model-options=" + options)
+        out = subprocess.check_output(cmd, cwd=runDir, universal_newlines=True)
+        with open(os.path.join(runDir, "stats.csv")) as f:
+            stats = sorted(line.strip() for line in f)
+    finally:
+        shutil.rmtree(runDir)
+    return sorted(line.rstrip() for line in out.splitlines() if line.strip()), stats
+
+failed = False
+
+def compare(desc, expected, result):
+    global failed
+    if result != expected:
+        print("FAIL: %s" % desc)
+        for line in sorted(set(expected).symmetric_difference(result))[:20]:
+            print("  " + line)
+        failed = True
+    else:
+        print("%s: same (%d lines)" % (desc, len(expected)))
+
+with open(refFile) as f:
+    expected = sorted(line.rstrip() for line in f if line.strip())
+
+optOut, optStats = run("--optimized")
+compare("optimized output vs %s" % os.path.basename(refFile), expected, optOut)
+
+defaultOut, defaultStats = run("")
+compare("optimized statistics vs default", defaultStats, optStats)
+
+sys.exit(1 if failed else 0)
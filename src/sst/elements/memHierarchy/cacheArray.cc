@@ -23,6 +23,10 @@
 #include "cacheArray.h"
 #include <vector>
 
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
 namespace SST { namespace MemHierarchy {
 
 /* Set Associative Array Class */
@@ -87,6 +91,95 @@ void SetAssociativeArray::deallocate(unsigned int index) {
     lines_[index]->reset();
 }
 
+/* Packed Set Associative Array Class */
+PackedSetAssociativeArray::PackedSetAssociativeArray(Output* dbg, unsigned int numLines, unsigned int lineSize, unsigned int associativity, ReplacementMgr* rm, HashFunction* hf, bool sharersAware) :
+    CacheArray(dbg, numLines, associativity, lineSize, rm, hf, sharersAware, true, false)
+    {
+        tags_.resize(numLines_, 0);
+        states_.resize(numLines_, I);
+        for (unsigned int i = 0; i < numLines_; i++) {
+            lines_[i] = new PackedCacheLine(lineSize_, i, dbg_, &sharerTable_, &states_[i]);
+        }
+        setSharers = new unsigned int[associativity];
+        setOwned = new bool[associativity];
+    }
+
+
+PackedSetAssociativeArray::~PackedSetAssociativeArray() {
+    delete [] setSharers;
+    delete [] setOwned;
+}
+
+int PackedSetAssociativeArray::findTag(const Addr * tags, unsigned int ways, Addr baseAddr) {
+    unsigned int i = 0;
+#if defined(__AVX2__)
+    __m256i key = _mm256_set1_epi64x(baseAddr);
+    for (; i + 4 <= ways; i += 4) {
+        __m256i cmp = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(tags + i)), key);
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(cmp));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+#elif defined(__SSE4_1__)
+    __m128i key = _mm_set1_epi64x(baseAddr);
+    for (; i + 2 <= ways; i += 2) {
+        __m128i cmp = _mm_cmpeq_epi64(_mm_loadu_si128((const __m128i*)(tags + i)), key);
+        int mask = _mm_movemask_pd(_mm_castsi128_pd(cmp));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+#endif
+    for (; i < ways; i++) {
+        if (tags[i] == baseAddr) return i;
+    }
+    return -1;
+}
+
+CacheArray::CacheLine* PackedSetAssociativeArray::lookup(const Addr baseAddr, bool update) {
+    Addr lineAddr = toLineAddr(baseAddr);
+    int set = hash_->hash(0, lineAddr) % numSets_;
+    int setBegin = set * associativity_;
+
+    int way = findTag(&tags_[setBegin], associativity_, baseAddr);
+    if (way == -1) return nullptr;
+    if (update) replacementMgr_->update(setBegin + way);
+    return lines_[setBegin + way];
+}
+
+CacheArray::CacheLine* PackedSetAssociativeArray::findReplacementCandidate(const Addr baseAddr, bool cache) {
+    int index = preReplace(baseAddr);
+    return lines_[index];
+}
+
+unsigned int PackedSetAssociativeArray::preReplace(const Addr baseAddr) {
+    Addr lineAddr   = toLineAddr(baseAddr);
+    int set         = hash_->hash(0, lineAddr) % numSets_;
+    int setBegin    = set * associativity_;
+    
+    // States are already packed; sharer/owner info is only needed if the replacement policy considers it
+    if (sharersAware_) {
+        for (unsigned int id = 0; id < associativity_; id++) {
+            setSharers[id] = lines_[id+setBegin]->numSharers();
+            setOwned[id] = lines_[id+setBegin]->ownerExists();
+        }
+    }
+    return replacementMgr_->findBestCandidate(setBegin, &states_[setBegin], setSharers, setOwned, sharersAware_);
+}
+
+void PackedSetAssociativeArray::replace(const Addr baseAddr, CacheArray::CacheLine * candidate, CacheArray::DataLine * dataCandidate) {
+    unsigned int index = candidate->getIndex();
+    replacementMgr_->replaced(index);
+    candidate->reset();
+    candidate->setBaseAddr(baseAddr);
+    tags_[index] = baseAddr;
+    states_[index] = I;
+    replacementMgr_->update(index);
+}
+
+void PackedSetAssociativeArray::deallocate(unsigned int index) {
+    replacementMgr_->replaced(index);
+    lines_[index]->reset();
+    states_[index] = I;
+}
+
 /* Dual Set Associative Array Class */
 DualSetAssociativeArray::DualSetAssociativeArray(Output* dbg, unsigned int lineSize, HashFunction * hf, bool sharersAware, unsigned int dirNumLines, 
         unsigned int dirAssociativity, ReplacementMgr * dirRp, unsigned int cacheNumLines, unsigned int cacheAssociativity, ReplacementMgr * cacheRp) :
@@ -21,6 +21,9 @@
 #define CACHEARRAY_H
 
 #include <vector>
+#include <unordered_map>
+#include <set>
+#include <algorithm>
 
 #include <sst/core/output.h>
 
@@ -28,6 +31,7 @@
 #include "sst/elements/memHierarchy/hash.h"
 #include "sst/elements/memHierarchy/util.h"
 #include "sst/elements/memHierarchy/replacementManager.h"
+#include "sst/elements/memHierarchy/sharedPayload.h"
 
 using namespace std;
 
@@ -40,6 +44,91 @@ public:
 
     class CacheLine; // Forward declaration so DataLine/CacheLine can point to each other
 
+    /* 
+     * Maps the names of the caches above this one to dense integer IDs so that 
+     * cache lines can track sharers/owner as a bit vector instead of a set of strings.
+     * Names are normally registered during init (see Cache::setup()); a name that
+     * shows up later is assigned the next free ID, so IDs never change once given out.
+     * The table also keeps the IDs in name order for iterating sharers when a late
+     * name breaks the ID order.
+     * With sharer_tracking=names lines keep the original set of names instead.
+     */
+    class SharerTable {
+    private:
+        std::unordered_map<std::string, int> nameToID_;
+        vector<std::string> idToName_;
+        vector<int> order_;             // IDs in sorted name order
+        vector<int> rank_;              // Position of each ID in order_
+        bool sorted_;                   // ID order is name order, order_[i] == i
+        std::string noName_;
+        bool named_;                    // Lines track sharers by name instead of ID
+    public:
+        SharerTable() : sorted_(true), named_(false) {}
+
+        void setNamed(bool named) { named_ = named; }
+        bool named() const { return named_; }
+
+        /** Assign IDs to a set of names. IDs are assigned in sorted name order so that 
+         *  iterating over a line's sharers visits them in the same order as a std::set<std::string> */
+        void assign(vector<std::string> names) {
+            std::sort(names.begin(), names.end());
+            names.erase(std::unique(names.begin(), names.end()), names.end());
+            nameToID_.clear();
+            idToName_.clear();
+            order_.clear();
+            rank_.clear();
+            for (unsigned int i = 0; i < names.size(); i++) {
+                if (names[i].empty()) continue;
+                nameToID_[names[i]] = idToName_.size();
+                order_.push_back(idToName_.size());
+                rank_.push_back(idToName_.size());
+                idToName_.push_back(names[i]);
+            }
+            sorted_ = true;
+        }
+
+        /** Return the ID for name, or -1 if the name has not been registered */
+        int find(const std::string &name) const {
+            std::unordered_map<std::string, int>::const_iterator it = nameToID_.find(name);
+            return (it == nameToID_.end()) ? -1 : it->second;
+        }
+
+        /** Return the ID for name, registering it with the next free ID if needed */
+        int getID(const std::string &name) {
+            std::unordered_map<std::string, int>::iterator it = nameToID_.find(name);
+            if (it != nameToID_.end()) return it->second;
+
+            int id = idToName_.size();
+            nameToID_[name] = id;
+            idToName_.push_back(name);
+
+            vector<int>::iterator pos = order_.end();
+            if (!order_.empty() && name < idToName_[order_.back()]) {
+                // Out of order, sharer iteration follows order_ from now on
+                sorted_ = false;
+                pos = order_.begin();
+                while (idToName_[*pos] < name) pos++;
+            }
+            pos = order_.insert(pos, id);
+            rank_.push_back(0);
+            for (unsigned int r = pos - order_.begin(); r < order_.size(); r++) rank_[order_[r]] = r;
+            return id;
+        }
+
+        /** Whether ID order is sorted name order */
+        bool sorted() const { return sorted_; }
+        /** Position of an ID in name order */
+        int rank(int id) const { return rank_[id]; }
+        /** ID at a position in name order */
+        int idAt(unsigned int rank) const { return order_[rank]; }
+
+        /** Return the name for an ID, empty string if id is -1 */
+        const std::string& getName(int id) const { return (id < 0) ? noName_ : idToName_[id]; }
+
+        /** Number of registered names */
+        unsigned int size() const { return idToName_.size(); }
+    };
+
     /* Data line used for split coherence/data (i.e., directories ) */
     class DataLine {
     private:
@@ -47,7 +136,7 @@ public:
         const int index_;
         Output * dbg_;
 
-        vector<uint8_t> data_;
+        SharedPayload data_;
         CacheArray::CacheLine * dirLine_;
     public:
         DataLine(unsigned int size, int index, Output * dbg) : size_(size), index_(index), dbg_(dbg), dirLine_(nullptr) {
@@ -56,14 +145,20 @@ public:
 
 
         // Data getter/setter
-        vector<uint8_t>* getData() { return &data_; }
+        const SharedPayload* getData() { return &data_; }
 
-        void setData(vector<uint8_t> data, uint32_t offset) {
-            std::copy(data.begin(), data.end(), data_.begin() + offset);
+        void setData(const vector<uint8_t>& data, uint32_t offset) {
             if (data.size() + offset > size_) { // TODO can we remove this check somehow?
                 dbg_->fatal(CALL_INFO, -1, "Error: Cacheline write exceeds line size. Size: %" PRIu32 ", Offset: %" PRIu32 ", Write size: %zu\n",
                         size_, offset, data.size());
             }
+            data_.write(offset, data.data(), data.size());
+        }
+
+        /* A full-line write shares the payload's buffer instead of copying it */
+        void setData(const SharedPayload& data, uint32_t offset) {
+            if (offset == 0 && data.size() == data_.size()) data_ = data;
+            else setData(data.get(), offset);
         }
 
         // dirIndex getter/setter
@@ -81,11 +176,16 @@ public:
         const uint32_t      size_;
         const int           index_;
         Output *            dbg_;
+        SharerTable *       sharerTable_;   // Name <-> ID mapping for sharers_ and owner_
         
         Addr                baseAddr_;
         State               state_;
-        set<std::string>    sharers_;
-        std::string         owner_;
+        uint64_t            sharers_;       // Sharer bit vector, IDs 0-63
+        vector<uint64_t>    sharersExt_;    // Sharer bit vector, IDs 64+. Only allocated if that many sharers exist.
+        unsigned int        numSharers_;
+        int                 owner_;         // Owner ID, -1 if none
+        set<std::string>    sharerNames_;   // Sharers and owner when sharerTable_->named()
+        std::string         ownerName_;
         
         uint64_t            lastSendTimestamp_; // Use to force sequential timing for subsequent accesses to the line
 
@@ -100,10 +200,38 @@ public:
         DataLine * dataLine_;
 
         /* Cache specific */
-        vector<uint8_t> data_;
+        SharedPayload data_;
+
+        /* Bit vector helpers */
+        uint64_t& sharerWord(int id) {
+            if (id < 64) return sharers_;
+            unsigned int word = (id >> 6) - 1;
+            if (word >= sharersExt_.size()) sharersExt_.resize(word + 1, 0);
+            return sharersExt_[word];
+        }
+
+        bool testSharer(int id) const {
+            if (id < 0) return false;
+            if (id < 64) return (sharers_ >> id) & 1;
+            unsigned int word = (id >> 6) - 1;
+            return word < sharersExt_.size() && ((sharersExt_[word] >> (id & 63)) & 1);
+        }
+
+        void clearSharers() {
+            sharers_ = 0;
+            for (unsigned int i = 0; i < sharersExt_.size(); i++) sharersExt_[i] = 0;
+            sharerNames_.clear();
+            numSharers_ = 0;
+        }
+
+        void clearOwnerField() {
+            owner_ = -1;
+            ownerName_.clear();
+        }
 
     public:
-        CacheLine (unsigned int size, int index, Output * dbg, bool cache) : size_(size), index_(index), dbg_(dbg), baseAddr_(0), state_(I) {
+        CacheLine (unsigned int size, int index, Output * dbg, bool cache, SharerTable * sharerTable) : size_(size), index_(index), dbg_(dbg), 
+            sharerTable_(sharerTable), baseAddr_(0), state_(I), sharers_(0), numSharers_(0), owner_(-1) {
             reset();
             if (cache) data_.resize(size_/sizeof(uint8_t));
         }
@@ -112,8 +240,8 @@ public:
 
         void reset() {
             state_ = I;
-            sharers_.clear();
-            owner_.clear();
+            clearSharers();
+            clearOwnerField();
             
             lastSendTimestamp_      = 0;
 
@@ -133,11 +261,12 @@ public:
             str << std::hex << "0x" << baseAddr_;
             str << " State: " << StateString[state_];
             str << " Sharers: [";
-            for (std::set<std::string>::iterator it = sharers_.begin(); it != sharers_.end(); it++) {
-                if (it != sharers_.begin()) str << ",";
-                str << *it;
+            const int first = firstSharer();
+            for (int id = first; id != -1; id = nextSharer(id)) {
+                if (id != first) str << ",";
+                str << getSharerName(id);
             }
-            str << "] Owner: " << owner_;
+            str << "] Owner: " << getOwner();
             return str.str();
         }
 
@@ -156,8 +285,8 @@ public:
             state_ = state; 
             if (state == I) {
                 clearAtomics();
-                sharers_.clear();
-                owner_.clear();
+                clearSharers();
+                clearOwnerField();
             }
         }
 
@@ -169,40 +298,100 @@ public:
         bool valid() { return state_ != I; }
 
         /** Getter for sharer field - return whether sharer field is empty */
-        bool isShareless() { return sharers_.empty(); }
-        /** Getter for sharer field */
-        set<std::string>* getSharers() { return &sharers_; }
+        bool isShareless() { return numSharers_ == 0; }
         /** Getter for sharer field - return number of sharers in set*/
-        unsigned int numSharers() { return sharers_.size(); }
+        unsigned int numSharers() { return numSharers_; }
+
+        /** Sharer iteration - return the lowest sharer ID or -1 if there are no sharers.
+         *  Usage: for (int id = line->firstSharer(); id != -1; id = line->nextSharer(id)) 
+         */
+        int firstSharer() const {
+            if (sharerTable_->named()) return sharerNames_.empty() ? -1 : sharerTable_->find(*sharerNames_.begin());
+            return nextSharer(-1); 
+        }
+        /** Sharer iteration - return the next sharer ID after 'id' or -1 if there are no more */
+        int nextSharer(int id) const {
+            if (sharerTable_->named()) {
+                set<std::string>::const_iterator it = sharerNames_.upper_bound(sharerTable_->getName(id));
+                return (it == sharerNames_.end()) ? -1 : sharerTable_->find(*it);
+            }
+            if (!sharerTable_->sorted()) {
+                // A late name broke the ID order, walk the IDs in name order instead
+                for (unsigned int r = (id < 0) ? 0 : sharerTable_->rank(id) + 1; r < sharerTable_->size(); r++) {
+                    if (testSharer(sharerTable_->idAt(r))) return sharerTable_->idAt(r);
+                }
+                return -1;
+            }
+            id++;
+            if (id < 64) {
+                uint64_t bits = sharers_ & (~0ULL << id);
+                if (bits) return __builtin_ctzll(bits);
+                id = 64;
+            }
+            for (unsigned int word = (id >> 6) - 1; word < sharersExt_.size(); word++, id = (word + 1) << 6) {
+                uint64_t bits = sharersExt_[word] & (~0ULL << (id & 63));
+                if (bits) return ((word + 1) << 6) + __builtin_ctzll(bits);
+            }
+            return -1;
+        }
+        /** Return the name of the cache corresponding to a sharer/owner ID */
+        const std::string& getSharerName(int id) const { return sharerTable_->getName(id); }
         
         /** Getter for sharer field - return whether a particular sharer exists in the set*/
-        bool isSharer(std::string name) { 
-            if (name.empty()) return false; 
-            return sharers_.find(name) != sharers_.end(); 
+        bool isSharer(const std::string &name) { 
+            if (name.empty() || numSharers_ == 0) return false; 
+            if (sharerTable_->named()) return sharerNames_.find(name) != sharerNames_.end();
+            return testSharer(sharerTable_->find(name));
         }
         
         /** Setter for sharer field - remove a specific sharer */
-        void removeSharer(std::string name) {
+        void removeSharer(const std::string &name) {
             if(name.empty()) return;
-            if (sharers_.find(name) == sharers_.end()) 
+            if (sharerTable_->named()) {
+                if (sharerNames_.erase(name) == 0)
+                    dbg_->fatal(CALL_INFO, -1, "Error: cannot remove sharer '%s', not a current sharer. Addr = 0x%" PRIx64 "\n", name.c_str(), baseAddr_);
+                numSharers_--;
+                return;
+            }
+            int id = sharerTable_->find(name);
+            if (!testSharer(id)) 
                 dbg_->fatal(CALL_INFO, -1, "Error: cannot remove sharer '%s', not a current sharer. Addr = 0x%" PRIx64 "\n", name.c_str(), baseAddr_);
-            sharers_.erase(name);        
+            sharerWord(id) &= ~(1ULL << (id & 63));
+            numSharers_--;
         }
     
         /** Setter for sharer field - add a specific sharer */
-        void addSharer(std::string name) {
+        void addSharer(const std::string &name) {
             if (name.empty()) return;
-            sharers_.insert(name);
+            int id = sharerTable_->getID(name);
+            if (sharerTable_->named()) {
+                if (sharerNames_.insert(name).second) numSharers_++;
+                return;
+            }
+            uint64_t &word = sharerWord(id);
+            uint64_t bit = 1ULL << (id & 63);
+            if (!(word & bit)) {
+                word |= bit;
+                numSharers_++;
+            }
         }
 
         /** Setter for owner field */
-        void setOwner(std::string owner) { owner_ = owner; }
+        void setOwner(const std::string &owner) { 
+            if (sharerTable_->named()) ownerName_ = owner;
+            else owner_ = owner.empty() ? -1 : sharerTable_->getID(owner); 
+        }
         /** Getter for owner field */
-        std::string getOwner() { return owner_; }
+        const std::string& getOwner() { return sharerTable_->named() ? ownerName_ : sharerTable_->getName(owner_); }
+        /** Getter for owner field - return whether a particular cache is the owner */
+        bool isOwner(const std::string &name) { 
+            if (sharerTable_->named()) return !ownerName_.empty() && ownerName_ == name;
+            return owner_ != -1 && sharerTable_->find(name) == owner_; 
+        }
         /** Setter for owner field - clear field */
-        void clearOwner() { owner_.clear(); }
+        void clearOwner() { clearOwnerField(); }
         /** Getter for owner field - return whether field is set */
-        bool ownerExists() { return !owner_.empty(); }
+        bool ownerExists() { return sharerTable_->named() ? !ownerName_.empty() : owner_ != -1; }
 
         /** Setter for timestamp field */
         void setTimestamp(uint64_t timestamp) { lastSendTimestamp_ = timestamp; }
@@ -246,15 +435,21 @@ public:
         
         /***** Cache specific fields *****/
         /** Getter for cache line data */
-        vector<uint8_t>* getData() { return &data_; }
+        const SharedPayload* getData() { return &data_; }
 
         /** Setter for cache line data - write only specified bits*/
-        void setData(vector<uint8_t> data, uint32_t offset) {
-            std::copy(data.begin(), data.end(), data_.begin() + offset);
+        void setData(const vector<uint8_t>& data, uint32_t offset) {
             if (data.size() + offset > size_) { // TODO can we remove this check somehow?
                 dbg_->fatal(CALL_INFO, -1, "Error: Cacheline write exceeds line size. Size: %" PRIu32 ", Offset: %" PRIu32 ", Write size: %zu\n",
                         size_, offset, data.size());
             }
+            data_.write(offset, data.data(), data.size());
+        }
+
+        /** Setter for cache line data - a full-line write shares the payload instead of copying */
+        void setData(const SharedPayload& data, uint32_t offset) {
+            if (offset == 0 && data.size() == data_.size()) data_ = data;
+            else setData(data.get(), offset);
         }
 
         /***** Dir specific fields *****/
@@ -268,6 +463,11 @@ public:
     typedef CacheArray::CacheLine CacheLine;
     typedef CacheArray::DataLine DataLine;
 
+    /** Track sharers and owner by name instead of by ID (sharer_tracking = names). Call before the lines are used */
+    void setNamedSharers(bool named) {
+        sharerTable_.setNamed(named);
+    }
+
     /** Function returns the cacheline tag's ID if its valid (-1 if unvalid).
         If updateReplacement is set, the replacement stats are updated */
     virtual CacheLine * lookup(Addr baseAddr, bool updateReplacement) = 0;
@@ -303,6 +503,11 @@ public:
         banks_ = numBanks;
     }
 
+    /** Assign dense sharer IDs to the caches above this one. Call once the names are known (after init) */
+    void setSharerNames(vector<std::string> names) {
+        sharerTable_.assign(names);
+    }
+
     void printCacheArray(Output &out) {
         for (unsigned int i = 0; i < numLines_; i++) {
             out.output("   %u %s\n", i, lines_[i]->getString().c_str());
@@ -327,9 +532,10 @@ protected:
     unsigned int    slices_;    // Both slices are banks_ are banks; slices_ are external to this cache array, banks_ are internal
     unsigned int    banks_;
     vector<CacheLine *> lines_; // The actual cache
+    SharerTable     sharerTable_;
 
     CacheArray(Output* dbg, unsigned int numLines, unsigned int associativity, unsigned int lineSize,
-               ReplacementMgr* replacementMgr, HashFunction* hash, bool sharersAware, bool cache) : dbg_(dbg), 
+               ReplacementMgr* replacementMgr, HashFunction* hash, bool sharersAware, bool cache, bool createLines = true) : dbg_(dbg), 
                numLines_(numLines), associativity_(associativity), lineSize_(lineSize),
                replacementMgr_(replacementMgr), hash_(hash) {
         dbg_->debug(_INFO_,"--------------------------- Initializing [Set Associative Cache Array]... \n");
@@ -339,8 +545,10 @@ protected:
         slices_ = 1;
         banks_ = 1;
 
-        for (unsigned int i = 0; i < numLines_; i++) {
-            lines_[i] = new CacheLine(lineSize_, i, dbg_, cache);
+        if (createLines) {
+            for (unsigned int i = 0; i < numLines_; i++) {
+                lines_[i] = new CacheLine(lineSize_, i, dbg_, cache, &sharerTable_);
+            }
         }
 
         printConfiguration();
@@ -372,6 +580,122 @@ public:
     bool * setOwned;
 };
 
+/*
+ * Packed set-associative cache array
+ * Same organization and replacement behavior as SetAssociativeArray, but line addresses
+ * and states are also kept in contiguous arrays indexed by line so that a set probe 
+ * scans a packed tag array (SIMD compare where available) instead of dereferencing one
+ * CacheLine per way. Intended for large, highly associative caches.
+ */
+class PackedSetAssociativeArray : public CacheArray {
+public:
+    
+    /* Cache line that mirrors its state into the array's packed state array */
+    class PackedCacheLine : public CacheLine {
+    private:
+        State * stateSlot_;
+    public:
+        PackedCacheLine(unsigned int size, int index, Output * dbg, SharerTable * sharerTable, State * stateSlot) : 
+            CacheLine(size, index, dbg, true, sharerTable), stateSlot_(stateSlot) { *stateSlot_ = state_; }
+
+        void setState(State state) {
+            CacheLine::setState(state);
+            *stateSlot_ = state;
+        }
+    };
+
+    PackedSetAssociativeArray(Output* dbg, unsigned int numLines, unsigned int lineSize, unsigned int associativity,
+                        ReplacementMgr* rp, HashFunction* hf, bool sharersAware);
+
+    ~PackedSetAssociativeArray();
+
+    CacheLine * lookup(Addr baseAddr, bool updateReplacement);
+    CacheLine * findReplacementCandidate(Addr baseAddr, bool cache);
+    void replace(Addr baseAddr, CacheLine * candidate_id, DataLine * dataCandidate);
+    unsigned int preReplace(Addr baseAddr);
+    void deallocate(unsigned int index);
+
+protected:
+    /** Return the way in [tags, tags+ways) holding baseAddr, or -1 */
+    static int findTag(const Addr * tags, unsigned int ways, Addr baseAddr);
+
+    unsigned int getSet(Addr baseAddr) { return hash_->hash(0, toLineAddr(baseAddr)) % numSets_; }
+
+    vector<Addr>    tags_;      // Line base addresses, numLines_ entries, contiguous by set
+    vector<State>   states_;    // Line states, same layout as tags_
+    unsigned int *  setSharers;
+    bool *          setOwned;
+};
+
+/*
+ * Packed set-associative array with a templated replacement policy (see replacementManager.h)
+ * Replacement calls are resolved at compile time and victims are chosen from the packed
+ * state array plus the policy's own per-set metadata, without building per-set side arrays.
+ */
+template<class Policy>
+class PolicySetAssociativeArray : public PackedSetAssociativeArray {
+public:
+    PolicySetAssociativeArray(Output* dbg, unsigned int numLines, unsigned int lineSize, unsigned int associativity, HashFunction* hf, bool sharersAware) :
+        PackedSetAssociativeArray(dbg, numLines, lineSize, associativity, nullptr, hf, sharersAware), policy_(numLines / associativity, associativity),
+        candidates_(associativity, 0) { }
+
+    CacheLine * lookup(Addr baseAddr, bool updateReplacement) {
+        unsigned int set = getSet(baseAddr);
+        int way = findTag(&tags_[set * associativity_], associativity_, baseAddr);
+        if (way == -1) return nullptr;
+        if (updateReplacement) policy_.touch(set, way);
+        return lines_[set * associativity_ + way];
+    }
+
+    CacheLine * findReplacementCandidate(Addr baseAddr, bool cache) {
+        return lines_[preReplace(baseAddr)];
+    }
+
+    unsigned int preReplace(Addr baseAddr) {
+        unsigned int set = getSet(baseAddr);
+        unsigned int setBegin = set * associativity_;
+        for (unsigned int way = 0; way < associativity_; way++) {
+            if (states_[setBegin + way] == I) return setBegin + way;
+        }
+        if (!sharersAware_) return setBegin + policy_.findVictim(set);
+
+        /* Rank as the ReplacementMgr policies do: lines without sharers before lines with sharers,
+         * then lines without an owner before owned lines. The policy picks within the lowest rank. */
+        unsigned int lowest = 3;
+        bool mixed = false;
+        for (unsigned int way = 0; way < associativity_; way++) {
+            CacheLine * line = lines_[setBegin + way];
+            candidates_[way] = (line->numSharers() > 0 ? 2 : 0) + (line->ownerExists() ? 1 : 0);
+            if (way > 0 && candidates_[way] != lowest) mixed = true;
+            if (candidates_[way] < lowest) lowest = candidates_[way];
+        }
+        if (!mixed) return setBegin + policy_.findVictim(set);
+        for (unsigned int way = 0; way < associativity_; way++) {
+            candidates_[way] = (candidates_[way] == lowest);
+        }
+        return setBegin + policy_.findVictim(set, &candidates_[0]);
+    }
+
+    void replace(Addr baseAddr, CacheLine * candidate, DataLine * dataCandidate) {
+        unsigned int index = candidate->getIndex();
+        candidate->reset();
+        candidate->setBaseAddr(baseAddr);
+        tags_[index] = baseAddr;
+        states_[index] = I;
+        policy_.insert(index / associativity_, index % associativity_);
+    }
+
+    void deallocate(unsigned int index) {
+        policy_.invalidate(index / associativity_, index % associativity_);
+        lines_[index]->reset();
+        states_[index] = I;
+    }
+
+private:
+    Policy policy_;
+    std::vector<uint8_t> candidates_;   // Per way rank, then whether the way may be the victim
+};
+
 /*
  *  Dual set-associative cache array
  *  Implements an array for coherence state and an array for data
@@ -110,7 +110,7 @@ void Cache::processCacheRequest(MemEvent* event, Command cmd, Addr baseAddr, boo
         }
 
         // Forward instead of allocating for non-inclusive caches
-        vector<uint8_t> * data = &event->getPayload();
+        const SharedPayload* data = &event->getSharedPayload();
         coherenceMgr_->forwardMessage(event, baseAddr, event->getSize(), 0, data); // Event to forward, address, requested size, data (if any)
         event->setInProgress(true);
         return;
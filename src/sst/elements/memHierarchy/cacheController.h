@@ -68,8 +68,10 @@ public:
             /* Not required */
             {"cache_line_size",         "(uint) Size of a cache line (aka cache block) in bytes.", "64"},
             {"hash_function",           "(int) 0 - none (default), 1 - linear, 2 - XOR", "0"},
+            {"packed_tags",             "(bool) Keep line addresses and states in packed per-set arrays so lookups scan contiguous tags. Faster for large, highly associative caches. Not supported for 'noninclusive_with_directory' caches. Options: 0[off], 1[on]", "false"},
+            {"sharer_tracking",         "(string) How lines track the caches above them that share or own them. Options: bitvector[bit vector of cache IDs], names[set of cache names]", "bitvector"},
             {"coherence_protocol",      "(string) Coherence protocol. Options: MESI, MSI, NONE", "MESI"},
-            {"replacement_policy",      "(string) Replacement policy of the cache array. Options:  LRU[least-recently-used], LFU[least-frequently-used], Random, MRU[most-recently-used], or NMRU[not-most-recently-used]. ", "lru"},
+            {"replacement_policy",      "(string) Replacement policy of the cache array. Options:  LRU[least-recently-used], LFU[least-frequently-used], Random, MRU[most-recently-used], NMRU[not-most-recently-used], PLRU[tree pseudo-LRU, power-of-2 associativity], SRRIP[static re-reference interval prediction], or BRRIP[bimodal RRIP]. PLRU, SRRIP and BRRIP imply packed_tags and are not supported for 'noninclusive_with_directory' caches.", "lru"},
             {"cache_type",              "(string) - Cache type. Options: inclusive cache ('inclusive', required for L1s), non-inclusive cache ('noninclusive') or non-inclusive cache with a directory ('noninclusive_with_directory', required for non-inclusive caches with multiple upper level caches directly above them),", "inclusive"},
             {"max_requests_per_cycle",  "(int) Maximum number of requests to accept per cycle. 0 or negative is unlimited.", "-1"},
             {"request_link_width",      "(string) Limits number of request bytes sent per cycle. Use 'B' units. '0B' is unlimited.", "0B"},
@@ -77,6 +79,8 @@ public:
             {"noninclusive_directory_repl",    "(string) If non-inclusive directory exists, its replacement policy. LRU, LFU, MRU, NMRU, or RANDOM. (not case-sensitive).", "LRU"},
             {"noninclusive_directory_entries", "(uint) Number of entries in the directory. Must be at least 1 if the non-inclusive directory exists.", "0"},
             {"noninclusive_directory_associativity", "(uint) For a set-associative directory, number of ways.", "1"},
+            {"sample_sets",             "(uint) Set sampling for fast design-space sweeps. If non-zero, only this many sets (the first sample_sets sets, must divide the number of sets) are simulated. Requests to other sets are not simulated (see sample_filter) and hit/miss statistics are extrapolated from the sampled sets. Only for inclusive, non-L1 caches directly above memory. Coherence is not maintained for unsampled sets so use for timing exploration only. 0 is off.", "0"},
+            {"sample_filter",           "(bool) Set sampling: forward only the sampled sets' miss ratio share of requests and writebacks to unsampled sets to memory and answer the rest at hit latency, so memory sees about the traffic the full cache would send. Answered reads return zeros and answered writebacks are dropped, so data in unsampled sets is not meaningful. If 0, all of them are forwarded, which is safe but sends memory every unsampled access. Options: 0[off], 1[on]", "false"},
             {"mshr_num_entries",        "(int) Number of MSHR entries. Not valid for L1s because L1 MSHRs assumed to be sized for the CPU's load/store queue. Setting this to -1 will create a very large MSHR.", "-1"},
             {"tag_access_latency_cycles", 
                 "(uint) Latency (in cycles) to access tag portion only of cache. Paid by misses and coherence requests that don't need data. If not specified, defaults to access_latency_cycles","access_latency_cycles"},
@@ -137,7 +141,16 @@ public:
             {"TotalEventsReplayed",     "Total number of events that were initially blocked and then were replayed", "events", 1},
             {"TotalNoncacheableEventsReceived", "Total number of non-cache or noncacheable cache events that were received by this cache and forward", "events", 1},
             {"MSHR_occupancy",          "Number of events in MSHR each cycle", "events", 1},
+            {"MSHR_pool_occupancy",     "Number of addresses holding an MSHR entry each cycle, including entries waiting only on acks or writebacks", "entries", 3},
+            {"MSHR_probe_length",       "Number of MSHR table slots probed per lookup", "slots", 3},
             {"Bank_conflicts",          "Total number of bank conflicts detected", "count", 1},
+            {"Unsampled_requests",      "Set sampling: GetS/GetX/GetSX requests to unsampled sets, handled without simulation", "count", 1},
+            {"Unsampled_forwarded",     "Set sampling: requests and writebacks to unsampled sets forwarded to memory (the rest were answered locally by sample_filter)", "count", 1},
+            {"Extrapolated_hits",       "Set sampling: hits over all requests, extrapolated from the sampled sets' miss ratio at the end of simulation", "count", 1},
+            {"Extrapolated_misses",     "Set sampling: misses over all requests, extrapolated from the sampled sets' miss ratio at the end of simulation", "count", 1},
+            {"Sampled_miss_ratio",      "Set sampling: miss ratio of the sampled sets", "ratio", 1},
+            {"Sampled_miss_ratio_CI_low",  "Set sampling: lower bound of the 95% confidence interval on the miss ratio", "ratio", 1},
+            {"Sampled_miss_ratio_CI_high", "Set sampling: upper bound of the 95% confidence interval on the miss ratio", "ratio", 1},
             {"Prefetch_requests",       "Number of prefetches received from prefetcher at this cache", "events", 1},
             {"Prefetch_drops",          "Number of prefetches that were cancelled. Reasons: too many prefetches outstanding, cache can't handle prefetch this cycle, currently handling another event for the address.", "events", 1},
             /* Coherence events - break down GetS between S/E */
@@ -199,6 +212,14 @@ private:
     /** Process an incoming event that is not meant for the cache */
     void processNoncacheable(MemEventBase* event);
     
+    /** Set sampling: forward requests to unsampled sets and their responses without simulating them */
+    bool processUnsampled(MemEventBase* event);
+    bool processUnsampledResponse(MemEvent* event);
+    bool forwardUnsampled();
+    bool isSampled(Addr baseAddr) { return sampleSet(baseAddr) < sampleSets_; }
+    uint64_t sampleSet(Addr baseAddr) { return sampleHash_->hash(0, cacheArray_->toLineAddr(baseAddr)) % fullSets_; }
+    void recordSampleStatistics();
+
     /** Process the oldest incoming event */
     bool processEvent(MemEventBase* event, bool mshrHit);
     
@@ -344,6 +365,9 @@ private:
     int                     maxOutstandingPrefetch_;
     SimTime_t               prefetchDelay_;
     int                     maxRequestsPerCycle_;
+    uint64_t                sampleSets_;    // Number of sets simulated when set sampling, 0 if off
+    uint64_t                fullSets_;      // Number of sets in the configured cache
+    HashFunction*           sampleHash_;    // Owned by the cache array
 
     /* Cache structures */
     CacheArray*             cacheArray_;
@@ -374,6 +398,14 @@ private:
     std::map<MemEvent*,uint64>      startTimeList_;
     std::map<MemEvent*,int>         missTypeList_;
     std::vector<bool>               bankStatus_;    // TODO change if we want multiported banks
+    std::vector<uint64_t>           sampleAccesses_;    // Per sampled set
+    std::vector<uint64_t>           sampleMisses_;      // Per sampled set
+    uint64_t                        sampleAccessTotal_; // Over all sampled sets
+    uint64_t                        sampleMissTotal_;
+    uint64_t                        unsampledRequests_;
+    bool                            sampleFilter_;
+    double                          unsampledCredit_;   // Accumulated share of unsampled events to forward
+    SharedPayload                   unsampledData_;     // Zero data returned for unsampled reads answered locally
 
     // These parameters are for the coherence controller and are detected during init
     bool                    isLL;
@@ -426,8 +458,19 @@ private:
     Statistic<uint64_t>* statInvStalledByLockedLine;
 
     Statistic<uint64_t>* statMSHROccupancy;
+    Statistic<uint64_t>* statMSHRPoolOccupancy;
+    Statistic<uint64_t>* statMSHRProbeLength;
     Statistic<uint64_t>* statBankConflicts;
 
+    // Set sampling statistics
+    Statistic<uint64_t>* statUnsampledRequests;
+    Statistic<uint64_t>* statUnsampledForwarded;
+    Statistic<uint64_t>* statExtrapolatedHits;
+    Statistic<uint64_t>* statExtrapolatedMisses;
+    Statistic<double>*   statSampledMissRatio;
+    Statistic<double>*   statSampledMissRatioLow;
+    Statistic<double>*   statSampledMissRatioHigh;
+
     // Prefetch statistics
     Statistic<uint64_t>* statPrefetchRequest;
     Statistic<uint64_t>* statPrefetchDrop;
@@ -22,6 +22,9 @@
 #include <sst_config.h>
 #include <sst/core/interfaces/stringEvent.h>
 
+#include <algorithm>
+#include <cmath>
+
 #include "cacheController.h"
 #include "coherencemgr/coherenceController.h"
 #include "hash.h"
@@ -97,6 +100,15 @@ void Cache::profileEvent(MemEvent* event, Command cmd, bool replay, bool canStal
         if (mshr_->isFull() || (!L1_ && !replay && mshr_->isAlmostFull()  && !(cacheHit == 0))) { 
                 return; // profile later, this event is getting NACKed 
         }
+        if (sampleSets_ != 0 && (!replay || wasBlocked)) {
+            uint64_t set = sampleSet(event->getBaseAddr());
+            sampleAccesses_[set]++;
+            sampleAccessTotal_++;
+            if (cacheHit != 0) {
+                sampleMisses_[set]++;
+                sampleMissTotal_++;
+            }
+        }
     }
 
     switch(cmd) {
@@ -228,6 +240,8 @@ bool Cache::processEvent(MemEventBase* ev, bool replay) {
         return true;
     }
 
+    if (sampleSets_ != 0 && processUnsampled(ev)) return true;
+
     /* Start handling cache events */
     MemEvent * event = static_cast<MemEvent*>(ev);
     Command cmd     = event->getCmd();
@@ -376,6 +390,126 @@ void Cache::processNoncacheable(MemEventBase* event) {
     }
 }
 
+/* 
+ * Set sampling: requests to lines outside the sampled sets are sent to memory as if they
+ * were noncacheable and their responses are returned without being cached. Returns false 
+ * if the event should be handled normally.
+ * With sample_filter, only the sampled sets' miss ratio share of requests and writebacks is
+ * forwarded. The rest are answered here at hit latency (reads with zero data) so that memory
+ * sees about the traffic the full cache would send rather than every access.
+ */
+bool Cache::processUnsampled(MemEventBase* ev) {
+    MemEvent* event = static_cast<MemEvent*>(ev);
+    Command cmd = event->getCmd();
+    bool expectResponse = !event->queryFlag(MemEvent::F_NORESPONSE);
+    switch (cmd) {
+        case Command::GetS:
+        case Command::GetX:
+        case Command::GetSX:
+            if (isSampled(event->getBaseAddr())) return false;
+            if (event->isPrefetch() && event->getRqstr() == this->getName()) {
+                statPrefetchDrop->addData(1);
+                delete event;
+                return true;
+            }
+            unsampledRequests_++;
+            statUnsampledRequests->addData(1);
+            if (!forwardUnsampled()) {
+                if (unsampledData_.size() != event->getSize())
+                    unsampledData_ = SharedPayload(std::vector<uint8_t>(event->getSize(), 0));
+                coherenceMgr_->sendResponseUp(event, &unsampledData_, false, timestamp_);
+                delete event;
+                return true;
+            }
+            break;
+        case Command::FlushLine:
+        case Command::FlushLineInv:
+            if (isSampled(event->getBaseAddr())) return false;
+            break;
+        case Command::PutS:
+        case Command::PutM:
+        case Command::PutE:
+            if (isSampled(event->getBaseAddr())) return false;
+            expectResponse = expectResponse && expectWritebackAcks;
+            if (!forwardUnsampled()) {
+                if (expectResponse) coherenceMgr_->sendResponseUp(event, nullptr, false, timestamp_);
+                delete event;
+                return true;
+            }
+            break;
+        default:
+            return !CommandCPUSide[(int)cmd] && processUnsampledResponse(event);
+    }
+
+    if (expectResponse)
+        responseDst_.insert(std::make_pair(event->getID(), event->getSrc()));
+    coherenceMgr_->forwardTowardsMem(event);
+    return true;
+}
+
+/* 
+ * Set sampling: whether to forward the next request or writeback to an unsampled set.
+ * Forwards the sampled miss ratio's share, spread evenly by accumulating it per event.
+ * Until a sampled set has been accessed the ratio is unknown and everything is forwarded.
+ */
+bool Cache::forwardUnsampled() {
+    bool forward = true;
+    if (sampleFilter_ && sampleAccessTotal_ != 0) {
+        unsampledCredit_ += (double)sampleMissTotal_ / (double)sampleAccessTotal_;
+        forward = unsampledCredit_ >= 1.0;
+        if (forward) unsampledCredit_ -= 1.0;
+    }
+    if (forward) statUnsampledForwarded->addData(1);
+    return forward;
+}
+
+/* Set sampling: return a response to a request that was forwarded by processUnsampled */
+bool Cache::processUnsampledResponse(MemEvent* event) {
+    std::map<SST::Event::id_type,std::string>::iterator it = responseDst_.find(event->getResponseToID());
+    if (it == responseDst_.end()) return false;
+    coherenceMgr_->forwardTowardsCPU(event, it->second);
+    responseDst_.erase(it);
+    return true;
+}
+
+/* 
+ * Set sampling: extrapolate hits and misses from the sampled sets. Each set is treated as a
+ * cluster of accesses, giving a ratio estimator with a finite population correction.
+ */
+void Cache::recordSampleStatistics() {
+    double accesses = 0, misses = 0;
+    for (uint64_t i = 0; i < sampleSets_; i++) {
+        accesses += sampleAccesses_[i];
+        misses += sampleMisses_[i];
+    }
+    if (accesses == 0) return;
+
+    double ratio = misses / accesses;
+    double variance = 0;
+    if (sampleSets_ > 1) {
+        double sumSquares = 0;
+        for (uint64_t i = 0; i < sampleSets_; i++) {
+            double residual = sampleMisses_[i] - ratio * sampleAccesses_[i];
+            sumSquares += residual * residual;
+        }
+        double meanAccesses = accesses / sampleSets_;
+        double fpc = 1.0 - (double)sampleSets_ / (double)fullSets_;
+        variance = fpc * (sumSquares / (sampleSets_ - 1)) / (sampleSets_ * meanAccesses * meanAccesses);
+    }
+    double bound = 1.96 * sqrt(variance);
+
+    double total = accesses + unsampledRequests_;
+    uint64_t extMisses = (uint64_t)(ratio * total + 0.5);
+    statSampledMissRatio->addData(ratio);
+    statSampledMissRatioLow->addData(std::max(0.0, ratio - bound));
+    statSampledMissRatioHigh->addData(std::min(1.0, ratio + bound));
+    statExtrapolatedMisses->addData(extMisses);
+    statExtrapolatedHits->addData((uint64_t)total - extMisses);
+
+    out_->verbose(CALL_INFO, 1, 0, "%s: Set sampling: %" PRIu64 " of %" PRIu64 " sets. Miss ratio %.4f (95%% CI %.4f - %.4f) over %" PRIu64 " requests\n",
+            getName().c_str(), sampleSets_, fullSets_, ratio, std::max(0.0, ratio - bound), std::min(1.0, ratio + bound), (uint64_t)total);
+}
+
 
 void Cache::handlePrefetchEvent(SST::Event* ev) {
     prefetchLink_->send(prefetchDelay_, ev);
@@ -511,6 +645,12 @@ void Cache::setup() {
     if (names->empty()) 
         out_->fatal(CALL_INFO, -1,"%s did not find any sources\n", getName().c_str());
 
+    // Resolve upper level names to dense IDs for sharer/owner tracking in the cache array
+    std::vector<std::string> sharerNames(upperLevelCacheNames_.begin(), upperLevelCacheNames_.end());
+    for (std::set<MemLinkBase::EndpointInfo>::iterator it = names->begin(); it != names->end(); it++)
+        sharerNames.push_back(it->name);
+    cacheArray_->setSharerNames(sharerNames);
+
     names = linkDown_->getDests();
     if (names->empty()) {
         std::set<MemLinkBase::EndpointInfo> dstNames;
@@ -542,6 +682,9 @@ void Cache::setup() {
     if (linkUp_ != linkDown_) linkDown_->setup();
 
     coherenceMgr_->setupLowerStatus(isLL, expectWritebackAcks, lowerIsNoninclusive);
+
+    if (sampleSets_ != 0 && !isLL)
+        out_->fatal(CALL_INFO, -1, "%s, Invalid param: sample_sets - set sampling is only supported for caches directly above memory.\n", getName().c_str());
 }
 
 
@@ -550,6 +693,7 @@ void Cache::finish() {
         turnClockOn();
     }
     listener_->printStats(*d_);
+    if (sampleSets_ != 0) recordSampleStatistics();
     linkDown_->finish();
     if (linkUp_ != linkDown_) linkUp_->finish();
 }
@@ -587,6 +731,7 @@ bool Cache::clockTick(Cycle_t time) {
         
     // MSHR occupancy
     statMSHROccupancy->addData(mshr_->getSize());
+    statMSHRPoolOccupancy->addData(mshr_->getEntryCount());
         
     // Clear bank status and issue conflicted requests
     bool conflicts = false;
@@ -643,6 +788,7 @@ void Cache::turnClockOn() {
     int64_t cyclesOff = timestamp_ - lastActiveClockCycle_;
     for (int64_t i = 0; i < cyclesOff; i++) {           // TODO more efficient way to do this? Don't want to add in one-shot or we get weird averages/sum sq.
         statMSHROccupancy->addData(mshr_->getSize());
+        statMSHRPoolOccupancy->addData(mshr_->getEntryCount());
     }
     //d_->debug(_L3_, "%s turning clock ON at cycle %" PRIu64 ", timestamp %" PRIu64 ", ns %" PRIu64 "\n", this->getName().c_str(), time, timestamp_, getCurrentSimTimeNano());
     clockIsOn_ = true;
@@ -96,8 +96,19 @@ Cache::Cache(ComponentId_t id, Params &params) : Component(id) {
     }
 
     /* Construct cache structures */
+    unsampledRequests_ = 0;
+    sampleAccessTotal_ = sampleMissTotal_ = 0;
+    unsampledCredit_ = 0;
+    sampleFilter_ = params.find<bool>("sample_filter", false);
     cacheArray_ = createCacheArray(params);
 
+    std::string sharerTracking = params.find<std::string>("sharer_tracking", "bitvector");
+    to_lower(sharerTracking);
+    if (sharerTracking == "names")
+        cacheArray_->setNamedSharers(true);
+    else if (sharerTracking != "bitvector")
+        out_->fatal(CALL_INFO, -1, "%s, Invalid param: sharer_tracking - must be 'bitvector' or 'names'. You specified '%s'.\n", getName().c_str(), sharerTracking.c_str());
+
     /* Banks */
     unsigned int banks = params.find<unsigned int>("banks", 0);
     bankStatus_.resize(banks, false);
@@ -503,6 +514,8 @@ CacheArray* Cache::createCacheArray(Params &params) {
     uint64_t dAssoc = params.find<uint64_t>("noninclusive_directory_associativity", 1);
 
     int hashFunc = params.find<int>("hash_function", 0);
+    bool packedTags = params.find<bool>("packed_tags", false);
+    sampleSets_ = params.find<uint64_t>("sample_sets", 0);
 
     /* Error check parameters and compute derived parameters */
     /* Fix up parameters */
@@ -533,17 +546,59 @@ CacheArray* Cache::createCacheArray(Params &params) {
                     getName().c_str(), dAssoc);
         if (dEntries < 1)
             out_->fatal(CALL_INFO, -1, "%s, Invalid param: noninclusive_directory_entries - must be at least 1 if cache_type is noninclusive_with_directory. You specified '%" PRIu64 "'.\n", getName().c_str(), dEntries);
+        if (packedTags)
+            out_->fatal(CALL_INFO, -1, "%s, Invalid param combo: packed_tags is not supported for cache_type 'noninclusive_with_directory'.\n", getName().c_str());
     }
 
-    /* Build cache array */
-    ReplacementMgr* rmgr = constructReplacementManager(replacement, lines, assoc);
+    /* Set sampling: only the first sampleSets_ sets are kept, since sampleSets_ divides the number
+     * of sets a sampled line maps to the same set index in the smaller array */
+    fullSets_ = lines / assoc;
+    if (sampleSets_ >= fullSets_) sampleSets_ = 0;
+    if (sampleSets_ != 0) {
+        if (L1_ || type_ != "inclusive")
+            out_->fatal(CALL_INFO, -1, "%s, Invalid param combo: sample_sets is only supported for non-L1 caches with cache_type 'inclusive'.\n", getName().c_str());
+        if (fullSets_ % sampleSets_ != 0)
+            out_->fatal(CALL_INFO, -1, "%s, Invalid param: sample_sets - must divide the number of sets (%" PRIu64 "). You specified '%" PRIu64 "'.\n", 
+                    getName().c_str(), fullSets_, sampleSets_);
+        lines = sampleSets_ * assoc;
+        sampleAccesses_.resize(sampleSets_, 0);
+        sampleMisses_.resize(sampleSets_, 0);
+    }
+
+    /* Policies implemented as templates (see replacementManager.h) always use a packed array */
+    bool templatedPolicy = (replacement == "plru" || replacement == "srrip" || replacement == "brrip");
+    if (templatedPolicy && type_ == "noninclusive_with_directory")
+        out_->fatal(CALL_INFO, -1, "%s, Invalid param combo: replacement_policy '%s' is not supported for cache_type 'noninclusive_with_directory'.\n", getName().c_str(), replacement.c_str());
+    if (replacement == "plru" && !isPowerOfTwo(assoc))
+        out_->fatal(CALL_INFO, -1, "%s, Invalid param combo: replacement_policy 'plru' requires associativity to be a power of 2. You specified '%" PRIu64 "'.\n", getName().c_str(), assoc);
 
+    /* Build cache array */
     HashFunction * ht;
     if (hashFunc == 1)      ht = new LinearHashFunction;
     else if (hashFunc == 2) ht = new XorHashFunction;
     else                    ht = new PureIdHashFunction;
+    sampleHash_ = ht;
+
+    if (templatedPolicy) {
+        if (replacement == "plru")
+            return new PolicySetAssociativeArray<TreePLRUPolicy>(d_, lines, lineSize, assoc, ht, !L1_);
+        if (replacement == "srrip")
+            return new PolicySetAssociativeArray<SRRIPPolicy>(d_, lines, lineSize, assoc, ht, !L1_);
+        return new PolicySetAssociativeArray<BRRIPPolicy>(d_, lines, lineSize, assoc, ht, !L1_);
+    }
+
+    /* L1s do not rank by sharers so packed LRU can use the templated policy with the same victim choice */
+    if (packedTags && L1_ && replacement == "lru") {
+        if (assoc <= 256)
+            return new PolicySetAssociativeArray<LRUPolicy<uint8_t> >(d_, lines, lineSize, assoc, ht, false);
+        return new PolicySetAssociativeArray<LRUPolicy<uint32_t> >(d_, lines, lineSize, assoc, ht, false);
+    }
+
+    ReplacementMgr* rmgr = constructReplacementManager(replacement, lines, assoc);
 
     if (type_ == "inclusive" || type_ == "noninclusive") {
+        if (packedTags)
+            return new PackedSetAssociativeArray(d_, lines, lineSize, assoc, rmgr, ht, !L1_);
         return new SetAssociativeArray(d_, lines, lineSize, assoc, rmgr, ht, !L1_);
     } else { //type_ == "noninclusive_with_directory" --> Already checked that this string is valid
         /* Construct */
@@ -659,5 +714,17 @@ void Cache::registerStatistics() {
     statInv_recv                    = registerStatistic<uint64_t>("Inv_recv");
     statNACK_recv                   = registerStatistic<uint64_t>("NACK_recv");
     statMSHROccupancy               = registerStatistic<uint64_t>("MSHR_occupancy");
+    statMSHRPoolOccupancy           = registerStatistic<uint64_t>("MSHR_pool_occupancy");
+    statMSHRProbeLength             = registerStatistic<uint64_t>("MSHR_probe_length");
+    mshr_->setProbeLengthStatistic(statMSHRProbeLength);
     statBankConflicts               = registerStatistic<uint64_t>("Bank_conflicts");
+    if (sampleSets_ != 0) {
+        statUnsampledRequests       = registerStatistic<uint64_t>("Unsampled_requests");
+        statUnsampledForwarded      = registerStatistic<uint64_t>("Unsampled_forwarded");
+        statExtrapolatedHits        = registerStatistic<uint64_t>("Extrapolated_hits");
+        statExtrapolatedMisses      = registerStatistic<uint64_t>("Extrapolated_misses");
+        statSampledMissRatio        = registerStatistic<double>("Sampled_miss_ratio");
+        statSampledMissRatioLow     = registerStatistic<double>("Sampled_miss_ratio_CI_low");
+        statSampledMissRatioHigh    = registerStatistic<double>("Sampled_miss_ratio_CI_high");
+    }
 }
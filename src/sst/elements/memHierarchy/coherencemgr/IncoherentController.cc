@@ -211,7 +211,7 @@ int IncoherentController::isCoherenceMiss(MemEvent* event, CacheLine* cacheLine)
  */
 CacheAction IncoherentController::handleGetSRequest(MemEvent* event, CacheLine* cacheLine, bool replay) {
     State state = cacheLine->getState();
-    vector<uint8_t>* data = cacheLine->getData();
+    const SharedPayload* data = cacheLine->getData();
     if (is_debug_event(event)) printData(cacheLine->getData(), false);
 
     bool localPrefetch = event->isPrefetch() && (event->getRqstr() == parent->getName());
@@ -304,7 +304,7 @@ CacheAction IncoherentController::handlePutMRequest(MemEvent* event, CacheLine*
     
     switch (state) {
         case I:
-            cacheLine->setData(event->getPayload(), 0);
+            cacheLine->setData(event->getSharedPayload(), 0);
             if (event->getDirty()) cacheLine->setState(M);
             else cacheLine->setState(E);
             break;
@@ -318,7 +318,7 @@ CacheAction IncoherentController::handlePutMRequest(MemEvent* event, CacheLine*
             if (event->getDirty()) cacheLine->setState(M);
         case M:
             if (event->getDirty()) {
-                cacheLine->setData(event->getPayload(), 0);
+                cacheLine->setData(event->getSharedPayload(), 0);
                 
                 if (is_debug_event(event)) printData(cacheLine->getData(), true);
             }
@@ -372,11 +372,11 @@ CacheAction IncoherentController::handleFlushLineInvRequest(MemEvent * event, Ca
 CacheAction IncoherentController::handleDataResponse(MemEvent* responseEvent, CacheLine* cacheLine, MemEvent* origRequest){
     
     if (!inclusive_ && (cacheLine == NULL || cacheLine->getState() == I)) {
-        sendResponseUp(origRequest, &responseEvent->getPayload(), true, 0);
+        sendResponseUp(origRequest, &responseEvent->getSharedPayload(), true, 0);
         return DONE;
     }
 
-    cacheLine->setData(responseEvent->getPayload(), 0);
+    cacheLine->setData(responseEvent->getSharedPayload(), 0);
     if (is_debug_event(responseEvent)) printData(cacheLine->getData(), true);
 
     State state = cacheLine->getState();
@@ -508,7 +508,7 @@ void IncoherentController::addToOutgoingQueueUp(Response& resp) {
 /*
  *  Print data values for debugging
  */
-void IncoherentController::printData(vector<uint8_t> * data, bool set) {
+void IncoherentController::printData(const SharedPayload* data, bool set) {
     /*if (set)    printf("Setting data (%zu): 0x", data->size());
     else        printf("Getting data (%zu): 0x", data->size());
     
@@ -270,7 +270,7 @@ bool L1CoherenceController::isRetryNeeded(MemEvent * event, CacheLine * cacheLin
 
 CacheAction L1CoherenceController::handleGetSRequest(MemEvent* event, CacheLine* cacheLine, bool replay){
     State state = cacheLine->getState();
-    vector<uint8_t>* data = cacheLine->getData();
+    const SharedPayload* data = cacheLine->getData();
     
     bool localPrefetch = event->isPrefetch() && (event->getRqstr() == parent->getName());
     recordStateEventCount(event->getCmd(), state);
@@ -312,7 +312,7 @@ CacheAction L1CoherenceController::handleGetSRequest(MemEvent* event, CacheLine*
 CacheAction L1CoherenceController::handleGetXRequest(MemEvent* event, CacheLine* cacheLine, bool replay) {
     State state = cacheLine->getState();
     Command cmd = event->getCmd();
-    vector<uint8_t>* data = cacheLine->getData();
+    const SharedPayload* data = cacheLine->getData();
     uint64_t sendTime = 0;
 
     recordStateEventCount(event->getCmd(), state);
@@ -353,7 +353,7 @@ CacheAction L1CoherenceController::handleGetXRequest(MemEvent* event, CacheLine*
             if (cmd == Command::GetX) {
                 /* L1s write back immediately */
                 if (!event->isStoreConditional() || atomic) {
-                    cacheLine->setData(event->getPayload(), event->getAddr() - event->getBaseAddr());
+                    cacheLine->setData(event->getSharedPayload(), event->getAddr() - event->getBaseAddr());
                     
                     if (is_debug_addr(cacheLine->getBaseAddr())) {
                         printData(cacheLine->getData(), true);
@@ -465,7 +465,7 @@ void L1CoherenceController::handleDataResponse(MemEvent* responseEvent, CacheLin
 
     switch (state) {
         case IS:
-            cacheLine->setData(responseEvent->getPayload(), 0);
+            cacheLine->setData(responseEvent->getSharedPayload(), 0);
             
             if (is_debug_addr(cacheLine->getBaseAddr())) {
                 printData(cacheLine->getData(), true);
@@ -484,7 +484,7 @@ void L1CoherenceController::handleDataResponse(MemEvent* responseEvent, CacheLin
             cacheLine->setTimestamp(sendTime-1);
             break;
         case IM:
-            cacheLine->setData(responseEvent->getPayload(), 0);
+            cacheLine->setData(responseEvent->getSharedPayload(), 0);
             
             if (is_debug_addr(cacheLine->getBaseAddr())) {
                 printData(cacheLine->getData(), true);
@@ -494,7 +494,7 @@ void L1CoherenceController::handleDataResponse(MemEvent* responseEvent, CacheLin
             cacheLine->setState(M);
             if (origRequest->getCmd() == Command::GetX) {
                 if (!origRequest->isStoreConditional() ||atomic) {
-                    cacheLine->setData(origRequest->getPayload(), origRequest->getAddr() - origRequest->getBaseAddr());
+                    cacheLine->setData(origRequest->getSharedPayload(), origRequest->getAddr() - origRequest->getBaseAddr());
                     
                     if (is_debug_addr(cacheLine->getBaseAddr())) {
                         printData(cacheLine->getData(), true);
@@ -753,7 +753,7 @@ void L1CoherenceController::sendResponseDown(MemEvent* event, CacheLine* cacheLi
 }
 
 
-uint64_t L1CoherenceController::sendResponseUp(MemEvent * event, std::vector<uint8_t>* data, bool replay, uint64_t baseTime, bool finishedAtomically) {
+uint64_t L1CoherenceController::sendResponseUp(MemEvent * event, const SharedPayload* data, bool replay, uint64_t baseTime, bool finishedAtomically) {
     Command cmd = event->getCmd();
     MemEvent * responseEvent = event->makeResponse();
     responseEvent->setDst(event->getSrc());
@@ -908,7 +908,7 @@ void L1CoherenceController::addToOutgoingQueueUp(Response& resp) {
  * Helper functions
  ********************/
 
-void L1CoherenceController::printData(vector<uint8_t> * data, bool set) {
+void L1CoherenceController::printData(const SharedPayload* data, bool set) {
 /*    if (set)    printf("Setting data (%zu): 0x", data->size());
     else        printf("Getting data (%zu): 0x", data->size());
     
@@ -290,7 +290,7 @@ public:
 
     /* Methods for sending events, called by cache controller */
     /** Send response up (to processor) */
-    uint64_t sendResponseUp(MemEvent * event, vector<uint8_t>* data, bool replay, uint64_t baseTime, bool atomic = false);
+    uint64_t sendResponseUp(MemEvent * event, const SharedPayload* data, bool replay, uint64_t baseTime, bool atomic = false);
     
     /** Call through to coherenceController with statistic recording */
     void addToOutgoingQueue(Response& resp);
@@ -300,7 +300,7 @@ public:
     /** Determine whether a retry of a NACKed event is needed */
     bool isRetryNeeded(MemEvent * event, CacheLine * cacheLine);
 
-    void printData(vector<uint8_t> * data, bool set);
+    void printData(const SharedPayload* data, bool set);
 
 private:
     bool                protocol_;  // True for MESI, false for MSI
@@ -188,7 +188,7 @@ bool L1IncoherentController::isRetryNeeded(MemEvent * event, CacheLine * cacheLi
 
 CacheAction L1IncoherentController::handleGetSRequest(MemEvent* event, CacheLine* cacheLine, bool replay){
     State state = cacheLine->getState();
-    vector<uint8_t>* data = cacheLine->getData();
+    const SharedPayload* data = cacheLine->getData();
     
     bool localPrefetch = event->isPrefetch() && (event->getRqstr() == parent->getName());
     recordStateEventCount(event->getCmd(), state);
@@ -232,7 +232,7 @@ CacheAction L1IncoherentController::handleGetSRequest(MemEvent* event, CacheLine
 CacheAction L1IncoherentController::handleGetXRequest(MemEvent* event, CacheLine* cacheLine, bool replay) {
     State state = cacheLine->getState();
     Command cmd = event->getCmd();
-    vector<uint8_t>* data = cacheLine->getData();
+    const SharedPayload* data = cacheLine->getData();
     
     uint64_t sendTime = 0;
 
@@ -255,7 +255,7 @@ CacheAction L1IncoherentController::handleGetXRequest(MemEvent* event, CacheLine
             if (cmd == Command::GetX) {
                 /* L1s write back immediately */
                 if (!event->isStoreConditional() ||atomic) {
-                    cacheLine->setData(event->getPayload(), event->getAddr() - event->getBaseAddr());
+                    cacheLine->setData(event->getSharedPayload(), event->getAddr() - event->getBaseAddr());
                 }
                 cacheLine->atomicEnd();
                 /* Handle GetX as unlock (store-unlock) */
@@ -342,7 +342,7 @@ CacheAction L1IncoherentController::handleFlushLineInvRequest(MemEvent * event,
 
 void L1IncoherentController::handleDataResponse(MemEvent* responseEvent, CacheLine* cacheLine, MemEvent* origRequest){
     
-    cacheLine->setData(responseEvent->getPayload(), 0);
+    cacheLine->setData(responseEvent->getSharedPayload(), 0);
     bool localPrefetch = origRequest->isPrefetch() && (origRequest->getRqstr() == parent->getName());
     
     State state = cacheLine->getState();
@@ -367,7 +367,7 @@ void L1IncoherentController::handleDataResponse(MemEvent* responseEvent, CacheLi
             cacheLine->setState(M);
             if (origRequest->getCmd() == Command::GetX) {
                 if (!origRequest->isStoreConditional() || cacheLine->isAtomic()) {
-                    cacheLine->setData(origRequest->getPayload(), origRequest->getAddr() - origRequest->getBaseAddr());
+                    cacheLine->setData(origRequest->getSharedPayload(), origRequest->getAddr() - origRequest->getBaseAddr());
 
                 }
                 /* Handle GetX as unlock (store-unlock) */
@@ -415,7 +415,7 @@ int L1IncoherentController::isCoherenceMiss(MemEvent* event, CacheLine* cacheLin
  *  Methods for sending & receiving messages
  *********************************************/
 
-uint64_t L1IncoherentController::sendResponseUp(MemEvent * event, std::vector<uint8_t>* data, bool replay, uint64_t baseTime, bool finishedAtomically) {
+uint64_t L1IncoherentController::sendResponseUp(MemEvent * event, const SharedPayload* data, bool replay, uint64_t baseTime, bool finishedAtomically) {
     Command cmd = event->getCmd();
     MemEvent * responseEvent = event->makeResponse();
     responseEvent->setDst(event->getSrc());
@@ -532,7 +532,7 @@ void L1IncoherentController::addToOutgoingQueueUp(Response& resp) {
  * Helper functions
  ********************/
 
-void L1IncoherentController::printData(vector<uint8_t> * data, bool set) {
+void L1IncoherentController::printData(const SharedPayload* data, bool set) {
 /*    if (set)    printf("Setting data (%zu): 0x", data->size());
     else        printf("Getting data (%zu): 0x", data->size());
     
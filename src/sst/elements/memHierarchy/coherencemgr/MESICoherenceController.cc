@@ -393,7 +393,7 @@ int MESIController::isCoherenceMiss(MemEvent* event, CacheLine* cacheLine) {
 /** Handle GetS request */
 CacheAction MESIController::handleGetSRequest(MemEvent* event, CacheLine* cacheLine, bool replay) {
     State state = cacheLine->getState();
-    vector<uint8_t>* data = cacheLine->getData();
+    const SharedPayload* data = cacheLine->getData();
     
     if (is_debug_event(event)) printData(cacheLine->getData(), false);
     
@@ -576,7 +576,7 @@ CacheAction MESIController::handleFlushLineRequest(MemEvent * event, CacheLine*
                 cacheLine->clearOwner();
                 cacheLine->addSharer(event->getSrc());
                 if (event->getDirty()) {
-                    cacheLine->setData(event->getPayload(), 0);
+                    cacheLine->setData(event->getSharedPayload(), 0);
                     cacheLine->setState(M);
                 }
             }
@@ -600,7 +600,7 @@ CacheAction MESIController::handleFlushLineRequest(MemEvent * event, CacheLine*
                 cacheLine->clearOwner();
                 cacheLine->addSharer(event->getSrc());
                 if (event->getDirty()) {
-                    cacheLine->setData(event->getPayload(), 0);
+                    cacheLine->setData(event->getSharedPayload(), 0);
                     cacheLine->setState(MI);
                 }
             }
@@ -611,7 +611,7 @@ CacheAction MESIController::handleFlushLineRequest(MemEvent * event, CacheLine*
                 cacheLine->clearOwner();
                 cacheLine->addSharer(event->getSrc());
                 if (event->getDirty()) {
-                    cacheLine->setData(event->getPayload(), 0);
+                    cacheLine->setData(event->getSharedPayload(), 0);
                     cacheLine->setState(M_Inv);
                 }
             }
@@ -623,7 +623,7 @@ CacheAction MESIController::handleFlushLineRequest(MemEvent * event, CacheLine*
                 cacheLine->addSharer(event->getSrc());
                 mshr_->decrementAcksNeeded(event->getBaseAddr());
                 if (event->getDirty()) {
-                    cacheLine->setData(event->getPayload(), 0);
+                    cacheLine->setData(event->getSharedPayload(), 0);
                     cacheLine->setState(M_InvX);
                 }
             }
@@ -687,7 +687,7 @@ CacheAction MESIController::handleFlushLineInvRequest(MemEvent * event, CacheLin
                 cacheLine->setState(M);
                 state = M;
             }
-            cacheLine->setData(event->getPayload(), 0);
+            cacheLine->setData(event->getSharedPayload(), 0);
         }
     
         if (cacheLine->getPrefetch()) {
@@ -894,7 +894,7 @@ CacheAction MESIController::handlePutSRequest(MemEvent* event, CacheLine* line,
                         parent->getName().c_str(), event->getVerboseString().c_str(), reqEvent->getVerboseString().c_str(), getCurrentSimTimeNano());
             }
         }
-        line->setData(event->getPayload(), 0);
+        line->setData(event->getSharedPayload(), 0);
         
         if (is_debug_event(event)) printData(line->getData(), true);
         
@@ -1061,7 +1061,7 @@ CacheAction MESIController::handlePutMRequest(MemEvent* event, CacheLine* cacheL
         }
     } 
     if (event->getDirty() || !inclusive_) {
-        cacheLine->setData(event->getPayload(), 0);
+        cacheLine->setData(event->getSharedPayload(), 0);
     }
     cacheLine->clearOwner();
             
@@ -1488,7 +1488,7 @@ CacheAction MESIController::handleDataResponse(MemEvent* responseEvent, CacheLin
     origRequest->setMemFlags(responseEvent->getMemFlags());
 
     if (!inclusive_ && (cacheLine == NULL || cacheLine->getState() == I)) {
-        uint64_t sendTime = sendResponseUp(origRequest, responseEvent->getCmd(), &responseEvent->getPayload(), responseEvent->getDirty(), true, 0);
+        uint64_t sendTime = sendResponseUp(origRequest, responseEvent->getCmd(), &responseEvent->getSharedPayload(), responseEvent->getDirty(), true, 0);
         if (cacheLine != NULL) cacheLine->setTimestamp(sendTime);
         return DONE;
     }
@@ -1502,7 +1502,7 @@ CacheAction MESIController::handleDataResponse(MemEvent* responseEvent, CacheLin
     
     switch (state) {
         case IS:
-            cacheLine->setData(responseEvent->getPayload(), 0);
+            cacheLine->setData(responseEvent->getSharedPayload(), 0);
             
             if (is_debug_event(responseEvent)) printData(cacheLine->getData(), true);
             
@@ -1517,13 +1517,13 @@ CacheAction MESIController::handleDataResponse(MemEvent* responseEvent, CacheLin
             
             if (!inclusive_ && cacheLine->getState() != S) { // Transfer E/M permission
                 cacheLine->setOwner(origRequest->getSrc());
-                sendTime = sendResponseUp(origRequest, Command::GetXResp, &responseEvent->getPayload(), state == M, true, cacheLine->getTimestamp());
+                sendTime = sendResponseUp(origRequest, Command::GetXResp, &responseEvent->getSharedPayload(), state == M, true, cacheLine->getTimestamp());
             } else if (protocol_ && cacheLine->getState() != S && mshr_->lookup(responseEvent->getBaseAddr()).size() == 1) { // Send exclusive response unless another request is waiting
                 cacheLine->setOwner(origRequest->getSrc());
-                sendTime = sendResponseUp(origRequest, Command::GetXResp, &responseEvent->getPayload(), true, cacheLine->getTimestamp());
+                sendTime = sendResponseUp(origRequest, Command::GetXResp, &responseEvent->getSharedPayload(), true, cacheLine->getTimestamp());
             } else { // Default shared response
                 cacheLine->addSharer(origRequest->getSrc());
-                sendTime = sendResponseUp(origRequest, &responseEvent->getPayload(), true, cacheLine->getTimestamp());
+                sendTime = sendResponseUp(origRequest, &responseEvent->getSharedPayload(), true, cacheLine->getTimestamp());
             }
 
             cacheLine->setTimestamp(sendTime);
@@ -1532,7 +1532,7 @@ CacheAction MESIController::handleDataResponse(MemEvent* responseEvent, CacheLin
             
             return DONE;
         case IM:
-            cacheLine->setData(responseEvent->getPayload(), 0);
+            cacheLine->setData(responseEvent->getSharedPayload(), 0);
             
             if (is_debug_event(responseEvent)) printData(cacheLine->getData(), true);
         case SM:
@@ -1568,7 +1568,7 @@ CacheAction MESIController::handleFetchResp(MemEvent * responseEvent, CacheLine*
     CacheAction action = (mshr_->getAcksNeeded(responseEvent->getBaseAddr()) == 0) ? DONE : IGNORE;
 
     // Update data
-    if (state != I) cacheLine->setData(responseEvent->getPayload(), 0);
+    if (state != I) cacheLine->setData(responseEvent->getSharedPayload(), 0);
     
     if (state != I && (is_debug_event(responseEvent))) printData(cacheLine->getData(), true);
 
@@ -1607,7 +1607,7 @@ CacheAction MESIController::handleFetchResp(MemEvent * responseEvent, CacheLine*
             } else if (reqEvent->getCmd() == Command::FlushLine) {
                 if (responseEvent->getDirty()) {
                     cacheLine->setState(M);
-                    cacheLine->setData(responseEvent->getPayload(), 0);
+                    cacheLine->setData(responseEvent->getSharedPayload(), 0);
                 } else {
                     cacheLine->setState(E);
                 }
@@ -1615,7 +1615,7 @@ CacheAction MESIController::handleFetchResp(MemEvent * responseEvent, CacheLine*
                 break;
             } else if (reqEvent->getCmd() == Command::FetchInv) {    // Raced with FlushLine
                 if (responseEvent->getDirty()) {
-                    cacheLine->setData(responseEvent->getPayload(), 0);
+                    cacheLine->setData(responseEvent->getSharedPayload(), 0);
                 }
                 if (cacheLine->numSharers() > 0) {
                     invalidateAllSharers(cacheLine, reqEvent->getRqstr(), true);
@@ -1630,7 +1630,7 @@ CacheAction MESIController::handleFetchResp(MemEvent * responseEvent, CacheLine*
                 cacheLine->addSharer(reqEvent->getSrc());
                 if (responseEvent->getDirty()) {
                     cacheLine->setState(M);
-                    cacheLine->setData(responseEvent->getPayload(), 0);
+                    cacheLine->setData(responseEvent->getSharedPayload(), 0);
                 } else cacheLine->setState(E);
                 sendTime = sendResponseUp(reqEvent, cacheLine->getData(), true, cacheLine->getTimestamp());
                 cacheLine->setTimestamp(sendTime);
@@ -1643,7 +1643,7 @@ CacheAction MESIController::handleFetchResp(MemEvent * responseEvent, CacheLine*
                 if (cacheLine->getOwner() == responseEvent->getSrc()) cacheLine->clearOwner();
                 if (responseEvent->getDirty()) {
                     cacheLine->setState(M);
-                    cacheLine->setData(responseEvent->getPayload(), 0);
+                    cacheLine->setData(responseEvent->getSharedPayload(), 0);
                 } else cacheLine->setState(E);
                 if (action != DONE) { // Sanity check...
                     debug->fatal(CALL_INFO, -1, "%s, Error: Received a FetchResp to a FlushLineInv but still waiting on more acks. Event = %s. Time = %" PRIu64 "ns\n",
@@ -1666,7 +1666,7 @@ CacheAction MESIController::handleFetchResp(MemEvent * responseEvent, CacheLine*
             } else if (reqEvent->getCmd() == Command::FlushLine) {
                 if (responseEvent->getDirty()) {
                     cacheLine->setState(M);
-                    cacheLine->setData(responseEvent->getPayload(), 0);
+                    cacheLine->setData(responseEvent->getSharedPayload(), 0);
                 } else {
                     cacheLine->setState(E);
                 }
@@ -1674,7 +1674,7 @@ CacheAction MESIController::handleFetchResp(MemEvent * responseEvent, CacheLine*
                 break;
             } else if (reqEvent->getCmd() == Command::FetchInv) {
                 if (responseEvent->getDirty()) {
-                    cacheLine->setData(responseEvent->getPayload(), 0);
+                    cacheLine->setData(responseEvent->getSharedPayload(), 0);
                 }
                 if (cacheLine->numSharers() > 0) {
                     invalidateAllSharers(cacheLine, reqEvent->getRqstr(), true);
@@ -1696,7 +1696,7 @@ CacheAction MESIController::handleFetchResp(MemEvent * responseEvent, CacheLine*
             cacheLine->clearOwner();
             if (reqEvent->getCmd() == Command::FlushLineInv) {
                 if (cacheLine->getOwner() == responseEvent->getSrc()) cacheLine->clearOwner();
-                if (responseEvent->getDirty()) cacheLine->setData(responseEvent->getPayload(), 0);
+                if (responseEvent->getDirty()) cacheLine->setData(responseEvent->getSharedPayload(), 0);
                 cacheLine->setState(M);
                 if (action != DONE) { // Sanity check...
                     debug->fatal(CALL_INFO, -1, "%s, Error: Received a FetchResp to a FlushLineInv but still waiting on more acks. Event = %s. Time = %" PRIu64 "ns\n",
@@ -1888,11 +1888,11 @@ CacheAction MESIController::handleAckInv(MemEvent * ack, CacheLine * line, MemEv
  *  Send an Inv to all sharers of the block. Used for evictions or Inv/FetchInv requests from lower level caches
  */
 void MESIController::invalidateAllSharers(CacheLine * cacheLine, string rqstr, bool replay) {
-    set<std::string> * sharers = cacheLine->getSharers();
     uint64_t deliveryTime = 0;
-    for (set<std::string>::iterator it = sharers->begin(); it != sharers->end(); it++) {
+    for (int id = cacheLine->firstSharer(); id != -1; id = cacheLine->nextSharer(id)) {
+        const std::string &sharer = cacheLine->getSharerName(id);
         MemEvent * inv = new MemEvent(parent, cacheLine->getBaseAddr(), cacheLine->getBaseAddr(), Command::Inv);
-        inv->setDst(*it);
+        inv->setDst(sharer);
         inv->setRqstr(rqstr);
         inv->setSize(cacheLine->getSize());
     
@@ -1905,7 +1905,7 @@ void MESIController::invalidateAllSharers(CacheLine * cacheLine, string rqstr, b
 
         if (is_debug_addr(cacheLine->getBaseAddr())) {
             debug->debug(_L7_,"Sending inv: Addr = 0x%" PRIx64 ", Dst = %s @ cycles = %" PRIu64 ".\n", 
-                    cacheLine->getBaseAddr(), (*it).c_str(), deliveryTime);
+                    cacheLine->getBaseAddr(), sharer.c_str(), deliveryTime);
         }
     }
     if (deliveryTime != 0) cacheLine->setTimestamp(deliveryTime);
@@ -1918,13 +1918,13 @@ void MESIController::invalidateAllSharers(CacheLine * cacheLine, string rqstr, b
  */
 bool MESIController::invalidateSharersExceptRequestor(CacheLine * cacheLine, string rqstr, string origRqstr, bool replay) {
     bool sentInv = false;
-    set<std::string> * sharers = cacheLine->getSharers();
     uint64_t deliveryTime = 0;
-    for (set<std::string>::iterator it = sharers->begin(); it != sharers->end(); it++) {
-        if (*it == rqstr) continue;
+    for (int id = cacheLine->firstSharer(); id != -1; id = cacheLine->nextSharer(id)) {
+        const std::string &sharer = cacheLine->getSharerName(id);
+        if (sharer == rqstr) continue;
 
         MemEvent * inv = new MemEvent(parent, cacheLine->getBaseAddr(), cacheLine->getBaseAddr(), Command::Inv);
-        inv->setDst(*it);
+        inv->setDst(sharer);
         inv->setRqstr(origRqstr);
         inv->setSize(cacheLine->getSize());
 
@@ -1938,7 +1938,7 @@ bool MESIController::invalidateSharersExceptRequestor(CacheLine * cacheLine, str
         
         if (is_debug_addr(cacheLine->getBaseAddr())) {
             debug->debug(_L7_,"Sending inv: Addr = 0x%" PRIx64 ", Dst = %s @ cycles = %" PRIu64 ".\n", 
-                    cacheLine->getBaseAddr(), (*it).c_str(), deliveryTime);
+                    cacheLine->getBaseAddr(), sharer.c_str(), deliveryTime);
         }
     }
     if (deliveryTime != 0) cacheLine->setTimestamp(deliveryTime);
@@ -2060,7 +2060,7 @@ void MESIController::sendResponseDown(MemEvent* event, CacheLine* cacheLine, boo
  */
 void MESIController::sendResponseDownFromMSHR(MemEvent * respEvent, MemEvent * reqEvent, bool dirty) {
     MemEvent * newResponseEvent = reqEvent->makeResponse();
-    newResponseEvent->setPayload(respEvent->getPayload());
+    newResponseEvent->setPayload(respEvent->getSharedPayload());
     newResponseEvent->setSize(respEvent->getSize());
     newResponseEvent->setDirty(dirty);
 
@@ -2204,7 +2204,7 @@ void MESIController::addToOutgoingQueueUp(Response& resp) {
 
 
 /** Print value of data blocks for debugging */
-void MESIController::printData(vector<uint8_t> * data, bool set) {
+void MESIController::printData(const SharedPayload* data, bool set) {
 /*    if (set)    printf("Setting data (%zu): 0x", data->size());
     else        printf("Getting data (%zu): 0x", data->size());
     
@@ -787,7 +787,7 @@ private:
 
 /* Helper methods */
    
-    void printData(vector<uint8_t> * data, bool set);
+    void printData(const SharedPayload* data, bool set);
 
 /* Statistics */
     void recordStateEventCount(Command cmd, State state);
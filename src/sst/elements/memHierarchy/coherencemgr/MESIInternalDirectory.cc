@@ -62,7 +62,7 @@ CacheAction MESIInternalDirectory::handleEviction(CacheLine* replacementLine, st
         if (state == E && waitingEvent->getDirty()) replacementLine->setState(M);
         if (replacementLine->isSharer(waitingEvent->getSrc())) replacementLine->removeSharer(waitingEvent->getSrc());
         else if (replacementLine->ownerExists()) replacementLine->clearOwner();
-        mshr_->setDataBuffer(waitingEvent->getBaseAddr(), waitingEvent->getPayload());
+        mshr_->setDataBuffer(waitingEvent->getBaseAddr(), waitingEvent->getSharedPayload());
         mshr_->removeFront(waitingEvent->getBaseAddr());
         delete waitingEvent;
     }
@@ -463,7 +463,7 @@ CacheAction MESIInternalDirectory::handleGetXRequest(MemEvent* event, CacheLine*
     switch (state) {
         case I:
             notifyListenerOfAccess(event, NotifyAccessType::WRITE, NotifyResultType::MISS);
-            sendTime = forwardMessage(event, dirLine->getBaseAddr(), lineSize_, 0, &event->getPayload());
+            sendTime = forwardMessage(event, dirLine->getBaseAddr(), lineSize_, 0, &event->getSharedPayload());
             dirLine->setState(IM);
             dirLine->setTimestamp(sendTime);
             return STALL;
@@ -473,7 +473,7 @@ CacheAction MESIInternalDirectory::handleGetXRequest(MemEvent* event, CacheLine*
                 dirLine->setPrefetch(false);
                 statPrefetchUpgradeMiss->addData(1);
             }
-            sendTime = forwardMessage(event, dirLine->getBaseAddr(), lineSize_, dirLine->getTimestamp(), &event->getPayload());
+            sendTime = forwardMessage(event, dirLine->getBaseAddr(), lineSize_, dirLine->getTimestamp(), &event->getSharedPayload());
             if (invalidateSharersExceptRequestor(dirLine, event->getSrc(), event->getRqstr(), replay, false)) {
                 dirLine->setState(SM_Inv);
             } else {
@@ -525,7 +525,7 @@ CacheAction MESIInternalDirectory::handlePutSRequest(MemEvent * event, CacheLine
     recordStateEventCount(event->getCmd(), state);
 
     if (state == S_D || state == E_D || state == SM_D || state == M_D) {
-        if (*(dirLine->getSharers()->begin()) == event->getSrc()) {    // Put raced with Fetch
+        if (dirLine->getSharerName(dirLine->firstSharer()) == event->getSrc()) {    // Put raced with Fetch
             mshr_->decrementAcksNeeded(event->getBaseAddr());
         }
     } else if (mshr_->getAcksNeeded(event->getBaseAddr()) > 0) mshr_->decrementAcksNeeded(event->getBaseAddr());
@@ -535,9 +535,9 @@ CacheAction MESIInternalDirectory::handlePutSRequest(MemEvent * event, CacheLine
     }
     // Set data, either to cache or to MSHR
     if (dirLine->getDataLine() != NULL) {
-        dirLine->getDataLine()->setData(event->getPayload(), 0);
+        dirLine->getDataLine()->setData(event->getSharedPayload(), 0);
         printData(dirLine->getDataLine()->getData(), true);
-    } else if (mshr_->isHit(dirLine->getBaseAddr())) mshr_->setDataBuffer(dirLine->getBaseAddr(), event->getPayload());
+    } else if (mshr_->isHit(dirLine->getBaseAddr())) mshr_->setDataBuffer(dirLine->getBaseAddr(), event->getSharedPayload());
     
     uint64_t sendTime = 0;
 
@@ -552,17 +552,17 @@ CacheAction MESIInternalDirectory::handlePutSRequest(MemEvent * event, CacheLine
             sendWritebackAck(event);
             return DONE;
         case SI:
-            sendWritebackFromMSHR(Command::PutS, dirLine, reqEvent->getRqstr(), &event->getPayload());
+            sendWritebackFromMSHR(Command::PutS, dirLine, reqEvent->getRqstr(), &event->getSharedPayload());
             if (expectWritebackAck_) mshr_->insertWriteback(event->getBaseAddr());
             dirLine->setState(I);
             return DONE;
         case EI:
-            sendWritebackFromMSHR(Command::PutE, dirLine, reqEvent->getRqstr(), &event->getPayload());
+            sendWritebackFromMSHR(Command::PutE, dirLine, reqEvent->getRqstr(), &event->getSharedPayload());
             if (expectWritebackAck_) mshr_->insertWriteback(event->getBaseAddr());
             dirLine->setState(I);
             return DONE;
         case MI:
-            sendWritebackFromMSHR(Command::PutM, dirLine, reqEvent->getRqstr(), &event->getPayload());
+            sendWritebackFromMSHR(Command::PutM, dirLine, reqEvent->getRqstr(), &event->getSharedPayload());
             if (expectWritebackAck_) mshr_->insertWriteback(event->getBaseAddr());
             dirLine->setState(I);
             return DONE;
@@ -582,7 +582,7 @@ CacheAction MESIInternalDirectory::handlePutSRequest(MemEvent * event, CacheLine
             dirLine->setState(S);
             if (reqEvent->getCmd() == Command::Fetch) {
                 if (dirLine->getDataLine() == NULL && dirLine->numSharers() == 0) {
-                    sendWritebackFromMSHR(Command::PutS, dirLine, reqEvent->getRqstr(), &event->getPayload());
+                    sendWritebackFromMSHR(Command::PutS, dirLine, reqEvent->getRqstr(), &event->getSharedPayload());
                     dirLine->setState(I);
                 } else {
                     sendResponseDownFromMSHR(event, false);
@@ -590,9 +590,9 @@ CacheAction MESIInternalDirectory::handlePutSRequest(MemEvent * event, CacheLine
             } else if (reqEvent->getCmd() == Command::GetS) {    // GetS
                 notifyListenerOfAccess(reqEvent, NotifyAccessType::READ, NotifyResultType::HIT);
                 dirLine->addSharer(reqEvent->getSrc());
-                sendTime = sendResponseUp(reqEvent, &event->getPayload(), true, dirLine->getTimestamp());
+                sendTime = sendResponseUp(reqEvent, &event->getSharedPayload(), true, dirLine->getTimestamp());
                 dirLine->setTimestamp(sendTime);
-                if (is_debug_event(event)) printData(&event->getPayload(), false);
+                if (is_debug_event(event)) printData(&event->getSharedPayload(), false);
             } else {
                 debug->fatal(CALL_INFO, -1, "%s (dir), Error: Received PutS in state %s but stalled request has command %s. Addr = 0x%" PRIx64 ". Time = %" PRIu64 "ns\n",
                         parent->getName().c_str(), StateString[state], CommandString[(int)reqEvent->getCmd()], event->getBaseAddr(), getCurrentSimTimeNano());
@@ -600,7 +600,7 @@ CacheAction MESIInternalDirectory::handlePutSRequest(MemEvent * event, CacheLine
             return DONE;
         case E_Inv:
             if (reqEvent->getCmd() == Command::FetchInv) {
-                sendResponseDown(reqEvent, dirLine, &event->getPayload(), event->getDirty(), true);
+                sendResponseDown(reqEvent, dirLine, &event->getSharedPayload(), event->getDirty(), true);
                 dirLine->setState(I);
             }
             return DONE;
@@ -608,7 +608,7 @@ CacheAction MESIInternalDirectory::handlePutSRequest(MemEvent * event, CacheLine
             dirLine->setState(E);
             if (reqEvent->getCmd() == Command::Fetch) {
                 if (dirLine->getDataLine() == NULL && dirLine->numSharers() == 0) {
-                    sendWritebackFromMSHR(Command::PutE, dirLine, reqEvent->getRqstr(), &event->getPayload());
+                    sendWritebackFromMSHR(Command::PutE, dirLine, reqEvent->getRqstr(), &event->getSharedPayload());
                     dirLine->setState(I);
                 } else {
                     sendResponseDownFromMSHR(event, false);
@@ -617,14 +617,14 @@ CacheAction MESIInternalDirectory::handlePutSRequest(MemEvent * event, CacheLine
                 notifyListenerOfAccess(reqEvent, NotifyAccessType::READ, NotifyResultType::HIT);
                 if (dirLine->numSharers() == 0) {
                     dirLine->setOwner(reqEvent->getSrc());
-                    sendTime = sendResponseUp(reqEvent, Command::GetXResp, &event->getPayload(), true, dirLine->getTimestamp());
+                    sendTime = sendResponseUp(reqEvent, Command::GetXResp, &event->getSharedPayload(), true, dirLine->getTimestamp());
                     dirLine->setTimestamp(sendTime);
                 } else {
                     dirLine->addSharer(reqEvent->getSrc());
-                    sendTime = sendResponseUp(reqEvent, &event->getPayload(), true, dirLine->getTimestamp());
+                    sendTime = sendResponseUp(reqEvent, &event->getSharedPayload(), true, dirLine->getTimestamp());
                     dirLine->setTimestamp(sendTime);
                 }
-                if (is_debug_event(event)) printData(&event->getPayload(), false);
+                if (is_debug_event(event)) printData(&event->getSharedPayload(), false);
             } else {
                 debug->fatal(CALL_INFO, -1, "%s (dir), Error: Received PutS in state %s but stalled request has command %s. Addr = 0x%" PRIx64 ". Time = %" PRIu64 "ns\n",
                         parent->getName().c_str(), StateString[state], CommandString[(int)reqEvent->getCmd()], event->getBaseAddr(), getCurrentSimTimeNano());
@@ -634,7 +634,7 @@ CacheAction MESIInternalDirectory::handlePutSRequest(MemEvent * event, CacheLine
             dirLine->setState(S);
             if (reqEvent->getCmd() == Command::FetchInvX) {
                 if (dirLine->getDataLine() == NULL && dirLine->numSharers() == 0) {
-                    sendWritebackFromMSHR(Command::PutE, dirLine, reqEvent->getRqstr(), &event->getPayload());
+                    sendWritebackFromMSHR(Command::PutE, dirLine, reqEvent->getRqstr(), &event->getSharedPayload());
                     dirLine->setState(I);
                 } else {
                     sendResponseDownFromMSHR(event, false);
@@ -646,15 +646,15 @@ CacheAction MESIInternalDirectory::handlePutSRequest(MemEvent * event, CacheLine
             return DONE;
         case M_Inv: // PutS raced with AckInv from GetX, PutS raced with AckInv from FetchInv
             if (reqEvent->getCmd() == Command::FetchInv) {
-                sendResponseDown(reqEvent, dirLine, &event->getPayload(), true, true);
+                sendResponseDown(reqEvent, dirLine, &event->getSharedPayload(), true, true);
                 dirLine->setState(I);
             } else {
                 notifyListenerOfAccess(reqEvent, NotifyAccessType::WRITE, NotifyResultType::HIT);
                 dirLine->setOwner(reqEvent->getSrc());
                 if (dirLine->isSharer(reqEvent->getSrc())) dirLine->removeSharer(reqEvent->getSrc());
-                sendTime = sendResponseUp(reqEvent, &event->getPayload(), true, dirLine->getTimestamp());
+                sendTime = sendResponseUp(reqEvent, &event->getSharedPayload(), true, dirLine->getTimestamp());
                 dirLine->setTimestamp(sendTime);
-                if (is_debug_event(reqEvent)) printData(&event->getPayload(), false);
+                if (is_debug_event(reqEvent)) printData(&event->getSharedPayload(), false);
                 dirLine->setState(M);
             }
             return DONE;
@@ -662,7 +662,7 @@ CacheAction MESIInternalDirectory::handlePutSRequest(MemEvent * event, CacheLine
             dirLine->setState(M);
             if (reqEvent->getCmd() == Command::Fetch) {
                 if (dirLine->getDataLine() == NULL && dirLine->numSharers() == 0) {
-                    sendWritebackFromMSHR(Command::PutM, dirLine, reqEvent->getRqstr(), &event->getPayload());
+                    sendWritebackFromMSHR(Command::PutM, dirLine, reqEvent->getRqstr(), &event->getSharedPayload());
                     dirLine->setState(I);
                 } else {
                     sendResponseDownFromMSHR(event, false);
@@ -671,14 +671,14 @@ CacheAction MESIInternalDirectory::handlePutSRequest(MemEvent * event, CacheLine
                 notifyListenerOfAccess(reqEvent, NotifyAccessType::READ, NotifyResultType::HIT);
                 if (dirLine->numSharers() == 0) {
                     dirLine->setOwner(reqEvent->getSrc());
-                    sendTime = sendResponseUp(reqEvent, Command::GetXResp, &event->getPayload(), true, dirLine->getTimestamp());
+                    sendTime = sendResponseUp(reqEvent, Command::GetXResp, &event->getSharedPayload(), true, dirLine->getTimestamp());
                     dirLine->setTimestamp(sendTime);
                 } else {
                     dirLine->addSharer(reqEvent->getSrc());
-                    sendTime = sendResponseUp(reqEvent, &event->getPayload(), true, dirLine->getTimestamp());
+                    sendTime = sendResponseUp(reqEvent, &event->getSharedPayload(), true, dirLine->getTimestamp());
                     dirLine->setTimestamp(sendTime);
                 }
-                if (is_debug_event(event)) printData(&event->getPayload(), false);
+                if (is_debug_event(event)) printData(&event->getSharedPayload(), false);
             } else {
                 debug->fatal(CALL_INFO, -1, "%s (dir), Error: Received PutS in state %s but stalled request has command %s. Addr = 0x%" PRIx64 ". Time = %" PRIu64 "ns\n",
                         parent->getName().c_str(), StateString[state], CommandString[(int)reqEvent->getCmd()], event->getBaseAddr(), getCurrentSimTimeNano());
@@ -725,8 +725,8 @@ CacheAction MESIInternalDirectory::handlePutMRequest(MemEvent * event, CacheLine
     recordStateEventCount(event->getCmd(), state);
 
     bool isCached = dirLine->getDataLine() != NULL;
-    if (isCached) dirLine->getDataLine()->setData(event->getPayload(), 0);
-    else if (mshr_->isHit(dirLine->getBaseAddr())) mshr_->setDataBuffer(dirLine->getBaseAddr(), event->getPayload());
+    if (isCached) dirLine->getDataLine()->setData(event->getSharedPayload(), 0);
+    else if (mshr_->isHit(dirLine->getBaseAddr())) mshr_->setDataBuffer(dirLine->getBaseAddr(), event->getSharedPayload());
 
     if (mshr_->getAcksNeeded(event->getBaseAddr()) > 0) mshr_->decrementAcksNeeded(event->getBaseAddr());
 
@@ -739,7 +739,7 @@ CacheAction MESIInternalDirectory::handlePutMRequest(MemEvent * event, CacheLine
             dirLine->clearOwner();
             sendWritebackAck(event);
             if (!isCached) {
-                sendWritebackFromMSHR(((dirLine->getState() == E) ? Command::PutE : Command::PutM), dirLine, event->getRqstr(), &event->getPayload());
+                sendWritebackFromMSHR(((dirLine->getState() == E) ? Command::PutE : Command::PutM), dirLine, event->getRqstr(), &event->getSharedPayload());
                 if (expectWritebackAck_) mshr_->insertWriteback(dirLine->getBaseAddr());
                 dirLine->setState(I);
             }
@@ -748,7 +748,7 @@ CacheAction MESIInternalDirectory::handlePutMRequest(MemEvent * event, CacheLine
             if (event->getDirty()) dirLine->setState(MI);
         case MI:
             dirLine->clearOwner();
-            sendWritebackFromMSHR(((dirLine->getState() == EI) ? Command::PutE : Command::PutM), dirLine, parent->getName(), &event->getPayload());
+            sendWritebackFromMSHR(((dirLine->getState() == EI) ? Command::PutE : Command::PutM), dirLine, parent->getName(), &event->getSharedPayload());
             if (expectWritebackAck_) mshr_->insertWriteback(dirLine->getBaseAddr());
             dirLine->setState(I);
             break;
@@ -756,7 +756,7 @@ CacheAction MESIInternalDirectory::handlePutMRequest(MemEvent * event, CacheLine
             dirLine->clearOwner();
             if (reqEvent->getCmd() == Command::FetchInvX) {
                 if (!isCached) {
-                    sendWritebackFromMSHR(event->getDirty() ? Command::PutM : Command::PutE, dirLine, event->getRqstr(), &event->getPayload());
+                    sendWritebackFromMSHR(event->getDirty() ? Command::PutM : Command::PutE, dirLine, event->getRqstr(), &event->getSharedPayload());
                     dirLine->setState(I);
                     if (expectWritebackAck_) mshr_->insertWriteback(event->getBaseAddr());
                 } else {
@@ -766,15 +766,15 @@ CacheAction MESIInternalDirectory::handlePutMRequest(MemEvent * event, CacheLine
             } else {
                 notifyListenerOfAccess(reqEvent, NotifyAccessType::READ, NotifyResultType::HIT);
                 if (protocol_) {
-                    sendTime = sendResponseUp(reqEvent, Command::GetXResp, &event->getPayload(), true, dirLine->getTimestamp());
+                    sendTime = sendResponseUp(reqEvent, Command::GetXResp, &event->getSharedPayload(), true, dirLine->getTimestamp());
                     dirLine->setTimestamp(sendTime);
                     dirLine->setOwner(reqEvent->getSrc());
                 } else {
-                    sendTime = sendResponseUp(reqEvent, &event->getPayload(), true, dirLine->getTimestamp());
+                    sendTime = sendResponseUp(reqEvent, &event->getSharedPayload(), true, dirLine->getTimestamp());
                     dirLine->setTimestamp(sendTime);
                     dirLine->addSharer(reqEvent->getSrc());
                 }
-                if (is_debug_event(event)) printData(&event->getPayload(), false);
+                if (is_debug_event(event)) printData(&event->getSharedPayload(), false);
                 if (event->getDirty()) dirLine->setState(M);
                 else dirLine->setState(E);
             }
@@ -783,7 +783,7 @@ CacheAction MESIInternalDirectory::handlePutMRequest(MemEvent * event, CacheLine
             dirLine->clearOwner();
             if (reqEvent->getCmd() == Command::FetchInvX) {
                 if (!isCached) {
-                    sendWritebackFromMSHR(Command::PutM, dirLine, event->getRqstr(), &event->getPayload());
+                    sendWritebackFromMSHR(Command::PutM, dirLine, event->getRqstr(), &event->getSharedPayload());
                     dirLine->setState(I);
                     if (expectWritebackAck_) mshr_->insertWriteback(event->getBaseAddr());
                 } else {
@@ -794,15 +794,15 @@ CacheAction MESIInternalDirectory::handlePutMRequest(MemEvent * event, CacheLine
                 notifyListenerOfAccess(reqEvent, NotifyAccessType::READ, NotifyResultType::HIT);
                 dirLine->setState(M);
                 if (protocol_) {
-                    sendTime = sendResponseUp(reqEvent, Command::GetXResp, &event->getPayload(), true, dirLine->getTimestamp());
+                    sendTime = sendResponseUp(reqEvent, Command::GetXResp, &event->getSharedPayload(), true, dirLine->getTimestamp());
                     dirLine->setTimestamp(sendTime);
                     dirLine->setOwner(reqEvent->getSrc());
                 } else {
-                    sendTime = sendResponseUp(reqEvent, &event->getPayload(), true, dirLine->getTimestamp());
+                    sendTime = sendResponseUp(reqEvent, &event->getSharedPayload(), true, dirLine->getTimestamp());
                     dirLine->setTimestamp(sendTime);
                     dirLine->addSharer(reqEvent->getSrc());
                 }
-                if (is_debug_event(event)) printData(&event->getPayload(), false);
+                if (is_debug_event(event)) printData(&event->getSharedPayload(), false);
             }
             return DONE;
         case E_Inv:
@@ -812,10 +812,10 @@ CacheAction MESIInternalDirectory::handlePutMRequest(MemEvent * event, CacheLine
             if (reqEvent->getCmd() == Command::GetX || reqEvent->getCmd() == Command::GetSX) {
                 notifyListenerOfAccess(reqEvent, NotifyAccessType::WRITE, NotifyResultType::HIT);
                 dirLine->setState(M);
-                sendTime = sendResponseUp(reqEvent, &event->getPayload(), true, dirLine->getTimestamp());
+                sendTime = sendResponseUp(reqEvent, &event->getSharedPayload(), true, dirLine->getTimestamp());
                 dirLine->setTimestamp(sendTime);
                 dirLine->setOwner(reqEvent->getSrc());
-                if (is_debug_event(event)) printData(&event->getPayload(), false);
+                if (is_debug_event(event)) printData(&event->getSharedPayload(), false);
             } else { /* Cmd == Fetch */
                 sendResponseDownFromMSHR(event, (dirLine->getState() == M_Inv));
                 dirLine->setState(I);
@@ -836,8 +836,8 @@ CacheAction MESIInternalDirectory::handleFlushLineRequest(MemEvent * event, Cach
 
     bool isCached = dirLine && dirLine->getDataLine() != NULL;
     if (event->getPayloadSize() != 0) {
-        if (isCached) dirLine->getDataLine()->setData(event->getPayload(), 0);
-        else if (mshr_->isHit(event->getBaseAddr())) mshr_->setDataBuffer(event->getBaseAddr(), event->getPayload());
+        if (isCached) dirLine->getDataLine()->setData(event->getSharedPayload(), 0);
+        else if (mshr_->isHit(event->getBaseAddr())) mshr_->setDataBuffer(event->getBaseAddr(), event->getSharedPayload());
     }
 
     CacheAction reqEventAction; // What to do with the reqEvent
@@ -949,8 +949,8 @@ CacheAction MESIInternalDirectory::handleFlushLineInvRequest(MemEvent * event, C
 
     bool isCached = dirLine && dirLine->getDataLine() != NULL;
     if (event->getPayloadSize() != 0) {
-        if (isCached) dirLine->getDataLine()->setData(event->getPayload(), 0);
-        else if (mshr_->isHit(event->getBaseAddr())) mshr_->setDataBuffer(event->getBaseAddr(), event->getPayload());
+        if (isCached) dirLine->getDataLine()->setData(event->getSharedPayload(), 0);
+        else if (mshr_->isHit(event->getBaseAddr())) mshr_->setDataBuffer(event->getBaseAddr(), event->getSharedPayload());
     }
 
     // Apply incoming flush -> remove if owner
@@ -1009,7 +1009,7 @@ CacheAction MESIInternalDirectory::handleFlushLineInvRequest(MemEvent * event, C
         case SM:
             return STALL; // Wait for the Get* request to finish
         case SM_D:
-            if (*(dirLine->getSharers()->begin()) == event->getSrc()) { // Flush raced with Fetch
+            if (dirLine->getSharerName(dirLine->firstSharer()) == event->getSrc()) { // Flush raced with Fetch
                 mshr_->decrementAcksNeeded(event->getBaseAddr());
             }
             if (mshr_->getAcksNeeded(event->getBaseAddr()) == 0) {
@@ -1024,7 +1024,7 @@ CacheAction MESIInternalDirectory::handleFlushLineInvRequest(MemEvent * event, C
         case S_D:
         case E_D:
         case M_D:
-            if (*(dirLine->getSharers()->begin()) == event->getSrc()) {
+            if (dirLine->getSharerName(dirLine->firstSharer()) == event->getSrc()) {
                 mshr_->decrementAcksNeeded(event->getBaseAddr()); 
             }
             if (dirLine->isSharer(event->getSrc())) {
@@ -1034,9 +1034,9 @@ CacheAction MESIInternalDirectory::handleFlushLineInvRequest(MemEvent * event, C
                 dirLine->setState(NextState[state]);
                 if (reqEvent->getCmd() == Command::Fetch) {
                     if (dirLine->getDataLine() == NULL && dirLine->numSharers() == 0) {
-                        if (state == M_D || event->getDirty()) sendWritebackFromMSHR(Command::PutM, dirLine, reqEvent->getRqstr(), &event->getPayload());
-                        else if (state == E_D) sendWritebackFromMSHR(Command::PutE, dirLine, reqEvent->getRqstr(), &event->getPayload());
-                        else if (state == S_D) sendWritebackFromMSHR(Command::PutS, dirLine, reqEvent->getRqstr(), &event->getPayload());
+                        if (state == M_D || event->getDirty()) sendWritebackFromMSHR(Command::PutM, dirLine, reqEvent->getRqstr(), &event->getSharedPayload());
+                        else if (state == E_D) sendWritebackFromMSHR(Command::PutE, dirLine, reqEvent->getRqstr(), &event->getSharedPayload());
+                        else if (state == S_D) sendWritebackFromMSHR(Command::PutS, dirLine, reqEvent->getRqstr(), &event->getSharedPayload());
                         dirLine->setState(I);
                     } else {
                         sendResponseDownFromMSHR(event, (state == M_D || event->getDirty()) ? true : false);
@@ -1045,14 +1045,14 @@ CacheAction MESIInternalDirectory::handleFlushLineInvRequest(MemEvent * event, C
                     notifyListenerOfAccess(reqEvent, NotifyAccessType::READ, NotifyResultType::HIT);
                     if (dirLine->numSharers() > 0 || state == S_D) {
                         dirLine->addSharer(reqEvent->getSrc());
-                        sendTime = sendResponseUp(reqEvent, &event->getPayload(), true, dirLine->getTimestamp());
+                        sendTime = sendResponseUp(reqEvent, &event->getSharedPayload(), true, dirLine->getTimestamp());
                         dirLine->setTimestamp(sendTime);
                     } else {
                         dirLine->setOwner(reqEvent->getSrc());
-                        sendTime = sendResponseUp(reqEvent, Command::GetXResp, &event->getPayload(), true, dirLine->getTimestamp());
+                        sendTime = sendResponseUp(reqEvent, Command::GetXResp, &event->getSharedPayload(), true, dirLine->getTimestamp());
                         dirLine->setTimestamp(sendTime);
                     }
-                    if (is_debug_event(event)) printData(&event->getPayload(), false);
+                    if (is_debug_event(event)) printData(&event->getSharedPayload(), false);
                 } else {
                     debug->fatal(CALL_INFO, -1, "%s (dir), Error: Received FlushLineInv in state %s but stalled request has command %s. Addr = 0x%" PRIx64 ". Time = %" PRIu64 "ns\n",
                             parent->getName().c_str(), StateString[state], CommandString[(int)reqEvent->getCmd()], event->getBaseAddr(), getCurrentSimTimeNano());
@@ -1158,7 +1158,7 @@ CacheAction MESIInternalDirectory::handleFlushLineInvRequest(MemEvent * event, C
             }
             if (mshr_->getAcksNeeded(event->getBaseAddr()) == 0) {
                 if (reqEvent->getCmd() == Command::FetchInv) {
-                    sendResponseDown(reqEvent, dirLine, &event->getPayload(), true, true);
+                    sendResponseDown(reqEvent, dirLine, &event->getSharedPayload(), true, true);
                     dirLine->setState(I);
                     return DONE;
                 } else if (reqEvent->getCmd() == Command::GetX || reqEvent->getCmd() == Command::GetSX) {
@@ -1184,7 +1184,7 @@ CacheAction MESIInternalDirectory::handleFlushLineInvRequest(MemEvent * event, C
             }
             if (mshr_->getAcksNeeded(event->getBaseAddr()) == 0) {
                 if (reqEvent->getCmd() == Command::FetchInv) {
-                    sendResponseDown(reqEvent, dirLine, &event->getPayload(), event->getDirty(), true);
+                    sendResponseDown(reqEvent, dirLine, &event->getSharedPayload(), event->getDirty(), true);
                     dirLine->setState(I);
                     return DONE;
                 } else if (reqEvent->getCmd() == Command::FlushLineInv) {
@@ -1207,7 +1207,7 @@ CacheAction MESIInternalDirectory::handleFlushLineInvRequest(MemEvent * event, C
             if (mshr_->getAcksNeeded(event->getBaseAddr()) == 0) {
                 if (reqEvent->getCmd() == Command::FetchInvX) {
                     if (!isCached) {
-                        sendWritebackFromMSHR((event->getDirty() || state == M_InvX) ? Command::PutM : Command::PutE, dirLine, event->getRqstr(), &event->getPayload());
+                        sendWritebackFromMSHR((event->getDirty() || state == M_InvX) ? Command::PutM : Command::PutE, dirLine, event->getRqstr(), &event->getSharedPayload());
                         dirLine->setState(I);
                         if (expectWritebackAck_) mshr_->insertWriteback(event->getBaseAddr());
                     } else {
@@ -1217,15 +1217,15 @@ CacheAction MESIInternalDirectory::handleFlushLineInvRequest(MemEvent * event, C
                 } else {
                     notifyListenerOfAccess(reqEvent, NotifyAccessType::READ, NotifyResultType::HIT);
                     if (protocol_) {
-                        sendTime = sendResponseUp(reqEvent, Command::GetXResp, &event->getPayload(), true, dirLine->getTimestamp());
+                        sendTime = sendResponseUp(reqEvent, Command::GetXResp, &event->getSharedPayload(), true, dirLine->getTimestamp());
                         dirLine->setTimestamp(sendTime);
                         dirLine->addSharer(reqEvent->getSrc());
                     } else {
-                        sendTime = sendResponseUp(reqEvent, &event->getPayload(), true, dirLine->getTimestamp());
+                        sendTime = sendResponseUp(reqEvent, &event->getSharedPayload(), true, dirLine->getTimestamp());
                         dirLine->setTimestamp(sendTime);
                         dirLine->addSharer(reqEvent->getSrc());
                     }
-                    if (is_debug_event(event)) printData(&event->getPayload(), false);
+                    if (is_debug_event(event)) printData(&event->getSharedPayload(), false);
                 }
 
                 (state == M_InvX || event->getDirty()) ? dirLine->setState(M) : dirLine->setState(E);
@@ -1430,7 +1430,7 @@ CacheAction MESIInternalDirectory::handleFetch(MemEvent * event, CacheLine * dir
                 return DONE;
             }
             if (collisionEvent != NULL) {
-                sendResponseDown(event, dirLine, &collisionEvent->getPayload(), false, replay);
+                sendResponseDown(event, dirLine, &collisionEvent->getSharedPayload(), false, replay);
                 return DONE;
             }
             sendFetch(dirLine, event->getRqstr(), replay);
@@ -1472,7 +1472,7 @@ CacheAction MESIInternalDirectory::handleFetchInv(MemEvent * event, CacheLine *
         collision = true;
         if (dirLine->isSharer(collisionEvent->getSrc())) dirLine->removeSharer(collisionEvent->getSrc());
         if (dirLine->ownerExists()) dirLine->clearOwner();
-        mshr_->setDataBuffer(collisionEvent->getBaseAddr(), collisionEvent->getPayload());
+        mshr_->setDataBuffer(collisionEvent->getBaseAddr(), collisionEvent->getSharedPayload());
         if (state == E && collisionEvent->getDirty()) dirLine->setState(M);
         state = M;
         sendWritebackAck(collisionEvent);
@@ -1610,7 +1610,7 @@ CacheAction MESIInternalDirectory::handleFetchInvX(MemEvent * event, CacheLine *
                     collisionEvent->setCmd(Command::PutS);   // TODO there's probably a cleaner way to do this...and a safer/better way!
                 }
                 dirLine->setState(S);
-                sendResponseDown(event, dirLine, &collisionEvent->getPayload(), collisionEvent->getDirty(), replay);
+                sendResponseDown(event, dirLine, &collisionEvent->getSharedPayload(), collisionEvent->getDirty(), replay);
                 return DONE;
             }
             if (dirLine->ownerExists()) {
@@ -1637,7 +1637,7 @@ CacheAction MESIInternalDirectory::handleFetchInvX(MemEvent * event, CacheLine *
                     collisionEvent->setCmd(Command::PutS);   // TODO there's probably a cleaner way to do this...and a safer/better way!
                 }
                 dirLine->setState(S);
-                sendResponseDown(event, dirLine, &collisionEvent->getPayload(), true, replay);
+                sendResponseDown(event, dirLine, &collisionEvent->getSharedPayload(), true, replay);
                 return DONE;
             }
             if (dirLine->ownerExists()) {
@@ -1695,34 +1695,34 @@ CacheAction MESIInternalDirectory::handleDataResponse(MemEvent* responseEvent, C
             if (responseEvent->getCmd() == Command::GetXResp && protocol_) dirLine->setState(E);
             else dirLine->setState(S);
             notifyListenerOfAccess(origRequest, NotifyAccessType::READ, NotifyResultType::HIT);
-            if (isCached) dirLine->getDataLine()->setData(responseEvent->getPayload(), 0);
+            if (isCached) dirLine->getDataLine()->setData(responseEvent->getSharedPayload(), 0);
             if (localPrefetch) {
                 dirLine->setPrefetch(true);
                 return DONE;
             }
             if (dirLine->getState() == E) {
                 dirLine->setOwner(origRequest->getSrc());
-                sendTime = sendResponseUp(origRequest, Command::GetXResp, &responseEvent->getPayload(), true, dirLine->getTimestamp());
+                sendTime = sendResponseUp(origRequest, Command::GetXResp, &responseEvent->getSharedPayload(), true, dirLine->getTimestamp());
             } else {
                 dirLine->addSharer(origRequest->getSrc());
-                sendTime = sendResponseUp(origRequest, &responseEvent->getPayload(), true, dirLine->getTimestamp());
+                sendTime = sendResponseUp(origRequest, &responseEvent->getSharedPayload(), true, dirLine->getTimestamp());
             }
             dirLine->setTimestamp(sendTime);
-            if (is_debug_event(responseEvent)) printData(&responseEvent->getPayload(), false);
+            if (is_debug_event(responseEvent)) printData(&responseEvent->getSharedPayload(), false);
             return DONE;
         case IM:
-            if (isCached) dirLine->getDataLine()->setData(responseEvent->getPayload(), 0);
+            if (isCached) dirLine->getDataLine()->setData(responseEvent->getSharedPayload(), 0);
         case SM:
             dirLine->setState(M);
             dirLine->setOwner(origRequest->getSrc());
             if (dirLine->isSharer(origRequest->getSrc())) dirLine->removeSharer(origRequest->getSrc());
             notifyListenerOfAccess(origRequest, NotifyAccessType::WRITE, NotifyResultType::HIT);
-            sendTime = sendResponseUp(origRequest, (isCached ? dirLine->getDataLine()->getData() : &responseEvent->getPayload()), true, dirLine->getTimestamp());
+            sendTime = sendResponseUp(origRequest, (isCached ? dirLine->getDataLine()->getData() : &responseEvent->getSharedPayload()), true, dirLine->getTimestamp());
             dirLine->setTimestamp(sendTime);
-            if (is_debug_event(responseEvent)) printData(&responseEvent->getPayload(), false);
+            if (is_debug_event(responseEvent)) printData(&responseEvent->getSharedPayload(), false);
             return DONE;
         case SM_Inv:
-            mshr_->setDataBuffer(responseEvent->getBaseAddr(), responseEvent->getPayload());  // TODO this might be a problem if we try to use it
+            mshr_->setDataBuffer(responseEvent->getBaseAddr(), responseEvent->getSharedPayload());  // TODO this might be a problem if we try to use it
             dirLine->setState(M_Inv);
             return STALL;
         default:
@@ -1742,7 +1742,7 @@ CacheAction MESIInternalDirectory::handleFetchResp(MemEvent * responseEvent, Cac
     CacheAction action = (mshr_->getAcksNeeded(responseEvent->getBaseAddr()) == 0) ? DONE : IGNORE;
     
     bool isCached = dirLine->getDataLine() != NULL;
-    if (isCached) dirLine->getDataLine()->setData(responseEvent->getPayload(), 0);    // Update local data if needed
+    if (isCached) dirLine->getDataLine()->setData(responseEvent->getSharedPayload(), 0);    // Update local data if needed
     recordStateEventCount(responseEvent->getCmd(), state);
     
     uint64_t sendTime = 0; 
@@ -1760,9 +1760,9 @@ CacheAction MESIInternalDirectory::handleFetchResp(MemEvent * responseEvent, Cac
             } else if (reqEvent->getCmd() == Command::GetS) {    // GetS
                 notifyListenerOfAccess(reqEvent, NotifyAccessType::READ, NotifyResultType::HIT);
                 dirLine->addSharer(reqEvent->getSrc());
-                sendTime = sendResponseUp(reqEvent, &responseEvent->getPayload(), true, dirLine->getTimestamp());
+                sendTime = sendResponseUp(reqEvent, &responseEvent->getSharedPayload(), true, dirLine->getTimestamp());
                 dirLine->setTimestamp(sendTime);
-                if (is_debug_event(responseEvent)) printData(&responseEvent->getPayload(), false);
+                if (is_debug_event(responseEvent)) printData(&responseEvent->getSharedPayload(), false);
             } else {
                 debug->fatal(CALL_INFO, -1, "%s (dir), Error: Received FetchResp in state %s but stalled request has command %s. Addr = 0x%" PRIx64 ". Time = %" PRIu64 "ns\n",
                         parent->getName().c_str(), StateString[state], CommandString[(int)reqEvent->getCmd()], responseEvent->getBaseAddr(), getCurrentSimTimeNano());
@@ -1770,9 +1770,9 @@ CacheAction MESIInternalDirectory::handleFetchResp(MemEvent * responseEvent, Cac
             break;
         case SI:
             dirLine->removeSharer(responseEvent->getSrc());
-            mshr_->setDataBuffer(responseEvent->getBaseAddr(), responseEvent->getPayload());
+            mshr_->setDataBuffer(responseEvent->getBaseAddr(), responseEvent->getSharedPayload());
             if (action == DONE) {
-                sendWritebackFromMSHR(Command::PutS, dirLine, reqEvent->getRqstr(), &responseEvent->getPayload());
+                sendWritebackFromMSHR(Command::PutS, dirLine, reqEvent->getRqstr(), &responseEvent->getSharedPayload());
                 if (expectWritebackAck_) mshr_->insertWriteback(dirLine->getBaseAddr());
                 dirLine->setState(I);
             }
@@ -1783,7 +1783,7 @@ CacheAction MESIInternalDirectory::handleFetchResp(MemEvent * responseEvent, Cac
             if (dirLine->getOwner() == responseEvent->getSrc()) dirLine->clearOwner();
             if (dirLine->isSharer(responseEvent->getSrc())) dirLine->removeSharer(responseEvent->getSrc());
             if (action == DONE) {
-                sendWritebackFromMSHR(((dirLine->getState() == EI) ? Command::PutE : Command::PutM), dirLine, parent->getName(), &responseEvent->getPayload());
+                sendWritebackFromMSHR(((dirLine->getState() == EI) ? Command::PutE : Command::PutM), dirLine, parent->getName(), &responseEvent->getSharedPayload());
                 if (expectWritebackAck_) mshr_->insertWriteback(dirLine->getBaseAddr());
                 dirLine->setState(I);
             }
@@ -1794,7 +1794,7 @@ CacheAction MESIInternalDirectory::handleFetchResp(MemEvent * responseEvent, Cac
                 dirLine->clearOwner();
                 dirLine->addSharer(responseEvent->getSrc());
             }
-            if (!isCached) mshr_->setDataBuffer(responseEvent->getBaseAddr(), responseEvent->getPayload());
+            if (!isCached) mshr_->setDataBuffer(responseEvent->getBaseAddr(), responseEvent->getSharedPayload());
             if (reqEvent->getCmd() == Command::FetchInvX) {
                 sendResponseDownFromMSHR(responseEvent, (state == M_InvX || responseEvent->getDirty()));
                 dirLine->setState(S);
@@ -1812,9 +1812,9 @@ CacheAction MESIInternalDirectory::handleFetchResp(MemEvent * responseEvent, Cac
             } else {
                 notifyListenerOfAccess(reqEvent, NotifyAccessType::READ, NotifyResultType::HIT);
                 dirLine->addSharer(reqEvent->getSrc());
-                sendTime = sendResponseUp(reqEvent, &responseEvent->getPayload(), true, dirLine->getTimestamp());
+                sendTime = sendResponseUp(reqEvent, &responseEvent->getSharedPayload(), true, dirLine->getTimestamp());
                 dirLine->setTimestamp(sendTime);
-                if (is_debug_event(responseEvent)) printData(&responseEvent->getPayload(), false);
+                if (is_debug_event(responseEvent)) printData(&responseEvent->getSharedPayload(), false);
                 if (responseEvent->getDirty() || state == M_InvX) dirLine->setState(M);
                 else dirLine->setState(E);
             }
@@ -1825,19 +1825,19 @@ CacheAction MESIInternalDirectory::handleFetchResp(MemEvent * responseEvent, Cac
             if (dirLine->getOwner() == responseEvent->getSrc()) dirLine->clearOwner();
             if (action != DONE) {
                 if (responseEvent->getDirty()) dirLine->setState(M_Inv);
-                mshr_->setDataBuffer(responseEvent->getBaseAddr(), responseEvent->getPayload());
+                mshr_->setDataBuffer(responseEvent->getBaseAddr(), responseEvent->getSharedPayload());
             } else {
                 if (reqEvent->getCmd() == Command::GetX || reqEvent->getCmd() == Command::GetSX) {
                     notifyListenerOfAccess(reqEvent, NotifyAccessType::WRITE, NotifyResultType::HIT);
                     if (dirLine->isSharer(reqEvent->getSrc())) dirLine->removeSharer(reqEvent->getSrc());
                     dirLine->setOwner(reqEvent->getSrc());
-                    sendTime = sendResponseUp(reqEvent, &responseEvent->getPayload(), true, dirLine->getTimestamp());
+                    sendTime = sendResponseUp(reqEvent, &responseEvent->getSharedPayload(), true, dirLine->getTimestamp());
                     dirLine->setTimestamp(sendTime);
                     dirLine->setState(M);
                 } else if (reqEvent->getCmd() == Command::FlushLineInv) {
                     if (responseEvent->getDirty()) {
-                        if (dirLine->getDataLine() != NULL) dirLine->getDataLine()->setData(responseEvent->getPayload(), 0);
-                        else mshr_->setDataBuffer(responseEvent->getBaseAddr(), responseEvent->getPayload());
+                        if (dirLine->getDataLine() != NULL) dirLine->getDataLine()->setData(responseEvent->getSharedPayload(), 0);
+                        else mshr_->setDataBuffer(responseEvent->getBaseAddr(), responseEvent->getSharedPayload());
                     }
                     if (responseEvent->getDirty() || state == M_Inv) dirLine->setState(M);
                     else dirLine->setState(E);
@@ -1856,7 +1856,7 @@ CacheAction MESIInternalDirectory::handleFetchResp(MemEvent * responseEvent, Cac
         case SM_Inv:    // Received a FetchInv in SM state
             if (dirLine->isSharer(responseEvent->getSrc())) dirLine->removeSharer(responseEvent->getSrc());
             if (action != DONE) {
-                mshr_->setDataBuffer(responseEvent->getBaseAddr(), responseEvent->getPayload());
+                mshr_->setDataBuffer(responseEvent->getBaseAddr(), responseEvent->getSharedPayload());
             } else {
                 sendResponseDownFromMSHR(responseEvent, false);
                 (state == S_Inv) ? dirLine->setState(I) : dirLine->setState(IM);
@@ -1883,7 +1883,7 @@ CacheAction MESIInternalDirectory::handleAckInv(MemEvent * ack, CacheLine * dirL
     if (mshr_->getAcksNeeded(ack->getBaseAddr()) > 0) mshr_->decrementAcksNeeded(ack->getBaseAddr());
     CacheAction action = (mshr_->getAcksNeeded(ack->getBaseAddr()) == 0) ? DONE : IGNORE;
     bool isCached = dirLine->getDataLine() != NULL;
-    vector<uint8_t> * data = isCached ? dirLine->getDataLine()->getData() : mshr_->getDataBuffer(reqEvent->getBaseAddr());
+    const SharedPayload* data = isCached ? dirLine->getDataLine()->getData() : mshr_->getDataBuffer(reqEvent->getBaseAddr());
     uint64_t sendTime = 0; 
     switch (state) {
         case S_Inv: // AckInv for Inv
@@ -1979,14 +1979,13 @@ CacheAction MESIInternalDirectory::handleAckInv(MemEvent * ack, CacheLine * dirL
 
 
 void MESIInternalDirectory::invalidateAllSharers(CacheLine * dirLine, string rqstr, bool replay) {
-    set<std::string> * sharers = dirLine->getSharers();
-    
     uint64_t baseTime = (timestamp_ > dirLine->getTimestamp()) ? timestamp_ : dirLine->getTimestamp();
     uint64_t deliveryTime = (replay) ? baseTime + mshrLatency_ : baseTime + tagLatency_;
     bool invSent = false;
-    for (set<std::string>::iterator it = sharers->begin(); it != sharers->end(); it++) {
+    for (int id = dirLine->firstSharer(); id != -1; id = dirLine->nextSharer(id)) {
+        const std::string &sharer = dirLine->getSharerName(id);
         MemEvent * inv = new MemEvent(parent, dirLine->getBaseAddr(), dirLine->getBaseAddr(), Command::Inv);
-        inv->setDst(*it);
+        inv->setDst(sharer);
         inv->setRqstr(rqstr);
     
         Response resp = {inv, deliveryTime, packetHeaderBytes};
@@ -1996,7 +1995,7 @@ void MESIInternalDirectory::invalidateAllSharers(CacheLine * dirLine, string rqs
         invSent = true;
         if (is_debug_addr(dirLine->getBaseAddr())) {
             debug->debug(_L7_,"Sending inv: Addr = 0x%" PRIx64 ", Dst = %s @ cycles = %" PRIu64 ".\n", 
-                dirLine->getBaseAddr(), (*it).c_str(), deliveryTime);
+                dirLine->getBaseAddr(), sharer.c_str(), deliveryTime);
         }
     }
     if (invSent) dirLine->setTimestamp(deliveryTime);
@@ -2004,21 +2003,21 @@ void MESIInternalDirectory::invalidateAllSharers(CacheLine * dirLine, string rqs
 
 
 void MESIInternalDirectory::invalidateAllSharersAndFetch(CacheLine * cacheLine, string rqstr, bool replay) {
-    set<std::string> * sharers = cacheLine->getSharers();
     bool fetched = false;
     
     uint64_t baseTime = (timestamp_ > cacheLine->getTimestamp()) ? timestamp_ : cacheLine->getTimestamp();
     uint64_t deliveryTime = (replay) ? timestamp_ + mshrLatency_ : timestamp_ + tagLatency_;
     bool invSent = false;
 
-    for (set<std::string>::iterator it = sharers->begin(); it != sharers->end(); it++) {
+    for (int id = cacheLine->firstSharer(); id != -1; id = cacheLine->nextSharer(id)) {
+        const std::string &sharer = cacheLine->getSharerName(id);
         MemEvent * inv;
         if (fetched) inv = new MemEvent(parent, cacheLine->getBaseAddr(), cacheLine->getBaseAddr(), Command::Inv);
         else {
             inv = new MemEvent(parent, cacheLine->getBaseAddr(), cacheLine->getBaseAddr(), Command::FetchInv);
             fetched = true;
         }
-        inv->setDst(*it);
+        inv->setDst(sharer);
         inv->setRqstr(rqstr);
         inv->setSize(cacheLine->getSize());
     
@@ -2030,7 +2029,7 @@ void MESIInternalDirectory::invalidateAllSharersAndFetch(CacheLine * cacheLine,
 
         if (is_debug_addr(cacheLine->getBaseAddr())) {
             debug->debug(_L7_,"Sending inv: Addr = 0x%" PRIx64 ", Dst = %s @ cycles = %" PRIu64 ".\n", 
-                cacheLine->getBaseAddr(), (*it).c_str(), deliveryTime);
+                cacheLine->getBaseAddr(), sharer.c_str(), deliveryTime);
         }
     }
     
@@ -2044,14 +2043,14 @@ void MESIInternalDirectory::invalidateAllSharersAndFetch(CacheLine * cacheLine,
  */
 bool MESIInternalDirectory::invalidateSharersExceptRequestor(CacheLine * cacheLine, string rqstr, string origRqstr, bool replay, bool uncached) {
     bool sentInv = false;
-    set<std::string> * sharers = cacheLine->getSharers();
-    bool needFetch = uncached && (sharers->find(rqstr) == sharers->end());
+    bool needFetch = uncached && !cacheLine->isSharer(rqstr);
     
     uint64_t baseTime = (timestamp_ > cacheLine->getTimestamp()) ? timestamp_ : cacheLine->getTimestamp();
     uint64_t deliveryTime = (replay) ? baseTime + mshrLatency_ : baseTime + tagLatency_;
     
-    for (set<std::string>::iterator it = sharers->begin(); it != sharers->end(); it++) {
-        if (*it == rqstr) continue;
+    for (int id = cacheLine->firstSharer(); id != -1; id = cacheLine->nextSharer(id)) {
+        const std::string &sharer = cacheLine->getSharerName(id);
+        if (sharer == rqstr) continue;
         MemEvent * inv;
         if (needFetch) {
             inv = new MemEvent(parent, cacheLine->getBaseAddr(), cacheLine->getBaseAddr(), Command::FetchInv);
@@ -2059,7 +2058,7 @@ bool MESIInternalDirectory::invalidateSharersExceptRequestor(CacheLine * cacheLi
         } else {
             inv = new MemEvent(parent, cacheLine->getBaseAddr(), cacheLine->getBaseAddr(), Command::Inv);
         }
-        inv->setDst(*it);
+        inv->setDst(sharer);
         inv->setRqstr(origRqstr);
         inv->setSize(cacheLine->getSize());
 
@@ -2072,7 +2071,7 @@ bool MESIInternalDirectory::invalidateSharersExceptRequestor(CacheLine * cacheLi
         
         if (is_debug_addr(cacheLine->getBaseAddr())) {
             debug->debug(_L7_,"Sending inv: Addr = 0x%" PRIx64 ", Dst = %s @ cycles = %" PRIu64 ".\n", 
-                cacheLine->getBaseAddr(), (*it).c_str(), deliveryTime);
+                cacheLine->getBaseAddr(), sharer.c_str(), deliveryTime);
         }
     }
     if (sentInv) cacheLine->setTimestamp(deliveryTime);
@@ -2083,7 +2082,7 @@ bool MESIInternalDirectory::invalidateSharersExceptRequestor(CacheLine * cacheLi
 void MESIInternalDirectory::sendFetchInv(CacheLine * cacheLine, string rqstr, bool replay) {
     MemEvent * fetch = new MemEvent(parent, cacheLine->getBaseAddr(), cacheLine->getBaseAddr(), Command::FetchInv);
     if (!(cacheLine->getOwner()).empty()) fetch->setDst(cacheLine->getOwner());
-    else fetch->setDst(*(cacheLine->getSharers()->begin()));
+    else fetch->setDst(cacheLine->getSharerName(cacheLine->firstSharer()));
     fetch->setRqstr(rqstr);
     fetch->setSize(cacheLine->getSize());
     
@@ -2121,7 +2120,7 @@ void MESIInternalDirectory::sendFetchInvX(CacheLine * cacheLine, string rqstr, b
 
 void MESIInternalDirectory::sendFetch(CacheLine * cacheLine, string rqstr, bool replay) {
     MemEvent * fetch = new MemEvent(parent, cacheLine->getBaseAddr(), cacheLine->getBaseAddr(), Command::Fetch);
-    fetch->setDst(*((cacheLine->getSharers())->begin()));
+    fetch->setDst(cacheLine->getSharerName(cacheLine->firstSharer()));
     fetch->setRqstr(rqstr);
     
     uint64_t baseTime = (timestamp_ > cacheLine->getTimestamp()) ? timestamp_ : cacheLine->getTimestamp();
@@ -2160,7 +2159,7 @@ void MESIInternalDirectory::sendForceInv(CacheLine * cacheLine, string rqstr, bo
  *  Handles: responses to fetch invalidates
  *  Latency: cache access to read data for payload  
  */
-void MESIInternalDirectory::sendResponseDown(MemEvent* event, CacheLine * cacheLine, std::vector<uint8_t>* data, bool dirty, bool replay){
+void MESIInternalDirectory::sendResponseDown(MemEvent* event, CacheLine * cacheLine, const SharedPayload* data, bool dirty, bool replay){
     MemEvent *responseEvent = event->makeResponse();
     responseEvent->setPayload(*data);
     if (is_debug_event(event)) printData(data, false);
@@ -2183,7 +2182,7 @@ void MESIInternalDirectory::sendResponseDown(MemEvent* event, CacheLine * cacheL
 void MESIInternalDirectory::sendResponseDownFromMSHR(MemEvent * event, bool dirty) {
     MemEvent * requestEvent = mshr_->lookupFront(event->getBaseAddr());
     MemEvent * responseEvent = requestEvent->makeResponse();
-    responseEvent->setPayload(event->getPayload());
+    responseEvent->setPayload(event->getSharedPayload());
     responseEvent->setSize(event->getSize());
     responseEvent->setDirty(dirty);
 
@@ -2240,7 +2239,7 @@ void MESIInternalDirectory::sendWritebackFromCache(Command cmd, CacheLine * dirL
     if (is_debug_addr(dirLine->getBaseAddr())) debug->debug(_L3_, "Sending writeback at cycle = %" PRIu64 ", Cmd = %s. From cache\n", deliveryTime, CommandString[(int)cmd]);
 }
 
-void MESIInternalDirectory::sendWritebackFromMSHR(Command cmd, CacheLine * dirLine, string rqstr, vector<uint8_t> * data) {
+void MESIInternalDirectory::sendWritebackFromMSHR(Command cmd, CacheLine * dirLine, string rqstr, const SharedPayload* data) {
     MemEvent * writeback = new MemEvent(parent, dirLine->getBaseAddr(), dirLine->getBaseAddr(), cmd);
     writeback->setDst(getDestination(dirLine->getBaseAddr()));
     writeback->setSize(dirLine->getSize());
@@ -2284,7 +2283,7 @@ void MESIInternalDirectory::forwardFlushLine(MemEvent * origFlush, CacheLine * d
     if (dirLine) {
         if (dirLine->getDataLine() != NULL) flush->setPayload(*dirLine->getDataLine()->getData());
         else if (mshr_->isHit(origFlush->getBaseAddr())) flush->setPayload(*mshr_->getDataBuffer(origFlush->getBaseAddr()));
-        else if (origFlush->getPayloadSize() != 0) flush->setPayload(origFlush->getPayload());
+        else if (origFlush->getPayloadSize() != 0) flush->setPayload(origFlush->getSharedPayload());
     }
     uint64_t baseTime = timestamp_;
     if (dirLine && dirLine->getTimestamp() > baseTime) baseTime = dirLine->getTimestamp();
@@ -2317,7 +2316,7 @@ void MESIInternalDirectory::addToOutgoingQueueUp(Response& resp) {
  *--------------------------------------------------------------------------------------------------*/
 
 
-void MESIInternalDirectory::printData(vector<uint8_t> * data, bool set) {
+void MESIInternalDirectory::printData(const SharedPayload* data, bool set) {
 /*    if (set)    printf("Setting data (%zu): 0x", data->size());
     else        printf("Getting data (%zu): 0x", data->size());
     
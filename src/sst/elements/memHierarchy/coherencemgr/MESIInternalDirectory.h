@@ -803,7 +803,7 @@ private:
     CacheAction handleAckInv(MemEvent * responseEvent, CacheLine* dirLine, MemEvent * reqEvent);
 
 /* Private methods for sending events */
-    void sendResponseDown(MemEvent* event, CacheLine* dirLine, std::vector<uint8_t>* data, bool dirty, bool replay);
+    void sendResponseDown(MemEvent* event, CacheLine* dirLine, const SharedPayload* data, bool dirty, bool replay);
    
     /** Send response to lower level cache using 'event' instead of dirLine */
     void sendResponseDownFromMSHR(MemEvent* event, bool dirty);
@@ -815,7 +815,7 @@ private:
     void sendWritebackFromCache(Command cmd, CacheLine* dirLine, string origRqstr);
 
     /** Send writeback request to lower level cache using data from MSHR */
-    void sendWritebackFromMSHR(Command cmd, CacheLine* dirLine, string origRqstr, std::vector<uint8_t>* data);
+    void sendWritebackFromMSHR(Command cmd, CacheLine* dirLine, string origRqstr, const SharedPayload* data);
     
     /** Send writeback ack */
     void sendWritebackAck(MemEvent * event);
@@ -853,7 +853,7 @@ private:
 
 /* Miscellaneous */
    
-    void printData(vector<uint8_t> * data, bool set);
+    void printData(const SharedPayload* data, bool set);
 
 /* Statistics */
     //void recordStateEventCount(Command cmd, State state);
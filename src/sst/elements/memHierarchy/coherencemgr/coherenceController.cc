@@ -115,13 +115,13 @@ void CoherenceController::sendNACK(MemEvent * event, bool up, SimTime_t timeInNa
 
     
 /* Send response towards the CPU. L1s need to implement their own to split out the requested block */
-uint64_t CoherenceController::sendResponseUp(MemEvent * event, vector<uint8_t>* data, bool replay, uint64_t baseTime, bool atomic) {
+uint64_t CoherenceController::sendResponseUp(MemEvent * event, const SharedPayload* data, bool replay, uint64_t baseTime, bool atomic) {
     return sendResponseUp(event, CommandResponse[(int)event->getCmd()], data, false, replay, baseTime, atomic);
 }
    
 
 /* Send response towards the CPU. L1s need to implement their own to split out the requested block */
-uint64_t CoherenceController::sendResponseUp(MemEvent * event, Command cmd, vector<uint8_t>* data, bool dirty, bool replay, uint64_t baseTime, bool atomic) {
+uint64_t CoherenceController::sendResponseUp(MemEvent * event, Command cmd, const SharedPayload* data, bool dirty, bool replay, uint64_t baseTime, bool atomic) {
     MemEvent * responseEvent = event->makeResponse(cmd);
     responseEvent->setDst(event->getSrc());
     responseEvent->setSize(event->getSize());
@@ -140,7 +140,7 @@ uint64_t CoherenceController::sendResponseUp(MemEvent * event, Command cmd, vect
 }
     
 /* Send response towards the CPU. L1s need to implement their own to split out the requested block */
-uint64_t CoherenceController::sendResponseUp(MemEvent * event, Command cmd, vector<uint8_t>* data, bool replay, uint64_t baseTime, bool atomic) {
+uint64_t CoherenceController::sendResponseUp(MemEvent * event, Command cmd, const SharedPayload* data, bool replay, uint64_t baseTime, bool atomic) {
     return sendResponseUp(event, cmd, data, false, replay, baseTime, atomic);
 }
     
@@ -165,7 +165,7 @@ void CoherenceController::resendEvent(MemEvent * event, bool up) {
   
 
 /* Forward a message to a lower level (towards memory) in the hierarchy */
-uint64_t CoherenceController::forwardMessage(MemEvent * event, Addr baseAddr, unsigned int requestSize, uint64_t baseTime, vector<uint8_t>* data) {
+uint64_t CoherenceController::forwardMessage(MemEvent * event, Addr baseAddr, unsigned int requestSize, uint64_t baseTime, const SharedPayload* data) {
     /* Create event to be forwarded */
     MemEvent* forwardEvent;
     forwardEvent = new MemEvent(*event);
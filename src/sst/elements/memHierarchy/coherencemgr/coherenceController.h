@@ -76,17 +76,17 @@ public:
     void resendEvent(MemEvent * event, bool towardsCPU);
 
     /* Send a response event up (towards CPU). L1s need to implement their own to split out requested bytes. */
-    uint64_t sendResponseUp(MemEvent * event, vector<uint8_t>* data, bool replay, uint64_t baseTime, bool atomic=false);
+    uint64_t sendResponseUp(MemEvent * event, const SharedPayload* data, bool replay, uint64_t baseTime, bool atomic=false);
 
     /* Send a response event up (towards CPU). L1s need to implement their own to split out requested bytes. */
-    uint64_t sendResponseUp(MemEvent * event, Command cmd, vector<uint8_t>* data, bool replay, uint64_t baseTime, bool atomic=false);
+    uint64_t sendResponseUp(MemEvent * event, Command cmd, const SharedPayload* data, bool replay, uint64_t baseTime, bool atomic=false);
     
     /* Send a response event up (towards CPU). L1s need to implement their own to split out requested bytes. */
-    uint64_t sendResponseUp(MemEvent * event, Command cmd, vector<uint8_t>* data, bool dirty, bool replay, uint64_t baseTime, bool atomic=false);
+    uint64_t sendResponseUp(MemEvent * event, Command cmd, const SharedPayload* data, bool dirty, bool replay, uint64_t baseTime, bool atomic=false);
 
 
     /* Forward a message to a lower memory level (towards memory) */
-    uint64_t forwardMessage(MemEvent * event, Addr baseAddr, unsigned int requestSize, uint64_t baseTime, vector<uint8_t>* data);
+    uint64_t forwardMessage(MemEvent * event, Addr baseAddr, unsigned int requestSize, uint64_t baseTime, const SharedPayload* data);
 
     /* Forward a generic message towards memory */
     uint64_t forwardTowardsMem(MemEventBase * event);
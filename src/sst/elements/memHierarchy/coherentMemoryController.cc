@@ -209,7 +209,7 @@ void CoherentMemController::handleReplacement(MemEvent * ev) {
     if (!directory_ && mshr_.find(ev->getBaseAddr()) != mshr_.end()) {
         MSHREntry * entry = &(mshr_.find(ev->getBaseAddr())->second.front());
         if (entry->cmd == Command::CustomReq && entry->shootdown) {
-            ev->getPayload().empty() ? handleAckInv(ev) : handleFetchResp(ev);
+            ev->getSharedPayload().empty() ? handleAckInv(ev) : handleFetchResp(ev);
             return;
         }
     }
@@ -264,7 +264,7 @@ void CoherentMemController::handleFlush(MemEvent * ev) {
 
     MemEvent* put = NULL;
     if (ev->getPayloadSize() != 0) {
-        put = new MemEvent(this, ev->getBaseAddr(), ev->getBaseAddr(), Command::PutM, ev->getPayload());
+        put = new MemEvent(this, ev->getBaseAddr(), ev->getBaseAddr(), Command::PutM, ev->getSharedPayload().get());
         put->setFlag(MemEvent::F_NORESPONSE);
         outstandingEventList_.insert(std::make_pair(put->getID(), OutstandingEvent(put, put->getBaseAddr())));
         notifyListeners(ev);
@@ -339,7 +339,7 @@ void CoherentMemController::handleFetchResp(MemEvent * ev) {
 
     // Write dirty data if needed
     if (ev->getDirty()) {
-        MemEvent * write = new MemEvent(this, ev->getAddr(), baseAddr, Command::PutM, ev->getPayload());
+        MemEvent * write = new MemEvent(this, ev->getAddr(), baseAddr, Command::PutM, ev->getSharedPayload().get());
         write->setRqstr(ev->getRqstr());
         ev->setFlag(MemEvent::F_NORESPONSE);
 
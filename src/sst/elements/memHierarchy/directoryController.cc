@@ -69,6 +69,13 @@ DirectoryController::DirectoryController(ComponentId_t id, Params &params) :
     
     entryCacheMaxSize = params.find<size_t>("entry_cache_size", 32768);
     entryCacheSize = 0;
+    std::string entryStore = params.find<std::string>("entry_store", "map");
+    if (entryStore != "slab" && entryStore != "map")
+        dbg.fatal(CALL_INFO, -1, "%s, Invalid param: entry_store - must be 'slab' or 'map'. You specified: '%s'\n", getName().c_str(), entryStore.c_str());
+    if (entryStore == "slab")
+        entries = new SlabDirEntryStore(&dbg, entryCacheMaxSize);
+    else
+        entries = new MapDirEntryStore(&dbg);
     std::string net_bw = params.find<std::string>("network_bw", "80GiB/s");
 
     // These are technically nic params and we're borrowing them
@@ -219,6 +226,8 @@ DirectoryController::DirectoryController(ComponentId_t id, Params &params) :
     stat_replacementRequestLatency  = registerStatistic<uint64_t>("replacement_request_latency");
     stat_getRequestLatency          = registerStatistic<uint64_t>("get_request_latency");
     stat_cacheHits                  = registerStatistic<uint64_t>("directory_cache_hits");
+    stat_cacheMisses                = registerStatistic<uint64_t>("directory_cache_misses");
+    stat_cacheEvictions             = registerStatistic<uint64_t>("directory_cache_evictions");
     stat_mshrHits                   = registerStatistic<uint64_t>("mshr_hits");
     stat_GetXReqReceived            = registerStatistic<uint64_t>("requests_received_GetX");
     stat_GetSXReqReceived          = registerStatistic<uint64_t>("requests_received_GetSX");
@@ -243,6 +252,9 @@ DirectoryController::DirectoryController(ComponentId_t id, Params &params) :
     stat_GetSRespSent               = registerStatistic<uint64_t>("responses_sent_GetSResp");
     stat_GetXRespSent               = registerStatistic<uint64_t>("responses_sent_GetXResp");
     stat_MSHROccupancy              = registerStatistic<uint64_t>("MSHR_occupancy");
+    stat_MSHRPoolOccupancy          = registerStatistic<uint64_t>("MSHR_pool_occupancy");
+    stat_MSHRProbeLength            = registerStatistic<uint64_t>("MSHR_probe_length");
+    mshr->setProbeLengthStatistic(stat_MSHRProbeLength);
     stat_NoncacheReceived           = registerStatistic<uint64_t>("requests_received_noncacheable");
     stat_CustomReceived             = registerStatistic<uint64_t>("requests_received_custom");
 
@@ -251,10 +263,7 @@ DirectoryController::DirectoryController(ComponentId_t id, Params &params) :
 
 
 DirectoryController::~DirectoryController(){
-    for(std::unordered_map<Addr, DirEntry*>::iterator i = directory.begin(); i != directory.end() ; ++i){
-        delete i->second;
-    }
-    directory.clear();
+    delete entries;
     
     while(workQueue.size()){
         MemEvent *front = workQueue.front().first;
@@ -328,6 +337,8 @@ inline void DirectoryController::profileRequestRecv(MemEvent * event, DirEntry *
     }
     if (!entry || entry->isCached()) {
         stat_cacheHits->addData(1);
+    } else {
+        stat_cacheMisses->addData(1);
     }
 }
 /** 
@@ -426,6 +437,7 @@ inline void DirectoryController::profileResponseRecv(MemEvent * event) {
 bool DirectoryController::clock(SST::Cycle_t cycle){
     timestamp++;
     stat_MSHROccupancy->addData(mshr->getSize());
+    stat_MSHRPoolOccupancy->addData(mshr->getEntryCount());
 
     bool debugLine = false;
     while (!netMsgQueue.empty() && netMsgQueue.begin()->first <= timestamp) {
@@ -555,7 +567,7 @@ void DirectoryController::handleNoncacheableRequest(MemEventBase * ev) {
 
 
 void DirectoryController::handleNoncacheableResponse(MemEventBase * ev) {
-    if (noncacheMemReqs.find(ev->getID()) == noncacheMemReqs.end()) {
+    if (!noncacheMemReqs.count(ev->getID())) {
         dbg.fatal(CALL_INFO, -1, "%s, Error: Received a noncacheable response that does not match a pending request. Event: %s\n. Time: %" PRIu64 "ns\n", 
                 getName().c_str(), ev->getVerboseString().c_str(), getCurrentSimTimeNano());
     }
@@ -1121,7 +1133,7 @@ void DirectoryController::handleFetchResp(MemEvent * ev, bool keepEvent) {
             dbg.fatal(CALL_INFO, -1, "%s, Error: Directory received %s but state is %s. Event: %s. Time = %" PRIu64 "ns, %" PRIu64 " cycles\n",
                     getName().c_str(), CommandString[(int)ev->getCmd()], StateString[state], ev->getVerboseString().c_str(), getCurrentSimTimeNano(), timestamp);
     }   
-    respEv->setPayload(ev->getPayload());
+    respEv->setPayload(ev->getSharedPayload());
     profileResponseSent(respEv);
     if (reqEv->getCmd() == Command::FetchInv || reqEv->getCmd() == Command::ForceInv)
         memMsgQueue.insert(std::make_pair(timestamp + mshrLatency, respEv));
@@ -1161,7 +1173,7 @@ void DirectoryController::handleFetchXResp(MemEvent * ev, bool keepEvent) {
     MemEvent * respEv = reqEv->makeResponse(); 
     entry->addSharer(node_id(reqEv->getSrc()));
     
-    respEv->setPayload(ev->getPayload());
+    respEv->setPayload(ev->getSharedPayload());
     profileResponseSent(respEv);
     sendEventToCaches(respEv, timestamp + mshrLatency);
     
@@ -1341,7 +1353,7 @@ void DirectoryController::handleMemoryResponse(SST::Event *event){
     }
     
     if (ev->queryFlag(MemEvent::F_NONCACHEABLE)) {
-        if (noncacheMemReqs.find(ev->getResponseToID()) != noncacheMemReqs.end()) {
+        if (noncacheMemReqs.count(ev->getResponseToID())) {
             ev->setDst(noncacheMemReqs[ev->getResponseToID()]);
             ev->setSrc(getName());
             
@@ -1364,11 +1376,11 @@ void DirectoryController::handleMemoryResponse(SST::Event *event){
         mshr->removeWriteback(memReqs[ev->getResponseToID()]);
         memReqs.erase(ev->getResponseToID());
         replayWaitingEvents(ev->getBaseAddr());
-    } else if (ev->getBaseAddr() == 0 && dirEntryMiss.find(ev->getResponseToID()) != dirEntryMiss.end()) {    // directory entry miss
+    } else if (ev->getBaseAddr() == 0 && dirEntryMiss.count(ev->getResponseToID())) {    // directory entry miss
         ev->setBaseAddr(dirEntryMiss[ev->getResponseToID()]);
         dirEntryMiss.erase(ev->getResponseToID());
         handleDirEntryMemoryResponse(ev);
-    } else if (memReqs.find(ev->getResponseToID()) != memReqs.end()) {
+    } else if (memReqs.count(ev->getResponseToID())) {
         ev->setBaseAddr(memReqs[ev->getResponseToID()]);
         memReqs.erase(ev->getResponseToID());
         if (ev->getCmd() == Command::FlushLineResp) handleFlushLineResponse(ev);
@@ -1420,7 +1432,7 @@ void DirectoryController::handleDataResponse(MemEvent * ev) {
     }
 
     respEv->setSize(cacheLineSize);
-    respEv->setPayload(ev->getPayload());
+    respEv->setPayload(ev->getSharedPayload());
     respEv->setMemFlags(ev->getMemFlags());
     profileResponseSent(respEv);
     sendEventToCaches(respEv, timestamp + mshrLatency);
@@ -1616,8 +1628,10 @@ void DirectoryController::printStatus(Output &statusOut) {
     }
 
     statusOut.output("  Directory entries:\n");
-    for (std::unordered_map<Addr, DirEntry*>::iterator it = directory.begin(); it != directory.end(); it++) {
-        statusOut.output("    0x%" PRIx64 " %s\n", it->first, it->second->getString().c_str());
+    std::vector<DirEntry*> entryList;
+    entries->getEntries(entryList);
+    for (std::vector<DirEntry*>::iterator it = entryList.begin(); it != entryList.end(); it++) {
+        statusOut.output("    0x%" PRIx64 " %s\n", (*it)->getBaseAddr(), (*it)->getString().c_str());
     }
     statusOut.output("End MemHierarchy::DirectoryController\n\n");
 }
@@ -1629,15 +1643,10 @@ void DirectoryController::emergencyShutdown() {
 
 
 DirectoryController::DirEntry* DirectoryController::getDirEntry(Addr baseAddr){
-    std::unordered_map<Addr,DirEntry*>::iterator i = directory.find(baseAddr);
-    DirEntry *entry;
-    if (directory.end() == i) {
-        entry = new DirEntry(baseAddr, numTargets, &dbg);
-        entry->cacheIter = entryCache.end();
-        directory[baseAddr] = entry;
+    DirEntry *entry = entries->find(baseAddr);
+    if (entry == nullptr) {
+        entry = entries->create(baseAddr, numTargets);
         entry->setCached(true);   // TODO fix this so new entries go to memory if we're caching, little bit o cheatin here
-    } else {
-        entry = i->second;
     }
     return entry;
 }
@@ -1723,34 +1732,31 @@ void DirectoryController::updateCache(DirEntry *entry){
         sendEntryToMemory(entry);
     } else {
         /* Find if we're in the cache */
-        if(entry->cacheIter != entryCache.end()){
-            entryCache.erase(entry->cacheIter);
+        if(entry->inLRU){
+            entries->lruRemove(entry);
             --entryCacheSize;
-            entry->cacheIter = entryCache.end();
         }
 
         /* Find out if we're no longer cached, and just remove */
         if (entry->getState() == I){
             if (is_debug_addr(entry->getBaseAddr())) dbg.debug(_L10_, "Entry for 0x%" PRIx64 " has no references - purging\n", entry->getBaseAddr());
             
-            directory.erase(entry->getBaseAddr());
-            delete entry;
+            entries->erase(entry);
             return;
         } else {
-            entryCache.push_front(entry);
-            entry->cacheIter = entryCache.begin();
+            entries->lruPushFront(entry);
             ++entryCacheSize;
 
             while(entryCacheSize > entryCacheMaxSize){
-                DirEntry *oldEntry = entryCache.back();
+                DirEntry *oldEntry = entries->lruBack();
                 // If the oldest entry is still in progress, everything is in progress
                 if(mshr->isHit(oldEntry->getBaseAddr())) break;
 
                 if (is_debug_addr(entry->getBaseAddr())) dbg.debug(_L10_, "entryCache too large.  Evicting entry for 0x%" PRIx64 "\n", oldEntry->getBaseAddr());
                 
-                entryCache.pop_back();
+                entries->lruRemove(oldEntry);
                 --entryCacheSize;
-                oldEntry->cacheIter = entryCache.end();
+                stat_cacheEvictions->addData(1);
                 oldEntry->setCached(false);
                 sendEntryToMemory(oldEntry);
             }
@@ -1777,13 +1783,13 @@ void DirectoryController::sendEntryToMemory(DirEntry *entry){
 MemEvent::id_type DirectoryController::writebackData(MemEvent *data_event, Command wbCmd) {
     MemEvent *ev       = new MemEvent(this, data_event->getBaseAddr(), data_event->getBaseAddr(), wbCmd, cacheLineSize);
 
-    if(data_event->getPayload().size() != cacheLineSize) {
+    if(data_event->getSharedPayload().size() != cacheLineSize) {
 	dbg.fatal(CALL_INFO, -1, "%s, Error: Writing back data request but payload does not match cache line size of %uB. Event: %s. Time = %" PRIu64 "ns\n",
                 getName().c_str(), cacheLineSize, ev->getVerboseString().c_str(), getCurrentSimTimeNano());
     }
 
-    ev->setSize(data_event->getPayload().size());
-    ev->setPayload(data_event->getPayload());
+    ev->setSize(data_event->getSharedPayload().size());
+    ev->setPayload(data_event->getSharedPayload());
     ev->setDst(memoryName);
     profileRequestSent(ev);
     
@@ -1984,3 +1990,97 @@ void DirectoryController::setup(void){
     entrySize = (numTargets+1)/8 +1;
 }
 
+
+/* Directory entry stores */
+DirectoryController::MapDirEntryStore::~MapDirEntryStore() {
+    for (std::unordered_map<Addr,DirEntry*>::iterator it = directory_.begin(); it != directory_.end(); it++)
+        delete it->second;
+}
+
+DirectoryController::DirEntry* DirectoryController::MapDirEntryStore::find(Addr addr) {
+    std::unordered_map<Addr,DirEntry*>::iterator it = directory_.find(addr);
+    return (it == directory_.end()) ? nullptr : it->second;
+}
+
+DirectoryController::DirEntry* DirectoryController::MapDirEntryStore::create(Addr addr, uint32_t numTargets) {
+    DirEntry* entry = new DirEntry(addr, numTargets, dbg_);
+    entry->cacheIter = lru_.end();
+    directory_[addr] = entry;
+    return entry;
+}
+
+void DirectoryController::MapDirEntryStore::erase(DirEntry* entry) {
+    directory_.erase(entry->getBaseAddr());
+    delete entry;
+}
+
+void DirectoryController::MapDirEntryStore::lruPushFront(DirEntry* entry) {
+    lru_.push_front(entry);
+    entry->cacheIter = lru_.begin();
+    entry->inLRU = true;
+}
+
+void DirectoryController::MapDirEntryStore::lruRemove(DirEntry* entry) {
+    lru_.erase(entry->cacheIter);
+    entry->cacheIter = lru_.end();
+    entry->inLRU = false;
+}
+
+void DirectoryController::MapDirEntryStore::getEntries(std::vector<DirEntry*>& entries) {
+    for (std::unordered_map<Addr,DirEntry*>::iterator it = directory_.begin(); it != directory_.end(); it++)
+        entries.push_back(it->second);
+}
+
+
+DirectoryController::SlabDirEntryStore::SlabDirEntryStore(Output* dbg, size_t capacity) : dbg_(dbg), directory_(capacity) {
+    lruHead_ = nullptr;
+    lruTail_ = nullptr;
+}
+
+DirectoryController::DirEntry* DirectoryController::SlabDirEntryStore::find(Addr addr) {
+    DirEntry** entry = directory_.find(addr);
+    return entry ? *entry : nullptr;
+}
+
+DirectoryController::DirEntry* DirectoryController::SlabDirEntryStore::create(Addr addr, uint32_t numTargets) {
+    DirEntry* entry;
+    if (freeList_.empty()) {
+        slab_.emplace_back(addr, numTargets, dbg_);
+        entry = &slab_.back();
+    } else {
+        entry = freeList_.back();
+        freeList_.pop_back();
+        entry->sharers.resize(numTargets);
+        entry->reset(addr);
+    }
+    directory_[addr] = entry;
+    return entry;
+}
+
+void DirectoryController::SlabDirEntryStore::erase(DirEntry* entry) {
+    directory_.erase(entry->getBaseAddr());
+    freeList_.push_back(entry);
+}
+
+void DirectoryController::SlabDirEntryStore::lruPushFront(DirEntry* entry) {
+    entry->lruPrev = nullptr;
+    entry->lruNext = lruHead_;
+    if (lruHead_) lruHead_->lruPrev = entry;
+    else lruTail_ = entry;
+    lruHead_ = entry;
+    entry->inLRU = true;
+}
+
+void DirectoryController::SlabDirEntryStore::lruRemove(DirEntry* entry) {
+    if (entry->lruPrev) entry->lruPrev->lruNext = entry->lruNext;
+    else lruHead_ = entry->lruNext;
+    if (entry->lruNext) entry->lruNext->lruPrev = entry->lruPrev;
+    else lruTail_ = entry->lruPrev;
+    entry->lruPrev = nullptr;
+    entry->lruNext = nullptr;
+    entry->inLRU = false;
+}
+
+void DirectoryController::SlabDirEntryStore::getEntries(std::vector<DirEntry*>& entries) {
+    directory_.forEach([&entries](const Addr&, DirEntry* entry) { entries.push_back(entry); });
+}
@@ -25,7 +25,9 @@
 #include <map>
 #include <set>
 #include <list>
+#include <deque>
 #include <vector>
+#include <unordered_map>
 
 #include <sst/core/event.h>
 #include <sst/core/sst_types.h>
@@ -38,6 +40,7 @@
 #include "sst/elements/memHierarchy/memEvent.h"
 #include "sst/elements/memHierarchy/util.h"
 #include "sst/elements/memHierarchy/mshr.h"
+#include "sst/elements/memHierarchy/flatHashMap.h"
 
 using namespace std;
 
@@ -52,6 +55,7 @@ public:
     SST_ELI_DOCUMENT_PARAMS( 
             {"clock",                   "Clock rate of controller.", "1GHz"},
             {"entry_cache_size",        "Size (in # of entries) the controller will cache.", "0"},
+            {"entry_store",             "How directory entries are stored. Options: 'map' - individually allocated entries, 'slab' - preallocated entries with an intrusive LRU list (experimental)", "map"},
             {"debug",                   "Where to send debug output. 0: No debugging, 1: STDOUT, 2: STDERR, 3: FILE.", "0"},
             {"debug_level",             "Debugging level: 0 to 10. Must configure sst-core with '--enable-debug'. 1=info, 2-10=debug output", "0"},
             {"debug_addr",              "(comma separated uint) Address(es) to be debugged. Leave empty for all, otherwise specify one or more, comma-separated values. Start and end string with brackets",""},
@@ -87,6 +91,8 @@ public:
             {"replacement_request_latency",     "Total latency in ns of all replacement (put*) requests handled",       "nanoseconds",  1},
             {"get_request_latency",             "Total latency in ns of all get* requests handled",                     "nanoseconds",  1},
             {"directory_cache_hits",            "Number of requests that hit in the directory cache",                   "requests",     1},
+            {"directory_cache_misses",          "Number of requests that missed in the directory cache",                "requests",     1},
+            {"directory_cache_evictions",       "Number of directory entries evicted from the directory cache to memory",   "entries",  1},
             {"mshr_hits",                       "Number of requests that hit in the MSHRs",                             "requests",     1},
             {"requests_received_GetS",          "Number of GetS (read-shared) requests received",                       "requests",     1},
             {"requests_received_GetX",          "Number of GetX (write-exclusive) requests received",                   "requests",     1},
@@ -112,7 +118,9 @@ public:
             {"responses_sent_NACK",             "Number of NACK responses sent to LLCs",                                            "responses",    1},
             {"responses_sent_GetSResp",         "Number of GetSResp (data response to GetS or GetSX) responses sent to LLCs",       "responses",    1},
             {"responses_sent_GetXResp",         "Number of GetXResp (data response to GetX) responses sent to LLCs",                "responses",    1},
-            {"MSHR_occupancy",                  "Number of events in MSHR each cycle",                                  "events",       1} )
+            {"MSHR_occupancy",                  "Number of events in MSHR each cycle",                                  "events",       1},
+            {"MSHR_pool_occupancy",             "Number of addresses holding an MSHR entry each cycle",                 "entries",      3},
+            {"MSHR_probe_length",               "Number of MSHR table slots probed per lookup",                         "slots",        3} )
 
 /* Begin class definition */
 private:
@@ -144,6 +152,8 @@ private:
     /* Directory cache */
     size_t      entryCacheMaxSize;
     size_t      entryCacheSize;
+    class DirEntryStore;
+    DirEntryStore* entries;
     
     /* Timestamp & latencies */
     uint64_t    timestamp;
@@ -161,6 +171,8 @@ private:
     Statistic<uint64_t> * stat_replacementRequestLatency;   // totalReplProcessTime
     Statistic<uint64_t> * stat_getRequestLatency;           // totalGetReqProcessTime;
     Statistic<uint64_t> * stat_cacheHits;                   // numCacheHits;
+    Statistic<uint64_t> * stat_cacheMisses;
+    Statistic<uint64_t> * stat_cacheEvictions;
     Statistic<uint64_t> * stat_mshrHits;                    // mshrHits;
     // Received events - from caches
     Statistic<uint64_t> * stat_GetXReqReceived;
@@ -190,18 +202,18 @@ private:
     Statistic<uint64_t> * stat_GetSRespSent;
     Statistic<uint64_t> * stat_GetXRespSent;
     Statistic<uint64_t> * stat_MSHROccupancy;
+    Statistic<uint64_t> * stat_MSHRPoolOccupancy;
+    Statistic<uint64_t> * stat_MSHRProbeLength;
 
     /* Directory structures */
-    std::list<DirEntry*>                    entryCache;
-    std::unordered_map<Addr,DirEntry*>      directory;
     std::map<std::string,uint32_t>          node_lookup;
     std::vector<std::string>                nodeid_to_name;
     
     /* Queue of packets to work on */
     std::list<std::pair<MemEvent*,bool> >   workQueue;
-    std::map<MemEvent::id_type, Addr>       memReqs;
-    std::map<MemEvent::id_type, Addr>       dirEntryMiss;
-    std::map<MemEvent::id_type, std::string> noncacheMemReqs;
+    FlatHashMap<MemEvent::id_type, Addr, PairHash>          memReqs;
+    FlatHashMap<MemEvent::id_type, Addr, PairHash>          dirEntryMiss;
+    FlatHashMap<MemEvent::id_type, std::string, PairHash>   noncacheMemReqs;
 
     /* Network connections */
     MemLinkBase*    memLink;
@@ -347,18 +359,29 @@ private:
         Addr                baseAddr;       // block address
         State               state;          // state
         MemEvent::id_type   lastRequest;    // ID of message we're wanting a response to  - used to track whether a NACK needs to be retried
-        std::list<DirEntry*>::iterator cacheIter;
+        bool                inLRU;          // whether entry is in the directory cache LRU list
+        std::list<DirEntry*>::iterator cacheIter;   // LRU position for 'map' entry store
+        DirEntry*           lruPrev;        // LRU links for 'slab' entry store
+        DirEntry*           lruNext;
 	std::vector<bool>   sharers;        // set of sharers for block
         int                 owner;          // owner of block
         Output * dbg;
 	
         DirEntry(Addr bsAddr, uint32_t bitlength, Output * d){
-            clearEntry();
-            baseAddr     = bsAddr;
             sharers.resize(bitlength);
             dbg          = d;
+            reset(bsAddr);
+        }
+
+        /* Reinitialize for a new address, used when an entry is recycled */
+        void reset(Addr bsAddr) {
+            clearEntry();
+            baseAddr     = bsAddr;
             state        = I;
             cached       = false;
+            inLRU        = false;
+            lruPrev      = nullptr;
+            lruNext      = nullptr;
         }
 
         void clearEntry(){
@@ -465,6 +488,57 @@ private:
         }
     };
 
+    /** Storage for directory entries and the LRU order of entries cached in the controller */
+    class DirEntryStore {
+    public:
+        virtual ~DirEntryStore() { }
+        virtual DirEntry* find(Addr addr) = 0;
+        virtual DirEntry* create(Addr addr, uint32_t numTargets) = 0;
+        virtual void erase(DirEntry* entry) = 0;
+        virtual void lruPushFront(DirEntry* entry) = 0;
+        virtual void lruRemove(DirEntry* entry) = 0;
+        virtual DirEntry* lruBack() = 0;
+        virtual void getEntries(std::vector<DirEntry*>& entries) = 0;
+    };
+
+    /** Entries individually allocated, indexed by std::unordered_map with a std::list LRU */
+    class MapDirEntryStore : public DirEntryStore {
+    public:
+        MapDirEntryStore(Output* dbg) : dbg_(dbg) { }
+        ~MapDirEntryStore();
+        DirEntry* find(Addr addr);
+        DirEntry* create(Addr addr, uint32_t numTargets);
+        void erase(DirEntry* entry);
+        void lruPushFront(DirEntry* entry);
+        void lruRemove(DirEntry* entry);
+        DirEntry* lruBack() { return lru_.back(); }
+        void getEntries(std::vector<DirEntry*>& entries);
+    private:
+        Output* dbg_;
+        std::unordered_map<Addr,DirEntry*> directory_;
+        std::list<DirEntry*> lru_;
+    };
+
+    /** Entries recycled from a slab, indexed by a FlatHashMap with an intrusive LRU */
+    class SlabDirEntryStore : public DirEntryStore {
+    public:
+        SlabDirEntryStore(Output* dbg, size_t capacity);
+        DirEntry* find(Addr addr);
+        DirEntry* create(Addr addr, uint32_t numTargets);
+        void erase(DirEntry* entry);
+        void lruPushFront(DirEntry* entry);
+        void lruRemove(DirEntry* entry);
+        DirEntry* lruBack() { return lruTail_; }
+        void getEntries(std::vector<DirEntry*>& entries);
+    private:
+        Output* dbg_;
+        std::deque<DirEntry> slab_;         // deque so that growing the slab does not move existing entries
+        std::vector<DirEntry*> freeList_;
+        FlatHashMap<Addr, DirEntry*> directory_;
+        DirEntry* lruHead_;
+        DirEntry* lruTail_;
+    };
+
 public:
     DirectoryController(ComponentId_t id, Params &params);
     ~DirectoryController();
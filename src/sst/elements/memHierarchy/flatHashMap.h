@@ -0,0 +1,145 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#ifndef _MEMHIERARCHY_FLATHASHMAP_H_
+#define _MEMHIERARCHY_FLATHASHMAP_H_
+
+#include <stdint.h>
+#include <vector>
+#include <utility>
+#include <functional>
+
+namespace SST { namespace MemHierarchy {
+
+/* Hash for event IDs (std::pair<uint64_t, int>) */
+struct PairHash {
+    template<typename A, typename B>
+    size_t operator()(const std::pair<A,B>& p) const {
+        return std::hash<A>()(p.first) ^ (std::hash<B>()(p.second) * 0x9E3779B97F4A7C15ULL);
+    }
+};
+
+/*
+ * Open-addressed hash map with linear probing and backward-shift deletion
+ * Key/value pairs are stored inline in a single array so inserts and erases do not
+ * allocate once the table has grown to its working size. Kept at most half full.
+ * Only the operations the memHierarchy request-tracking tables need are provided;
+ * pointers returned by find() are invalidated by any insert or erase.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key> >
+class FlatHashMap {
+public:
+    FlatHashMap(size_t capacity = 16) : size_(0) {
+        size_t slots = 16;
+        while (slots < 2 * capacity) slots <<= 1;
+        slots_.resize(slots);
+        mask_ = slots - 1;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t count(const Key& key) const { return slots_[findSlot(key)].used ? 1 : 0; }
+
+    /* Return pointer to value for key or nullptr if not present */
+    Value* find(const Key& key) {
+        Slot& slot = slots_[findSlot(key)];
+        return slot.used ? &slot.value : nullptr;
+    }
+
+    /* Return value for key, inserting a default-constructed one if not present */
+    Value& operator[](const Key& key) {
+        size_t index = findSlot(key);
+        if (slots_[index].used) return slots_[index].value;
+        if (2 * (size_ + 1) > slots_.size()) {
+            grow();
+            index = findSlot(key);
+        }
+        slots_[index].key = key;
+        slots_[index].value = Value();
+        slots_[index].used = true;
+        size_++;
+        return slots_[index].value;
+    }
+
+    /* Remove key, returns number of elements removed */
+    size_t erase(const Key& key) {
+        size_t index = findSlot(key);
+        if (!slots_[index].used) return 0;
+        size_--;
+
+        size_t next = index;
+        while (true) {
+            next = (next + 1) & mask_;
+            if (!slots_[next].used) break;
+            size_t nextHome = home(slots_[next].key);
+            bool movable = (index <= next) ? (nextHome <= index || nextHome > next) : (nextHome <= index && nextHome > next);
+            if (movable) {
+                std::swap(slots_[index], slots_[next]);
+                index = next;
+            }
+        }
+        slots_[index].used = false;
+        slots_[index].value = Value();
+        return 1;
+    }
+
+    /* Call func(key, value) for each element, in no particular order */
+    template<typename Func>
+    void forEach(Func func) {
+        for (typename std::vector<Slot>::iterator it = slots_.begin(); it != slots_.end(); it++) {
+            if (it->used) func(it->key, it->value);
+        }
+    }
+
+private:
+    struct Slot {
+        Key key;
+        Value value;
+        bool used;
+        Slot() : key(), value(), used(false) { }
+    };
+
+    size_t home(const Key& key) const {
+        uint64_t h = (uint64_t)Hash()(key) * 0x9E3779B97F4A7C15ULL;
+        return (h ^ (h >> 32)) & mask_;
+    }
+
+    size_t findSlot(const Key& key) const {
+        size_t index = home(key);
+        while (slots_[index].used && !(slots_[index].key == key))
+            index = (index + 1) & mask_;
+        return index;
+    }
+
+    void grow() {
+        std::vector<Slot> oldSlots(2 * slots_.size());
+        oldSlots.swap(slots_);
+        mask_ = slots_.size() - 1;
+        for (typename std::vector<Slot>::iterator it = oldSlots.begin(); it != oldSlots.end(); it++) {
+            if (!it->used) continue;
+            size_t index = home(it->key);
+            while (slots_[index].used) index = (index + 1) & mask_;
+            std::swap(slots_[index], *it);
+        }
+    }
+
+    std::vector<Slot> slots_;
+    size_t mask_;
+    size_t size_;
+};
+
+}}
+
+#endif
@@ -25,6 +25,7 @@
 #include "sst/elements/memHierarchy/util.h"
 #include "sst/elements/memHierarchy/memEventBase.h"
 #include "sst/elements/memHierarchy/memTypes.h"
+#include "sst/elements/memHierarchy/sharedPayload.h"
 
 namespace SST { namespace MemHierarchy {
 
@@ -60,7 +61,7 @@ public:
     }
 
     /** MemEvent constructor - Writes */
-    MemEvent(const Component *src, Addr addr, Addr baseAddr, Command cmd, std::vector<uint8_t>& data) : MemEventBase(src->getName(), cmd) {
+    MemEvent(const Component *src, Addr addr, Addr baseAddr, Command cmd, const std::vector<uint8_t>& data) : MemEventBase(src->getName(), cmd) {
         initialize();
         addr_ = addr;
         baseAddr_ = baseAddr;
@@ -180,32 +181,59 @@ public:
     bool fromHighNetNACK()  { return !CommandCPUSide[(int)cmd_];}
     bool fromLowNetNACK()   { return CommandCPUSide[(int)cmd_];}
 
-    /** @return  the data payload. */
-    dataVec& getPayload(void) {
+    /** @return  the data payload, read-only and without copying */
+    const dataVec& getPayload(void) const {
         /* Lazily allocate space for payload */
+        if ( payload_.size() < size_ )  payload_.resize(size_);
+        return payload_.get();
+    }
+
+    /** @return  the data payload for writing.
+     * The payload is copied first if it is shared with other events or cache lines
+     * and is not shared again afterwards, so only use this to modify the data.
+     */
+    dataVec& getMutablePayload(void) {
+        if ( payload_.size() < size_ )  payload_.resize(size_);
+        return payload_.getMutable();
+    }
+
+    /** @return  the data payload, read-only, for sharing with another event or line */
+    const SharedPayload& getSharedPayload(void) const {
         if ( payload_.size() < size_ )  payload_.resize(size_);
         return payload_;
     }
-    
 
     /** Sets the data payload and payload size.
      * @param[in] data  Vector from which to copy data
      */
-    void setPayload(std::vector<uint8_t>& data) {
+    void setPayload(const std::vector<uint8_t>& data) {
+        setSize(data.size());
+        payload_.assign(data);
+    }
+
+    /** Sets the data payload and payload size.
+     * @param[in] data  Vector to take the data from, left empty
+     */
+    void setPayload(std::vector<uint8_t>&& data) {
+        setSize(data.size());
+        payload_.assign(std::move(data));
+    }
+
+    /** Sets the data payload and payload size.
+     * @param[in] data  Payload to share data with, no copy is made
+     */
+    void setPayload(const SharedPayload& data) {
         setSize(data.size());
         payload_ = data;
     }
-    
+
     /** Sets the data payload and payload size.
      * @param[in] size  How many bytes to copy from data
      * @param[in] data  Data array to set as payload
      */
-    void setPayload(uint32_t size, uint8_t* data) {
+    void setPayload(uint32_t size, const uint8_t* data) {
         setSize(size);
-        payload_.resize(size);
-        for ( uint32_t i = 0 ; i < size ; i++ ) {
-            payload_[i] = data[i];
-        }
+        payload_.assign(data, size);
     }
 
     void setZeroPayload(uint32_t size) {
@@ -272,7 +300,7 @@ private:
     bool            addrGlobal_;        // Whether address is a local or global address 
     MemEvent*       NACKedEvent_;       // For a NACK, pointer to the NACKed event
     int             retries_;           // For NACKed events, how many times a retry has been sent
-    dataVec         payload_;           // Data
+    mutable SharedPayload payload_;     // Data, shared with copies of this event until written. Sized lazily on read
     bool            prefetch_;          // Whether this request came from a prefetcher
     bool            blocked_;           // Whether this request blocked for another pending request (for profiling) TODO move to mshrs
     SimTime_t       initTime_;          // Timestamp when event was created, for detecting timeouts TODO move to mshrs
@@ -292,7 +320,12 @@ public:
         ser & addrGlobal_;
         ser & NACKedEvent_;
         ser & retries_;
-        ser & payload_;
+        dataVec payload;
+        if (ser.mode() != SST::Core::Serialization::serializer::UNPACK)
+            payload = payload_.get();
+        ser & payload;
+        if (ser.mode() == SST::Core::Serialization::serializer::UNPACK)
+            payload_.assign(std::move(payload));
         ser & prefetch_;
         ser & blocked_;
         ser & initTime_;
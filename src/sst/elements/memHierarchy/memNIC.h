@@ -161,7 +161,8 @@ public:
         { "network_input_buffer_size",   "(string) Size of input buffer", "1KiB"},\
         { "network_output_buffer_size",  "(string) Size of output buffer", "1KiB"},\
         { "min_packet_size",             "(string) Size of a packet without a payload (e.g., control message size)", "8B"},\
-        { "port",                        "(string) Set by parent component. Name of port this NIC sits on.", ""}
+        { "port",                        "(string) Set by parent component. Name of port this NIC sits on.", ""},\
+        { "linkcontrol",                 "(string) SimpleNetwork implementation to use, for example merlin.flow_linkcontrol with a merlin.flow_network", "merlin.linkcontrol"}
 
     
     SST_ELI_REGISTER_SUBCOMPONENT(MemNIC, "memHierarchy", "MemNIC", SST_ELI_ELEMENT_VERSION(1,0,0),
@@ -18,6 +18,13 @@
 
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/mman.h>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <new>
+#include <set>
+#include <unordered_map>
 #include "sst/elements/memHierarchy/util.h"
 
 namespace SST {
@@ -27,15 +34,23 @@ namespace Backend {
 class Backing {
 public:
     Backing( ) { }
-    ~Backing() { }
+    virtual ~Backing() { }
 
     virtual void set( Addr addr, uint8_t value ) = 0;
-    virtual void set( Addr addr, size_t size, std::vector<uint8_t>& data) = 0;
+    virtual void set( Addr addr, size_t size, const std::vector<uint8_t>& data) = 0;
 
     virtual uint8_t get( Addr addr) = 0;
     virtual void get( Addr addr, size_t size, std::vector<uint8_t>& data) = 0;
 };
 
+/*
+ * Backing store in an mmap'd region, anonymous or of memory_file
+ * Addresses are relative to 'offset': address 'offset' is the first byte of the region. Single-byte
+ * and multi-byte accesses both subtract it. Before the multi-byte accessors were changed to memcpy,
+ * they ignored the offset, so with a non-zero offset a multi-byte access went to a different place
+ * than single-byte accesses to the same address. All the users in memHierarchy pass an offset of 0,
+ * which is unaffected.
+ */
 class BackingMMAP : public Backing {
 public:
     BackingMMAP(std::string memoryFile, size_t size, size_t offset = 0) : Backing(), m_fd(-1), m_size(size), m_offset(offset) {
@@ -66,9 +81,8 @@ public:
         m_buffer[addr - m_offset ] = value;
     }
 
-    void set (Addr addr, size_t size, std::vector<uint8_t> &data) {
-        for (size_t i = 0; i < size; i++) 
-            m_buffer[addr + i] = data[i];
+    void set (Addr addr, size_t size, const std::vector<uint8_t> &data) {
+        memcpy(m_buffer + (addr - m_offset), data.data(), size);
     }
 
     uint8_t get( Addr addr ) {
@@ -76,14 +90,13 @@ public:
     }
 
     void get( Addr addr, size_t size, std::vector<uint8_t> &data) {
-        for (size_t i = 0; i < size; i++)
-            data[i] = m_buffer[addr + i];
+        memcpy(data.data(), m_buffer + (addr - m_offset), size);
     }
 
 private:
     uint8_t* m_buffer;
     int m_fd;
-    int m_size;
+    size_t m_size;
     size_t m_offset;
 };
 
@@ -106,24 +119,19 @@ public:
         m_buffer[bAddr][offset] = value;
     }
 
-    void set( Addr addr, size_t size, std::vector<uint8_t> &data ) {
+    void set( Addr addr, size_t size, const std::vector<uint8_t> &data ) {
         /* Account for size exceeding alloc unit size */
         Addr bAddr = addr >> m_shift;
         Addr offset = addr - (bAddr << m_shift);
         size_t dataOffset = 0;
         
-        allocIfNeeded(bAddr);
-
         while (dataOffset != size) {
-            m_buffer[bAddr][offset] = data[dataOffset];
-            offset++;
-            dataOffset++;
-
-            if (offset == m_allocUnit) {
-                offset = 0;
-                bAddr++;
-                allocIfNeeded(bAddr);
-            }
+            allocIfNeeded(bAddr);
+            size_t bytes = std::min(size - dataOffset, (size_t)(m_allocUnit - offset));
+            memcpy(m_buffer[bAddr] + offset, data.data() + dataOffset, bytes);
+            dataOffset += bytes;
+            offset = 0;
+            bAddr++;
         }
     }        
 
@@ -132,17 +140,13 @@ public:
         Addr offset = addr - (bAddr << m_shift);
         size_t dataOffset = 0;
         
-        allocIfNeeded(bAddr);
-        
         while (dataOffset != size) {
-            data[dataOffset] = m_buffer[bAddr][offset];
-            offset++;
-            dataOffset++;
-            if (offset == m_allocUnit) {
-                bAddr++;
-                offset = 0;
-                allocIfNeeded(bAddr);
-            }
+            allocIfNeeded(bAddr);
+            size_t bytes = std::min(size - dataOffset, (size_t)(m_allocUnit - offset));
+            memcpy(data.data() + dataOffset, m_buffer[bAddr] + offset, bytes);
+            dataOffset += bytes;
+            offset = 0;
+            bAddr++;
         }
     }
 
@@ -170,6 +174,226 @@ private:
     unsigned int m_shift;
 };
 
+/*
+ * Sparse backing store
+ * Memory is allocated lazily in aligned, power-of-two sized chunks. Chunks that are not allocated
+ * read as zero. Writing all-zero data to them does not allocate, and a chunk that becomes all zero
+ * is released, so zeroed regions do not hold memory.
+ * The store can be saved to an image file and later restored from it. Restored chunks are mapped
+ * copy-on-write from the image so a large warmed-up image is paged in only as it is touched.
+ *
+ * Image format: header, chunk index (one Addr per chunk), padding to a page boundary, chunk data.
+ *
+ * Errors are thrown: 1 if the image cannot be opened, 2 if the zero chunk cannot be mapped, 3 if the
+ * image is not valid for this chunk size, 4 if the chunk size is not a power of two, and
+ * std::bad_alloc if a chunk cannot be mapped.
+ */
+class BackingSparse : public Backing {
+public:
+    BackingSparse(size_t chunkSize, std::string imageFile = "") : Backing(), m_chunkSize(chunkSize) {
+        if (0 == m_chunkSize || 0 != (m_chunkSize & (m_chunkSize - 1))) {
+            throw 4;
+        }
+        m_shift = 0;
+        while (((size_t)1 << m_shift) < m_chunkSize) m_shift++;
+        m_zeroChunk = (uint8_t*) mmap(NULL, m_chunkSize, PROT_READ, MAP_PRIVATE|MAP_ANON, -1, 0);
+        if (m_zeroChunk == MAP_FAILED) {
+            throw 2;
+        }
+        if (!imageFile.empty())
+            restore(imageFile);
+    }
+
+    ~BackingSparse() {
+        for (ChunkMap::iterator it = m_chunks.begin(); it != m_chunks.end(); it++) {
+            if (!m_imageChunks.count(it->first))
+                munmap(it->second.data, m_chunkSize);
+        }
+        if (m_image) munmap(m_image, m_imageSize);
+        munmap(m_zeroChunk, m_chunkSize);
+    }
+
+    void set( Addr addr, uint8_t value ) {
+        Addr cAddr = addr >> m_shift;
+        ChunkMap::iterator it = m_chunks.find(cAddr);
+        if (it == m_chunks.end()) {
+            if (value == 0) return;
+            it = allocateChunk(cAddr);
+        }
+        write(it, addr & (m_chunkSize - 1), &value, 1);
+    }
+
+    void set( Addr addr, size_t size, const std::vector<uint8_t> &data ) {
+        Addr cAddr = addr >> m_shift;
+        Addr offset = addr & (m_chunkSize - 1);
+        size_t dataOffset = 0;
+
+        while (dataOffset != size) {
+            size_t bytes = std::min(size - dataOffset, (size_t)(m_chunkSize - offset));
+            ChunkMap::iterator it = m_chunks.find(cAddr);
+            if (it == m_chunks.end() && !isZero(data.data() + dataOffset, bytes))
+                it = allocateChunk(cAddr);
+            if (it != m_chunks.end())
+                write(it, offset, data.data() + dataOffset, bytes);
+            dataOffset += bytes;
+            offset = 0;
+            cAddr++;
+        }
+    }
+
+    uint8_t get( Addr addr ) {
+        return findChunk(addr >> m_shift)[addr & (m_chunkSize - 1)];
+    }
+
+    void get( Addr addr, size_t size, std::vector<uint8_t> &data ) {
+        Addr cAddr = addr >> m_shift;
+        Addr offset = addr & (m_chunkSize - 1);
+        size_t dataOffset = 0;
+
+        while (dataOffset != size) {
+            size_t bytes = std::min(size - dataOffset, (size_t)(m_chunkSize - offset));
+            memcpy(data.data() + dataOffset, findChunk(cAddr) + offset, bytes);
+            dataOffset += bytes;
+            offset = 0;
+            cAddr++;
+        }
+    }
+
+    size_t getAllocatedChunks() { return m_chunks.size(); }
+
+    /* Write an image of the store to 'file'. Chunks that hold only zeros are omitted. Returns false on error.
+     * The image is written to 'file'.tmp and renamed over 'file' so that saving over the image this store
+     * was restored from does not truncate the file under its mapping. */
+    bool save( std::string file ) {
+        std::vector<Addr> index;
+        for (ChunkMap::iterator it = m_chunks.begin(); it != m_chunks.end(); it++) {
+            if (!isZero(it->second.data, m_chunkSize)) index.push_back(it->first);
+        }
+        std::sort(index.begin(), index.end());
+
+        ImageHeader header;
+        memcpy(header.magic, imageMagic(), sizeof(header.magic));
+        header.chunkSize = m_chunkSize;
+        header.numChunks = index.size();
+        header.dataOffset = dataOffset(index.size());
+
+        std::string tmpFile = file + ".tmp";
+        FILE* fp = fopen(tmpFile.c_str(), "wb");
+        if (!fp) return false;
+        bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+        ok = ok && (index.empty() || fwrite(index.data(), sizeof(Addr), index.size(), fp) == index.size());
+        ok = ok && fseek(fp, header.dataOffset, SEEK_SET) == 0;
+        for (std::vector<Addr>::iterator it = index.begin(); ok && it != index.end(); it++)
+            ok = fwrite(m_chunks[*it].data, m_chunkSize, 1, fp) == 1;
+        ok = (fflush(fp) == 0) && ok;
+        ok = (fclose(fp) == 0) && ok;
+        ok = ok && rename(tmpFile.c_str(), file.c_str()) == 0;
+        if (!ok) unlink(tmpFile.c_str());
+        return ok;
+    }
+
+private:
+    struct ImageHeader {
+        char magic[8];
+        uint64_t chunkSize;
+        uint64_t numChunks;
+        uint64_t dataOffset;
+    };
+
+    struct Chunk {
+        uint8_t* data;
+        size_t nonZero;     // Number of non-zero bytes, NOT_COUNTED until an image chunk is first written
+    };
+    typedef std::unordered_map<Addr,Chunk> ChunkMap;
+
+    static const size_t NOT_COUNTED = (size_t)-1;
+
+    static const char* imageMagic() { return "SSTMEMB1"; }
+
+    size_t dataOffset(size_t numChunks) {
+        size_t page = sysconf(_SC_PAGESIZE);
+        size_t bytes = sizeof(ImageHeader) + numChunks * sizeof(Addr);
+        return (bytes + page - 1) & ~(page - 1);
+    }
+
+    /* Map the chunks in an image copy-on-write. Throws 1 if the file cannot be opened, 3 if it is not a valid image */
+    void restore( std::string file ) {
+        int fd = open(file.c_str(), O_RDONLY);
+        if (fd < 0) throw 1;
+
+        ImageHeader header;
+        std::vector<Addr> index;
+        bool ok = (pread(fd, &header, sizeof(header), 0) == sizeof(header)) && !memcmp(header.magic, imageMagic(), sizeof(header.magic))
+            && (header.chunkSize == m_chunkSize) && (header.dataOffset == dataOffset(header.numChunks));
+        if (ok && header.numChunks != 0) {
+            index.resize(header.numChunks);
+            ssize_t bytes = header.numChunks * sizeof(Addr);
+            ok = pread(fd, index.data(), bytes, sizeof(header)) == bytes;
+            if (ok) {
+                m_imageSize = header.numChunks * m_chunkSize;
+                m_image = (uint8_t*) mmap(NULL, m_imageSize, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, header.dataOffset);
+                ok = (m_image != MAP_FAILED);
+                if (!ok) m_image = nullptr;
+            }
+        }
+        close(fd);
+        if (!ok) throw 3;
+
+        // Counting non-zero bytes here would page in the whole image, so it is done on first write
+        for (size_t i = 0; i < index.size(); i++) {
+            Chunk chunk = { m_image + i * m_chunkSize, NOT_COUNTED };
+            m_chunks[index[i]] = chunk;
+            m_imageChunks.insert(index[i]);
+        }
+    }
+
+    bool isZero(const uint8_t* data, size_t size) {
+        return (data[0] == 0) && !memcmp(data, data + 1, size - 1);
+    }
+
+    /* For reads, unallocated chunks read from the shared zero chunk */
+    uint8_t* findChunk(Addr cAddr) {
+        ChunkMap::iterator it = m_chunks.find(cAddr);
+        return (it == m_chunks.end()) ? m_zeroChunk : it->second.data;
+    }
+
+    /* Anonymous mappings are zero-filled by the OS as they are touched */
+    ChunkMap::iterator allocateChunk(Addr cAddr) {
+        Chunk chunk = { (uint8_t*) mmap(NULL, m_chunkSize, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANON|MAP_NORESERVE, -1, 0), 0 };
+        if (chunk.data == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return m_chunks.insert(std::make_pair(cAddr, chunk)).first;
+    }
+
+    /* Write into an allocated chunk and release the chunk if it is left holding only zeros */
+    void write(ChunkMap::iterator it, Addr offset, const uint8_t* src, size_t bytes) {
+        Chunk &chunk = it->second;
+        uint8_t* dst = chunk.data + offset;
+        if (chunk.nonZero == NOT_COUNTED)
+            chunk.nonZero = m_chunkSize - std::count(chunk.data, chunk.data + m_chunkSize, 0);
+        for (size_t i = 0; i < bytes; i++) {
+            if (dst[i] == 0 && src[i] != 0) chunk.nonZero++;
+            else if (dst[i] != 0 && src[i] == 0) chunk.nonZero--;
+        }
+        memcpy(dst, src, bytes);
+
+        if (chunk.nonZero == 0) {
+            if (!m_imageChunks.erase(it->first))
+                munmap(chunk.data, m_chunkSize);
+            m_chunks.erase(it);
+        }
+    }
+
+    ChunkMap m_chunks;
+    std::set<Addr> m_imageChunks;   // Chunks that point into m_image rather than their own mapping
+    uint8_t* m_zeroChunk;
+    uint8_t* m_image = nullptr;
+    size_t m_imageSize = 0;
+    size_t m_chunkSize;
+    unsigned int m_shift;
+};
+
 }
 }
 }
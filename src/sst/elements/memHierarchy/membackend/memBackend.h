@@ -103,6 +103,7 @@ public:
     virtual int32_t getMaxReqPerCycle() { return m_maxReqPerCycle; } 
     virtual const std::string& getClockFreq() { return m_clockFreq; }
     virtual bool isClocked() { return true; }
+    virtual bool isBatchCapable() { return false; }
     virtual bool issueCustomRequest(ReqId, CustomCmdInfo*) {
         output->fatal(CALL_INFO, -1, "Error (%s): This backend cannot handle custom requests\n", getName().c_str());
         return false;
@@ -126,6 +127,30 @@ class SimpleMemBackend : public MemBackend {
 
     virtual bool issueRequest( ReqId, Addr, bool isWrite, unsigned numBytes ) = 0; 
 
+    /* Batch issue, used if isBatchCapable() returns true. Backends whose rejections are
+     * per-resource (e.g., a busy bank) opt in so that one blocked request does not stall
+     * the requests behind it. Pieces of the same request must be accepted in order and at
+     * most maxIssue requests may be accepted (no limit if negative).
+     */
+    virtual void issueBatch( std::vector<MemBackendConvertor::BatchReq>& reqs, int32_t maxIssue ) {
+        int32_t issued = 0;
+        uint32_t blockedId = 0;
+        bool blocked = false;
+        for (std::vector<MemBackendConvertor::BatchReq>::iterator it = reqs.begin(); it != reqs.end(); it++) {
+            if (issued == maxIssue) break;
+            if (it->accepted) continue;
+            uint32_t baseId = MemBackendConvertor::BaseReq::getBaseId(it->id);
+            if (blocked && baseId == blockedId) continue;
+            it->accepted = issueRequest(it->id, it->addr, it->isWrite, it->numBytes);
+            if (it->accepted) {
+                issued++;
+            } else {
+                blocked = true;
+                blockedId = baseId;
+            }
+        }
+    }
+
     void handleMemResponse( ReqId id ) {
         m_respFunc( id );
     }
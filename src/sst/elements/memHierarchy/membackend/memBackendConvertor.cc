@@ -55,6 +55,10 @@ MemBackendConvertor::MemBackendConvertor(Component *comp, Params& params ) :
     }
     
     m_clockBackend = m_backend->isClocked();
+
+    m_batchIssue = false;
+    m_batchWindow = params.find<uint32_t>("batch_window", 32);
+    if (m_batchWindow == 0) m_batchWindow = 1;
     
     stat_GetSReqReceived    = registerStatistic<uint64_t>("requests_received_GetS");
     stat_GetSXReqReceived  = registerStatistic<uint64_t>("requests_received_GetSX");
@@ -105,6 +109,13 @@ bool MemBackendConvertor::clock(Cycle_t cycle) {
         }
 
         BaseReq* req = m_requestQueue.front();
+
+        if ( m_batchIssue && req->isMemEv() ) {
+            int32_t maxReqs = m_backend->getMaxReqPerCycle();
+            cycleWithIssue = clockBatch( maxReqs < 0 ? -1 : maxReqs - reqsThisCycle ) || cycleWithIssue;
+            break;
+        }
+
         Debug(_L10_, "Processing request: %s\n", req->getString().c_str());
 
         if ( issue( req ) ) {
@@ -120,6 +131,7 @@ bool MemBackendConvertor::clock(Cycle_t cycle) {
 
         if ( req->issueDone() ) {
             Debug(_L10_, "Completed issue of request\n");
+            unindexReq( req );
             m_requestQueue.pop_front();
         }
     }
@@ -142,6 +154,61 @@ bool MemBackendConvertor::clock(Cycle_t cycle) {
     return false;
 }
 
+/*
+ * Offer the backend up to m_batchWindow backend-sized requests from the head of the queue
+ * in one call so it can schedule across them. Requests it accepts may be out of queue order
+ * but the pieces of a single request are accepted in order. Stops at the first custom command,
+ * those are issued one at a time.
+ * maxIssue = requests left in this cycle's max_requests_per_cycle, negative if unlimited
+ * Return whether anything was issued.
+ */
+bool MemBackendConvertor::clockBatch( int32_t maxIssue ) {
+    m_batch.clear();
+    m_batchOwners.clear();
+
+    std::deque<BaseReq*>::iterator it = m_requestQueue.begin();
+    for ( ; it != m_requestQueue.end() && m_batch.size() < m_batchWindow; it++) {
+        if (!(*it)->isMemEv()) break;
+        MemReq* req = static_cast<MemReq*>(*it);
+        uint32_t offset = req->processed();
+        do {
+            BatchReq breq = { req->id(offset), req->addr(offset), req->isWrite(), m_backendRequestWidth, false };
+            m_batch.push_back(breq);
+            m_batchOwners.push_back(req);
+            offset += m_backendRequestWidth;
+        } while (offset < req->size() && m_batch.size() < m_batchWindow);
+    }
+    std::deque<BaseReq*>::iterator scanEnd = it;
+
+    issueBatch(m_batch, maxIssue);
+
+    size_t accepted = 0;
+    for (size_t i = 0; i < m_batch.size(); i++) {
+        if (!m_batch[i].accepted) continue;
+        Debug(_L10_, "Batch issued request: %s\n", m_batchOwners[i]->getString().c_str());
+        m_batchOwners[i]->increment( m_backendRequestWidth );
+        accepted++;
+    }
+
+    if (accepted < m_batch.size())
+        stat_cyclesAttemptIssueButRejected->addData(1);
+    if (accepted == 0)
+        return false;
+
+    /* Remove completely issued requests from the scanned part of the queue, keeping the rest in order */
+    std::deque<BaseReq*>::iterator out = m_requestQueue.begin();
+    for (it = m_requestQueue.begin(); it != scanEnd; it++) {
+        if ((*it)->issueDone()) {
+            Debug(_L10_, "Completed issue of request\n");
+            unindexReq( *it );
+        } else {
+            *out++ = *it;
+        }
+    }
+    m_requestQueue.erase(out, scanEnd);
+    return true;
+}
+
 /*
  * Called by MemController to turn the clock back on
  * cycle = current cycle
@@ -21,6 +21,8 @@
 #include <sst/core/event.h>
 #include <sst/core/warnmacros.h>
 
+#include <unordered_map>
+
 #include "sst/elements/memHierarchy/memEvent.h"
 #include "sst/elements/memHierarchy/customcmd/customCmdMemory.h"
 
@@ -42,6 +44,7 @@ class MemBackendConvertor : public SubComponent {
             {"debug_mask",      "(uint) Mask on debug_level", "0"},\
             {"debug_location",  "(uint) 0: No debugging, 1: STDOUT, 2: STDERR, 3: FILE", "0"},\
             {"request_width",   "(uint) Max size of a request that can be accepted by the memory controller", "64"},\
+            {"batch_window",    "(uint) For backends that accept batched requests, max number of pending backend requests offered to the backend each cycle", "32"},\
             {"backend",         "Backend memory model to use for timing. Defaults to 'simpleMem'", "memHierarchy.simpleMem"}
 
 #define MEMBACKENDCONVERTOR_ELI_STATS { "cycles_with_issue",                  "Total cycles with successful issue to back end",   "cycles",   1 },\
@@ -60,6 +63,15 @@ class MemBackendConvertor : public SubComponent {
 
     typedef uint64_t ReqId;
 
+    /* A backend-sized request offered to a batch-capable backend. The backend sets 'accepted' on those it takes. */
+    struct BatchReq {
+        ReqId       id;
+        Addr        addr;
+        bool        isWrite;
+        unsigned    numBytes;
+        bool        accepted;
+    };
+
     class BaseReq {
     public:
 
@@ -113,6 +125,8 @@ class MemBackendConvertor : public SubComponent {
 
         uint32_t processed()    { return m_offset; }
         uint64_t id()           { return ((uint64_t)m_reqId << 32) | m_offset; }
+        uint64_t id( uint32_t offset )  { return ((uint64_t)m_reqId << 32) | offset; }
+        Addr addr( uint32_t offset )    { return m_event->getBaseAddr() + offset; }
         MemEvent* getMemEvent() { return m_event; }
         bool isWrite()          { return (m_event->getCmd() == Command::PutM || (m_event->queryFlag(MemEvent::F_NONCACHEABLE) && m_event->getCmd() == Command::GetX)) ? true : false; }
         uint32_t size()         { return m_event->getSize(); }
@@ -190,32 +204,26 @@ class MemBackendConvertor : public SubComponent {
     uint32_t    m_backendRequestWidth;
 
     bool m_clockBackend;
+    bool m_batchIssue;      // Backend accepts batches of requests, set by subclasses that support it
 
   private:
     virtual bool issue(BaseReq*) = 0;
+    virtual void issueBatch( std::vector<BatchReq>& UNUSED(reqs), int32_t UNUSED(maxIssue) ) { }
+    bool clockBatch( int32_t maxIssue );
 
 
 
 
     bool setupMemReq( MemEvent* ev ) {
         if ( Command::FlushLine == ev->getCmd() || Command::FlushLineInv == ev->getCmd() ) {
-            // TODO optimize if this becomes a problem, it is slow
+            QueueIndex::iterator idx = m_queuedByAddr.find(ev->getBaseAddr());
+            if (idx == m_queuedByAddr.end()) return false;
+
             std::set<SST::Event::id_type> dependsOn;
-            for (std::deque<BaseReq*>::iterator it = m_requestQueue.begin(); it != m_requestQueue.end(); it++) {
-                if (!(*it)->isMemEv())
-                    continue;
-                MemReq * mr = static_cast<MemReq*>(*it);
-                if (mr->baseAddr() == ev->getBaseAddr()) {
-                    MemEvent * req = mr->getMemEvent();
-                    dependsOn.insert(req->getID());
-                    if (m_dependentRequests.find(req->getID()) == m_dependentRequests.end()) {
-                        std::set<MemEvent*, memEventCmp> flushSet;
-                        flushSet.insert(ev);
-                        m_dependentRequests.insert(std::make_pair(req->getID(), flushSet));
-                    } else {
-                        (m_dependentRequests.find(req->getID())->second).insert(ev);
-                    }
-                }
+            for (std::vector<MemReq*>::iterator it = idx->second.begin(); it != idx->second.end(); it++) {
+                MemEvent * req = (*it)->getMemEvent();
+                dependsOn.insert(req->getID());
+                m_dependentRequests[req->getID()].insert(ev);
             }
 
             if (dependsOn.empty()) return false;
@@ -227,9 +235,26 @@ class MemBackendConvertor : public SubComponent {
         MemReq* req = new MemReq( ev, id );
         m_requestQueue.push_back( req );
         m_pendingRequests[id] = req;
+        m_queuedByAddr[ev->getBaseAddr()].push_back(req);
         return true;
     }
 
+    /* Remove a request that has been completely issued from the flush dependency index */
+    void unindexReq( BaseReq* req ) {
+        if (!req->isMemEv()) return;
+        MemReq * mr = static_cast<MemReq*>(req);
+        QueueIndex::iterator idx = m_queuedByAddr.find(mr->baseAddr());
+        std::vector<MemReq*>& reqs = idx->second;
+        for (size_t i = 0; i < reqs.size(); i++) {
+            if (reqs[i] == mr) {
+                reqs[i] = reqs.back();
+                reqs.pop_back();
+                break;
+            }
+        }
+        if (reqs.empty()) m_queuedByAddr.erase(idx);
+    }
+
     inline void doClockStat( ) {
         stat_totalCycles->addData(1);        
     }
@@ -284,9 +309,16 @@ class MemBackendConvertor : public SubComponent {
 
     typedef std::map<uint32_t,BaseReq*>    PendingRequests;
 
+    typedef std::unordered_map<Addr, std::vector<MemReq*> > QueueIndex;
+
     std::deque<BaseReq*>     m_requestQueue;
     PendingRequests         m_pendingRequests;
     uint32_t                m_frontendRequestWidth;
+    QueueIndex              m_queuedByAddr;     // Requests in m_requestQueue by base address, for flush dependencies
+
+    uint32_t                m_batchWindow;
+    std::vector<BatchReq>   m_batch;
+    std::vector<MemReq*>    m_batchOwners;      // Request each entry in m_batch belongs to
 
     std::map<MemEvent*, std::set<SST::Event::id_type> > m_waitingFlushes; // Set of request IDs for each flush
     std::map<SST::Event::id_type, std::set<MemEvent*, memEventCmp> > m_dependentRequests; // Reverse map, set of flushes for each request ID, for faster lookup
@@ -0,0 +1,234 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#include <sst_config.h>
+#include "sst/elements/memHierarchy/util.h"
+#include "membackend/requestReorderFRFCFS.h"
+
+using namespace SST;
+using namespace SST::MemHierarchy;
+
+/*------------------------------- FR-FCFS Backend ------------------------------- */
+RequestReorderFRFCFS::RequestReorderFRFCFS(Component *comp, Params &params) : SimpleMemBackend(comp, params){
+
+    fixupParams( params, "clock", "backend.clock" );
+
+    // Get parameters
+    reqsPerCycle = params.find<int>("max_issue_per_cycle", -1);
+
+    banks = params.find<unsigned int>("banks", 8);
+    UnitAlgebra rowSize(params.find<std::string>("row_size", "8KiB"));
+    UnitAlgebra requestSize(params.find<std::string>("bank_interleave_granularity", "64B"));
+    bankQueueSize = params.find<unsigned int>("bank_queue_size", 0);
+    lookahead = params.find<unsigned int>("lookahead", 16);
+    starvationLimit = params.find<unsigned int>("starvation_limit", 16);
+    writeHigh = params.find<unsigned int>("write_high_watermark", 32);
+    writeLow = params.find<unsigned int>("write_low_watermark", 16);
+
+    // Check parameters
+    if (banks == 0) {
+        output->fatal(CALL_INFO, -1, "Invalid param(%s): banks - must be at least 1. You specified '0'.\n", comp->getName().c_str());
+    }
+    if (!(rowSize.hasUnits("B"))) {
+        output->fatal(CALL_INFO, -1, "Invalid param(%s): row_size - must have units of 'B' (bytes). You specified %s.\n", comp->getName().c_str(), rowSize.toString().c_str());
+    }
+    if (!isPowerOfTwo(rowSize.getRoundedValue())) {
+        output->fatal(CALL_INFO, -1, "Invalid param(%s): row_size - must be a power of two. You specified %s.\n", comp->getName().c_str(), rowSize.toString().c_str());
+    }
+    if (!(requestSize.hasUnits("B"))) {
+        output->fatal(CALL_INFO, -1, "Invalid param(%s): bank_interleave_granularity - must have units of 'B' (bytes). You specified '%s'.\n", comp->getName().c_str(), requestSize.toString().c_str());
+    }
+    if (!isPowerOfTwo(requestSize.getRoundedValue())) {
+        output->fatal(CALL_INFO, -1, "Invalid param(%s): bank_interleave_granularity - must be a power of two. You specified '%s'.\n", comp->getName().c_str(), requestSize.toString().c_str());
+    }
+    if (writeLow > writeHigh) {
+        output->fatal(CALL_INFO, -1, "Invalid param(%s): write_low_watermark - must not be larger than write_high_watermark (%u). You specified '%u'.\n", comp->getName().c_str(), writeHigh, writeLow);
+    }
+    if (lookahead == 0) lookahead = 1;
+
+    // Create our backend & copy 'mem_size' through for now
+    std::string backendName = params.find<std::string>("backend", "memHierarchy.simpleDRAM");
+    Params backendParams = params.find_prefix_params("backend.");
+    backendParams.insert("mem_size", params.find<std::string>("mem_size"));
+    backend = dynamic_cast<SimpleMemBackend*>(loadSubComponent(backendName, backendParams));
+    using std::placeholders::_1;
+    backend->setResponseHandler( std::bind( &RequestReorderFRFCFS::handleBackendResponse, this, _1 )  );
+
+    // Set up local variables
+    nextBank = 0;
+    rowOffset = log2Of(rowSize.getRoundedValue());
+    lineOffset = log2Of(requestSize.getRoundedValue());
+    bankState.resize(banks);
+    queuedWrites = 0;
+    nextSeq = 0;
+    drainingWrites = false;
+    busyBanks = 0;
+
+    statRowHit = registerStatistic<uint64_t>("row_hits");
+    statRowMiss = registerStatistic<uint64_t>("row_misses");
+    statStarved = registerStatistic<uint64_t>("starved_issues");
+    statHazardStalls = registerStatistic<uint64_t>("hazard_stalls");
+    statWriteDrain = registerStatistic<uint64_t>("write_drains");
+    statBankParallelism = registerStatistic<uint64_t>("bank_parallelism");
+}
+
+bool RequestReorderFRFCFS::issueRequest(ReqId id, Addr addr, bool isWrite, unsigned numBytes ) {
+    unsigned int bank = (addr >> lineOffset) % banks;
+    Bank& state = bankState[bank];
+
+    if (bankQueueSize != 0 && state.reads.size() + state.writes.size() >= bankQueueSize)
+        return false;
+
+#ifdef __SST_DEBUG_OUTPUT__
+    output->debug(_L10_, "Reorderer received request for 0x%" PRIx64 ", bank %u\n", (Addr)addr, bank);
+#endif
+
+    if (isWrite) {
+        state.writes.push_back(Req(id,addr,isWrite,numBytes,nextSeq++));
+        queuedWrites++;
+        if (!drainingWrites && queuedWrites >= writeHigh) {
+            drainingWrites = true;
+            statWriteDrain->addData(1);
+        }
+    } else {
+        state.reads.push_back(Req(id,addr,isWrite,numBytes,nextSeq++));
+    }
+    return true;
+}
+
+/*
+ * Issue one request from each bank, starting after the last bank that issued,
+ * up to max_issue_per_cycle
+ */
+bool RequestReorderFRFCFS::clock(Cycle_t cycle) {
+    int reqsIssuedThisCycle = 0;
+    unsigned int bank = nextBank;
+    for (unsigned int i = 0; i < banks; i++) {
+        if (issueFromBank(bank)) {
+            reqsIssuedThisCycle++;
+            nextBank = (bank + 1) % banks;
+            if (reqsIssuedThisCycle == reqsPerCycle) break;
+        }
+        bank = (bank + 1) % banks;
+    }
+
+    if (busyBanks != 0)
+        statBankParallelism->addData(busyBanks);
+
+    backend->clock(cycle);
+    return false;
+}
+
+/*
+ * Return whether queue holds a request to the same line as req that arrived before it
+ */
+bool RequestReorderFRFCFS::hasOlderConflict(const std::deque<Req>& queue, const Req& req) {
+    Addr line = req.addr >> lineOffset;
+    for (std::deque<Req>::const_iterator it = queue.begin(); it != queue.end() && it->seq < req.seq; it++) {
+        if ((it->addr >> lineOffset) == line)
+            return true;
+    }
+    return false;
+}
+
+/*
+ * Pick the oldest row hit in the lookahead window, or the oldest request if there is no
+ * row hit or it has been bypassed too often, and try to issue it.
+ * If the pick would pass an older request of the other type to the same line (a read
+ * passing a write or a write passing a read), issue the oldest request in the bank instead.
+ * It has nothing older to wait for, so the bank cannot deadlock.
+ */
+bool RequestReorderFRFCFS::issueFromBank(unsigned int bankId) {
+    Bank& state = bankState[bankId];
+
+    std::deque<Req>* queue;
+    if (drainingWrites) queue = state.writes.empty() ? &state.reads : &state.writes;
+    else queue = state.reads.empty() ? &state.writes : &state.reads;
+
+    if (queue->empty())
+        return false;
+
+    std::deque<Req>::iterator pick = queue->begin();
+    bool starved = pick->bypassed >= starvationLimit;
+    if (state.rowValid && !starved) {
+        std::deque<Req>::iterator end = queue->size() > lookahead ? queue->begin() + lookahead : queue->end();
+        for (std::deque<Req>::iterator it = queue->begin(); it != end; it++) {
+            if ((it->addr >> rowOffset) == state.openRow) {
+                pick = it;
+                break;
+            }
+        }
+    }
+
+    std::deque<Req>* other = (queue == &state.reads) ? &state.writes : &state.reads;
+    if (hasOlderConflict(*other, *pick)) {
+        statHazardStalls->addData(1);
+        if (other->front().seq < queue->front().seq) queue = other;
+        pick = queue->begin();
+        starved = false;
+    }
+
+    if (!backend->issueRequest(pick->id, pick->addr, pick->isWrite, pick->numBytes))
+        return false;
+
+#ifdef __SST_DEBUG_OUTPUT__
+    output->debug(_L10_, "Reorderer issued request for 0x%" PRIx64 ", bank %u\n", (Addr)pick->addr, bankId);
+#endif
+
+    Addr row = pick->addr >> rowOffset;
+    if (state.rowValid && row == state.openRow) statRowHit->addData(1);
+    else statRowMiss->addData(1);
+    state.openRow = row;
+    state.rowValid = true;
+
+    if (pick == queue->begin()) {
+        if (starved) statStarved->addData(1);
+    } else {
+        queue->front().bypassed++;
+    }
+
+    outstanding[pick->id] = bankId;
+    if (state.outstanding++ == 0) busyBanks++;
+
+    if (pick->isWrite) {
+        queuedWrites--;
+        if (drainingWrites && queuedWrites <= writeLow) drainingWrites = false;
+    }
+
+    queue->erase(pick);
+    return true;
+}
+
+void RequestReorderFRFCFS::handleBackendResponse(ReqId id) {
+    std::unordered_map<ReqId, unsigned int>::iterator it = outstanding.find(id);
+    if (it != outstanding.end()) {
+        if (--bankState[it->second].outstanding == 0) busyBanks--;
+        outstanding.erase(it);
+    }
+    SimpleMemBackend::handleMemResponse(id);
+}
+
+/*
+ * Call throughs to our backend
+ */
+
+void RequestReorderFRFCFS::setup() {
+    backend->setup();
+}
+
+void RequestReorderFRFCFS::finish() {
+    backend->finish();
+}
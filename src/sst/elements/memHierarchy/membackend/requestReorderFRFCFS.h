@@ -0,0 +1,137 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#ifndef _H_SST_MEMH_REQUEST_REORDER_FRFCFS_BACKEND
+#define _H_SST_MEMH_REQUEST_REORDER_FRFCFS_BACKEND
+
+#include "sst/elements/memHierarchy/membackend/memBackend.h"
+#include <deque>
+#include <vector>
+#include <unordered_map>
+
+namespace SST {
+namespace MemHierarchy {
+
+/*
+ * First-ready, first-come-first-serve request scheduler
+ * Requests are queued per bank, with reads and writes in separate queues. Each cycle every bank
+ * with pending requests issues the oldest request to its open row within the lookahead window,
+ * or the oldest request if there is none. The oldest request is forced out once it has been
+ * bypassed starvation_limit times. Reads are preferred until the number of buffered writes
+ * reaches the high watermark, then writes are drained down to the low watermark.
+ * A request is never issued ahead of an older request of the other type to the same line
+ * (bank_interleave_granularity); the oldest request in the bank is issued instead.
+ */
+class RequestReorderFRFCFS : public SimpleMemBackend {
+public:
+/* Element Library Info */
+    SST_ELI_REGISTER_SUBCOMPONENT(RequestReorderFRFCFS, "memHierarchy", "reorderFRFCFS", SST_ELI_ELEMENT_VERSION(1,0,0),
+            "Request re-orderer, FR-FCFS scheduling with per-bank queues and write draining", "SST::MemHierarchy::MemBackend")
+
+    SST_ELI_DOCUMENT_PARAMS( MEMBACKEND_ELI_PARAMS,
+            /* Own parameters */
+            {"verbose",                     "Sets the verbosity of the backend output", "0"},
+            {"max_issue_per_cycle",         "Maximum number of requests to issue per cycle. 0 or negative is unlimited.", "-1"},
+            {"banks",                       "Number of banks", "8"},
+            {"bank_interleave_granularity", "Granularity of interleaving in bytes (B), generally a cache line. Must be a power of 2.", "64B"},
+            {"row_size",                    "Size of a row in bytes (B). Must be a power of 2.", "8KiB"},
+            {"bank_queue_size",             "Maximum number of requests queued per bank. 0 is unlimited.", "0"},
+            {"lookahead",                   "Number of requests per bank queue searched for a row hit.", "16"},
+            {"starvation_limit",            "Number of times the oldest request in a bank queue may be bypassed by row hits before it is issued.", "16"},
+            {"write_high_watermark",        "Number of buffered writes at which the scheduler starts draining writes.", "32"},
+            {"write_low_watermark",         "Number of buffered writes at which the scheduler stops draining writes.", "16"},
+            {"backend",                     "Backend memory system.", "memHierarchy.simpleDRAM"} )
+
+    SST_ELI_DOCUMENT_STATISTICS(
+            {"row_hits",            "Requests issued to the last row opened in their bank", "count", 1},
+            {"row_misses",          "Requests issued to a different row than the last one opened in their bank", "count", 1},
+            {"starved_issues",      "Requests issued because they reached the starvation limit", "count", 2},
+            {"hazard_stalls",       "Times the picked request had an older request of the other type to the same line, so the oldest request was issued instead", "count", 2},
+            {"write_drains",        "Number of times the write queues reached the high watermark", "count", 2},
+            {"bank_parallelism",    "Number of banks with requests outstanding in the backend, sampled each cycle with at least one", "banks", 2} )
+
+/* Begin class definition */
+    RequestReorderFRFCFS();
+    RequestReorderFRFCFS(Component *comp, Params &params);
+    virtual bool issueRequest( ReqId, Addr, bool isWrite, unsigned numBytes );
+    virtual bool isBatchCapable() { return true; }
+    virtual void setGetRequestorHandler( std::function<const std::string(ReqId)> func ) {
+        MemBackend::setGetRequestorHandler( func );
+        backend->setGetRequestorHandler( func );
+    }
+    void setup();
+    void finish();
+    bool clock(Cycle_t cycle);
+    virtual const std::string& getClockFreq() { return backend->getClockFreq(); }
+
+private:
+    void handleBackendResponse( ReqId id );
+
+    struct Req {
+        Req( ReqId id, Addr addr, bool isWrite, unsigned numBytes, uint64_t seq ) :
+            id(id), addr(addr), isWrite(isWrite), numBytes(numBytes), bypassed(0), seq(seq)
+        { }
+        ReqId id;
+        Addr addr;
+        bool isWrite;
+        unsigned numBytes;
+        unsigned int bypassed;      // Times a younger request has been issued ahead of this one
+        uint64_t seq;               // Arrival order
+    };
+
+    struct Bank {
+        std::deque<Req> reads;
+        std::deque<Req> writes;
+        Addr openRow;
+        bool rowValid;
+        unsigned int outstanding;   // Requests issued to the backend and not yet completed
+        Bank() : openRow(0), rowValid(false), outstanding(0) { }
+    };
+
+    bool issueFromBank( unsigned int bankId );
+    bool hasOlderConflict( const std::deque<Req>& queue, const Req& req );
+
+    SimpleMemBackend* backend;
+    unsigned int banks;         // Number of banks we're issuing to
+    unsigned int nextBank;      // Bank to start searching from next cycle
+    unsigned int rowOffset;     // Offset for determining request row
+    unsigned int lineOffset;    // Offset for determining line (needed for finding bank)
+    int reqsPerCycle;           // Number of requests to issue per cycle (max) -> memCtrl limits how many we accept
+    unsigned int bankQueueSize;
+    unsigned int lookahead;
+    unsigned int starvationLimit;
+    unsigned int writeHigh;
+    unsigned int writeLow;
+
+    std::vector<Bank> bankState;
+    unsigned int queuedWrites;
+    uint64_t nextSeq;
+    bool drainingWrites;
+    unsigned int busyBanks;     // Banks with outstanding backend requests
+    std::unordered_map<ReqId, unsigned int> outstanding;   // Bank each issued request maps to
+
+    Statistic<uint64_t>* statRowHit;
+    Statistic<uint64_t>* statRowMiss;
+    Statistic<uint64_t>* statStarved;
+    Statistic<uint64_t>* statHazardStalls;
+    Statistic<uint64_t>* statWriteDrain;
+    Statistic<uint64_t>* statBankParallelism;
+};
+
+}
+}
+
+#endif
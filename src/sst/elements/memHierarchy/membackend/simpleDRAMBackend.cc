@@ -133,6 +133,25 @@ void SimpleDRAM::handleSelfEvent(SST::Event *event){
     }
 }
 
+/*
+ * Row hits first: issue the requests in the batch that hit an open row on an idle bank,
+ * then offer the rest in order. A piece of a split request is only taken once the piece
+ * before it has been. Requests to the same address map to the same bank and row so they
+ * are never reordered.
+ */
+void SimpleDRAM::issueBatch( std::vector<MemBackendConvertor::BatchReq>& reqs, int32_t maxIssue ) {
+    int32_t issued = 0;
+    for (size_t i = 0; i < reqs.size() && issued != maxIssue; i++) {
+        if (i > 0 && !reqs[i-1].accepted && MemBackendConvertor::BaseReq::getBaseId(reqs[i-1].id) == MemBackendConvertor::BaseReq::getBaseId(reqs[i].id))
+            continue;
+        int bank = (reqs[i].addr >> lineOffset) & bankMask;
+        if (busy[bank] || openRow[bank] != (int)(reqs[i].addr >> rowOffset)) continue;
+        reqs[i].accepted = issueRequest(reqs[i].id, reqs[i].addr, reqs[i].isWrite, reqs[i].numBytes);
+        if (reqs[i].accepted) issued++;
+    }
+    SimpleMemBackend::issueBatch( reqs, maxIssue < 0 ? maxIssue : maxIssue - issued );
+}
+
 bool SimpleDRAM::issueRequest( ReqId reqId, Addr addr, bool isWrite, unsigned numBytes ){
 
     // Determine bank & row for address
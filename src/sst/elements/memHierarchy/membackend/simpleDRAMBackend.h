@@ -50,7 +50,9 @@ public:
     SimpleDRAM();
     SimpleDRAM(Component *comp, Params &params);
     bool issueRequest( ReqId, Addr, bool, unsigned );
+    void issueBatch( std::vector<MemBackendConvertor::BatchReq>& reqs, int32_t maxIssue );
     bool isClocked() { return false; }
+    bool isBatchCapable() { return true; }
 
     typedef enum {OPEN, CLOSED, DYNAMIC, TIMEOUT } RowPolicy;
 
@@ -28,6 +28,7 @@ SimpleMemBackendConvertor::SimpleMemBackendConvertor(Component *comp, Params &pa
 {
     using std::placeholders::_1;
     static_cast<SimpleMemBackend*>(m_backend)->setResponseHandler( std::bind( &SimpleMemBackendConvertor::handleMemResponse, this, _1 ) );
+    m_batchIssue = m_backend->isBatchCapable();
 }
 
 bool SimpleMemBackendConvertor::issue( BaseReq* req ) {
@@ -39,3 +40,7 @@ bool SimpleMemBackendConvertor::issue( BaseReq* req ) {
         return static_cast<SimpleMemBackend*>(m_backend)->issueCustomRequest( creq->id(), creq->getInfo() );
     }
 }
+
+void SimpleMemBackendConvertor::issueBatch( std::vector<BatchReq>& reqs, int32_t maxIssue ) {
+    static_cast<SimpleMemBackend*>(m_backend)->issueBatch( reqs, maxIssue );
+}
@@ -38,6 +38,7 @@ public:
     SimpleMemBackendConvertor(Component *comp, Params &params);
 
     virtual bool issue( BaseReq* req );
+    virtual void issueBatch( std::vector<BatchReq>& reqs, int32_t maxIssue );
 
     virtual void handleMemResponse( ReqId reqId ) {
         doResponse(reqId);
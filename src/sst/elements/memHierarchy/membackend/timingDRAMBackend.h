@@ -299,6 +299,7 @@ public:
     TimingDRAM();
     TimingDRAM(Component*, Params& );
     virtual bool issueRequest( ReqId, Addr, bool, unsigned );
+    virtual bool isBatchCapable() { return true; }
     void handleResponse(ReqId  id ) {
         output->verbose(CALL_INFO, 2, DBG_MASK, "req=%" PRIu64 "\n", id ); 
         handleMemResponse( id );
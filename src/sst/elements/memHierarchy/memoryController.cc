@@ -198,8 +198,8 @@ MemController::MemController(ComponentId_t id, Params &params) : Component(id),
         if (oldBackVal) backingType = "none";
     }
 
-    if (backingType != "none" && backingType != "mmap" && backingType != "malloc") {
-        out.fatal(CALL_INFO, -1, "%s, Error - Invalid param: backing. Must be one of 'none', 'malloc', or 'mmap'. You specified: %s\n",
+    if (backingType != "none" && backingType != "mmap" && backingType != "malloc" && backingType != "sparse") {
+        out.fatal(CALL_INFO, -1, "%s, Error - Invalid param: backing. Must be one of 'none', 'malloc', 'mmap', or 'sparse'. You specified: %s\n",
                 getName().c_str(), backingType.c_str());
     }
         
@@ -237,6 +237,32 @@ MemController::MemController(ComponentId_t id, Params &params) : Component(id),
         }
     } else if (backingType == "malloc") {
         backing_ = new Backend::BackingMalloc(sizeBytes);
+    } else if (backingType == "sparse") {
+        std::string memoryFile = params.find<std::string>("memory_file", NO_STRING_DEFINED );
+
+        if ( 0 == memoryFile.compare( NO_STRING_DEFINED ) ) {
+            memoryFile.clear();
+        }
+        try {
+            backing_ = new Backend::BackingSparse(sizeBytes, memoryFile);
+        }
+        catch ( int e ) {
+            if (e == 1)
+                out.fatal(CALL_INFO, -1, "%s, Error - unable to open memory_file. You specified '%s'.\n", getName().c_str(), memoryFile.c_str());
+            else if (e == 3)
+                out.fatal(CALL_INFO, -1, "%s, Error - memory_file is not a sparse backing image with a chunk size of %zu bytes (backing_size_unit). You specified '%s'.\n", 
+                        getName().c_str(), sizeBytes, memoryFile.c_str());
+            else if (e == 4)
+                out.fatal(CALL_INFO, -1, "%s, Error - backing_size_unit must be a power of two for the sparse backing store. Got %zu bytes.\n",
+                        getName().c_str(), sizeBytes);
+            else
+                out.fatal(CALL_INFO, -1, "%s, Error - unable to create backing store. Exception thrown is %d.\n", getName().c_str(), e);
+        }
+    }
+    backingOutFile_ = params.find<std::string>("backing_out_file", "");
+    if (!backingOutFile_.empty() && backingType != "sparse") {
+        out.fatal(CALL_INFO, -1, "%s, Error - Invalid param: backing_out_file. Only supported with backing = 'sparse'. You specified backing = '%s'.\n", 
+                getName().c_str(), backingType.c_str());
     }
 
     /* Clock Handler */
@@ -299,7 +325,7 @@ void MemController::handleEvent(SST::Event* event) {
             {
                 MemEvent* put = NULL;
                 if ( ev->getPayloadSize() != 0 ) {
-                    put = new MemEvent(this, ev->getBaseAddr(), ev->getBaseAddr(), Command::PutM, ev->getPayload() );
+                    put = new MemEvent(this, ev->getBaseAddr(), ev->getBaseAddr(), Command::PutM, ev->getSharedPayload().get() );
                     put->setFlag(MemEvent::F_NORESPONSE);
                     outstandingEvents_.insert(std::make_pair(put->getID(), put));
                     notifyListeners(ev);
@@ -447,6 +473,12 @@ void MemController::finish(void) {
     }
     memBackendConvertor_->finish();
     link_->finish();
+
+    if (!backingOutFile_.empty()) {
+        Backend::BackingSparse* sparse = static_cast<Backend::BackingSparse*>(backing_);
+        if (!sparse->save(backingOutFile_))
+            out.output("%s, Warning - unable to write backing_out_file '%s'\n", getName().c_str(), backingOutFile_.c_str());
+    }
 }
 
 void MemController::writeData(MemEvent* event) {
@@ -457,7 +489,7 @@ void MemController::writeData(MemEvent* event) {
     if (event->getCmd() == Command::PutM) { /* Write request to memory */
         if (is_debug_event(event)) { Debug(_L4_, "\tUpdate backing. Addr = %" PRIx64 ", Size = %i\n", addr, event->getSize()); }
             
-        backing_->set(addr, event->getSize(), event->getPayload());
+        backing_->set(addr, event->getSize(), event->getSharedPayload().get());
         
         return;
     }
@@ -465,7 +497,7 @@ void MemController::writeData(MemEvent* event) {
     if (noncacheable && event->getCmd() == Command::GetX) {
         if (is_debug_event(event)) { Debug(_L4_, "\tUpdate backing. Addr = %" PRIx64 ", Size = %i\n", addr, event->getSize()); }
         
-        backing_->set(addr, event->getSize(), event->getPayload());
+        backing_->set(addr, event->getSize(), event->getSharedPayload().get());
         
         return;
     }
@@ -483,7 +515,7 @@ void MemController::readData(MemEvent* event) {
     if (backing_)
         backing_->get(localAddr, event->getSize(), payload);
     
-    event->setPayload(payload);
+    event->setPayload(std::move(payload));
 }
 
 
@@ -491,8 +523,7 @@ void MemController::readData(MemEvent* event) {
 void MemController::writeData(Addr addr, std::vector<uint8_t> * data) {
     if (!backing_) return;
 
-    for (size_t i = 0; i < data->size(); i++)
-        backing_->set(addr + i, data->at(i));
+    backing_->set(addr, data->size(), *data);
 }
 
 
@@ -501,8 +532,7 @@ void MemController::readData(Addr addr, size_t bytes, std::vector<uint8_t> &data
     
     if (!backing_) return;
 
-    for (size_t i = 0; i < bytes; i++)
-        data[i] = backing_->get(addr + i);
+    backing_->get(addr, bytes, data);
 }
 
 
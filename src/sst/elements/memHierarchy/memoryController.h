@@ -51,9 +51,10 @@ public:
             {"debug_addr",          "(comma separated uint) Address(es) to be debugged. Leave empty for all, otherwise specify one or more, comma-separated values. Start and end string with brackets",""},\
             {"listenercount",       "(uint) Counts the number of listeners attached to this controller, these are modules for tracing or components like prefetchers", "0"},\
             {"listener%(listenercount)d", "(string) Loads a listener module into the controller", ""},\
-            {"backing",             "(string) Type of backing store to use. Options: 'none' - no backing store (only use if simulation does not require correct memory values), 'malloc', or 'mmap'", "mmap"},\
-            {"backing_size_unit",   "(string) For 'malloc' backing stores, malloc granularity", "1MiB"},\
-            {"memory_file",         "(string) Optional backing-store file to pre-load memory, or store resulting state", "N/A"},\
+            {"backing",             "(string) Type of backing store to use. Options: 'none' - no backing store (only use if simulation does not require correct memory values), 'malloc', 'mmap', or 'sparse' - lazily allocated, zero chunks are not stored", "mmap"},\
+            {"backing_size_unit",   "(string) For 'malloc' and 'sparse' backing stores, allocation granularity", "1MiB"},\
+            {"memory_file",         "(string) Optional backing-store file to pre-load memory, or store resulting state. For 'sparse' backing stores, an image written by 'backing_out_file' to restore", "N/A"},\
+            {"backing_out_file",    "(string) For 'sparse' backing stores, optional file to write a memory image to at the end of simulation", ""},\
             {"addr_range_start",    "(uint) Lowest address handled by this memory.", "0"},\
             {"addr_range_end",      "(uint) Highest address handled by this memory.", "uint64_t-1"},\
             {"interleave_size",     "(string) Size of interleaved chunks. E.g., to interleave 8B chunks among 3 memories, set size=8B, step=24B", "0B"},\
@@ -130,6 +131,7 @@ protected:
 
     MemBackendConvertor*    memBackendConvertor_;
     Backend::Backing*       backing_; 
+    std::string             backingOutFile_;    // If set, a sparse backing store is saved here at finish()
 
     MemLinkBase* link_;         // Link to the rest of memHierarchy 
     bool clockLink_;            // Flag - should we call clock() on this link or not
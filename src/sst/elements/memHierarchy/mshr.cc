@@ -50,7 +50,123 @@ struct MSHREntryCompare {
     Type type_;
 };
 
-MSHR::MSHR(Output* debug, int maxSize, string cacheName, std::set<Addr> debugAddr) {
+/* mshrTable
+ * Open-addressed hash table with linear probing and backward-shift deletion (no tombstones).
+ * Kept at most half full. Entries are pulled from a pool and recycled on erase.
+ */
+mshrTable::mshrTable(unsigned int poolSize) {
+    size_ = 0;
+    lastProbeLength_ = 0;
+
+    unsigned int slots = 16;
+    while (slots < 2 * poolSize) slots <<= 1;
+    slots_.resize(slots, Slot{0, nullptr});
+    mask_ = slots - 1;
+    shift_ = 64 - log2Of(slots);
+
+    for (unsigned int i = 0; i < poolSize; i++) {
+        pool_.emplace_back();
+        freeList_.push_back(&pool_.back());
+    }
+}
+
+/* Return index of the slot holding addr, or of the empty slot ending its probe sequence */
+unsigned int mshrTable::findSlot(Addr addr) const {
+    unsigned int index = home(addr);
+    lastProbeLength_ = 1;
+    while (slots_[index].entry != nullptr && slots_[index].addr != addr) {
+        index = (index + 1) & mask_;
+        lastProbeLength_++;
+    }
+    return index;
+}
+
+mshrEntry* mshrTable::find(Addr addr) const {
+    return slots_[findSlot(addr)].entry;
+}
+
+mshrEntry& mshrTable::operator[](Addr addr) {
+    unsigned int index = findSlot(addr);
+    if (slots_[index].entry != nullptr) return *(slots_[index].entry);
+
+    if (2 * (size_ + 1) > slots_.size()) {
+        grow();
+        index = findSlot(addr);
+    }
+    slots_[index].addr = addr;
+    slots_[index].entry = allocate();
+    size_++;
+    return *(slots_[index].entry);
+}
+
+void mshrTable::erase(Addr addr) {
+    unsigned int index = findSlot(addr);
+    mshrEntry* entry = slots_[index].entry;
+    if (entry == nullptr) return;
+
+    entry->mshrQueue.clear();
+    entry->dataBuffer.clear();
+    freeList_.push_back(entry);
+    size_--;
+
+    /* Shift later members of the cluster back so that lookups never stop early */
+    unsigned int next = index;
+    while (true) {
+        next = (next + 1) & mask_;
+        if (slots_[next].entry == nullptr) break;
+        unsigned int nextHome = home(slots_[next].addr);
+        bool movable = (index <= next) ? (nextHome <= index || nextHome > next) : (nextHome <= index && nextHome > next);
+        if (movable) {
+            slots_[index] = slots_[next];
+            index = next;
+        }
+    }
+    slots_[index].entry = nullptr;
+}
+
+vector<Addr> mshrTable::getAddrs() const {
+    vector<Addr> addrs;
+    addrs.reserve(size_);
+    for (vector<Slot>::const_iterator it = slots_.begin(); it != slots_.end(); it++) {
+        if (it->entry != nullptr) addrs.push_back(it->addr);
+    }
+    std::sort(addrs.begin(), addrs.end());
+    return addrs;
+}
+
+mshrEntry* mshrTable::allocate() {
+    mshrEntry* entry;
+    if (freeList_.empty()) {
+        pool_.emplace_back();
+        entry = &pool_.back();
+    } else {
+        entry = freeList_.back();
+        freeList_.pop_back();
+    }
+    entry->acksNeeded = 0;
+    return entry;
+}
+
+void mshrTable::grow() {
+    vector<Slot> oldSlots;
+    oldSlots.swap(slots_);
+    slots_.resize(2 * oldSlots.size(), Slot{0, nullptr});
+    mask_ = slots_.size() - 1;
+    shift_--;
+    for (vector<Slot>::iterator it = oldSlots.begin(); it != oldSlots.end(); it++) {
+        if (it->entry == nullptr) continue;
+        unsigned int index = home(it->addr);
+        while (slots_[index].entry != nullptr) index = (index + 1) & mask_;
+        slots_[index] = *it;
+    }
+}
+
+
+/* The pool is sized to the MSHR, an unbounded MSHR starts small and grows as needed.
+ * Ack and writeback entries do not count toward the MSHR size so the pool may grow past maxSize.
+ */
+MSHR::MSHR(Output* debug, int maxSize, string cacheName, std::set<Addr> debugAddr) : map_((maxSize > 0 && maxSize < HUGE_MSHR) ? maxSize : 64) {
+    statProbeLength_ = nullptr;
     d_ = debug;
     maxSize_ = maxSize;
     size_ = 0;
@@ -78,116 +194,118 @@ bool MSHR::isFull() {
     return false;
 }
 
+mshrEntry* MSHR::find(Addr baseAddr) {
+    mshrEntry* entry = map_.find(baseAddr);
+    if (statProbeLength_) statProbeLength_->addData(map_.getLastProbeLength());
+    return entry;
+}
+
 int MSHR::getAcksNeeded(Addr baseAddr) {
-    mshrTable::iterator it = map_.find(baseAddr);
-    if (it == map_.end()) return 0;
-    return (it->second).acksNeeded;
+    mshrEntry* entry = find(baseAddr);
+    if (entry == nullptr) return 0;
+    return entry->acksNeeded;
 }
 
 
 void MSHR::setAcksNeeded(Addr baseAddr, int acksNeeded, MemEvent * event) {
-    mshrTable::iterator it = map_.find(baseAddr);
-    if (it == map_.end()) {
+    mshrEntry* entry = find(baseAddr);
+    if (entry == nullptr) {
         if (is_debug_addr(baseAddr)) d_->debug(_L6_, "\tCreating new MSHR holder for acks\n");
         
-        mshrEntry entry;
-        entry.acksNeeded = acksNeeded;
-        entry.dataBuffer.clear();
+        entry = &map_[baseAddr];
+        entry->acksNeeded = acksNeeded;
         if (event != nullptr)
-            entry.mshrQueue.push_back(mshrType(event));
-        map_[baseAddr] = entry;
+            entry->mshrQueue.push_back(mshrType(event));
         return;
     }
-    (it->second).acksNeeded = acksNeeded;
+    entry->acksNeeded = acksNeeded;
 }
 
 void MSHR::incrementAcksNeeded(Addr baseAddr) {
-    mshrTable::iterator it = map_.find(baseAddr);
-    if (it == map_.end()) {
-        mshrEntry entry;
-        entry.acksNeeded = 1;
-        map_[baseAddr] = entry;
+    mshrEntry* entry = find(baseAddr);
+    if (entry == nullptr) {
+        map_[baseAddr].acksNeeded = 1;
     } else {
-        (it->second).acksNeeded++;
+        entry->acksNeeded++;
     }
 }
 
 void MSHR::decrementAcksNeeded(Addr baseAddr) {
-    mshrTable::iterator it = map_.find(baseAddr);
-    if (it == map_.end()) return;
-    (it->second).acksNeeded--;
-    if (((it->second).acksNeeded == 0) && (it->second).dataBuffer.empty() && (it->second).mshrQueue.empty()) {
+    mshrEntry* entry = find(baseAddr);
+    if (entry == nullptr) return;
+    entry->acksNeeded--;
+    if ((entry->acksNeeded == 0) && entry->dataBuffer.empty() && entry->mshrQueue.empty()) {
         if (is_debug_addr(baseAddr)) d_->debug(_L9_, "\tMSHR erasing 0x%" PRIx64 "\n", baseAddr);
         
-        map_.erase(it);
+        map_.erase(baseAddr);
     }
 }
 
-void MSHR::setDataBuffer(Addr baseAddr, vector<uint8_t>& data) {
-    mshrTable::iterator it = map_.find(baseAddr);
-    if (it == map_.end()) d2_->fatal(CALL_INFO,-1, "%s (MSHR), Error: No pending request for response event. Addr = 0x%" PRIx64 "\n", ownerName_.c_str(), baseAddr);
-    (it->second).dataBuffer = data;
+void MSHR::setDataBuffer(Addr baseAddr, const SharedPayload& data) {
+    mshrEntry* entry = find(baseAddr);
+    if (entry == nullptr) d2_->fatal(CALL_INFO,-1, "%s (MSHR), Error: No pending request for response event. Addr = 0x%" PRIx64 "\n", ownerName_.c_str(), baseAddr);
+    entry->dataBuffer = data;
 }
 
-vector<uint8_t> * MSHR::getDataBuffer(Addr baseAddr) {
-    mshrTable::iterator it = map_.find(baseAddr);
-    if (it == map_.end()) return NULL;
-    return &((it->second).dataBuffer);
+const SharedPayload * MSHR::getDataBuffer(Addr baseAddr) {
+    mshrEntry* entry = find(baseAddr);
+    if (entry == nullptr) return NULL;
+    return &(entry->dataBuffer);
 }
 
 void MSHR::clearDataBuffer(Addr baseAddr) {
-    mshrTable::iterator it = map_.find(baseAddr);
-    if (it != map_.end()) (it->second).dataBuffer.clear();
-    if (((it->second).acksNeeded == 0) && (it->second).dataBuffer.empty() && (it->second).mshrQueue.empty()) {
+    mshrEntry* entry = find(baseAddr);
+    if (entry == nullptr) return;
+    entry->dataBuffer.clear();
+    if ((entry->acksNeeded == 0) && entry->mshrQueue.empty()) {
         if (is_debug_addr(baseAddr)) d_->debug(_L9_, "\tMSHR erasing 0x%" PRIx64 "\n", baseAddr);
         
-        map_.erase(it);
+        map_.erase(baseAddr);
     }
 }
 
 bool MSHR::isDataBufferValid(Addr baseAddr) {
-    mshrTable::iterator it = map_.find(baseAddr);
-    if (it != map_.end()) (it->second).dataBuffer.clear();
+    mshrEntry* entry = find(baseAddr);
+    if (entry != nullptr) entry->dataBuffer.clear();
     return false;
 }
 
 bool MSHR::exists(Addr baseAddr) {
-    mshrTable::iterator it = map_.find(baseAddr);
-    if (it == map_.end()) return false;
-    vector<mshrType> * queue = &((it->second).mshrQueue);
-    vector<mshrType>::iterator frontEntry = queue->begin();
-    if (frontEntry == queue->end()) return false;
-    return (frontEntry->elem.isEvent());
+    mshrEntry* entry = find(baseAddr);
+    if (entry == nullptr || entry->mshrQueue.empty()) return false;
+    return (entry->mshrQueue.front().elem.isEvent());
 }
 
-bool MSHR::isHit(Addr baseAddr) { return (map_.find(baseAddr) != map_.end()) && (map_.find(baseAddr)->second.mshrQueue.size() > 0); }
+bool MSHR::isHit(Addr baseAddr) {
+    mshrEntry* entry = find(baseAddr);
+    return (entry != nullptr) && (entry->mshrQueue.size() > 0);
+}
 
 bool MSHR::pendingWriteback(Addr baseAddr) {
-    mshrType entry = mshrType(baseAddr);
-    mshrTable::iterator it = map_.find(baseAddr);
-    if (it == map_.end()) return false;
+    mshrType wbEntry = mshrType(baseAddr);
+    mshrEntry* entry = find(baseAddr);
+    if (entry == nullptr) return false;
 
-    vector<mshrType>& res = (it->second).mshrQueue;
-    vector<mshrType>::iterator itv = std::find_if(res.begin(), res.end(), MSHREntryCompare(&entry));
+    vector<mshrType>& res = entry->mshrQueue;
+    vector<mshrType>::iterator itv = std::find_if(res.begin(), res.end(), MSHREntryCompare(&wbEntry));
     return (itv != res.end());
 }
 
 const vector<mshrType> MSHR::lookup(Addr baseAddr) {
-    mshrTable::iterator it = map_.find(baseAddr);
-    if (it == map_.end()) {
+    mshrEntry* entry = find(baseAddr);
+    if (entry == nullptr) {
         d2_->fatal(CALL_INFO,-1, "%s (MSHR), Error: mshr did not find entry with address 0x%" PRIx64 "\n", ownerName_.c_str(), baseAddr);
     }
-    vector<mshrType> res = (it->second).mshrQueue;
-    return res;
+    return entry->mshrQueue;
 }
 
 
 MemEvent* MSHR::lookupFront(Addr baseAddr) {
-    mshrTable::iterator it = map_.find(baseAddr);
-    if (it == map_.end()) {
+    mshrEntry* entry = find(baseAddr);
+    if (entry == nullptr) {
         d2_->fatal(CALL_INFO,-1, "%s (MSHR), Error: mshr did not find entry with address 0x%" PRIx64 "\n", ownerName_.c_str(), baseAddr);
     }
-    vector<mshrType> queue = (it->second).mshrQueue;
+    vector<mshrType>& queue = entry->mshrQueue;
     if (queue.front().elem.isAddr()) {
         d2_->fatal(CALL_INFO,-1, "%s (MSHR), Error: front entry in mshr is not of type MemEvent. Addr = 0x%" PRIx64 "\n", ownerName_.c_str(), baseAddr);
     }
@@ -238,16 +356,9 @@ bool MSHR::insertWriteback(Addr keyAddr) {
     
     mshrType mshrElement = mshrType(keyAddr);
 
-    mshrTable::iterator it = map_.find(keyAddr);
-    if (it == map_.end()) {
-        mshrEntry newEntry;
-        newEntry.acksNeeded = 0;
-        newEntry.dataBuffer.clear();
-        map_[keyAddr] = newEntry;
-    }
-
-    vector<mshrType>::iterator itv = map_[keyAddr].mshrQueue.begin();
-    map_[keyAddr].mshrQueue.insert(itv, mshrElement);
+    vector<mshrType>& queue = map_[keyAddr].mshrQueue;
+    if (statProbeLength_) statProbeLength_->addData(map_.getLastProbeLength());
+    queue.insert(queue.begin(), mshrElement);
     //printTable();
     
     return true;
@@ -268,16 +379,10 @@ bool MSHR::insertInv(Addr baseAddr, MemEvent* event, bool inProgress) {
 
 bool MSHR::insertAll(Addr baseAddr, vector<mshrType>& events) {
     if (events.empty()) return false;
-    mshrTable::iterator it = map_.find(baseAddr);
     
-    if (it != map_.end()) (it->second).mshrQueue.insert((it->second).mshrQueue.end(), events.begin(), events.end());
-    else {
-        mshrEntry entry;
-        entry.mshrQueue = events;
-        entry.acksNeeded = 0;
-        entry.dataBuffer.clear();
-        map_[baseAddr] = entry;
-    }
+    vector<mshrType>& queue = map_[baseAddr].mshrQueue;
+    if (statProbeLength_) statProbeLength_->addData(map_.getLastProbeLength());
+    queue.insert(queue.end(), events.begin(), events.end());
     
     int trueSize = 0;
     int prefetches = 0;
@@ -298,14 +403,8 @@ bool MSHR::insertAll(Addr baseAddr, vector<mshrType>& events) {
 
 /* Private insertion methods called by public inserts */
 bool MSHR::insert(Addr baseAddr, mshrType entry) {
-    mshrTable::iterator it = map_.find(baseAddr);
-    if (it == map_.end()) {
-        mshrEntry entry;
-        entry.acksNeeded = 0;
-        entry.dataBuffer.clear();
-        map_[baseAddr] = entry;
-    }
     map_[baseAddr].mshrQueue.push_back(entry);
+    if (statProbeLength_) statProbeLength_->addData(map_.getLastProbeLength());
     //printTable();
     
     return true;
@@ -314,9 +413,11 @@ bool MSHR::insert(Addr baseAddr, mshrType entry) {
 bool MSHR::insertInv(Addr baseAddr, mshrType entry, bool inProgress) {
     if (size_ >= maxSize_) return false;
     
-    vector<mshrType>::iterator it = map_[baseAddr].mshrQueue.begin();
-    if (inProgress && map_[baseAddr].mshrQueue.size() > 0) it++;
-    map_[baseAddr].mshrQueue.insert(it, entry);
+    vector<mshrType>& queue = map_[baseAddr].mshrQueue;
+    if (statProbeLength_) statProbeLength_->addData(map_.getLastProbeLength());
+    vector<mshrType>::iterator it = queue.begin();
+    if (inProgress && queue.size() > 0) it++;
+    queue.insert(it, entry);
     if (entry.elem.isEvent()) size_++;
     //printTable();
     return true;
@@ -330,12 +431,19 @@ bool MSHR::insertInv(Addr baseAddr, mshrType entry, bool inProgress) {
 
 MemEvent* MSHR::getOldestRequest() const {
     MemEvent *ev = NULL;
-    for ( mshrTable::const_iterator it = map_.begin() ; it != map_.end() ; ++it ) {
-        for ( vector<mshrType>::const_iterator jt = (it->second).mshrQueue.begin() ; jt != (it->second).mshrQueue.end() ; jt++ ) {
+    Addr evAddr = 0;
+    // Scan the slots directly, ties go to the lowest address as when entries were kept in address order
+    for (unsigned int i = 0; i < map_.slotCount(); i++) {
+        const mshrEntry* entry = map_.slotEntry(i);
+        if (entry == nullptr) continue;
+        Addr addr = map_.slotAddr(i);
+        for ( vector<mshrType>::const_iterator jt = entry->mshrQueue.begin() ; jt != entry->mshrQueue.end() ; jt++ ) {
             if ( jt->elem.isEvent() ) {
                 MemEvent *me = (jt->elem).getEvent();
-                if ( !ev || ( me->getInitializationTime() < ev->getInitializationTime() ) ) {
+                if ( !ev || ( me->getInitializationTime() < ev->getInitializationTime() ) ||
+                        ( me->getInitializationTime() == ev->getInitializationTime() && addr < evAddr ) ) {
                     ev = me;
+                    evAddr = addr;
                 }
             }
         }
@@ -345,26 +453,26 @@ MemEvent* MSHR::getOldestRequest() const {
 }
 
 vector<mshrType>* MSHR::getAll(Addr baseAddr) {
-    mshrTable::iterator it = map_.find(baseAddr);
-    if (it == map_.end()) {
+    mshrEntry* entry = find(baseAddr);
+    if (entry == nullptr) {
         d2_->fatal(CALL_INFO,-1, "%s (MSHR), Error: mshr did not find entry with address 0x%" PRIx64 "\n", ownerName_.c_str(), baseAddr);
     }
-    return &((it->second).mshrQueue); 
+    return &(entry->mshrQueue); 
 }
 
 
 vector<mshrType> MSHR::removeAll(Addr baseAddr) {
-    mshrTable::iterator it = map_.find(baseAddr);
-    if (it == map_.end()) {
+    mshrEntry* entry = find(baseAddr);
+    if (entry == nullptr) {
         d2_->fatal(CALL_INFO,-1, "%s (MSHR), Error: mshr did not find entry with address 0x%" PRIx64 "\n", ownerName_.c_str(), baseAddr);
     }
-    vector<mshrType> res = (it->second).mshrQueue;
-    if ((it->second).acksNeeded == 0 && (it->second).dataBuffer.empty()) {
+    vector<mshrType> res = entry->mshrQueue;
+    if (entry->acksNeeded == 0 && entry->dataBuffer.empty()) {
         if (is_debug_addr(baseAddr)) d_->debug(_L9_, "\tMSHR erasing 0x%" PRIx64 "\n", baseAddr);
         
-        map_.erase(it);
+        map_.erase(baseAddr);
     } else {
-        (it->second).mshrQueue.clear();
+        entry->mshrQueue.clear();
     }
     int trueSize = 0;
     int prefetches = 0;
@@ -385,26 +493,26 @@ vector<mshrType> MSHR::removeAll(Addr baseAddr) {
 }
 
 MemEvent* MSHR::removeFront(Addr baseAddr) {
-    mshrTable::iterator it = map_.find(baseAddr);
-    if (it == map_.end()) {
+    mshrEntry* entry = find(baseAddr);
+    if (entry == nullptr) {
         d2_->fatal(CALL_INFO,-1, "%s (MSHR), Error: mshr did not find entry with address 0x%" PRIx64 "\n", ownerName_.c_str(), baseAddr);
     }
-    //if (it->second.empty()) {
+    //if (entry->mshrQueue.empty()) {
     //  d2_->fatal(CALL_INFO,-1, "%s (MSHR), Error: no front entry to remove in mshr for addr = 0x%" PRIx64 "\n", ownerName_.c_str(), baseAddr);
     //}
     //
-    // if (it->second.front().elem.isAddr()) {
+    // if (entry->mshrQueue.front().elem.isAddr()) {
     //     d2_->fatal(CALL_INFO,-1, "%s (MSHR), Error: front entry in mshr is not of type MemEvent. Addr = 0x%" PRIx64 "\n", ownerName_.c_str(), baseAddr);
     // }
     
-    MemEvent* ret = ((it->second).mshrQueue.front().elem).getEvent();
+    MemEvent* ret = (entry->mshrQueue.front().elem).getEvent();
     
     if (ret->isPrefetch()) prefetchCount_--;
     
-    (it->second).mshrQueue.erase(it->second.mshrQueue.begin());
-    if (((it->second).acksNeeded == 0) && (it->second).dataBuffer.empty() && (it->second).mshrQueue.empty()) {
+    entry->mshrQueue.erase(entry->mshrQueue.begin());
+    if ((entry->acksNeeded == 0) && entry->dataBuffer.empty() && entry->mshrQueue.empty()) {
         if (is_debug_addr(baseAddr)) d_->debug(_L9_, "\tMSHR erasing 0x%" PRIx64 "\n", baseAddr);
-        map_.erase(it);
+        map_.erase(baseAddr);
     }
     
     size_--;
@@ -436,21 +544,21 @@ void MSHR::removeElement(Addr baseAddr, Addr pointer) {
 
 bool MSHR::removeElement(Addr baseAddr, mshrType entry) {
 
-    mshrTable::iterator it = map_.find(baseAddr);
-    if (it == map_.end()) return false;    
+    mshrEntry* addrEntry = find(baseAddr);
+    if (addrEntry == nullptr) return false;    
    
-    if (is_debug_addr(baseAddr)) d_->debug(_L9_,"\tMSHR Entry size = %zu\n", it->second.mshrQueue.size());
+    if (is_debug_addr(baseAddr)) d_->debug(_L9_,"\tMSHR Entry size = %zu\n", addrEntry->mshrQueue.size());
     
-    vector<mshrType>& res = (it->second).mshrQueue;
+    vector<mshrType>& res = addrEntry->mshrQueue;
     vector<mshrType>::iterator itv = std::find_if(res.begin(), res.end(), MSHREntryCompare(&entry));
     
     if (itv == res.end()) return false;
     res.erase(std::remove_if(res.begin(), res.end(), MSHREntryCompare(&entry)), res.end());
 
-    if (((it->second).acksNeeded == 0) && (it->second).dataBuffer.empty() && (it->second).mshrQueue.empty()) {
+    if ((addrEntry->acksNeeded == 0) && addrEntry->dataBuffer.empty() && addrEntry->mshrQueue.empty()) {
         if (is_debug_addr(baseAddr)) d_->debug(_L9_, "\tMSHR erasing 0x%" PRIx64 "\n", baseAddr);
         
-        map_.erase(it);
+        map_.erase(baseAddr);
     }
     
     if (is_debug_addr(baseAddr)) d_->debug(_L9_, "\tMSHR Removed Event\n");
@@ -465,15 +573,15 @@ void MSHR::removeWriteback(Addr baseAddr) {
 }
 
 bool MSHR::elementIsHit(Addr baseAddr, MemEvent *event) {
-    mshrType entry = mshrType(event);
+    mshrType eventEntry = mshrType(event);
 
-    mshrTable::iterator it = map_.find(baseAddr);
-    if (it == map_.end()) return false;    
+    mshrEntry* entry = find(baseAddr);
+    if (entry == nullptr) return false;    
     
-    if (is_debug_addr(baseAddr)) d_->debug(_L9_,"\tMSHR Entry size = %zu\n", it->second.mshrQueue.size());
+    if (is_debug_addr(baseAddr)) d_->debug(_L9_,"\tMSHR Entry size = %zu\n", entry->mshrQueue.size());
     
-    vector<mshrType>& res = (it->second).mshrQueue;
-    vector<mshrType>::iterator itv = std::find_if (res.begin(), res.end(), MSHREntryCompare(&entry));
+    vector<mshrType>& res = entry->mshrQueue;
+    vector<mshrType>::iterator itv = std::find_if (res.begin(), res.end(), MSHREntryCompare(&eventEntry));
     
     if (itv == res.end()) return false;
     return true;
@@ -481,9 +589,10 @@ bool MSHR::elementIsHit(Addr baseAddr, MemEvent *event) {
 
 
 void MSHR::printTable() {
-    for (mshrTable::iterator it = map_.begin(); it != map_.end(); it++) {
-        vector<mshrType> entries = (it->second).mshrQueue;
-        d_->debug(_L9_, "\tMSHR: Addr = 0x%" PRIx64 "\n", (it->first));
+    vector<Addr> addrs = map_.getAddrs();
+    for (vector<Addr>::iterator it = addrs.begin(); it != addrs.end(); it++) {
+        vector<mshrType>& entries = map_.find(*it)->mshrQueue;
+        d_->debug(_L9_, "\tMSHR: Addr = 0x%" PRIx64 "\n", (*it));
         for (vector<mshrType>::iterator it2 = entries.begin(); it2 != entries.end(); it2++) {
             if (it2->elem.isAddr()) {
                 Addr ptr = (it2->elem).getAddr();
@@ -510,9 +619,11 @@ void MSHR::printTable() {
 
 void MSHR::printStatus(Output &out) {
     out.output("    MSHR Status for %s. Size: %u. Prefetches: %u\n", ownerName_.c_str(), size_, prefetchCount_);
-    for (mshrTable::iterator it = map_.begin(); it != map_.end(); it++) {
-        vector<mshrType> entries = (it->second).mshrQueue;
-        out.output("      Entry: Addr = 0x%" PRIx64 " Acks needed: %d\n", (it->first), it->second.acksNeeded);
+    vector<Addr> addrs = map_.getAddrs();
+    for (vector<Addr>::iterator it = addrs.begin(); it != addrs.end(); it++) {
+        mshrEntry* entry = map_.find(*it);
+        vector<mshrType>& entries = entry->mshrQueue;
+        out.output("      Entry: Addr = 0x%" PRIx64 " Acks needed: %d\n", (*it), entry->acksNeeded);
         for (vector<mshrType>::iterator it2 = entries.begin(); it2 != entries.end(); it2++) {
             if (it2->elem.isAddr()) {
                 Addr ptr = (it2->elem).getAddr();
@@ -525,8 +636,3 @@ void MSHR::printStatus(Output &out) {
     }
     out.output("    End MSHR Status for %s\n", ownerName_.c_str());
 }
-
-
-
-
-
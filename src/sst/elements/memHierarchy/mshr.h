@@ -17,6 +17,7 @@
 #define _MSHR_H_
 
 #include <map>
+#include <deque>
 #include <string>
 #include <sstream>
 
@@ -68,13 +69,60 @@ struct mshrType {
 struct mshrEntry {
     vector<mshrType> mshrQueue; // Events and pointers to events for this address
     uint32_t        acksNeeded; // Acks needed for request at top of queue. Here instead of at cacheline for non-inclusive caches
-    vector<uint8_t> dataBuffer;   // Temporary holding place for response data during replay of request events (for non-inclusive caches)
+    SharedPayload dataBuffer;     // Temporary holding place for response data during replay of request events (for non-inclusive caches)
 };
 
-typedef map<Addr, mshrEntry >   mshrTable;
-
 #define HUGE_MSHR 100000
 
+/**
+ *  Table of mshrEntry's keyed by address
+ *  Open-addressed (linear probing) hash table pointing into a pool of entries. Entries
+ *  are recycled rather than freed so their queue and data buffer storage is reused.
+ */
+class mshrTable {
+public:
+    mshrTable(unsigned int poolSize);
+
+    /** Return entry for addr or nullptr if none exists */
+    mshrEntry* find(Addr addr) const;
+    /** Return entry for addr, creating it if it does not exist */
+    mshrEntry& operator[](Addr addr);
+    /** Remove the entry for addr and return it to the pool */
+    void erase(Addr addr);
+
+    /** Number of addresses in the table */
+    unsigned int size() const { return size_; }
+    /** Number of entries allocated in the pool (in use or free) */
+    unsigned int poolSize() const { return pool_.size(); }
+    /** Length of the probe sequence for the most recent find/insert */
+    unsigned int getLastProbeLength() const { return lastProbeLength_; }
+    /** All addresses in the table, in ascending order */
+    vector<Addr> getAddrs() const;
+    /** Unordered iteration over the table - entry in slot 'index' or nullptr if the slot is empty */
+    unsigned int slotCount() const { return slots_.size(); }
+    const mshrEntry* slotEntry(unsigned int index) const { return slots_[index].entry; }
+    Addr slotAddr(unsigned int index) const { return slots_[index].addr; }
+
+private:
+    struct Slot {
+        Addr addr;
+        mshrEntry* entry; // nullptr if slot is empty
+    };
+
+    unsigned int home(Addr addr) const { return (addr * 0x9E3779B97F4A7C15ULL) >> shift_; }
+    unsigned int findSlot(Addr addr) const;
+    mshrEntry* allocate();
+    void grow();
+
+    vector<Slot> slots_;
+    unsigned int mask_;
+    unsigned int shift_;
+    unsigned int size_;
+    mutable unsigned int lastProbeLength_;
+    deque<mshrEntry> pool_;         // deque so that growing the pool does not move existing entries
+    vector<mshrEntry*> freeList_;
+};
+
 /**
  *  Implements an MSHR with entries of type mshrEntry
  */
@@ -106,14 +154,19 @@ public:
     bool pendingWriteback(Addr baseAddr);
     unsigned int getSize(){ return size_; }                 
     unsigned int getPrefetchCount() { return prefetchCount_; }
+    unsigned int getEntryCount() { return map_.size(); }         // Number of addresses with an entry, including ack/writeback-only entries
+    unsigned int getPoolSize() { return map_.poolSize(); }
+
+    // Statistics - optional, recorded if set and enabled at the current statistic load level
+    void setProbeLengthStatistic(Statistic<uint64_t>* stat) { statProbeLength_ = (stat && !stat->isNullStatistic()) ? stat : nullptr; }
 
     // Bookkeeping getters/setters
     int getAcksNeeded(Addr baseAddr);
     void setAcksNeeded(Addr baseAddr, int acksNeeded, MemEvent * event = nullptr);
     void incrementAcksNeeded(Addr baseAddr);
     void decrementAcksNeeded(Addr baseAddr);
-    vector<uint8_t> * getDataBuffer(Addr baseAddr);
-    void setDataBuffer(Addr baseAddr, vector<uint8_t>& data);
+    const SharedPayload * getDataBuffer(Addr baseAddr);
+    void setDataBuffer(Addr baseAddr, const SharedPayload& data);
     void clearDataBuffer(Addr baseAddr);
     bool isDataBufferValid(Addr baseAddr);
 
@@ -134,7 +187,10 @@ public:
     void printTable();
 
 private:
+    mshrEntry* find(Addr baseAddr);
+
     mshrTable map_;
+    Statistic<uint64_t>* statProbeLength_;
     Output* d_;
     Output* d2_;
     int size_;
@@ -26,6 +26,7 @@
 #include "sst/core/rng/marsaglia.h"
 #include <stdlib.h>     /* srand, rand */
 #include <time.h>       /* time */
+#include <vector>
 
 using namespace std;
 namespace SST {
@@ -374,6 +375,198 @@ public:
 };
 
 
+
+/* ------------------------------------------------------------------------------------------
+ *  Templated replacement policies
+ *  Used as the template parameter of PolicySetAssociativeArray so that calls are resolved at
+ *  compile time. Each keeps compact per-set metadata indexed by (set, way). The array always
+ *  fills an invalid way first, so findVictim() is only called on a full set. Sharers/owners are
+ *  ranked by the array, which passes the ways in the lowest rank as candidates when the set
+ *  holds lines of more than one rank.
+ *
+ *  Interface:
+ *      Policy(uint numSets, uint numWays)
+ *      void touch(uint set, uint way)          - line was accessed
+ *      void insert(uint set, uint way)         - line was filled
+ *      void invalidate(uint set, uint way)     - line was deallocated
+ *      uint findVictim(uint set)               - way to replace
+ *      uint findVictim(uint set, const uint8_t* candidates)
+ *                                              - way to replace among the ways with candidates[way] set
+ * ------------------------------------------------------------------------------------------*/
+
+/* True LRU as a per-set age ordering (0 = most recently used), one byte per way up to 256 ways */
+template<typename Age = uint8_t>
+class LRUPolicy {
+public:
+    typedef unsigned int uint;
+
+    LRUPolicy(uint numSets, uint numWays) : numWays_(numWays), ages_(numSets * numWays) {
+        for (uint i = 0; i < ages_.size(); i++) ages_[i] = i % numWays;
+    }
+
+    void touch(uint set, uint way) {
+        Age* ages = &ages_[set * numWays_];
+        Age age = ages[way];
+        for (uint i = 0; i < numWays_; i++) {
+            if (ages[i] < age) ages[i]++;
+        }
+        ages[way] = 0;
+    }
+
+    void insert(uint set, uint way) { touch(set, way); }
+
+    void invalidate(uint set, uint way) {
+        Age* ages = &ages_[set * numWays_];
+        Age age = ages[way];
+        for (uint i = 0; i < numWays_; i++) {
+            if (ages[i] > age) ages[i]--;
+        }
+        ages[way] = numWays_ - 1;
+    }
+
+    uint findVictim(uint set) {
+        Age* ages = &ages_[set * numWays_];
+        uint victim = 0;
+        for (uint i = 1; i < numWays_; i++) {
+            if (ages[i] > ages[victim]) victim = i;
+        }
+        return victim;
+    }
+
+    uint findVictim(uint set, const uint8_t* candidates) {
+        Age* ages = &ages_[set * numWays_];
+        uint victim = numWays_;
+        for (uint i = 0; i < numWays_; i++) {
+            if (candidates[i] && (victim == numWays_ || ages[i] > ages[victim])) victim = i;
+        }
+        return victim;
+    }
+
+private:
+    uint numWays_;
+    std::vector<Age> ages_;
+};
+
+/* Tree pseudo-LRU. numWays-1 direction bits per set, numWays must be a power of two */
+class TreePLRUPolicy {
+public:
+    typedef unsigned int uint;
+
+    TreePLRUPolicy(uint numSets, uint numWays) : numWays_(numWays), tree_(numSets * numWays, 0) { }
+
+    /* Point every node on the path to this way away from it. Node 1 is the root, way w is leaf numWays + w */
+    void touch(uint set, uint way) {
+        uint8_t* tree = &tree_[set * numWays_];
+        for (uint node = numWays_ + way; node > 1; node >>= 1) {
+            tree[node >> 1] = (node & 1) ? 0 : 1;
+        }
+    }
+
+    void insert(uint set, uint way) { touch(set, way); }
+
+    /* Point the path towards this way so it is the next victim */
+    void invalidate(uint set, uint way) {
+        uint8_t* tree = &tree_[set * numWays_];
+        for (uint node = numWays_ + way; node > 1; node >>= 1) {
+            tree[node >> 1] = (node & 1);
+        }
+    }
+
+    uint findVictim(uint set) {
+        uint8_t* tree = &tree_[set * numWays_];
+        uint node = 1;
+        while (node < numWays_) node = 2 * node + tree[node];
+        return node - numWays_;
+    }
+
+    /* Follow the tree but turn away from subtrees without a candidate */
+    uint findVictim(uint set, const uint8_t* candidates) {
+        uint8_t* tree = &tree_[set * numWays_];
+        uint node = 1;
+        uint first = 0, width = numWays_;
+        while (node < numWays_) {
+            width >>= 1;
+            uint dir = tree[node];
+            bool found = false;
+            for (uint i = first + dir * width; i < first + (dir + 1) * width && !found; i++) found = candidates[i];
+            if (!found) dir = 1 - dir;
+            first += dir * width;
+            node = 2 * node + dir;
+        }
+        return node - numWays_;
+    }
+
+private:
+    uint numWays_;
+    std::vector<uint8_t> tree_;
+};
+
+/* Re-reference interval prediction with 2-bit RRPVs (Jaleel et al., ISCA 2010)
+ * SRRIP inserts with a long re-reference interval, BRRIP inserts with a distant interval
+ * except for 1 in 32 fills. Hits promote to near-immediate. */
+template<bool Bimodal>
+class RRIPPolicy {
+public:
+    typedef unsigned int uint;
+
+    RRIPPolicy(uint numSets, uint numWays) : numWays_(numWays), rrpv_(numSets * numWays, maxRRPV), randomGenerator_(1, 1) { }
+
+    void touch(uint set, uint way) { rrpv_[set * numWays_ + way] = 0; }
+
+    void insert(uint set, uint way) {
+        uint8_t rrpv = maxRRPV - 1;
+        if (Bimodal && (randomGenerator_.generateNextUInt32() % 32) != 0) rrpv = maxRRPV;
+        rrpv_[set * numWays_ + way] = rrpv;
+    }
+
+    void invalidate(uint set, uint way) { rrpv_[set * numWays_ + way] = maxRRPV; }
+
+    /* First way at the distant RRPV, aging the set until one is found */
+    uint findVictim(uint set) {
+        uint8_t* rrpv = &rrpv_[set * numWays_];
+        uint8_t oldest = 0;
+        for (uint i = 0; i < numWays_; i++) {
+            if (rrpv[i] == maxRRPV) return i;
+            if (rrpv[i] > oldest) oldest = rrpv[i];
+        }
+        uint8_t age = maxRRPV - oldest;
+        uint victim = numWays_;
+        for (uint i = 0; i < numWays_; i++) {
+            rrpv[i] += age;
+            if (victim == numWays_ && rrpv[i] == maxRRPV) victim = i;
+        }
+        return victim;
+    }
+
+    /* As above but only candidates can be the victim, other ways age up to the distant RRPV */
+    uint findVictim(uint set, const uint8_t* candidates) {
+        uint8_t* rrpv = &rrpv_[set * numWays_];
+        uint8_t oldest = 0;
+        for (uint i = 0; i < numWays_; i++) {
+            if (!candidates[i]) continue;
+            if (rrpv[i] == maxRRPV) return i;
+            if (rrpv[i] > oldest) oldest = rrpv[i];
+        }
+        uint8_t age = maxRRPV - oldest;
+        uint victim = numWays_;
+        for (uint i = 0; i < numWays_; i++) {
+            rrpv[i] = (rrpv[i] + age < maxRRPV) ? rrpv[i] + age : maxRRPV;
+            if (victim == numWays_ && candidates[i] && rrpv[i] == maxRRPV) victim = i;
+        }
+        return victim;
+    }
+
+private:
+    enum { maxRRPV = 3 };
+    uint numWays_;
+    std::vector<uint8_t> rrpv_;
+    SST::RNG::MarsagliaRNG randomGenerator_;
+};
+
+typedef RRIPPolicy<false> SRRIPPolicy;
+typedef RRIPPolicy<true> BRRIPPolicy;
+
+
 }}
 
 
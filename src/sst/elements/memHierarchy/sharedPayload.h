@@ -0,0 +1,186 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#ifndef _MEMHIERARCHY_SHAREDPAYLOAD_H_
+#define _MEMHIERARCHY_SHAREDPAYLOAD_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <vector>
+
+namespace SST { namespace MemHierarchy {
+
+/*
+ * Reference-counted, copy-on-write data buffer
+ * Used for MemEvent payloads and cache line data so that forwarding an event, creating a
+ * response, or filling a line from a response shares the bytes instead of copying them.
+ * A copy is made only when a shared buffer is written. Released buffers go to a per-thread
+ * pool and keep their capacity for reuse.
+ *
+ * getMutable() hands out a reference that can be written at any later time, so a buffer
+ * that has been accessed that way is copied, not shared, by the next copy of the payload.
+ */
+class SharedPayload {
+public:
+    SharedPayload() : buf_(nullptr) { }
+    explicit SharedPayload(const std::vector<uint8_t>& data) : buf_(nullptr) { assign(data); }
+    SharedPayload(const SharedPayload& other) : buf_(nullptr) { share(other); }
+    ~SharedPayload() { release(); }
+
+    SharedPayload& operator=(const SharedPayload& other) {
+        if (buf_ != other.buf_) {
+            release();
+            share(other);
+        }
+        return *this;
+    }
+
+    /* Read access, never copies */
+    const std::vector<uint8_t>& get() const { return buf_ ? buf_->data : emptyVector(); }
+    size_t size() const { return buf_ ? buf_->data.size() : 0; }
+    bool empty() const { return size() == 0; }
+    const uint8_t& at(size_t i) const { return get().at(i); }
+    const uint8_t& operator[](size_t i) const { return buf_->data[i]; }
+    std::vector<uint8_t>::const_iterator begin() const { return get().begin(); }
+    std::vector<uint8_t>::const_iterator end() const { return get().end(); }
+
+    /* Whether another payload references the same bytes */
+    bool isShared() const { return buf_ && buf_->refs.load(std::memory_order_acquire) > 1; }
+
+    /* Write access, copies first if the buffer is shared */
+    std::vector<uint8_t>& getMutable() {
+        makeUnique();
+        buf_->pinned = true;
+        return buf_->data;
+    }
+
+    void assign(const std::vector<uint8_t>& data) { assign(data.data(), data.size()); }
+
+    void assign(const uint8_t* data, size_t size) {
+        if (!buf_ || isShared()) {
+            release();
+            buf_ = allocate();
+        }
+        buf_->pinned = false;
+        buf_->data.resize(size);
+        if (size) memcpy(buf_->data.data(), data, size);
+    }
+
+    void assign(std::vector<uint8_t>&& data) {
+        release();
+        buf_ = allocate();
+        buf_->data.swap(data);
+    }
+
+    /* Copy size bytes into the buffer at offset, the buffer must already be large enough */
+    void write(size_t offset, const uint8_t* data, size_t size) {
+        makeUnique();
+        if (size) memcpy(buf_->data.data() + offset, data, size);
+    }
+
+    void resize(size_t size, uint8_t value = 0) {
+        if (buf_ && buf_->data.size() == size) return;
+        makeUnique();
+        buf_->data.resize(size, value);
+    }
+
+    void clear() {
+        release();
+    }
+
+private:
+    struct Buffer {
+        std::atomic<uint32_t> refs;
+        bool pinned;                // A mutable reference has been handed out, do not share
+        std::vector<uint8_t> data;
+    };
+
+    /* Free buffers are recycled per thread, up to a limit */
+    struct Pool {
+        std::vector<Buffer*> free;
+        ~Pool() {
+            for (std::vector<Buffer*>::iterator it = free.begin(); it != free.end(); it++) delete *it;
+        }
+    };
+
+    static const size_t poolLimit = 4096;
+
+    static Pool& pool() {
+        static thread_local Pool pool;
+        return pool;
+    }
+
+    static const std::vector<uint8_t>& emptyVector() {
+        static const std::vector<uint8_t> empty;
+        return empty;
+    }
+
+    static Buffer* allocate() {
+        Pool& p = pool();
+        Buffer* buf;
+        if (p.free.empty()) {
+            buf = new Buffer;
+        } else {
+            buf = p.free.back();
+            p.free.pop_back();
+        }
+        buf->refs.store(1, std::memory_order_relaxed);
+        buf->pinned = false;
+        return buf;
+    }
+
+    void share(const SharedPayload& other) {
+        if (!other.buf_) {
+            buf_ = nullptr;
+        } else if (other.buf_->pinned) {
+            buf_ = allocate();
+            buf_->data = other.buf_->data;
+        } else {
+            buf_ = other.buf_;
+            buf_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void release() {
+        if (buf_ && buf_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Pool& p = pool();
+            if (p.free.size() < poolLimit) {
+                buf_->data.clear();
+                p.free.push_back(buf_);
+            } else {
+                delete buf_;
+            }
+        }
+        buf_ = nullptr;
+    }
+
+    void makeUnique() {
+        if (!buf_) {
+            buf_ = allocate();
+        } else if (isShared()) {
+            Buffer* copy = allocate();
+            copy->data = buf_->data;
+            release();
+            buf_ = copy;
+        }
+    }
+
+    Buffer* buf_;
+};
+
+}}
+
+#endif
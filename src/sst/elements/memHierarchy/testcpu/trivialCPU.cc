@@ -55,6 +55,8 @@ trivialCPU::trivialCPU(ComponentId_t id, Params& params) :
 
     do_write = params.find<bool>("do_write", 1);
 
+    check_data = params.find<bool>("check_data", 0);
+
     numLS = params.find<int>("num_loadstore", -1);
 
     noncacheableRangeStart = params.find<uint64_t>("noncacheableRangeStart", 0);
@@ -84,6 +86,7 @@ trivialCPU::trivialCPU(ComponentId_t id, Params& params) :
     
     clock_ticks = 0;
     num_reads_issued = num_reads_returned = 0;
+    num_reads_checked = 0;
     noncacheableReads = noncacheableWrites = 0;
 }
 
@@ -111,6 +114,22 @@ void trivialCPU::handleEvent(Interfaces::SimpleMem::Request *req)
         out.verbose(CALL_INFO, 2, 0, "%s: Received Request with command %d (addr 0x%" PRIx64 ") [Time: %" PRIu64 "] [%zu outstanding requests]\n",
                     getName().c_str(), req->cmd, req->addr, et, requests.size());
         num_reads_returned++;
+
+        // Every write to an address writes the same data (the address), so a read issued after one completed must return it
+        if ( check_data ) {
+            if ( req->cmd == Interfaces::SimpleMem::Request::WriteResp ) {
+                writtenAddrs.insert(req->addr);
+            } else if ( checkedReads.erase(req->id) ) {
+                uint32_t value = 0;
+                for (size_t b = 0; b < req->data.size() && b < 4; b++)
+                    value = (value << 8) | req->data[b];
+                if ( req->data.size() != 4 || value != (uint32_t)req->addr ) {
+                    out.fatal(CALL_INFO, -1, "%s: Read of address 0x%" PRIx64 " returned 0x%" PRIx32 " after a write of 0x%" PRIx32 " completed\n",
+                            getName().c_str(), req->addr, value, (uint32_t)req->addr);
+                }
+                num_reads_checked++;
+            }
+        }
     }
 
     delete req;
@@ -187,6 +206,8 @@ bool trivialCPU::clockTic( Cycle_t )
 
 		memory->sendRequest(req);
 		requests[req->id] =  getCurrentSimTime();
+                if ( check_data && cmd == Interfaces::SimpleMem::Request::Read && writtenAddrs.count(addr) )
+                    checkedReads.insert(req->id);
                 
 		out.verbose(CALL_INFO, 2, 0, "%s: %d Issued %s%s for address 0x%" PRIx64 "\n",
                             getName().c_str(), numLS, noncacheable ? "Noncacheable " : "" , cmdString.c_str(), addr);
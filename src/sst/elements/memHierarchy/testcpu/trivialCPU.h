@@ -20,6 +20,7 @@
 #define __STDC_FORMAT_MACROS
 #endif
 #include <inttypes.h>
+#include <set>
 
 #include <sst/core/event.h>
 #include <sst/core/sst_types.h>
@@ -55,6 +56,7 @@ public:
             {"reqsPerIssue",            "(uint) Maximum number of requests to issue at a time", "1"},
             {"do_write",                "(bool) Enable writes to memory (versus just reads).", "1"},
             {"do_flush",                "(bool) Enable flushes", "0"},
+            {"check_data",              "(bool) Check that reads issued after a write to the same address completed return the written data", "0"},
             {"noncacheableRangeStart",  "(uint) Beginning of range of addresses that are noncacheable.", "0x0"},
             {"noncacheableRangeEnd",    "(uint) End of range of addresses that are noncacheable.", "0x0"},
             {"addressoffset",           "(uint) Apply an offset to a calculated address to check for non-alignment issues", "0"} )
@@ -69,6 +71,8 @@ public:
     void finish() {
     	out.verbose(CALL_INFO, 1, 0, "TrivialCPU %s Finished after %" PRIu64 " issued reads, %" PRIu64 " returned (%" PRIu64 " clocks)\n",
     		getName().c_str(), num_reads_issued, num_reads_returned, clock_ticks);
+    	if ( check_data )
+	    out.verbose(CALL_INFO, 1, 0, "\t%" PRIu64 " Reads checked against written data\n", num_reads_checked);
     	if ( noncacheableReads || noncacheableWrites )
 	    out.verbose(CALL_INFO, 1, 0, "\t%zu Noncacheable Reads\n\t%zu Noncacheable Writes\n", noncacheableReads, noncacheableWrites);
 
@@ -93,17 +97,21 @@ private:
     int commFreq;
     bool do_write;
     bool do_flush;
+    bool check_data;
     uint64_t maxAddr;
     uint64_t lineSize;
     uint64_t maxOutstanding;
     uint32_t maxReqsPerIssue;
     uint64_t num_reads_issued, num_reads_returned;
+    uint64_t num_reads_checked;
     uint64_t noncacheableRangeStart, noncacheableRangeEnd, noncacheableSize;
     uint64_t clock_ticks;
     size_t noncacheableReads, noncacheableWrites;
     Statistic<uint64_t>* requestsPendingCycle;
 
     std::map<uint64_t, SimTime_t> requests;
+    std::set<uint64_t> writtenAddrs;    // Addresses with a completed write, for check_data
+    std::set<uint64_t> checkedReads;    // Reads issued after a write to their address completed
 
     Interfaces::SimpleMem *memory;
 
@@ -0,0 +1,68 @@
+#!/usr/bin/env python
+#
+# Run testPackedTags.py with and without packed_tags and report the cache
+# access rate of each.
+#   - Every cache and memory statistic must be the same in both runs, since
+#     the packed arrays choose the same victims as the unpacked ones
+#   - The L1 must see at least the CPU's num_loadstore accesses
+#
+# The rate is L1 + LLC accesses per second of the run loop time reported
+# by --print-timing-info (the wall clock time of sst if that is missing).
+#
+# Usage: checkPackedTags.py [sst]
+# Exits non-zero on failure.
+
+import re
+import subprocess
+import sys
+import time
+
+sstBin = sys.argv[1] if len(sys.argv) > 1 else "sst"
+numLoadStore = 200000
+
+statPattern = re.compile('^\s*([^\s:]+) : Accumulator : Sum\.(?:u64|f64) = ([-0-9.e+]+);')
+runTimePattern = re.compile(r'^\s*Run[^:]*:\s*([0-9.eE+-]+)\s*s', re.IGNORECASE)
+
+def run(packed):
+    cmd = [sstBin, "--print-timing-info", "testPackedTags.py", "--model-options=--packed_tags=" + packed]
+    start = time.time()
+    out = subprocess.check_output(cmd, universal_newlines=True)
+    runTime = time.time() - start
+    stats = dict()
+    for line in out.splitlines():
+        m = statPattern.match(line)
+        if m:
+            stats[m.group(1)] = float(m.group(2))
+        m = runTimePattern.match(line)
+        if m:
+            runTime = float(m.group(1))
+    return stats, runTime
+
+def accesses(stats):
+    return sum(stats.get(cache + "." + stat, 0) for cache in ("l1cache", "llc") for stat in ("CacheHits", "CacheMisses"))
+
+failed = False
+results = dict()
+for packed in ("0", "1"):
+    stats, runTime = run(packed)
+    rate = accesses(stats) / runTime if runTime > 0 else 0
+    print("packed_tags=%s  accesses %d  run time %.3f s  %.0f accesses/s" % (packed, accesses(stats), runTime, rate))
+    results[packed] = (stats, rate)
+
+unpacked, unpackedRate = results["0"]
+packed, packedRate = results["1"]
+if unpackedRate > 0:
+    print("speedup %.2fx" % (packedRate / unpackedRate))
+
+l1Accesses = unpacked.get("l1cache.CacheHits", 0) + unpacked.get("l1cache.CacheMisses", 0)
+if l1Accesses < numLoadStore:
+    print("FAIL: L1 saw %d accesses, expected at least %d" % (l1Accesses, numLoadStore))
+    failed = True
+for name in sorted(set(unpacked.keys()) | set(packed.keys())):
+    if unpacked.get(name) != packed.get(name):
+        print("FAIL: %s is %s unpacked, %s packed" % (name, unpacked.get(name), packed.get(name)))
+        failed = True
+
+if failed:
+    sys.exit(1)
+print("PASS")
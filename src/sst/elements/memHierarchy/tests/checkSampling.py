@@ -0,0 +1,66 @@
+#!/usr/bin/env python
+#
+# Compare a set-sampled run of testSetSampling.py against a full run.
+#   - The full L2's miss ratio must be inside the sampled run's 95% confidence
+#     interval (widened by 'slack' to allow for the sampled sets' own noise)
+#   - The extrapolated hits + misses must match the full run's accesses
+#   - The requests memory receives must be within 'tolerance' of the full run,
+#     i.e., unsampled sets must not send every access to memory
+#
+# Usage: checkSampling.py [sample_sets] [sst]
+# Exits non-zero on failure.
+
+import re
+import subprocess
+import sys
+
+sampleSets = sys.argv[1] if len(sys.argv) > 1 else "16"
+sstBin = sys.argv[2] if len(sys.argv) > 2 else "sst"
+slack = 0.02
+tolerance = 0.15
+
+statPattern = re.compile('^\s*([^\s:]+) : Accumulator : Sum\.(?:u64|f64) = ([-0-9.e+]+);')
+
+def run(options):
+    cmd = [sstBin, "testSetSampling.py"]
+    if options:
+        cmd.append('--model-options=' + options)
+    out = subprocess.check_output(cmd, universal_newlines=True)
+    stats = dict()
+    for line in out.splitlines():
+        m = statPattern.match(line)
+        if m:
+            stats[m.group(1)] = float(m.group(2))
+    return stats
+
+def memRequests(stats):
+    return sum(stats.get("memory.requests_received_" + cmd, 0) for cmd in ("GetS", "GetX", "GetSX"))
+
+full = run("")
+sampled = run("--sample_sets=" + sampleSets)
+
+fullAccesses = full["l2cache.CacheHits"] + full["l2cache.CacheMisses"]
+fullRatio = full["l2cache.CacheMisses"] / fullAccesses
+ratio = sampled["l2cache.Sampled_miss_ratio"]
+low = sampled["l2cache.Sampled_miss_ratio_CI_low"]
+high = sampled["l2cache.Sampled_miss_ratio_CI_high"]
+extAccesses = sampled["l2cache.Extrapolated_hits"] + sampled["l2cache.Extrapolated_misses"]
+
+print("Full miss ratio %.4f, sampled %.4f (95%% CI %.4f - %.4f)" % (fullRatio, ratio, low, high))
+print("Accesses: full %d, extrapolated %d" % (fullAccesses, extAccesses))
+print("Memory requests: full %d, sampled %d" % (memRequests(full), memRequests(sampled)))
+
+failed = False
+if fullRatio < low - slack or fullRatio > high + slack:
+    print("FAIL: full miss ratio is outside the sampled confidence interval")
+    failed = True
+if abs(extAccesses - fullAccesses) > tolerance * fullAccesses:
+    print("FAIL: extrapolated accesses do not match the full run")
+    failed = True
+if abs(memRequests(sampled) - memRequests(full)) > tolerance * memRequests(full):
+    print("FAIL: memory traffic of the sampled run does not match the full run")
+    failed = True
+
+if failed:
+    sys.exit(1)
+print("PASS")
@@ -25,6 +25,7 @@ declare -a bk_arr=( testBackendChaining.py
                     testBackendDelayBuffer.py
                     testBackendPagedMulti.py
                     testBackendReorderRow.py
+                    testBackendReorderFRFCFS.py
                     testBackendReorderSimple.py
                     testBackendSimpleDRAM-1.py
                     testBackendSimpleDRAM-2.py
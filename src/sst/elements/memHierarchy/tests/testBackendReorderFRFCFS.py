@@ -0,0 +1,86 @@
+# FR-FCFS reorderer with a streaming read/write mix over a small footprint.
+# The caches are small so lines are written back and read again while the
+# writebacks are still buffered in the reorderer. The CPUs check that every
+# read issued after a write to its address completed returns the written
+# data, so a read that passes a buffered write to the same line fails the run.
+import sst
+
+cpus = 2
+
+comp_bus = sst.Component("bus", "memHierarchy.Bus")
+comp_bus.addParams({
+      "bus_frequency" : "2GHz"
+})
+
+for i in range(cpus):
+    cpu = sst.Component("cpu" + str(i), "memHierarchy.trivialCPU")
+    cpu.addParams({
+          "clock" : "2GHz",
+          "commFreq" : "2",
+          "rngseed" : str(101 + 200 * i),
+          "do_write" : "1",
+          "check_data" : "1",
+          "num_loadstore" : "20000",
+          "maxOutstanding" : "16",
+          "memSize" : "0x8000",
+    })
+    l1 = sst.Component("c" + str(i) + ".l1cache", "memHierarchy.Cache")
+    l1.addParams({
+          "access_latency_cycles" : "2",
+          "cache_frequency" : "2GHz",
+          "replacement_policy" : "lru",
+          "coherence_protocol" : "MESI",
+          "associativity" : "2",
+          "cache_line_size" : "64",
+          "cache_size" : "1KiB",
+          "L1" : "1",
+          "debug" : "0"
+    })
+    link_cpu = sst.Link("link_cpu" + str(i))
+    link_cpu.connect( (cpu, "mem_link", "100ps"), (l1, "high_network_0", "100ps") )
+    link_bus = sst.Link("link_l1_bus" + str(i))
+    link_bus.connect( (l1, "low_network_0", "100ps"), (comp_bus, "high_network_" + str(i), "100ps") )
+
+comp_l2cache = sst.Component("l2cache", "memHierarchy.Cache")
+comp_l2cache.addParams({
+      "access_latency_cycles" : "6",
+      "cache_frequency" : "2GHz",
+      "replacement_policy" : "lru",
+      "coherence_protocol" : "MESI",
+      "associativity" : "4",
+      "cache_line_size" : "64",
+      "cache_size" : "4KiB",
+      "debug" : "0"
+})
+comp_memory = sst.Component("memory", "memHierarchy.MemController")
+comp_memory.addParams({
+      "clock" : "1GHz",
+      "backing" : "malloc",
+      "backend" : "memHierarchy.reorderFRFCFS",
+      "backend.mem_size" : "512MiB",
+      "backend.banks" : "4",
+      "backend.bank_interleave_granularity" : "64B",
+      "backend.row_size" : "1KiB",
+      "backend.lookahead" : "32",
+      "backend.starvation_limit" : "64",
+      "backend.write_high_watermark" : "8",
+      "backend.write_low_watermark" : "2",
+      "backend.backend" : "memHierarchy.simpleDRAM",
+      "backend.backend.banks" : "4",
+      "backend.backend.bank_interleave_granularity" : "64B",
+      "backend.backend.row_size" : "1KiB",
+      "backend.backend.row_policy" : "open",
+      "backend.backend.tCAS" : "3",
+      "backend.backend.tRCD" : "3",
+      "backend.backend.tRP" : "3",
+      "backend.backend.cycle_time" : "1ns",
+})
+
+sst.setStatisticLoadLevel(2)
+sst.setStatisticOutput("sst.statOutputConsole")
+sst.enableAllStatisticsForComponentType("memHierarchy.MemController")
+
+link_bus_l2 = sst.Link("link_bus_l2")
+link_bus_l2.connect( (comp_bus, "low_network_0", "100ps"), (comp_l2cache, "high_network_0", "100ps") )
+link_l2_mem = sst.Link("link_l2_mem")
+link_l2_mem.connect( (comp_l2cache, "low_network_0", "100ps"), (comp_memory, "direct_link", "100ps") )
@@ -0,0 +1,241 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+/*
+ * Checks for the sparse backing store (Backend::BackingSparse):
+ *  - chunks are only allocated when non-zero data is written and reads of
+ *    other chunks return zeros
+ *  - a chunk that is written back to all zeros is released
+ *  - an image saved by one process restores in a fresh one (this program
+ *    runs itself with --restore) with the same data, only the non-zero
+ *    chunks stored, and writes to the restored store not reaching the image
+ *
+ * Usage: testBackingSparse [--restore <image>]
+ */
+
+#include <sst_config.h>
+#include "membackend/backing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+using namespace SST::MemHierarchy;
+using namespace SST::MemHierarchy::Backend;
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if ( !(cond) ) { \
+        fprintf(stderr, "FAIL line %d: ", __LINE__); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+        failures++; \
+    } \
+} while ( 0 )
+
+static const size_t chunkSize = 4096;
+
+/* Addresses written by the round trip, with the value written to each
+ * byte of the 16 bytes starting there. The third straddles two chunks,
+ * the last is far above the others. */
+static const Addr patternAddrs[] = { 0, 3 * chunkSize + 100, 8 * chunkSize - 8, (Addr)1 << 40 };
+static const int patternCount = sizeof(patternAddrs) / sizeof(patternAddrs[0]);
+static const size_t patternSize = 16;
+
+static uint8_t patternValue(int i, size_t b) {
+    return (uint8_t)(0x10 * (i + 1) + b + 1);
+}
+
+static void writePattern(Backing& backing) {
+    for (int i = 0; i < patternCount; i++) {
+        std::vector<uint8_t> data(patternSize);
+        for (size_t b = 0; b < patternSize; b++) data[b] = patternValue(i, b);
+        backing.set(patternAddrs[i], patternSize, data);
+    }
+}
+
+static void checkPattern(Backing& backing, const char* desc) {
+    for (int i = 0; i < patternCount; i++) {
+        std::vector<uint8_t> data(patternSize + 2, 0xff);
+        backing.get(patternAddrs[i], patternSize, data);
+        for (size_t b = 0; b < patternSize; b++) {
+            CHECK(data[b] == patternValue(i, b), "%s: byte 0x%" PRIx64 " is 0x%x, expected 0x%x",
+                    desc, patternAddrs[i] + b, data[b], patternValue(i, b));
+        }
+        CHECK(data[patternSize] == 0xff, "%s: bulk read of 0x%" PRIx64 " wrote past its size", desc, patternAddrs[i]);
+        CHECK(backing.get(patternAddrs[i] + 5) == patternValue(i, 5), "%s: single byte read of 0x%" PRIx64 " wrong",
+                desc, patternAddrs[i] + 5);
+        if (patternAddrs[i] > 0) {
+            CHECK(backing.get(patternAddrs[i] - 1) == 0, "%s: byte before 0x%" PRIx64 " not zero", desc, patternAddrs[i]);
+        }
+        CHECK(backing.get(patternAddrs[i] + patternSize) == 0, "%s: byte after the data at 0x%" PRIx64 " not zero", desc, patternAddrs[i]);
+    }
+    CHECK(backing.get(20 * chunkSize + 7) == 0, "%s: unwritten byte not zero", desc);
+}
+
+static void testLazyAllocation() {
+    BackingSparse backing(chunkSize);
+    CHECK(backing.getAllocatedChunks() == 0, "new store has %zu chunks", backing.getAllocatedChunks());
+
+    // Reads, and writes of zeros, allocate nothing
+    std::vector<uint8_t> data(3 * chunkSize, 0xee);
+    backing.get(5 * chunkSize + 10, data.size(), data);
+    CHECK(data[0] == 0 && data[data.size() - 1] == 0, "read of unwritten memory not zero");
+    CHECK(backing.get((Addr)1 << 50) == 0, "read of unwritten high memory not zero");
+    backing.set(7, 0);
+    backing.set(2 * chunkSize, data.size(), data);
+    CHECK(backing.getAllocatedChunks() == 0, "reads or zero writes allocated %zu chunks", backing.getAllocatedChunks());
+
+    // A write allocates only the chunks it puts non-zero data in
+    backing.set(chunkSize + 1, 0x5a);
+    CHECK(backing.getAllocatedChunks() == 1, "one byte write allocated %zu chunks", backing.getAllocatedChunks());
+    std::vector<uint8_t> span(2 * chunkSize + 16, 0);
+    span[chunkSize + 20] = 0x77;                     // Only the middle chunk of the three gets data
+    backing.set(10 * chunkSize - 8, span.size(), span);
+    CHECK(backing.getAllocatedChunks() == 2, "spanning write allocated %zu chunks in all, expected 2", backing.getAllocatedChunks());
+    CHECK(backing.get(11 * chunkSize + 12) == 0x77, "spanning write data not read back");
+    CHECK(backing.get(chunkSize + 1) == 0x5a && backing.get(chunkSize) == 0, "single byte write not read back");
+}
+
+static void testZeroRelease() {
+    BackingSparse backing(chunkSize);
+    std::vector<uint8_t> data(64, 0x33);
+    backing.set(chunkSize, data.size(), data);
+    backing.set(chunkSize + 100, 1);
+    CHECK(backing.getAllocatedChunks() == 1, "%zu chunks after writes to one chunk", backing.getAllocatedChunks());
+
+    // Zeroing part of the data keeps the chunk
+    std::vector<uint8_t> zeros(64, 0);
+    backing.set(chunkSize, 32, zeros);
+    CHECK(backing.getAllocatedChunks() == 1, "chunk released while it still held data");
+    CHECK(backing.get(chunkSize + 40) == 0x33, "data lost when part of the chunk was zeroed");
+
+    // Zeroing the rest releases it
+    backing.set(chunkSize + 32, 32, zeros);
+    backing.set(chunkSize + 100, 0);
+    CHECK(backing.getAllocatedChunks() == 0, "all zero chunk not released, %zu chunks", backing.getAllocatedChunks());
+    CHECK(backing.get(chunkSize + 40) == 0 && backing.get(chunkSize + 100) == 0, "released chunk does not read as zero");
+
+    // And it can be allocated again
+    backing.set(chunkSize + 8, 9);
+    CHECK(backing.getAllocatedChunks() == 1 && backing.get(chunkSize + 8) == 9, "released chunk not reallocated");
+}
+
+static off_t fileSize(const std::string& file) {
+    struct stat st;
+    return (0 == stat(file.c_str(), &st)) ? st.st_size : -1;
+}
+
+/* Run in a fresh process: restore the image and read back what the first process wrote */
+static int restoreAndCheck(const std::string& image) {
+    BackingSparse* restored = NULL;
+    try {
+        restored = new BackingSparse(chunkSize, image);
+    } catch (int e) {
+        fprintf(stderr, "FAIL: restoring %s threw %d\n", image.c_str(), e);
+        return 1;
+    }
+
+    // The straddling write uses two chunks, the others one each
+    CHECK(restored->getAllocatedChunks() == patternCount + 1, "restored %zu chunks, expected %d",
+            restored->getAllocatedChunks(), patternCount + 1);
+    checkPattern(*restored, "restored");
+
+    // Writes go to the private copy, not the image
+    std::vector<uint8_t> data(patternSize, 0xab);
+    restored->set(patternAddrs[1], patternSize, data);
+    CHECK(restored->get(patternAddrs[1]) == 0xab, "write to restored store not read back");
+    delete restored;
+
+    BackingSparse again(chunkSize, image);
+    checkPattern(again, "restored again");
+
+    return failures ? 1 : 0;
+}
+
+static void testSaveRestore(const char* self) {
+    std::string image = "testBackingSparse.img";
+    unlink(image.c_str());
+
+    {
+        BackingSparse backing(chunkSize);
+        writePattern(backing);
+        // A chunk that is written and zeroed again does not go in the image
+        backing.set(30 * chunkSize, 0x44);
+        backing.set(30 * chunkSize, 0);
+        checkPattern(backing, "before save");
+        CHECK(backing.save(image), "save to %s failed", image.c_str());
+    }
+
+    // Only the non-zero chunks are stored after the page aligned header and index
+    const size_t chunks = patternCount + 1;     // The straddling write uses two chunks
+    const size_t page = sysconf(_SC_PAGESIZE);
+    const size_t header = 32 + chunks * sizeof(Addr);
+    const off_t expectSize = ((header + page - 1) & ~(page - 1)) + chunks * chunkSize;
+    CHECK(fileSize(image) == expectSize, "image is %lld bytes, expected %lld", (long long)fileSize(image), (long long)expectSize);
+    CHECK(fileSize(image + ".tmp") == -1, "temporary image file left behind");
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        execl(self, self, "--restore", image.c_str(), (char*)NULL);
+        _exit(127);
+    }
+    int status = 0;
+    CHECK(pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0,
+            "restore in a fresh process failed (status %d)", status);
+
+    // Saving a restored store over its own image keeps the data
+    {
+        BackingSparse restored(chunkSize, image);
+        restored.set((Addr)1 << 41, 0x66);
+        CHECK(restored.save(image), "save over the restored image failed");
+    }
+    BackingSparse resaved(chunkSize, image);
+    checkPattern(resaved, "saved over its image");
+    CHECK(resaved.get((Addr)1 << 41) == 0x66, "write before the second save lost");
+
+    // Bad images and chunk sizes
+    int thrown = 0;
+    try { BackingSparse wrongSize(2 * chunkSize, image); } catch (int e) { thrown = e; }
+    CHECK(thrown == 3, "image with a different chunk size threw %d, expected 3", thrown);
+    thrown = 0;
+    try { BackingSparse missing(chunkSize, image + ".missing"); } catch (int e) { thrown = e; }
+    CHECK(thrown == 1, "missing image threw %d, expected 1", thrown);
+    thrown = 0;
+    try { BackingSparse notPow2(3000); } catch (int e) { thrown = e; }
+    CHECK(thrown == 4, "chunk size that is not a power of two threw %d, expected 4", thrown);
+
+    unlink(image.c_str());
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 3 && std::string(argv[1]) == "--restore") {
+        return restoreAndCheck(argv[2]);
+    }
+
+    testLazyAllocation();
+    testZeroRelease();
+    testSaveRestore(argv[0]);
+
+    if ( failures ) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("Sparse backing store tests passed\n");
+    return 0;
+}
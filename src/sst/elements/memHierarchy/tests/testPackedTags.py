@@ -0,0 +1,72 @@
+# Cache array microbenchmark: a large, highly associative LLC
+# behind a small L1, driven by random loads/stores.
+#
+# checkPackedTags.py runs this with and without the packed tag
+# array, reports the access rate of each and checks that both give
+# the same statistics.
+#   sst testPackedTags.py --model-options="--packed_tags=0"
+import sst
+import sys
+
+packed = "1"
+for arg in sys.argv:
+    if arg.startswith("--packed_tags="):
+        packed = arg.split("=")[1]
+
+verbose = 2
+
+comp_cpu = sst.Component("cpu", "memHierarchy.trivialCPU")
+comp_cpu.addParams({
+      "do_write" : "1",
+      "num_loadstore" : "200000",
+      "commFreq" : "2",
+      "maxOutstanding" : "16",
+      "memSize" : "0x10000000"
+})
+comp_l1cache = sst.Component("l1cache", "memHierarchy.Cache")
+comp_l1cache.addParams({
+    "access_latency_cycles" : "2",
+    "cache_frequency" : "2 Ghz",
+    "replacement_policy" : "lru",
+    "coherence_protocol" : "MESI",
+    "associativity" : "4",
+    "cache_line_size" : "64",
+    "verbose" : verbose,
+    "L1" : "1",
+    "cache_size" : "4KiB",
+    "packed_tags" : packed
+})
+comp_llc = sst.Component("llc", "memHierarchy.Cache")
+comp_llc.addParams({
+    "access_latency_cycles" : "20",
+    "cache_frequency" : "2 Ghz",
+    "replacement_policy" : "lru",
+    "coherence_protocol" : "MESI",
+    "associativity" : "32",
+    "cache_line_size" : "64",
+    "verbose" : verbose,
+    "cache_size" : "64MiB",
+    "mshr_num_entries" : "64",
+    "packed_tags" : packed
+})
+comp_memory = sst.Component("memory", "memHierarchy.MemController")
+comp_memory.addParams({
+    "coherence_protocol" : "MESI",
+    "backend.access_time" : "50 ns",
+    "clock" : "1GHz",
+    "backend.mem_size" : "512MiB",
+    "verbose" : verbose,
+})
+
+# Enable statistics
+sst.setStatisticLoadLevel(7)
+sst.setStatisticOutput("sst.statOutputConsole")
+sst.enableAllStatisticsForComponentType("memHierarchy.Cache")
+
+# Define the simulation links
+link_cpu_l1 = sst.Link("link_cpu_l1")
+link_cpu_l1.connect( (comp_cpu, "mem_link", "1000ps"), (comp_l1cache, "high_network_0", "1000ps") )
+link_l1_llc = sst.Link("link_l1_llc")
+link_l1_llc.connect( (comp_l1cache, "low_network_0", "100ps"), (comp_llc, "high_network_0", "100ps") )
+link_llc_mem = sst.Link("link_llc_mem")
+link_llc_mem.connect( (comp_llc, "low_network_0", "50ps"), (comp_memory, "direct_link", "50ps") )
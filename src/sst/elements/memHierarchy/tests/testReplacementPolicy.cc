@@ -0,0 +1,95 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+/*
+ * Checks for the templated replacement policies in replacementManager.h.
+ * Non-L1 caches rank lines by sharers and owner before asking the policy,
+ * so findVictim(set, candidates) must only return a candidate, and must
+ * return the same way as findVictim(set) when every way is a candidate.
+ */
+
+#include <sst_config.h>
+#include "replacementManager.h"
+
+#include <stdio.h>
+
+using namespace SST::MemHierarchy;
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if ( !(cond) ) { \
+        fprintf(stderr, "FAIL line %d: ", __LINE__); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+        failures++; \
+    } \
+} while ( 0 )
+
+static const unsigned int numSets = 4;
+static const unsigned int numWays = 8;
+
+/* Fill every way of each set and touch them in a per-set order */
+template<typename Policy>
+static void warm(Policy& policy) {
+    for (unsigned int set = 0; set < numSets; set++) {
+        for (unsigned int way = 0; way < numWays; way++) policy.insert(set, way);
+        for (unsigned int i = 0; i < numWays; i++) policy.touch(set, (i * 3 + set) % numWays);
+    }
+}
+
+template<typename Policy>
+static void testPolicy(const char* name) {
+    Policy all(numSets, numWays), restricted(numSets, numWays);
+    warm(all);
+    warm(restricted);
+
+    // With every way a candidate the victim is the unrestricted one
+    uint8_t candidates[numWays];
+    for (unsigned int way = 0; way < numWays; way++) candidates[way] = 1;
+    for (unsigned int set = 0; set < numSets; set++) {
+        unsigned int expect = all.findVictim(set);
+        unsigned int victim = restricted.findVictim(set, candidates);
+        CHECK(victim == expect, "%s set %u: victim %u with every way a candidate, expected %u", name, set, victim, expect);
+    }
+
+    // The victim is always a candidate, whichever ways are allowed
+    for (unsigned int mask = 1; mask < (1u << numWays); mask += 7) {
+        for (unsigned int way = 0; way < numWays; way++) candidates[way] = (mask >> way) & 1;
+        for (unsigned int set = 0; set < numSets; set++) {
+            unsigned int victim = restricted.findVictim(set, candidates);
+            CHECK(victim < numWays && candidates[victim], "%s set %u mask 0x%x: victim %u is not a candidate", name, set, mask, victim);
+            if (victim < numWays) restricted.touch(set, victim);
+        }
+    }
+
+    // A single candidate is the victim
+    for (unsigned int way = 0; way < numWays; way++) candidates[way] = (way == 5);
+    CHECK(restricted.findVictim(2, candidates) == 5, "%s: single candidate not chosen", name);
+}
+
+int main(int argc, char* argv[]) {
+    testPolicy<LRUPolicy<uint8_t> >("lru");
+    testPolicy<TreePLRUPolicy>("plru");
+    testPolicy<SRRIPPolicy>("srrip");
+    testPolicy<BRRIPPolicy>("brrip");
+
+    if ( failures ) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("Replacement policy tests passed\n");
+    return 0;
+}
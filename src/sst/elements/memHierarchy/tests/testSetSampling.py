@@ -0,0 +1,70 @@
+# Set sampling: a CPU with random loads/stores over a footprint four times
+# the size of the L2, so every L2 set sees about the same miss ratio.
+# checkSampling.py runs this once with the full L2 and once with
+# sample_sets and compares the two. sample_filter is on so that memory
+# sees about the full L2's traffic.
+#   sst testSetSampling.py
+#   sst testSetSampling.py --model-options="--sample_sets=16"
+import sst
+import sys
+
+sampleSets = "0"
+for arg in sys.argv:
+    if arg.startswith("--sample_sets="):
+        sampleSets = arg.split("=")[1]
+
+comp_cpu = sst.Component("cpu", "memHierarchy.trivialCPU")
+comp_cpu.addParams({
+      "clock" : "2GHz",
+      "commFreq" : "2",
+      "rngseed" : "7",
+      "do_write" : "1",
+      "num_loadstore" : "100000",
+      "maxOutstanding" : "16",
+      "memSize" : "0x40000",
+})
+comp_l1cache = sst.Component("l1cache", "memHierarchy.Cache")
+comp_l1cache.addParams({
+      "access_latency_cycles" : "2",
+      "cache_frequency" : "2GHz",
+      "replacement_policy" : "lru",
+      "coherence_protocol" : "MESI",
+      "associativity" : "4",
+      "cache_line_size" : "64",
+      "cache_size" : "4KiB",
+      "L1" : "1",
+})
+comp_l2cache = sst.Component("l2cache", "memHierarchy.Cache")
+comp_l2cache.addParams({
+      "access_latency_cycles" : "8",
+      "cache_frequency" : "2GHz",
+      "replacement_policy" : "lru",
+      "coherence_protocol" : "MESI",
+      "associativity" : "8",
+      "cache_line_size" : "64",
+      "cache_size" : "64KiB",
+      "sample_sets" : sampleSets,
+      "sample_filter" : "1",
+      "verbose" : "1",
+})
+comp_memory = sst.Component("memory", "memHierarchy.MemController")
+comp_memory.addParams({
+      "clock" : "1GHz",
+      "backing" : "none",
+      "backend" : "memHierarchy.simpleMem",
+      "backend.mem_size" : "512MiB",
+      "backend.access_time" : "50ns",
+      "max_requests_per_cycle" : "-1",
+})
+
+sst.setStatisticLoadLevel(1)
+sst.setStatisticOutput("sst.statOutputConsole")
+sst.enableAllStatisticsForComponentType("memHierarchy.Cache")
+sst.enableAllStatisticsForComponentType("memHierarchy.MemController")
+
+link_cpu_l1 = sst.Link("link_cpu_l1")
+link_cpu_l1.connect( (comp_cpu, "mem_link", "100ps"), (comp_l1cache, "high_network_0", "100ps") )
+link_l1_l2 = sst.Link("link_l1_l2")
+link_l1_l2.connect( (comp_l1cache, "low_network_0", "100ps"), (comp_l2cache, "high_network_0", "100ps") )
+link_l2_mem = sst.Link("link_l2_mem")
+link_l2_mem.connect( (comp_l2cache, "low_network_0", "100ps"), (comp_memory, "direct_link", "100ps") )
@@ -0,0 +1,137 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+/*
+ * Sharing checks for SharedPayload, the copy-on-write buffer behind MemEvent
+ * payloads and cache line data. A line that is read into a response, forwarded
+ * and filled into another cache must keep pointing at the same bytes; only a
+ * write may copy them.
+ */
+
+#include <sst_config.h>
+#include "sharedPayload.h"
+
+#include <stdio.h>
+
+using namespace SST::MemHierarchy;
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if ( !(cond) ) { \
+        fprintf(stderr, "FAIL line %d: ", __LINE__); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+        failures++; \
+    } \
+} while ( 0 )
+
+static const size_t lineSize = 64;
+
+static std::vector<uint8_t> lineBytes(uint8_t seed) {
+    std::vector<uint8_t> data(lineSize);
+    for (size_t i = 0; i < lineSize; i++) data[i] = seed + i;
+    return data;
+}
+
+/* What the cache does for a hit: response payload = line data, then the
+ * response is forwarded (event copy) and filled into the next line */
+static void testForwardShares() {
+    SharedPayload line(lineBytes(1));
+    const uint8_t* bytes = line.get().data();
+
+    SharedPayload response;
+    response = line;                    // Response built from the line
+    SharedPayload forwarded(response);  // Event forwarded by the next level
+    SharedPayload upperLine;
+    upperLine.resize(lineSize);
+    upperLine = forwarded;              // Full-line fill
+
+    CHECK(response.get().data() == bytes, "response payload was copied");
+    CHECK(forwarded.get().data() == bytes, "forwarded payload was copied");
+    CHECK(upperLine.get().data() == bytes, "filled line was copied");
+    CHECK(line.isShared() && upperLine.isShared(), "buffers not reported as shared");
+
+    /* Reads (MemEvent::getPayload) must not stop later copies from sharing */
+    uint32_t sum = 0;
+    for (size_t i = 0; i < forwarded.size(); i++) sum += forwarded[i];
+    CHECK(sum == 64 * 65 / 2, "wrong data read back, sum %u", sum);
+    SharedPayload again(forwarded);
+    CHECK(again.get().data() == bytes, "payload copied after being read");
+}
+
+/* A partial write copies once and leaves the other holders alone */
+static void testWriteCopies() {
+    SharedPayload line(lineBytes(1));
+    SharedPayload event(line);
+    const uint8_t* bytes = line.get().data();
+
+    uint8_t value = 0xff;
+    event.write(8, &value, 1);
+    CHECK(event.get().data() != bytes, "write to a shared buffer did not copy");
+    CHECK(line.get().data() == bytes, "the line's buffer moved");
+    CHECK(line[8] == 9, "write leaked into the line: %u", line[8]);
+    CHECK(event[8] == 0xff && event[9] == 10, "write not applied to the copy");
+    CHECK(!line.isShared() && !event.isShared(), "buffers still shared after the write");
+
+    /* A buffer with one holder is written in place */
+    const uint8_t* own = event.get().data();
+    event.write(0, &value, 1);
+    CHECK(event.get().data() == own, "unshared buffer copied on write");
+}
+
+/* A mutable reference (MemEvent::getMutablePayload) can be written later,
+ * so that buffer must be copied, not shared, from then on */
+static void testMutableNotShared() {
+    SharedPayload event(lineBytes(3));
+    std::vector<uint8_t>& data = event.getMutable();
+    SharedPayload copy(event);
+    CHECK(copy.get().data() != event.get().data(), "pinned buffer was shared");
+
+    data[0] = 0;
+    CHECK(copy[0] == 3, "later write through the mutable reference reached the copy");
+
+    /* Assigning new data ends the pin */
+    event.assign(lineBytes(5));
+    SharedPayload shared(event);
+    CHECK(shared.get().data() == event.get().data(), "buffer still pinned after assign");
+}
+
+/* Releasing the last holder keeps the bytes alive for the others */
+static void testRelease() {
+    SharedPayload* line = new SharedPayload(lineBytes(7));
+    SharedPayload event(*line);
+    delete line;
+    CHECK(!event.isShared(), "released holder still counted");
+    CHECK(event.size() == lineSize && event[0] == 7 && event[63] == 70, "data lost on release");
+
+    SharedPayload empty;
+    SharedPayload emptyCopy(empty);
+    CHECK(emptyCopy.empty() && emptyCopy.get().empty(), "empty payload not empty");
+}
+
+int main(int argc, char* argv[]) {
+    testForwardShares();
+    testWriteCopies();
+    testMutableNotShared();
+    testRelease();
+
+    if ( failures ) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("SharedPayload tests passed\n");
+    return 0;
+}
@@ -0,0 +1,104 @@
+// -*- mode: c++ -*-
+
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#ifndef COMPONENTS_MERLIN_EVENTPOOL_H
+#define COMPONENTS_MERLIN_EVENTPOOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <new>
+#include <vector>
+
+namespace SST {
+namespace Merlin {
+
+// Per-thread free lists for router events.  Blocks are kept in size
+// classes of 16 bytes, so every event type (including the topology
+// subclasses of internal_router_event) gets reused by the next event
+// of the same size.  A block freed on a different thread than it was
+// allocated on simply moves to that thread's lists.
+class EventPool {
+public:
+    static inline void* allocate(size_t size) {
+        size_t bucket = (size + granularity - 1) / granularity;
+        Pool& p = pool();
+        if ( bucket < num_buckets && !p.free[bucket].empty() ) {
+            void* ptr = p.free[bucket].back();
+            p.free[bucket].pop_back();
+            p.hits++;
+            return ptr;
+        }
+        p.misses++;
+        if ( bucket < num_buckets ) return ::operator new(bucket * granularity);
+        return ::operator new(size);
+    }
+
+    static inline void release(void* ptr, size_t size) {
+        if ( ptr == NULL ) return;
+        size_t bucket = (size + granularity - 1) / granularity;
+        Pool& p = pool();
+        if ( bucket < num_buckets && p.free[bucket].size() < max_free ) {
+            p.free[bucket].push_back(ptr);
+            return;
+        }
+        ::operator delete(ptr);
+    }
+
+    // Allocations on this thread served from / not served from the
+    // free lists
+    static uint64_t getHits() { return pool().hits; }
+    static uint64_t getMisses() { return pool().misses; }
+
+    // True for the first caller on this thread only, so that one
+    // component per thread reports the per-thread counts
+    static bool claimReporter() {
+        Pool& p = pool();
+        if ( p.reporter_claimed ) return false;
+        p.reporter_claimed = true;
+        return true;
+    }
+
+private:
+    static const size_t granularity = 16;
+    static const size_t num_buckets = 32;
+    static const size_t max_free = 16384;
+
+    struct Pool {
+        std::vector<void*> free[num_buckets];
+        uint64_t hits;
+        uint64_t misses;
+        bool reporter_claimed;
+
+        Pool() : hits(0), misses(0), reporter_claimed(false) {}
+        ~Pool() {
+            for ( size_t i = 0; i < num_buckets; i++ ) {
+                for ( size_t j = 0; j < free[i].size(); j++ ) ::operator delete(free[i][j]);
+            }
+        }
+    };
+
+    static Pool& pool() {
+        static thread_local Pool p;
+        return p;
+    }
+};
+
+}
+}
+
+#endif // COMPONENTS_MERLIN_EVENTPOOL_H
@@ -0,0 +1,234 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#include <sst_config.h>
+
+#include "flow_linkcontrol.h"
+
+#include <sst/core/simulation.h>
+
+#include "sst/elements/merlin/merlin.h"
+#include "flow_network.h"
+
+namespace SST {
+using namespace Interfaces;
+
+namespace Merlin {
+
+FlowLinkControl::FlowLinkControl(Component* parent, Params &params) :
+    SST::Interfaces::SimpleNetwork(parent),
+    net_link(NULL),
+    vns(0), id(-1),
+    network_initialized(false),
+    input_buf(NULL), outbuf_credits(NULL),
+    receiveFunctor(NULL), sendFunctor(NULL),
+    output(Simulation::getSimulation()->getSimulationOutput())
+{
+}
+
+bool
+FlowLinkControl::initialize(const std::string& port_name, const UnitAlgebra& link_bw_in,
+                            int vns_in, const UnitAlgebra& in_buf_size,
+                            const UnitAlgebra& out_buf_size)
+{
+    vns = vns_in;
+    link_bw = link_bw_in;
+    if ( link_bw.hasUnits("B/s") ) {
+        link_bw *= UnitAlgebra("8b/B");
+    }
+
+    UnitAlgebra outbuf_size = out_buf_size;
+    if ( !outbuf_size.hasUnits("b") && !outbuf_size.hasUnits("B") ) {
+        merlin_abort.fatal(CALL_INFO,-1,"out_buf_size must be specified in either "
+                           "bits or bytes: %s\n",outbuf_size.toStringBestSI().c_str());
+    }
+    if ( outbuf_size.hasUnits("B") ) outbuf_size *= UnitAlgebra("8b/B");
+
+    input_buf = new std::queue<SST::Interfaces::SimpleNetwork::Request*>[vns];
+    outbuf_credits = new int64_t[vns];
+    for ( int i = 0; i < vns; i++ ) outbuf_credits[i] = outbuf_size.getRoundedValue();
+
+    net_link = configureLink(port_name, std::string("1ps"), new Event::Handler<FlowLinkControl>(this,&FlowLinkControl::handle_input));
+
+    packet_latency = registerStatistic<uint64_t>("packet_latency");
+    send_bit_count = registerStatistic<uint64_t>("send_bit_count");
+
+    return true;
+}
+
+FlowLinkControl::~FlowLinkControl()
+{
+    delete [] input_buf;
+    delete [] outbuf_credits;
+}
+
+void FlowLinkControl::setup()
+{
+    while ( init_events.size() ) {
+        delete init_events.front();
+        init_events.pop_front();
+    }
+}
+
+void FlowLinkControl::init(unsigned int phase)
+{
+    if ( phase == 0 ) {
+        FlowEvent* ev = new FlowEvent(FlowEvent::REPORT_BW);
+        ev->bw = link_bw.getDoubleValue();
+        net_link->sendUntimedData(ev);
+    }
+
+    Event* ev;
+    while ( ( ev = net_link->recvUntimedData() ) != NULL ) {
+        FlowEvent* fev = static_cast<FlowEvent*>(ev);
+        switch ( fev->type ) {
+        case FlowEvent::REPORT_ID:
+            id = fev->int_value;
+            network_initialized = true;
+            delete fev;
+            break;
+        case FlowEvent::DATA:
+            init_events.push_back(fev->request);
+            fev->request = NULL;
+            delete fev;
+            break;
+        default:
+            merlin_abort_full.fatal(CALL_INFO, 1, "Unexpected event type during init.");
+            break;
+        }
+    }
+}
+
+void FlowLinkControl::complete(unsigned int phase)
+{
+    Event* ev;
+    while ( ( ev = net_link->recvUntimedData() ) != NULL ) {
+        FlowEvent* fev = static_cast<FlowEvent*>(ev);
+        if ( fev->type != FlowEvent::DATA ) {
+            merlin_abort_full.fatal(CALL_INFO, 1, "Unexpected event type during complete.");
+        }
+        init_events.push_back(fev->request);
+        fev->request = NULL;
+        delete fev;
+    }
+}
+
+void FlowLinkControl::finish(void)
+{
+    for ( int i = 0; i < vns; i++ ) {
+        while ( !input_buf[i].empty() ) {
+            delete input_buf[i].front();
+            input_buf[i].pop();
+        }
+    }
+}
+
+bool FlowLinkControl::send(SimpleNetwork::Request* req, int vn) {
+    if ( vn >= vns ) return false;
+    if ( outbuf_credits[vn] < (int64_t)req->size_in_bits ) return false;
+    outbuf_credits[vn] -= req->size_in_bits;
+
+    req->vn = vn;
+    FlowEvent* ev = new FlowEvent(FlowEvent::DATA);
+    ev->request = req;
+    ev->injection_time = parent->getCurrentSimTimeNano();
+    send_bit_count->addData(req->size_in_bits);
+
+    if ( req->getTraceType() != SimpleNetwork::Request::NONE ) {
+        output.output("TRACE(%d): %" PRIu64 " ns: Send on FlowLinkControl in NIC: %s\n",req->getTraceID(),
+                      parent->getCurrentSimTimeNano(), parent->getName().c_str());
+    }
+
+    net_link->send(ev);
+    return true;
+}
+
+bool FlowLinkControl::spaceToSend(int vn, int bits) {
+    return outbuf_credits[vn] >= bits;
+}
+
+SST::Interfaces::SimpleNetwork::Request* FlowLinkControl::recv(int vn) {
+    if ( input_buf[vn].empty() ) return NULL;
+
+    SST::Interfaces::SimpleNetwork::Request* req = input_buf[vn].front();
+    input_buf[vn].pop();
+    return req;
+}
+
+void FlowLinkControl::sendUntimedData(SST::Interfaces::SimpleNetwork::Request* req)
+{
+    FlowEvent* ev = new FlowEvent(FlowEvent::DATA);
+    ev->request = req;
+    net_link->sendUntimedData(ev);
+}
+
+SST::Interfaces::SimpleNetwork::Request* FlowLinkControl::recvUntimedData()
+{
+    if ( init_events.empty() ) return NULL;
+    SST::Interfaces::SimpleNetwork::Request* ret = init_events.front();
+    init_events.pop_front();
+    return ret;
+}
+
+void FlowLinkControl::sendInitData(SST::Interfaces::SimpleNetwork::Request* req) {
+    sendUntimedData(req);
+}
+
+SST::Interfaces::SimpleNetwork::Request* FlowLinkControl::recvInitData() {
+    return recvUntimedData();
+}
+
+void FlowLinkControl::handle_input(Event* ev)
+{
+    FlowEvent* fev = static_cast<FlowEvent*>(ev);
+    if ( fev->type == FlowEvent::DONE ) {
+        // The whole message has left the network, return its output
+        // buffer space
+        int vn = fev->int_value;
+        outbuf_credits[vn] += fev->bits;
+        delete fev;
+        if ( sendFunctor != NULL ) {
+            bool keep = (*sendFunctor)(vn);
+            if ( !keep ) sendFunctor = NULL;
+        }
+        return;
+    }
+
+    SST::Interfaces::SimpleNetwork::Request* req = fev->request;
+    fev->request = NULL;
+    int vn = req->vn;
+    input_buf[vn].push(req);
+
+    if ( req->getTraceType() == SimpleNetwork::Request::FULL ) {
+        output.output("TRACE(%d): %" PRIu64 " ns: Received an event on FlowLinkControl in NIC: %s"
+                      " on VN %d from src %" PRIu64 "\n",
+                      req->getTraceID(),
+                      parent->getCurrentSimTimeNano(),
+                      parent->getName().c_str(),
+                      vn,
+                      req->src);
+    }
+    packet_latency->addData(parent->getCurrentSimTimeNano() - fev->injection_time);
+    delete fev;
+
+    if ( receiveFunctor != NULL ) {
+        bool keep = (*receiveFunctor)(vn);
+        if ( !keep) receiveFunctor = NULL;
+    }
+}
+
+}
+}
@@ -0,0 +1,117 @@
+// -*- mode: c++ -*-
+
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#ifndef COMPONENTS_MERLIN_FLOWNETWORK_FLOW_LINKCONTROL_H
+#define COMPONENTS_MERLIN_FLOWNETWORK_FLOW_LINKCONTROL_H
+
+#include <sst/core/elementinfo.h>
+#include <sst/core/subcomponent.h>
+#include <sst/core/unitAlgebra.h>
+
+#include <sst/core/interfaces/simpleNetwork.h>
+
+#include <sst/core/statapi/statbase.h>
+
+#include <deque>
+#include <queue>
+
+namespace SST {
+
+class Component;
+
+namespace Merlin {
+
+// SimpleNetwork interface to a flow_network.  Messages are handed to
+// the flow model as soon as there is output buffer space for them, and
+// the space is returned once the whole message has left the network.
+// Received messages are buffered without limit.
+class FlowLinkControl : public SST::Interfaces::SimpleNetwork {
+
+public:
+
+    SST_ELI_REGISTER_SUBCOMPONENT(
+        FlowLinkControl,
+        "merlin",
+        "flow_linkcontrol",
+        SST_ELI_ELEMENT_VERSION(1,0,0),
+        "Link Control module for connecting an endpoint to a merlin.flow_network",
+        "SST::Interfaces::SimpleNetwork")
+
+    SST_ELI_DOCUMENT_STATISTICS(
+        { "packet_latency",     "Histogram of latencies for received packets", "latency", 1},
+        { "send_bit_count",     "Count number of bits sent on link", "bits", 1},
+    )
+
+private:
+    Link* net_link;
+
+    UnitAlgebra link_bw;
+    int vns;
+    int id;
+    bool network_initialized;
+
+    std::queue<SST::Interfaces::SimpleNetwork::Request*>* input_buf;
+    // Output buffer space left on each VN, in bits
+    int64_t* outbuf_credits;
+    std::deque<SST::Interfaces::SimpleNetwork::Request*> init_events;
+
+    HandlerBase* receiveFunctor;
+    HandlerBase* sendFunctor;
+
+    Statistic<uint64_t>* packet_latency;
+    Statistic<uint64_t>* send_bit_count;
+
+    Output& output;
+
+    void handle_input(Event* ev);
+
+public:
+    FlowLinkControl(Component* parent, Params &params);
+    ~FlowLinkControl();
+
+    bool initialize(const std::string& port_name, const UnitAlgebra& link_bw_in,
+                    int vns, const UnitAlgebra& in_buf_size,
+                    const UnitAlgebra& out_buf_size);
+    void setup();
+    void init(unsigned int phase);
+    void complete(unsigned int phase);
+    void finish();
+
+    bool send(SST::Interfaces::SimpleNetwork::Request* req, int vn);
+    bool spaceToSend(int vn, int bits);
+    SST::Interfaces::SimpleNetwork::Request* recv(int vn);
+    bool requestToReceive( int vn ) { return ! input_buf[vn].empty(); }
+
+    void sendInitData(SST::Interfaces::SimpleNetwork::Request* ev);
+    SST::Interfaces::SimpleNetwork::Request* recvInitData();
+
+    void sendUntimedData(SST::Interfaces::SimpleNetwork::Request* ev);
+    SST::Interfaces::SimpleNetwork::Request* recvUntimedData();
+
+    inline void setNotifyOnReceive(HandlerBase* functor) { receiveFunctor = functor; }
+    inline void setNotifyOnSend(HandlerBase* functor) { sendFunctor = functor; }
+
+    inline bool isNetworkInitialized() const { return network_initialized; }
+    inline nid_t getEndpointID() const { return id; }
+    inline const UnitAlgebra& getLinkBW() const { return link_bw; }
+};
+
+}
+}
+
+#endif // COMPONENTS_MERLIN_FLOWNETWORK_FLOW_LINKCONTROL_H
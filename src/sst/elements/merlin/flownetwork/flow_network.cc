@@ -0,0 +1,663 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#include <sst_config.h>
+#include "flow_network.h"
+
+#include <sst/core/params.h>
+#include <sst/core/simulation.h>
+#include <sst/core/unitAlgebra.h>
+
+#include <algorithm>
+#include <math.h>
+#include <sstream>
+#include <stdlib.h>
+
+#include "sst/elements/merlin/merlin.h"
+
+using namespace SST;
+using namespace SST::Merlin;
+using namespace SST::Interfaces;
+
+namespace {
+
+// Parses strings of the form 4x4x2
+std::vector<int> parseDims(const std::string& shape)
+{
+    std::vector<int> dims;
+    std::stringstream ss(shape);
+    std::string sub;
+    while ( getline(ss, sub, 'x') ) {
+        dims.push_back(strtol(sub.c_str(), NULL, 0));
+    }
+    return dims;
+}
+
+// Router ids use dimension 0 as the fastest changing coordinate, as in
+// merlin.torus and merlin.hyperx
+void idToLocation(int id, const std::vector<int>& dims, std::vector<int>& loc)
+{
+    loc.resize(dims.size());
+    for ( size_t i = 0; i < dims.size(); i++ ) {
+        loc[i] = id % dims[i];
+        id /= dims[i];
+    }
+}
+
+
+// Dimension order routing, taking the shorter direction around each
+// ring as merlin.torus does
+class FlowTorus : public FlowTopology {
+    std::vector<int> dims;
+    std::vector<int> widths;
+    int local_ports;
+    int num_routers;
+    int base;
+
+public:
+    FlowTorus(Params& params) {
+        dims = parseDims(params.find<std::string>("torus:shape"));
+        widths = parseDims(params.find<std::string>("torus:width"));
+        local_ports = params.find<int>("torus:local_ports", 1);
+        if ( dims.empty() || dims.size() != widths.size() ) {
+            merlin_abort.fatal(CALL_INFO, -1, "flow_network: torus:shape and torus:width must have the same number of dimensions\n");
+        }
+        num_routers = 1;
+        for ( size_t i = 0; i < dims.size(); i++ ) num_routers *= dims[i];
+        base = 2 * num_routers * local_ports;
+    }
+
+    int getNumEndpoints() const { return num_routers * local_ports; }
+    int getNumLinks() const { return base + num_routers * dims.size() * 2; }
+
+    double getLinkWidth(int link) const {
+        return widths[((link - base) / 2) % dims.size()];
+    }
+
+    int getPath(int src, int dest, std::vector<int>& links) const {
+        int rtr = src / local_ports;
+        int dest_rtr = dest / local_ports;
+        std::vector<int> loc, dest_loc;
+        idToLocation(rtr, dims, loc);
+        idToLocation(dest_rtr, dims, dest_loc);
+
+        int hops = 1;
+        int stride = 1;
+        for ( size_t dim = 0; dim < dims.size(); stride *= dims[dim], dim++ ) {
+            if ( loc[dim] == dest_loc[dim] ) continue;
+            int dist_pos = dest_loc[dim] - loc[dim];
+            if ( dist_pos < 0 ) dist_pos += dims[dim];
+            int dist_neg = dims[dim] - dist_pos;
+            int dir = (dist_pos <= dist_neg) ? 0 : 1;
+            int dist = dir == 0 ? dist_pos : dist_neg;
+            for ( int i = 0; i < dist; i++ ) {
+                links.push_back(base + (rtr * dims.size() + dim) * 2 + dir);
+                int next = dir == 0 ? (loc[dim] + 1) % dims[dim] : (loc[dim] + dims[dim] - 1) % dims[dim];
+                rtr += (next - loc[dim]) * stride;
+                loc[dim] = next;
+                hops++;
+            }
+        }
+        return hops;
+    }
+};
+
+
+// Dimension order routing, one hop per unaligned dimension
+class FlowHyperX : public FlowTopology {
+    std::vector<int> dims;
+    std::vector<int> widths;
+    std::vector<int> dim_offset;
+    int dim_total;
+    int local_ports;
+    int num_routers;
+    int base;
+
+public:
+    FlowHyperX(Params& params) {
+        dims = parseDims(params.find<std::string>("hyperx:shape"));
+        widths = parseDims(params.find<std::string>("hyperx:width"));
+        local_ports = params.find<int>("hyperx:local_ports", 1);
+        if ( dims.empty() || dims.size() != widths.size() ) {
+            merlin_abort.fatal(CALL_INFO, -1, "flow_network: hyperx:shape and hyperx:width must have the same number of dimensions\n");
+        }
+        num_routers = 1;
+        dim_total = 0;
+        for ( size_t i = 0; i < dims.size(); i++ ) {
+            num_routers *= dims[i];
+            dim_offset.push_back(dim_total);
+            dim_total += dims[i];
+        }
+        base = 2 * num_routers * local_ports;
+    }
+
+    int getNumEndpoints() const { return num_routers * local_ports; }
+    int getNumLinks() const { return base + num_routers * dim_total; }
+
+    double getLinkWidth(int link) const {
+        int offset = (link - base) % dim_total;
+        int dim = std::upper_bound(dim_offset.begin(), dim_offset.end(), offset) - dim_offset.begin() - 1;
+        return widths[dim];
+    }
+
+    int getPath(int src, int dest, std::vector<int>& links) const {
+        int rtr = src / local_ports;
+        int dest_rtr = dest / local_ports;
+        std::vector<int> loc, dest_loc;
+        idToLocation(rtr, dims, loc);
+        idToLocation(dest_rtr, dims, dest_loc);
+
+        int hops = 1;
+        int stride = 1;
+        for ( size_t dim = 0; dim < dims.size(); stride *= dims[dim], dim++ ) {
+            if ( loc[dim] == dest_loc[dim] ) continue;
+            links.push_back(base + rtr * dim_total + dim_offset[dim] + dest_loc[dim]);
+            rtr += (dest_loc[dim] - loc[dim]) * stride;
+            hops++;
+        }
+        return hops;
+    }
+};
+
+
+// Traffic goes up to the lowest level whose subtree holds both
+// endpoints and back down.  The up (and down) links of each subtree
+// are one link with the bandwidth of all of them, which assumes the
+// traffic spreads evenly over the routers at each level.
+class FlowFatTree : public FlowTopology {
+    int levels;
+    std::vector<int> downs;
+    std::vector<int> ups;
+    std::vector<int> hosts_below;   // Hosts in a subtree rooted at each level
+    std::vector<int> level_offset;  // First subtree index of each level
+    std::vector<int> level_width;   // Up links of a subtree at each level
+    int num_hosts;
+    int base;
+
+public:
+    FlowFatTree(Params& params) {
+        std::string shape = params.find<std::string>("fattree:shape");
+        std::stringstream ss(shape);
+        std::string sub;
+        while ( getline(ss, sub, ':') ) {
+            size_t comma = sub.find(',');
+            downs.push_back(strtol(sub.substr(0, comma).c_str(), NULL, 0));
+            ups.push_back(comma == std::string::npos ? 0 : strtol(sub.substr(comma + 1).c_str(), NULL, 0));
+        }
+        levels = downs.size();
+        if ( levels == 0 ) {
+            merlin_abort.fatal(CALL_INFO, -1, "flow_network: fattree:shape must be specified\n");
+        }
+
+        num_hosts = 1;
+        for ( int i = 0; i < levels; i++ ) num_hosts *= downs[i];
+
+        // Routers in a level-i subtree at level i, times their up links
+        int routers = 1;
+        int below = 1;
+        int subtrees = 0;
+        for ( int i = 0; i < levels; i++ ) {
+            below *= downs[i];
+            hosts_below.push_back(below);
+            level_offset.push_back(subtrees);
+            level_width.push_back(routers * ups[i]);
+            subtrees += num_hosts / below;
+            routers *= ups[i];
+        }
+        base = 2 * num_hosts;
+        level_offset.push_back(subtrees);
+    }
+
+    int getNumEndpoints() const { return num_hosts; }
+    int getNumLinks() const { return base + 2 * level_offset[levels]; }
+
+    double getLinkWidth(int link) const {
+        int subtree = (link - base) / 2;
+        int level = std::upper_bound(level_offset.begin(), level_offset.end(), subtree) - level_offset.begin() - 1;
+        return level_width[level];
+    }
+
+    int getPath(int src, int dest, std::vector<int>& links) const {
+        int top = 0;
+        while ( src / hosts_below[top] != dest / hosts_below[top] ) top++;
+        for ( int l = 0; l < top; l++ ) {
+            links.push_back(base + 2 * (level_offset[l] + src / hosts_below[l]));
+        }
+        for ( int l = top - 1; l >= 0; l-- ) {
+            links.push_back(base + 2 * (level_offset[l] + dest / hosts_below[l]) + 1);
+        }
+        return 2 * top + 1;
+    }
+};
+
+
+// Minimal routing.  Global traffic uses slice src % intergroup_links,
+// as merlin.dragonfly2 does.
+class FlowDragonfly2 : public FlowTopology {
+    int p, a, g, n;
+    bool relative;
+    std::vector<int> link_router;   // Router in a group owning each global link map entry
+    int base;
+    int global_base;
+
+    int relativeGroup(int from, int to) const {
+        if ( !relative ) return to < from ? to : to - 1;
+        return to > from ? to - from - 1 : g - from + to - 1;
+    }
+
+    int gatewayRouter(int from, int to, int slice) const {
+        int router = link_router[slice * (g - 1) + relativeGroup(from, to)];
+        if ( router == -1 ) {
+            merlin_abort.fatal(CALL_INFO, -1, "flow_network: no global link from group %d to group %d on slice %d\n", from, to, slice);
+        }
+        return router;
+    }
+
+public:
+    FlowDragonfly2(Params& params) {
+        p = params.find<int>("dragonfly:hosts_per_router");
+        a = params.find<int>("dragonfly:routers_per_group");
+        g = params.find<int>("dragonfly:num_groups");
+        n = params.find<int>("dragonfly:intergroup_links");
+        relative = params.find<std::string>("dragonfly:global_route_mode", "absolute") == "relative";
+
+        link_router.assign((g - 1) * n, -1);
+        std::string array = params.find<std::string>("dragonfly:global_link_map", "");
+        if ( array != "" ) {
+            int h = params.find<int>("dragonfly:intergroup_per_router");
+            array = array.substr(1, array.size() - 2);
+            std::stringstream ss(array);
+            std::string sub;
+            for ( int i = 0; getline(ss, sub, ','); i++ ) {
+                int value = strtol(sub.c_str(), NULL, 0);
+                if ( value >= 0 && value < (int)link_router.size() ) link_router[value] = i / h;
+            }
+        }
+        else {
+            // Same linear map pymerlin builds by default
+            int total = (g - 1) * n;
+            int h = (total + a - 1) / a;
+            int start_skip = a - (h * a - total);
+            int count = 0;
+            for ( int r = 0; r < a; r++ ) {
+                int end = r >= start_skip ? h - 1 : h;
+                for ( int j = 0; j < end; j++ ) link_router[count++] = r;
+            }
+        }
+
+        base = 2 * g * a * p;
+        global_base = base + g * a * a;
+    }
+
+    int getNumEndpoints() const { return g * a * p; }
+    int getNumLinks() const { return global_base + g * (g - 1) * n; }
+    double getLinkWidth(int link) const { return 1; }
+
+    int getPath(int src, int dest, std::vector<int>& links) const {
+        int src_rtr = src / p;
+        int dest_rtr = dest / p;
+        int src_group = src_rtr / a;
+        int dest_group = dest_rtr / a;
+        int r = src_rtr % a;
+        int dest_r = dest_rtr % a;
+        int hops = 1;
+
+        if ( src_group != dest_group ) {
+            int slice = src % n;
+            int gw = gatewayRouter(src_group, dest_group, slice);
+            if ( gw != r ) {
+                links.push_back(base + (src_group * a + r) * a + gw);
+                hops++;
+            }
+            links.push_back(global_base + (src_group * (g - 1) + relativeGroup(src_group, dest_group)) * n + slice);
+            hops++;
+            r = gatewayRouter(dest_group, src_group, slice);
+        }
+        if ( r != dest_r ) {
+            links.push_back(base + (dest_group * a + r) * a + dest_r);
+            hops++;
+        }
+        return hops;
+    }
+};
+
+}
+
+
+FlowNetwork::FlowNetwork(ComponentId_t cid, Params& params) :
+    Component(cid),
+    topo(NULL),
+    last_update(0),
+    timer_generation(0),
+    output(Simulation::getSimulation()->getSimulationOutput())
+{
+    std::string topology = params.find<std::string>("topology");
+    if ( topology == "merlin.torus" ) topo = new FlowTorus(params);
+    else if ( topology == "merlin.hyperx" ) topo = new FlowHyperX(params);
+    else if ( topology == "merlin.fattree" ) topo = new FlowFatTree(params);
+    else if ( topology == "merlin.dragonfly2" ) topo = new FlowDragonfly2(params);
+    else {
+        merlin_abort.fatal(CALL_INFO, -1, "flow_network: unsupported topology: %s\n", topology.c_str());
+    }
+    num_endpoints = topo->getNumEndpoints();
+
+    UnitAlgebra bw = params.find<UnitAlgebra>("link_bw");
+    if ( bw.hasUnits("B/s") ) bw *= UnitAlgebra("8b/B");
+    if ( !bw.hasUnits("b/s") ) {
+        merlin_abort.fatal(CALL_INFO, -1, "flow_network: link_bw must be specified in b/s or B/s: %s\n", bw.toStringBestSI().c_str());
+    }
+    link_bw = bw.getDoubleValue();
+
+    UnitAlgebra latency = params.find<UnitAlgebra>("hop_latency", "20ns");
+    if ( !latency.hasUnits("s") ) {
+        merlin_abort.fatal(CALL_INFO, -1, "flow_network: hop_latency must be specified in s: %s\n", latency.toStringBestSI().c_str());
+    }
+    hop_latency = (latency / UnitAlgebra("1ps")).getRoundedValue();
+
+    // Endpoint links get their bandwidth during init
+    int num_links = topo->getNumLinks();
+    link_capacity.resize(num_links);
+    for ( int i = 2 * num_endpoints; i < num_links; i++ ) {
+        link_capacity[i] = link_bw * topo->getLinkWidth(i);
+    }
+    link_flows.resize(num_links);
+    busy_index.assign(num_links, -1);
+
+    ps_tc = getTimeConverter("1ps");
+    ports.resize(num_endpoints);
+    for ( int i = 0; i < num_endpoints; i++ ) {
+        std::stringstream port_name;
+        port_name << "port" << i;
+        ports[i] = configureLink(port_name.str(), ps_tc,
+                                 new Event::Handler<FlowNetwork,int>(this, &FlowNetwork::handle_input, i));
+        if ( ports[i] == NULL ) {
+            merlin_abort.fatal(CALL_INFO, -1, "flow_network: %s is not connected, the topology has %d endpoints\n",
+                               port_name.str().c_str(), num_endpoints);
+        }
+    }
+    completion_timer = configureSelfLink("completion_timer", ps_tc,
+                                         new Event::Handler<FlowNetwork>(this, &FlowNetwork::handle_timer));
+
+    stat_flows = registerStatistic<uint64_t>("flows");
+    stat_flow_time = registerStatistic<uint64_t>("flow_time");
+    stat_rate_updates = registerStatistic<uint64_t>("rate_updates");
+    stat_active_flows = registerStatistic<uint64_t>("active_flows");
+}
+
+FlowNetwork::~FlowNetwork()
+{
+    delete topo;
+}
+
+void
+FlowNetwork::init(unsigned int phase)
+{
+    for ( int i = 0; i < num_endpoints; i++ ) {
+        Event* ev;
+        while ( (ev = ports[i]->recvUntimedData()) != NULL ) {
+            FlowEvent* fev = static_cast<FlowEvent*>(ev);
+            switch ( fev->type ) {
+            case FlowEvent::REPORT_BW:
+                {
+                // Endpoint links run at the slower of the two sides
+                double bw = std::min(fev->bw, link_bw);
+                link_capacity[i] = bw;
+                link_capacity[num_endpoints + i] = bw;
+                FlowEvent* id_ev = new FlowEvent(FlowEvent::REPORT_ID);
+                id_ev->int_value = i;
+                ports[i]->sendUntimedData(id_ev);
+                delete fev;
+                }
+                break;
+            case FlowEvent::DATA:
+                if ( fev->request->dest == SimpleNetwork::INIT_BROADCAST_ADDR ) {
+                    for ( int j = 0; j < num_endpoints; j++ ) {
+                        if ( j == i ) continue;
+                        FlowEvent* copy = new FlowEvent(FlowEvent::DATA);
+                        copy->request = fev->request->clone();
+                        ports[j]->sendUntimedData(copy);
+                    }
+                    delete fev;
+                }
+                else {
+                    ports[fev->request->dest]->sendUntimedData(fev);
+                }
+                break;
+            default:
+                merlin_abort.fatal(CALL_INFO, -1, "flow_network: unexpected event during init\n");
+                break;
+            }
+        }
+    }
+}
+
+void
+FlowNetwork::setup()
+{
+    last_update = getCurrentSimTime(ps_tc);
+}
+
+void
+FlowNetwork::finish()
+{
+    // Every flow not yet delivered, finished or not, is in in_order
+    for ( auto& x : in_order ) {
+        for ( size_t i = 0; i < x.second.size(); i++ ) {
+            delete x.second[i]->ev;
+            delete x.second[i];
+        }
+    }
+    in_order.clear();
+    flows.clear();
+}
+
+void
+FlowNetwork::handle_input(Event* ev, int port)
+{
+    SimTime_t now = getCurrentSimTime(ps_tc);
+    advance(now);
+    addFlow(static_cast<FlowEvent*>(ev), port);
+    computeRates();
+    scheduleCompletion(now);
+}
+
+void
+FlowNetwork::handle_timer(Event* ev)
+{
+    // Only the most recently scheduled timer is current
+    uint64_t generation = static_cast<FlowEvent*>(ev)->bits;
+    delete ev;
+    if ( generation != timer_generation ) return;
+
+    SimTime_t now = getCurrentSimTime(ps_tc);
+    advance(now);
+
+    // Finish every flow that has finished (or would within the next
+    // picosecond).  flows is compacted in place so it keeps the order
+    // the flows were added in.
+    std::vector<FlowKey> finished;
+    size_t kept = 0;
+    for ( size_t i = 0; i < flows.size(); i++ ) {
+        Flow* flow = flows[i];
+        if ( flow->remaining > flow->rate * 1e-12 ) {
+            flows[kept++] = flow;
+            continue;
+        }
+
+        FlowEvent* done = new FlowEvent(FlowEvent::DONE);
+        done->int_value = flow->vn;
+        done->bits = flow->ev->request->size_in_bits;
+        ports[flow->src]->send(done);
+
+        stat_flows->addData(1);
+        stat_flow_time->addData((now - flow->ev->injection_time * 1000) / 1000);
+
+        releaseLinks(flow);
+        flow->finished = true;
+        FlowKey key = { flow->src, flow->dest, flow->vn };
+        finished.push_back(key);
+    }
+    flows.resize(kept);
+
+    for ( size_t i = 0; i < finished.size(); i++ ) {
+        deliverInOrder(finished[i]);
+    }
+
+    computeRates();
+    scheduleCompletion(now);
+}
+
+void
+FlowNetwork::advance(SimTime_t now)
+{
+    double elapsed = (now - last_update) * 1e-12;
+    last_update = now;
+    if ( elapsed == 0 ) return;
+    for ( size_t i = 0; i < flows.size(); i++ ) {
+        flows[i]->remaining -= flows[i]->rate * elapsed;
+    }
+}
+
+void
+FlowNetwork::addFlow(FlowEvent* ev, int src)
+{
+    Flow* flow = new Flow();
+    flow->ev = ev;
+    flow->src = src;
+    flow->dest = ev->request->dest;
+    flow->vn = ev->request->vn;
+    flow->finished = false;
+    flow->remaining = ev->request->size_in_bits;
+    flow->rate = 0;
+    flow->links.push_back(src);
+    flow->hops = topo->getPath(src, flow->dest, flow->links);
+    flow->links.push_back(num_endpoints + flow->dest);
+
+    for ( size_t i = 0; i < flow->links.size(); i++ ) {
+        int link = flow->links[i];
+        if ( link_flows[link].empty() ) {
+            busy_index[link] = busy_links.size();
+            busy_links.push_back(link);
+        }
+        link_flows[link].push_back(flow);
+    }
+    flows.push_back(flow);
+
+    FlowKey key = { src, flow->dest, flow->vn };
+    in_order[key].push_back(flow);
+}
+
+// Sends the finished flows at the head of the key's queue to their
+// destination.  A flow that finished ahead of an earlier one on the
+// same key is held until the earlier one is delivered.
+void
+FlowNetwork::deliverInOrder(const FlowKey& key)
+{
+    std::map<FlowKey, std::deque<Flow*> >::iterator it = in_order.find(key);
+    // Already delivered along with an earlier flow on the key
+    if ( it == in_order.end() ) return;
+
+    std::deque<Flow*>& pending = it->second;
+    while ( !pending.empty() && pending.front()->finished ) {
+        Flow* flow = pending.front();
+        pending.pop_front();
+        ports[flow->dest]->send(flow->hops * hop_latency, flow->ev);
+        delete flow;
+    }
+    if ( pending.empty() ) in_order.erase(it);
+}
+
+void
+FlowNetwork::releaseLinks(Flow* flow)
+{
+    for ( size_t i = 0; i < flow->links.size(); i++ ) {
+        int link = flow->links[i];
+        std::vector<Flow*>& on_link = link_flows[link];
+        on_link.erase(std::find(on_link.begin(), on_link.end(), flow));
+        if ( on_link.empty() ) {
+            int last = busy_links.back();
+            busy_links[busy_index[link]] = last;
+            busy_index[last] = busy_index[link];
+            busy_links.pop_back();
+            busy_index[link] = -1;
+        }
+    }
+}
+
+// Max-min fair rates by progressive filling: repeatedly find the link
+// that gives the smallest equal share to its unfixed flows and fix
+// those flows at that share.
+void
+FlowNetwork::computeRates()
+{
+    stat_rate_updates->addData(1);
+    stat_active_flows->addData(flows.size());
+    if ( flows.empty() ) return;
+
+    std::vector<double> residual(busy_links.size());
+    std::vector<int> unfixed(busy_links.size());
+    for ( size_t i = 0; i < busy_links.size(); i++ ) {
+        residual[i] = link_capacity[busy_links[i]];
+        unfixed[i] = link_flows[busy_links[i]].size();
+    }
+    for ( size_t i = 0; i < flows.size(); i++ ) flows[i]->fixed = false;
+
+    size_t remaining_flows = flows.size();
+    while ( remaining_flows > 0 ) {
+        int bottleneck = -1;
+        double share = 0;
+        for ( size_t i = 0; i < busy_links.size(); i++ ) {
+            if ( unfixed[i] == 0 ) continue;
+            double s = residual[i] / unfixed[i];
+            if ( bottleneck == -1 || s < share ) {
+                bottleneck = i;
+                share = s;
+            }
+        }
+
+        std::vector<Flow*>& on_link = link_flows[busy_links[bottleneck]];
+        for ( size_t f = 0; f < on_link.size(); f++ ) {
+            Flow* flow = on_link[f];
+            if ( flow->fixed ) continue;
+            flow->fixed = true;
+            flow->rate = share;
+            remaining_flows--;
+            for ( size_t l = 0; l < flow->links.size(); l++ ) {
+                int i = busy_index[flow->links[l]];
+                residual[i] -= share;
+                unfixed[i]--;
+            }
+        }
+    }
+}
+
+void
+FlowNetwork::scheduleCompletion(SimTime_t now)
+{
+    double first = -1;
+    for ( size_t i = 0; i < flows.size(); i++ ) {
+        if ( flows[i]->rate <= 0 ) continue;
+        double t = flows[i]->remaining > 0 ? flows[i]->remaining / flows[i]->rate : 0;
+        if ( first < 0 || t < first ) first = t;
+    }
+    if ( first < 0 ) return;
+    SimTime_t delay = (SimTime_t)ceil(first * 1e12);
+
+    // The timer carries its generation in bits
+    FlowEvent* timer = new FlowEvent(FlowEvent::DONE);
+    timer->bits = ++timer_generation;
+    completion_timer->send(delay, timer);
+}
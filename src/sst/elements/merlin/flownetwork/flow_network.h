@@ -0,0 +1,230 @@
+// -*- mode: c++ -*-
+
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#ifndef COMPONENTS_MERLIN_FLOWNETWORK_FLOW_NETWORK_H
+#define COMPONENTS_MERLIN_FLOWNETWORK_FLOW_NETWORK_H
+
+#include <sst/core/component.h>
+#include <sst/core/elementinfo.h>
+#include <sst/core/event.h>
+#include <sst/core/link.h>
+#include <sst/core/timeConverter.h>
+#include <sst/core/interfaces/simpleNetwork.h>
+
+#include <deque>
+#include <map>
+#include <vector>
+
+using namespace SST;
+
+namespace SST {
+namespace Merlin {
+
+// Event between flow_network and flow_linkcontrol
+class FlowEvent : public Event {
+
+public:
+    enum FlowEventType {REPORT_BW, REPORT_ID, DATA, DONE};
+
+    FlowEventType type;
+    SST::Interfaces::SimpleNetwork::Request* request;
+    int int_value;          // REPORT_ID: endpoint id, DONE: vn
+    uint64_t bits;          // DONE: bits whose output buffer space is returned
+    double bw;              // REPORT_BW: link bandwidth in bits/s
+    SimTime_t injection_time;
+
+    FlowEvent() :
+        Event(),
+        request(NULL),
+        int_value(0),
+        bits(0),
+        bw(0),
+        injection_time(0)
+    {}
+
+    FlowEvent(FlowEventType type) :
+        Event(),
+        type(type),
+        request(NULL),
+        int_value(0),
+        bits(0),
+        bw(0),
+        injection_time(0)
+    {}
+
+    ~FlowEvent()
+    {
+        if ( request != NULL ) delete request;
+    }
+
+    void serialize_order(SST::Core::Serialization::serializer &ser)  override {
+        Event::serialize_order(ser);
+        ser & type;
+        ser & request;
+        ser & int_value;
+        ser & bits;
+        ser & bw;
+        ser & injection_time;
+    }
+
+private:
+    ImplementSerializable(SST::Merlin::FlowEvent)
+};
+
+
+// Path model for one of the merlin topologies.  Links are numbered
+// densely: [0,E) are the endpoint injection links, [E,2E) the ejection
+// links and the rest are between routers.  Parallel links between the
+// same pair of routers (or, for fattree, between a subtree and the
+// level above it) are modeled as one link with their combined
+// bandwidth.
+class FlowTopology {
+public:
+    virtual ~FlowTopology() {}
+
+    virtual int getNumEndpoints() const = 0;
+    virtual int getNumLinks() const = 0;
+    // Bandwidth of a router to router link as a multiple of link_bw
+    virtual double getLinkWidth(int link) const = 0;
+    // Appends the router to router links from src to dest to links and
+    // returns the number of routers on the path
+    virtual int getPath(int src, int dest, std::vector<int>& links) const = 0;
+};
+
+
+class FlowNetwork : public Component {
+
+public:
+
+    SST_ELI_REGISTER_COMPONENT(
+        FlowNetwork,
+        "merlin",
+        "flow_network",
+        SST_ELI_ELEMENT_VERSION(1,0,0),
+        "Flow-level model of a whole merlin network.  Messages are flows over the minimal route of the "
+        "topology sharing link bandwidth max-min fairly, plus a fixed latency per router.  Endpoints "
+        "connect with merlin.flow_linkcontrol in place of merlin.linkcontrol.  Messages with the same source, "
+        "destination and vn are delivered in the order they were sent.",
+        COMPONENT_CATEGORY_NETWORK)
+
+    SST_ELI_DOCUMENT_PARAMS(
+        {"topology",                    "Topology to model [merlin.torus | merlin.hyperx | merlin.fattree | merlin.dragonfly2]."},
+        {"link_bw",                     "Bandwidth of the links specified in either b/s or B/s (can include SI prefix)."},
+        {"hop_latency",                 "Latency added for each router on a message's path.", "20ns"},
+        {"torus:shape",                 "Shape of the torus, for example 4x4x2."},
+        {"torus:width",                 "Number of links between routers in each dimension, for example 2x2x1."},
+        {"torus:local_ports",           "Number of endpoints attached to each torus router.", "1"},
+        {"hyperx:shape",                "Shape of the hyperx, for example 4x4x2."},
+        {"hyperx:width",                "Number of links between routers in each dimension, for example 2x2x1."},
+        {"hyperx:local_ports",          "Number of endpoints attached to each hyperx router.", "1"},
+        {"fattree:shape",               "Shape of the fattree, as for merlin.fattree."},
+        {"dragonfly:hosts_per_router",  "Number of hosts connected to each router."},
+        {"dragonfly:routers_per_group", "Number of routers in each group."},
+        {"dragonfly:intergroup_links",  "Number of links between each pair of groups."},
+        {"dragonfly:num_groups",        "Number of groups in network."},
+        {"dragonfly:intergroup_per_router", "Number of global links per router, needed with dragonfly:global_link_map."},
+        {"dragonfly:global_link_map",   "Array specifying connectivity of global links in each dragonfly group.  Defaults to the linear map built by pymerlin.", ""},
+        {"dragonfly:global_route_mode", "Mode for intepreting global link map [absolute (default) | relative].", "absolute"}
+    )
+
+    SST_ELI_DOCUMENT_STATISTICS(
+        { "flows",              "Number of messages carried", "messages", 1},
+        { "flow_time",          "Time from injection until the last bit left the network, not counting hop latency", "ns", 1},
+        { "rate_updates",       "Number of times flow rates were recomputed", "updates", 1},
+        { "active_flows",       "Number of flows sharing the network, sampled at each rate update", "flows", 2}
+    )
+
+    SST_ELI_DOCUMENT_PORTS(
+        {"port%(num_endpoints)d", "Links to the endpoints, numbered by endpoint id.", { "merlin.FlowEvent" } }
+    )
+
+    FlowNetwork(ComponentId_t cid, Params& params);
+    ~FlowNetwork();
+
+    void init(unsigned int phase);
+    void setup();
+    void finish();
+
+private:
+    struct Flow {
+        FlowEvent* ev;
+        int src;
+        int dest;
+        int vn;
+        int hops;
+        double remaining;           // bits
+        double rate;                // bits/s
+        std::vector<int> links;
+        bool fixed;
+        bool finished;              // Done but waiting on earlier flows with the same key
+    };
+
+    // Messages with the same source, destination and vn are delivered
+    // in the order they were sent, as merlin.linkcontrol does with
+    // deterministic routing
+    struct FlowKey {
+        int src;
+        int dest;
+        int vn;
+        bool operator<(const FlowKey& other) const {
+            if ( src != other.src ) return src < other.src;
+            if ( dest != other.dest ) return dest < other.dest;
+            return vn < other.vn;
+        }
+    };
+
+    FlowTopology* topo;
+    int num_endpoints;
+    std::vector<Link*> ports;
+    Link* completion_timer;
+    TimeConverter* ps_tc;
+
+    double link_bw;                 // bits/s
+    SimTime_t hop_latency;          // ps
+    std::vector<double> link_capacity;
+    std::vector<std::vector<Flow*> > link_flows;
+    std::vector<int> busy_links;    // Links with at least one flow
+    std::vector<int> busy_index;    // Position of each link in busy_links, or -1
+    std::vector<Flow*> flows;       // Unfinished flows in the order they were added
+    std::map<FlowKey, std::deque<Flow*> > in_order;   // Undelivered flows for each key
+
+    SimTime_t last_update;          // ps
+    uint64_t timer_generation;
+
+    Statistic<uint64_t>* stat_flows;
+    Statistic<uint64_t>* stat_flow_time;
+    Statistic<uint64_t>* stat_rate_updates;
+    Statistic<uint64_t>* stat_active_flows;
+
+    Output& output;
+
+    void handle_input(Event* ev, int port);
+    void handle_timer(Event* ev);
+
+    void advance(SimTime_t now);
+    void computeRates();
+    void scheduleCompletion(SimTime_t now);
+    void addFlow(FlowEvent* ev, int src);
+    void releaseLinks(Flow* flow);
+    void deliverInOrder(const FlowKey& key);
+};
+
+}
+}
+
+#endif // COMPONENTS_MERLIN_FLOWNETWORK_FLOW_NETWORK_H
@@ -123,6 +123,11 @@ hr_router::hr_router(ComponentId_t cid, Params& params) :
     Router(cid),
     num_vcs(-1),
     vcs_initialized(false),
+    clocked_cycles(0),
+    skipped_cycles(0),
+    report_pool_hit_rate(false),
+    pool_hits_start(0),
+    pool_misses_start(0),
     output(Simulation::getSimulation()->getSimulationOutput())
 {
     // Get the options for the router
@@ -204,6 +209,7 @@ hr_router::hr_router(ComponentId_t cid, Params& params) :
 
     // Create all the PortControl blocks
     ports = new PortControl*[num_ports];
+    active_ports.resize(num_ports);
 
     std::string input_buf_size = params.find<std::string>("input_buf_size", "0");
     std::string output_buf_size = params.find<std::string>("output_buf_size", "0");
@@ -219,6 +225,7 @@ hr_router::hr_router(ComponentId_t cid, Params& params) :
 
     std::string inspector_config = params.find<std::string>("network_inspectors", "");
     split(inspector_config,",",inspector_names);
+    Params inspector_params = params.find_prefix_params("network_inspector:");
 
     bool oql_track_port = params.find<bool>("oql_track_port","false");
     bool oql_track_remote = params.find<bool>("oql_track_remote","false");
@@ -247,7 +254,7 @@ hr_router::hr_router(ComponentId_t cid, Params& params) :
                                    1, getLogicalGroupParam(params,topo,i,"output_latency","0ns"),
                                    getLogicalGroupParam(params,topo,i,"input_buf_size"),
                                    getLogicalGroupParam(params,topo,i,"output_buf_size"),
-                                   inspector_names,
+                                   inspector_names, inspector_params,
 								   std::stof(getLogicalGroupParam(params,topo,i,"dlink_thresh", "-1")),
                                    oql_track_port,oql_track_remote);
         
@@ -257,6 +264,7 @@ hr_router::hr_router(ComponentId_t cid, Params& params) :
     // Get the Xbar arbitration
     Params empty_params; // Empty params sent to subcomponents
     arb = static_cast<XbarArbitration*>(loadSubComponent(xbar_arb, this, empty_params));
+    arb->setActivePorts(&active_ports);
     
     // if ( params.find_integer("debug", 0) ) {
     //     if ( num_routers == 0 ) {
@@ -290,6 +298,10 @@ hr_router::hr_router(ComponentId_t cid, Params& params) :
         port_name = port_name + std::to_string(i);
         xbar_stalls[i] = registerStatistic<uint64_t>("xbar_stalls",port_name);
     }
+    stat_cycles_clocked = registerStatistic<uint64_t>("cycles_clocked");
+    stat_cycles_skipped = registerStatistic<uint64_t>("cycles_skipped");
+    stat_skipped_fraction = registerStatistic<double>("skipped_cycle_fraction");
+    stat_pool_hit_rate = registerStatistic<double>("event_pool_hit_rate");
 }
 
 
@@ -306,6 +318,8 @@ hr_router::notifyEvent()
 #endif
 
     int64_t elapsed_cycles = next_cycle - unclocked_cycle;
+    // The handler ran on unclocked_cycle
+    skipped_cycles += elapsed_cycles - 1;
 
 
 #if !VERIFY_DECLOCKING
@@ -370,10 +384,12 @@ hr_router::printStatus(Output& out)
 bool
 hr_router::clock_handler(Cycle_t cycle)
 {
+    clocked_cycles++;
+    
     // If there are no events in the input queues, then we can remove
     // ourselves from the clock queue, as long as the arbitration unit
     // says it's okay.
-    if ( get_vcs_with_data() == 0 ) {
+    if ( active_ports.empty() ) {
 #if VERIFY_DECLOCKING
         if ( clocking ) {
             if ( arb->isOkayToPauseClock() ) {
@@ -395,14 +411,12 @@ hr_router::clock_handler(Cycle_t cycle)
 #endif
     }
     // Loop through all the events at the heads of the queues and call
-    // route
-    int index = 0;
-    for ( int i = 0; i < num_ports; i++ ) {
-        for ( int j = 0; j < num_vcs; j++ ) {
-            if ( vc_heads[index] != NULL ) {
-                topo->reroute(i,j,vc_heads[index]);
-            }
-            index++;
+    // route.  Only ports and VCs with data need to be looked at.
+    for ( int i = active_ports.next(0); i != -1; i = active_ports.next(i+1) ) {
+        const ActiveMask& active_vcs = ports[i]->getActiveVCs();
+        internal_router_event** heads = &vc_heads[i*num_vcs];
+        for ( int j = active_vcs.next(0); j != -1; j = active_vcs.next(j+1) ) {
+            topo->reroute(i,j,heads[j]);
         }
     }
     
@@ -413,8 +427,9 @@ hr_router::clock_handler(Cycle_t cycle)
     arb->arbitrate(ports,in_port_busy,out_port_busy,progress_vcs);
 #endif
     
-    // Move the events and decrement the busy values
-    for ( int i = 0; i < num_ports; i++ ) {
+    // Move the events.  Arbiters only set progress_vcs for ports
+    // with data, so reset each entry once it has been used.
+    for ( int i = active_ports.next(0); i != -1; i = active_ports.next(i+1) ) {
         // if ( progress_vcs[i] != -1 ) {
         if ( progress_vcs[i] > -1 ) {
             internal_router_event* ev = ports[i]->recv(progress_vcs[i]);
@@ -451,7 +466,11 @@ hr_router::clock_handler(Cycle_t cycle)
         else if ( progress_vcs[i] == -2 ) {
                 xbar_stalls[i]->addData(1);
         }
+        progress_vcs[i] = -1;
+    }
 
+    // Decrement the busy values
+    for ( int i = 0; i < num_ports; i++ ) {
         // Should stop at zero, need to find a clean way to do this
         // with no branch.  For now it should work.
         if ( in_port_busy[i] != 0 ) in_port_busy[i]--;
@@ -466,6 +485,14 @@ void hr_router::setup()
     for ( int i = 0; i < num_ports; i++ ) {
     	ports[i]->setup();
     }
+    // Topologies may build routing tables now that init data is complete
+    topo->setup();
+
+    // The pool is per thread, so only the first router on the thread
+    // to get here records its hit rate
+    report_pool_hit_rate = EventPool::claimReporter();
+    pool_hits_start = EventPool::getHits();
+    pool_misses_start = EventPool::getMisses();
 }
 
 void hr_router::finish()
@@ -473,7 +500,22 @@ void hr_router::finish()
     for ( int i = 0; i < num_ports; i++ ) {
     	ports[i]->finish();
     }
-    
+
+    if ( getRequestNotifyOnEvent() ) {
+        // Clock is still off
+        skipped_cycles += getCurrentSimTime(xbar_tc) - unclocked_cycle;
+    }
+    stat_cycles_clocked->addData(clocked_cycles);
+    stat_cycles_skipped->addData(skipped_cycles);
+    uint64_t total_cycles = clocked_cycles + skipped_cycles;
+    if ( total_cycles != 0 ) stat_skipped_fraction->addData((double)skipped_cycles / total_cycles);
+
+    if ( report_pool_hit_rate ) {
+        uint64_t pool_hits = EventPool::getHits() - pool_hits_start;
+        uint64_t pool_allocs = pool_hits + EventPool::getMisses() - pool_misses_start;
+        if ( pool_allocs != 0 ) stat_pool_hit_rate->addData((double)pool_hits / pool_allocs);
+    }
+
 }
 
 void
@@ -64,6 +64,7 @@ public:
         {"input_buf_size",     "Size of input buffers specified in b or B (can include SI prefix)."},
         {"output_buf_size",    "Size of output buffers specified in b or B (can include SI prefix)."},
         {"network_inspectors", "Comma separated list of network inspectors to put on output ports.", ""},
+        {"network_inspector:*", "Parameters passed to the network inspectors, with the prefix removed.", ""},
         {"oql_track_port",     "Set to true to track output queue length for an entire port.  False tracks per VC.", "false"},
         {"oql_track_remote",   "Set to true to track output queue length including remote input queue.  False tracks only local queue.", "false"},
         {"debug",              "Turn on debugging for router. Set to 1 for on, 0 for off.", "0"}
@@ -75,7 +76,11 @@ public:
         { "output_port_stalls", "Time output port is stalled (in units of core timebase)", "time in stalls", 1},
         { "xbar_stalls",        "Count number of cycles the xbar is stalled", "cycles", 1},
         { "idle_time",          "Amount of time spent idle for a given port", "units of core timebase", 1},
-        { "width_adj_count",    "Number of times that link width was increased or decreased", "width adjustment count", 1}
+        { "width_adj_count",    "Number of times that link width was increased or decreased", "width adjustment count", 1},
+        { "cycles_clocked",     "Number of crossbar cycles the router clock handler ran", "cycles", 1},
+        { "cycles_skipped",     "Number of crossbar cycles skipped because the router had no data and its clock was off", "cycles", 1},
+        { "skipped_cycle_fraction", "Fraction of crossbar cycles skipped", "ratio", 1},
+        { "event_pool_hit_rate", "Fraction of router event allocations between setup and finish served from the event pool.  The pool is shared by all routers on a thread, so only the first router on each thread to run setup records it, for all of them.", "ratio", 1}
     )
 
     SST_ELI_DOCUMENT_PORTS(
@@ -126,6 +131,20 @@ private:
     void init_vcs();
     Statistic<uint64_t>** xbar_stalls;
 
+    // Clock activity, recorded at finish
+    uint64_t clocked_cycles;
+    uint64_t skipped_cycles;
+    Statistic<uint64_t>* stat_cycles_clocked;
+    Statistic<uint64_t>* stat_cycles_skipped;
+    Statistic<double>* stat_skipped_fraction;
+
+    // Event pool counters at setup, recorded as a hit rate at finish
+    // by the router that reports for its thread
+    bool report_pool_hit_rate;
+    uint64_t pool_hits_start;
+    uint64_t pool_misses_start;
+    Statistic<double>* stat_pool_hit_rate;
+
     Output& output;
     
 public:
@@ -162,31 +162,25 @@ public:
                    )
     {
 
-        for ( int i = 0; i < num_ports; i++ ) progress_vc[i] = -1;
-
-
         // Find all ports that have data and who's inputs to the xbar
         // aren't busy.  Sort them by prioritizing on injection time.
-        // Oldest gets top priority.
-        int index = 0;
-        for ( int i = 0; i < num_ports; i++ ) {
+        // Oldest gets top priority.  Only ports with data are looked
+        // at.
+        for ( int i = active_ports->next(0); i != -1; i = active_ports->next(i+1) ) {
             if ( in_port_busy[i] > 0 ) {
-                index += num_vcs;
                 continue; // No need to consider port if input to xbar is busy
             }
 
             vc_heads = ports[i]->getVCHeads();
-            for ( int j = 0; j < num_vcs; j++ ) {
-                internal_router_event* src_event = vc_heads[j];
-                if ( src_event != NULL ) {
-                    entries[index].next_port = vc_heads[j]->getNextPort();
-                    entries[index].next_vc = vc_heads[j]->getVC();
-                    entries[index].injection_time = vc_heads[j]->getEncapsulatedEvent()->getInjectionTime();
-                    entries[index].size_in_flits = vc_heads[j]->getFlitCount();
-
-                    age_queue.push(&entries[index]);
-                }
-                index++;
+            const ActiveMask& active_vcs = ports[i]->getActiveVCs();
+            int index = i * num_vcs;
+            for ( int j = active_vcs.next(0); j != -1; j = active_vcs.next(j+1) ) {
+                entries[index+j].next_port = vc_heads[j]->getNextPort();
+                entries[index+j].next_vc = vc_heads[j]->getVC();
+                entries[index+j].injection_time = vc_heads[j]->getEncapsulatedEvent()->getInjectionTime();
+                entries[index+j].size_in_flits = vc_heads[j]->getFlitCount();
+
+                age_queue.push(&entries[index+j]);
             }
             
         }
@@ -0,0 +1,252 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+
+#ifndef COMPONENTS_HR_ROUTER_XBAR_ARB_BITMASK_H
+#define COMPONENTS_HR_ROUTER_XBAR_ARB_BITMASK_H
+
+#include <sst/core/component.h>
+#include <sst/core/elementinfo.h>
+#include <sst/core/event.h>
+#include <sst/core/link.h>
+#include <sst/core/timeConverter.h>
+
+#include <vector>
+
+#include "sst/elements/merlin/router.h"
+#include "sst/elements/merlin/portControl.h"
+
+using namespace SST;
+
+namespace SST {
+namespace Merlin {
+
+// Bitmask assisted round robin arbitration.  This is the same
+// sequential greedy allocation as xbar_arb_rr, not a separable
+// input/output allocator: inputs are visited one at a time in round
+// robin order and each claims the first VC (again in round robin
+// order) whose head is going to a free output with enough credits.
+// Grants are identical to xbar_arb_rr (tests/xbar_arb_check.py).
+//
+// The ready input and free output masks are rebuilt with a scan of
+// the ports every cycle; the savings come from skipping idle and busy
+// inputs with find-first-set and rejecting VCs whose output is already
+// taken with a single bit test, which matters for high radix routers
+// where most inputs have nothing to send in a given cycle.
+class xbar_arb_bitmask : public XbarArbitration {
+
+public:
+
+    SST_ELI_REGISTER_SUBCOMPONENT(
+        xbar_arb_bitmask,
+        "merlin",
+        "xbar_arb_bitmask",
+        SST_ELI_ELEMENT_VERSION(1,0,0),
+        "Round robin arbitration unit for hr_router that skips idle ports with bitmasks.  Grants match xbar_arb_rr",
+        "SST::Merlin::XbarArbitration")
+
+
+private:
+    int num_ports;
+    int num_vcs;
+    int num_words;
+
+    int rr_port;
+
+#if VERIFY_DECLOCKING
+    int rr_port_shadow;
+#endif
+
+    // Number of arbitration cycles so far, and the number of those
+    // each input was busy for.  An input's round robin VC advances on
+    // every cycle it is not busy, so it is the difference of the two.
+    uint64_t arb_count;
+    uint64_t* busy_cycles;
+
+    // Per cycle masks, bit set if the port can be used
+    std::vector<uint64_t> in_ready;
+    std::vector<uint64_t> out_free;
+
+    // Builds a mask of the entries of busy that are zero
+    inline void buildFreeMask(const int* busy, std::vector<uint64_t>& mask) {
+        for ( int w = 0; w < num_words; w++ ) {
+            int base = w << 6;
+            int end = num_ports - base < 64 ? num_ports - base : 64;
+            uint64_t word = 0;
+            for ( int b = 0; b < end; b++ ) {
+                word |= (uint64_t)(busy[base + b] == 0) << b;
+            }
+            mask[w] = word;
+        }
+    }
+
+    // Returns the first set bit at or after i, or -1 if there is none
+    inline int nextSet(const std::vector<uint64_t>& mask, int i) const {
+        if ( i >= num_ports ) return -1;
+        int w = i >> 6;
+        uint64_t word = mask[w] & (~(uint64_t)0 << (i & 63));
+        while ( word == 0 ) {
+            if ( ++w == num_words ) return -1;
+            word = mask[w];
+        }
+        return (w << 6) + __builtin_ctzll(word);
+    }
+
+    inline bool testBit(const std::vector<uint64_t>& mask, int i) const {
+        return mask[i >> 6] & ((uint64_t)1 << (i & 63));
+    }
+
+    inline void clearBit(std::vector<uint64_t>& mask, int i) {
+        mask[i >> 6] &= ~((uint64_t)1 << (i & 63));
+    }
+
+    // Returns true if the event at the head of vc could be progressed
+    inline bool progressVC(PortControl** ports, int port, int vc, internal_router_event** vc_heads,
+                           int* in_port_busy, int* out_port_busy, int* progress_vc) {
+        internal_router_event* src_event = vc_heads[vc];
+        int next_port = src_event->getNextPort();
+
+        if ( !testBit(out_free, next_port) ) return false;
+        if ( !ports[next_port]->spaceToSend(src_event->getVC(), src_event->getFlitCount()) ) return false;
+
+        progress_vc[port] = vc;
+        in_port_busy[port] = src_event->getFlitCount();
+        out_port_busy[next_port] = src_event->getFlitCount();
+        clearBit(out_free, next_port);
+        return true;
+    }
+
+    inline void arbitratePort(PortControl** ports, int port, int* in_port_busy, int* out_port_busy, int* progress_vc) {
+        internal_router_event** vc_heads = ports[port]->getVCHeads();
+        const ActiveMask& active_vcs = ports[port]->getActiveVCs();
+        int start = (arb_count - busy_cycles[port]) % num_vcs;
+
+        for ( int pass = 0; pass < 2; pass++ ) {
+            int end = pass == 0 ? num_vcs : start;
+            for ( int vc = active_vcs.next(pass == 0 ? start : 0); vc != -1 && vc < end; vc = active_vcs.next(vc+1) ) {
+                if ( progressVC(ports, port, vc, vc_heads, in_port_busy, out_port_busy, progress_vc) ) return;
+            }
+        }
+    }
+
+    inline bool anyOutputFree() const {
+        for ( int w = 0; w < num_words; w++ ) {
+            if ( out_free[w] ) return true;
+        }
+        return false;
+    }
+
+public:
+    xbar_arb_bitmask(Component* parent, Params& params) :
+        XbarArbitration(parent),
+        arb_count(0),
+        busy_cycles(NULL)
+    {
+    }
+
+    ~xbar_arb_bitmask() {
+        if ( busy_cycles != NULL ) delete [] busy_cycles;
+    }
+
+    void setPorts(int num_ports_s, int num_vcs_s) {
+        num_ports = num_ports_s;
+        num_vcs = num_vcs_s;
+        num_words = (num_ports + 63) / 64;
+
+        busy_cycles = new uint64_t[num_ports];
+        for ( int i = 0; i < num_ports; i++ ) busy_cycles[i] = 0;
+        in_ready.resize(num_words);
+        out_free.resize(num_words);
+
+        rr_port = 0;
+#if VERIFY_DECLOCKING
+        rr_port_shadow = 0;
+#endif
+    }
+
+    // Naming convention is from point of view of the xbar.  So,
+    // in_port_busy is >0 if someone is writing to that xbar port and
+    // out_port_busy is >0 if that xbar port being read.
+    void arbitrate(
+#if VERIFY_DECLOCKING
+                   PortControl** ports, int* in_port_busy, int* out_port_busy, int* progress_vc, bool clocking
+#else
+                   PortControl** ports, int* in_port_busy, int* out_port_busy, int* progress_vc
+#endif
+                   )
+    {
+        buildFreeMask(in_port_busy, in_ready);
+        buildFreeMask(out_port_busy, out_free);
+
+        // Count the cycle for busy inputs, then keep only the free
+        // inputs that have data
+        for ( int w = 0; w < num_words; w++ ) {
+            uint64_t busy = ~in_ready[w];
+            if ( w == num_words - 1 && (num_ports & 63) ) busy &= ((uint64_t)1 << (num_ports & 63)) - 1;
+            while ( busy ) {
+                busy_cycles[(w << 6) + __builtin_ctzll(busy)]++;
+                busy &= busy - 1;
+            }
+            in_ready[w] &= active_ports->getWord(w);
+        }
+
+        if ( anyOutputFree() ) {
+            // Give inputs first pick in round robin order starting at
+            // rr_port
+            for ( int pass = 0; pass < 2; pass++ ) {
+                int end = pass == 0 ? num_ports : rr_port;
+                for ( int port = nextSet(in_ready, pass == 0 ? rr_port : 0); port != -1 && port < end; port = nextSet(in_ready, port+1) ) {
+                    arbitratePort(ports, port, in_port_busy, out_port_busy, progress_vc);
+                }
+            }
+        }
+
+        arb_count++;
+        rr_port = (rr_port + 1) % num_ports;
+
+#if VERIFY_DECLOCKING
+        if ( clocking ) {
+            rr_port_shadow = rr_port;
+        }
+#endif
+
+        return;
+    }
+
+    void reportSkippedCycles(Cycle_t cycles) {
+#if VERIFY_DECLOCKING
+        rr_port_shadow = (rr_port_shadow + cycles) % num_ports;
+        if ( rr_port_shadow != rr_port ) std::cout << "  PROBLEM:  rr_port = "
+                         << rr_port << ", rr_port_shadow = " << rr_port_shadow <<
+                         ", cycles = " << cycles << std::endl;
+#else
+        rr_port = (rr_port + cycles) % num_ports;
+#endif
+    }
+
+    void dumpState(std::ostream& stream) {
+        stream << "Current round robin port: " << rr_port << std::endl;
+        stream << "  Current round robin VC by port:" << std::endl;
+        for ( int i = 0; i < num_ports; i++ ) {
+            stream << i << ": " << (arb_count - busy_cycles[i]) % num_vcs << std::endl;
+        }
+    }
+
+};
+
+}
+}
+
+#endif // COMPONENTS_HR_ROUTER_XBAR_ARB_BITMASK_H
@@ -106,7 +106,6 @@ public:
                    )
     {
         
-        for ( int i = 0; i < num_ports; i++ ) progress_vc[i] = -1;
 
         // std::cout << "---------" << std::endl;
         // for ( int i = 0; i < total_entries; i++ ) {
@@ -134,6 +133,13 @@ public:
 
             // std::cout << check.first << ", " << check.second << std::endl;
             
+            // Ports without data keep their place in the list
+            if ( !active_ports->test(port) ) {
+                *unsat_list = check;
+                ++unsat_list;
+                continue;
+            }
+
             vc_heads = ports[port]->getVCHeads();
 	    
             // if the output of this port is busy or if there is no
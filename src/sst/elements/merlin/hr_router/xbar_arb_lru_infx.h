@@ -107,7 +107,6 @@ public:
     {
         // TraceFunction trace(CALL_INFO_LONG);
         
-        for ( int i = 0; i < num_ports; i++ ) progress_vc[i] = -1;
         
 
         priority_entry_t* sat_list = &next_list[total_entries-1];
@@ -124,6 +123,13 @@ public:
 
             // std::cout << check.first << ", " << check.second << std::endl;
             
+            // Ports without data keep their place in the list
+            if ( !active_ports->test(port) ) {
+                *unsat_list = check;
+                ++unsat_list;
+                continue;
+            }
+
             vc_heads = ports[port]->getVCHeads();
             
             internal_router_event* src_event = vc_heads[vc];
@@ -59,17 +59,109 @@ private:
     
     internal_router_event** vc_heads;
 
+    // Ports without data whose rr_vcs pointer is not advanced every
+    // cycle.  An idle port's pointer moves once per arbitration cycle
+    // that its xbar input is not busy, so ports are watched until they
+    // are idle and not busy, then marked quiet.
+    ActiveMask watch;
+    bool* quiet;
+    uint64_t* quiet_since;
+    uint64_t arb_count;
+
     // PortControl** ports;
+
+    inline int nextPort(int port) {
+        int a = active_ports->next(port);
+        int w = watch.next(port);
+        if ( a == -1 ) return w;
+        if ( w == -1 ) return a;
+        return a < w ? a : w;
+    }
+
+    // Returns true if the event could be progressed
+    inline bool progressVC(PortControl** ports, int port, int vc, int* in_port_busy, int* out_port_busy, int* progress_vc) {
+        internal_router_event* src_event = vc_heads[vc];
+        
+        // Have an event, see if it can be progressed
+        int next_port = src_event->getNextPort();
+		
+        // We can progress if the next port's input is not
+        // busy and there are enough credits.
+        if ( out_port_busy[next_port] > 0 ) return false;
+                
+        // Need to see if the VC has enough credits
+        int next_vc = src_event->getVC();
+
+        // See if there is enough space
+        if ( !ports[next_port]->spaceToSend(next_vc, src_event->getFlitCount()) ) return false;
+		
+        // Tell the router what to move
+        progress_vc[port] = vc;
+		
+        // Need to set the busy values
+        in_port_busy[port] = src_event->getFlitCount();
+        out_port_busy[next_port] = src_event->getFlitCount();
+        return true;
+    }
+
+    inline void arbitratePort(PortControl** ports, int port, int* in_port_busy, int* out_port_busy, int* progress_vc) {
+        if ( quiet[port] ) {
+            // Catch up the cycles the port was skipped
+            rr_vcs[port] = (rr_vcs[port] + (arb_count - 1 - quiet_since[port])) % num_vcs;
+            quiet[port] = false;
+        }
+
+        // Overwrite old data
+        progress_vc[port] = -1;
+        // if the output of this port is busy, nothing to do.
+        if ( in_port_busy[port] > 0 ) {
+            watch.set(port);
+            return;
+        }
+
+        if ( !active_ports->test(port) ) {
+            rr_vcs[port] = (rr_vcs[port] + 1) % num_vcs;
+            watch.clear(port);
+            quiet[port] = true;
+            quiet_since[port] = arb_count;
+            return;
+        }
+        
+        vc_heads = ports[port]->getVCHeads();
+        const ActiveMask& active_vcs = ports[port]->getActiveVCs();
+        int start = rr_vcs[port];
+	    
+        // See what we should progress for this port, only VCs with an
+        // event need to be checked
+        bool found = false;
+        for ( int pass = 0; pass < 2 && !found; pass++ ) {
+            int end = pass == 0 ? num_vcs : start;
+            for ( int vc = active_vcs.next(pass == 0 ? start : 0); vc != -1 && vc < end; vc = active_vcs.next(vc+1) ) {
+                if ( progressVC(ports, port, vc, in_port_busy, out_port_busy, progress_vc) ) {
+                    found = true;
+                    break;  // Go to next port;
+                }
+            }
+        }
+        // Increment rr_vcs for next time 
+        rr_vcs[port] = (rr_vcs[port] + 1) % num_vcs;
+        watch.set(port);
+    }
     
 public:
     xbar_arb_rr(Component* parent, Params& params) :
         XbarArbitration(parent),
-        rr_vcs(NULL)
+        rr_vcs(NULL),
+        quiet(NULL),
+        quiet_since(NULL),
+        arb_count(0)
     {
     }
 
     ~xbar_arb_rr() {
         if ( rr_vcs != NULL ) delete [] rr_vcs;
+        if ( quiet != NULL ) delete [] quiet;
+        if ( quiet_since != NULL ) delete [] quiet_since;
     }
 
     void setPorts(int num_ports_s, int num_vcs_s) {
@@ -77,9 +169,14 @@ public:
         num_vcs = num_vcs_s;
 
         rr_vcs = new int[num_ports];
+        quiet = new bool[num_ports];
+        quiet_since = new uint64_t[num_ports];
         for ( int i = 0; i < num_ports; i++ ) {
             rr_vcs[i] = 0;
+            quiet[i] = true;
+            quiet_since[i] = 0;
         }
+        watch.resize(num_ports);
 	
         rr_port = 0;
 #if VERIFY_DECLOCKING
@@ -99,50 +196,16 @@ public:
 #endif
                    )
     {
-        // Run through each of the ports, giving first pick in a round robin fashion
-        // for ( int port = rr_port, pcount = 0; pcount < num_ports; port = (port+1) % num_ports, pcount++ ) {
-        for ( int port = rr_port, pcount = 0; pcount < num_ports; port = ((port != num_ports-1) ? port+1 : 0), pcount++ ) {
-
-            vc_heads = ports[port]->getVCHeads();
-	    
-            // Overwrite old data
-            progress_vc[port] = -1;
-            // if the output of this port is busy, nothing to do.
-            if ( in_port_busy[port] > 0 ) {
-                continue;
-            }
-	    
-            // See what we should progress for this port
-            // for ( int vc = rr_vcs[port], vcount = 0; vcount < num_vcs; vc = (vc+1) % num_vcs, vcount++ ) {
-            for ( int vc = rr_vcs[port], vcount = 0; vcount < num_vcs; vc = ((vc != num_vcs-1) ? (vc+1) : 0), vcount++ ) {
-		
-                // If there is no event, move to next VC
-                internal_router_event* src_event = vc_heads[vc];
-                if ( src_event == NULL ) continue;
-		
-                // Have an event, see if it can be progressed
-                int next_port = src_event->getNextPort();
-		
-                // We can progress if the next port's input is not
-                // busy and there are enough credits.
-                if ( out_port_busy[next_port] > 0 ) continue;
-                
-                // Need to see if the VC has enough credits
-                int next_vc = src_event->getVC();
-
-                // See if there is enough space
-                if ( !ports[next_port]->spaceToSend(next_vc, src_event->getFlitCount()) ) continue;
-		
-                // Tell the router what to move
-                progress_vc[port] = vc;
-		
-                // Need to set the busy values
-                in_port_busy[port] = src_event->getFlitCount();
-                out_port_busy[next_port] = src_event->getFlitCount();
-                break;  // Go to next port;
+        arb_count++;
+        
+        // Run through each of the ports with data, giving first pick
+        // in a round robin fashion.  Ports without data are skipped,
+        // their rr_vcs pointer is caught up when they get data again.
+        for ( int pass = 0; pass < 2; pass++ ) {
+            int end = pass == 0 ? num_ports : rr_port;
+            for ( int port = nextPort(pass == 0 ? rr_port : 0); port != -1 && port < end; port = nextPort(port+1) ) {
+                arbitratePort(ports, port, in_port_busy, out_port_busy, progress_vc);
             }
-            // Increemnt rr_vcs for next time 
-            rr_vcs[port] = (rr_vcs[port] + 1) % num_vcs;
         }
         rr_port = (rr_port + 1) % num_ports;
 
@@ -0,0 +1,209 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#include <sst_config.h>
+
+#include "trafficMatrix.h"
+
+#include <sst/core/simulation.h>
+#include <sst/core/unitAlgebra.h>
+
+#include <algorithm>
+#include <cstdio>
+
+#include "sst/elements/merlin/merlin.h"
+
+using namespace std;
+
+namespace SST {
+namespace Merlin {
+
+std::vector<std::pair<TrafficMatrixInspector::Cell, TrafficMatrixInspector::Count> > TrafficMatrixInspector::global_cells;
+std::vector<TrafficMatrixInspector::LinkRecord> TrafficMatrixInspector::global_links;
+int TrafficMatrixInspector::num_inspectors = 0;
+SST::Core::ThreadSafe::Spinlock TrafficMatrixInspector::lock;
+
+
+TrafficMatrixInspector::TrafficMatrixInspector(SST::Component* parent, SST::Params &params) :
+    SimpleNetwork::NetworkInspector(parent),
+    initialized(false)
+{
+    out_file = params.find<std::string>("output_file", "traffic_matrix");
+
+    std::string format = params.find<std::string>("format", "csv");
+    if ( format == "csv" ) binary = false;
+    else if ( format == "binary" ) binary = true;
+    else {
+        merlin_abort.fatal(CALL_INFO,-1,"traffic_matrix_inspector: unknown format: %s\n",format.c_str());
+    }
+
+    UnitAlgebra window = params.find<UnitAlgebra>("window", "0ns");
+    if ( !window.hasUnits("s") ) {
+        merlin_abort.fatal(CALL_INFO,-1,"traffic_matrix_inspector: window must be specified in seconds\n");
+    }
+    window_ns = (window / UnitAlgebra("1ns")).getRoundedValue();
+
+    host_port = params.find<std::string>("port_state", "router") == "host";
+
+    lock.lock();
+    num_inspectors++;
+    lock.unlock();
+}
+
+void TrafficMatrixInspector::initialize(string id) {
+    link_name = parent->getName() + ":" + id;
+    initialized = true;
+}
+
+void TrafficMatrixInspector::inspectNetworkData(SimpleNetwork::Request* req) {
+    size_t w = 0;
+    if ( window_ns != 0 ) w = parent->getCurrentSimTimeNano() / window_ns;
+    uint64_t bytes = (req->size_in_bits + 7) / 8;
+
+    if ( w >= link_windows.size() ) link_windows.resize(w + 1, Count{0, 0});
+    link_windows[w].packets++;
+    link_windows[w].bytes += bytes;
+
+    if ( !host_port ) return;
+
+    Cell cell = { w, (uint32_t)req->src, (uint32_t)req->dest };
+    Count& count = cells.insert(std::make_pair(cell, Count{0, 0})).first->second;
+    count.packets++;
+    count.bytes += bytes;
+}
+
+// Hand this inspector's counts over.  The last inspector on the rank
+// writes the files.
+void TrafficMatrixInspector::finish() {
+    if ( !initialized ) return;
+    initialized = false;
+
+    lock.lock();
+
+    global_links.push_back(LinkRecord());
+    global_links.back().name = link_name;
+    global_links.back().windows.swap(link_windows);
+
+    global_cells.insert(global_cells.end(), cells.begin(), cells.end());
+    cells.clear();
+
+    if ( --num_inspectors == 0 ) {
+        writeOutput(out_file, binary, window_ns);
+        std::vector<std::pair<Cell, Count> >().swap(global_cells);
+        global_links.clear();
+    }
+
+    lock.unlock();
+}
+
+void TrafficMatrixInspector::writeOutput(const std::string& out_file, bool binary, SimTime_t window_ns) {
+    // Ranks each write their own files
+    std::string prefix = out_file;
+    if ( Simulation::getSimulation()->getNumRanks().rank > 1 ) {
+        char rank[16];
+        snprintf(rank, sizeof(rank), ".%u", Simulation::getSimulation()->getRank().rank);
+        prefix += rank;
+    }
+
+    // Windows are only merged here: sort the cells by window, source and
+    // destination, then add up any cell seen by more than one inspector
+    std::sort(global_cells.begin(), global_cells.end(),
+              [](const std::pair<Cell, Count>& a, const std::pair<Cell, Count>& b) { return a.first < b.first; });
+    size_t num_cells = 0;
+    uint32_t dim = 0;
+    for ( size_t i = 0; i < global_cells.size(); i++ ) {
+        if ( num_cells > 0 && global_cells[num_cells - 1].first == global_cells[i].first ) {
+            global_cells[num_cells - 1].second.packets += global_cells[i].second.packets;
+            global_cells[num_cells - 1].second.bytes += global_cells[i].second.bytes;
+            continue;
+        }
+        global_cells[num_cells++] = global_cells[i];
+        dim = std::max(dim, std::max(global_cells[i].first.src, global_cells[i].first.dest) + 1);
+    }
+    global_cells.resize(num_cells);
+
+    if ( binary ) {
+        // Header: "MTMX", version, dim, number of windows, window
+        // length in ns.  Then for each window the dim x dim packet
+        // counts followed by the byte counts, row major by source.
+        std::string name = prefix + ".matrix.bin";
+        FILE* fp = fopen(name.c_str(), "wb");
+        if ( fp == NULL ) {
+            merlin_abort.fatal(CALL_INFO,-1,"traffic_matrix_inspector: unable to open %s\n",name.c_str());
+        }
+        uint64_t num_windows = global_cells.empty() ? 0 : global_cells.back().first.window + 1;
+        uint32_t header[4] = { 0x584d544d, 1, dim, (uint32_t)num_windows };
+        uint64_t window_len = window_ns;
+        fwrite(header, sizeof(header), 1, fp);
+        fwrite(&window_len, sizeof(window_len), 1, fp);
+
+        // Rows are filled one at a time from the sorted cells
+        std::vector<uint64_t> row(dim);
+        size_t first = 0;
+        for ( uint64_t w = 0; w < num_windows; w++ ) {
+            size_t last = first;
+            while ( last < global_cells.size() && global_cells[last].first.window == w ) last++;
+            for ( int field = 0; field < 2; field++ ) {
+                size_t i = first;
+                for ( uint32_t src = 0; src < dim; src++ ) {
+                    std::fill(row.begin(), row.end(), 0);
+                    for ( ; i < last && global_cells[i].first.src == src; i++ ) {
+                        const Count& count = global_cells[i].second;
+                        row[global_cells[i].first.dest] = field == 0 ? count.packets : count.bytes;
+                    }
+                    fwrite(row.data(), sizeof(uint64_t), dim, fp);
+                }
+            }
+            first = last;
+        }
+        fclose(fp);
+    }
+    else {
+        std::string name = prefix + ".matrix.csv";
+        FILE* fp = fopen(name.c_str(), "w");
+        if ( fp == NULL ) {
+            merlin_abort.fatal(CALL_INFO,-1,"traffic_matrix_inspector: unable to open %s\n",name.c_str());
+        }
+        fprintf(fp, "window_start_ns,src,dest,packets,bytes\n");
+        for ( auto& cell : global_cells ) {
+            fprintf(fp, "%" PRIu64 ",%u,%u,%" PRIu64 ",%" PRIu64 "\n",
+                    (uint64_t)(cell.first.window * window_ns), cell.first.src, cell.first.dest,
+                    cell.second.packets, cell.second.bytes);
+        }
+        fclose(fp);
+    }
+
+    // Inspectors finish in whatever order the threads get to them
+    std::sort(global_links.begin(), global_links.end(),
+              [](const LinkRecord& a, const LinkRecord& b) { return a.name < b.name; });
+
+    std::string name = prefix + ".links.csv";
+    FILE* fp = fopen(name.c_str(), "w");
+    if ( fp == NULL ) {
+        merlin_abort.fatal(CALL_INFO,-1,"traffic_matrix_inspector: unable to open %s\n",name.c_str());
+    }
+    fprintf(fp, "link,window_start_ns,packets,bytes\n");
+    for ( auto& link : global_links ) {
+        for ( size_t w = 0; w < link.windows.size(); w++ ) {
+            if ( link.windows[w].packets == 0 ) continue;
+            fprintf(fp, "%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n", link.name.c_str(),
+                    (uint64_t)(w * window_ns), link.windows[w].packets, link.windows[w].bytes);
+        }
+    }
+    fclose(fp);
+}
+
+} // namespace Merlin
+} // namespace SST
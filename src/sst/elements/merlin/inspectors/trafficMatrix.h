@@ -0,0 +1,120 @@
+// Copyright 2009-2018 NTESS. Under the terms
+// of Contract DE-NA0003525 with NTESS, the U.S.
+// Government retains certain rights in this software.
+//
+// Copyright (c) 2009-2018, NTESS
+// All rights reserved.
+//
+// Portions are copyright of other developers:
+// See the file CONTRIBUTORS.TXT in the top level directory
+// the distribution for more information.
+//
+// This file is part of the SST software package. For license
+// information, see the LICENSE file in the top level directory of the
+// distribution.
+
+#ifndef COMPONENTS_MERLIN_TRAFFICMATRIX_H
+#define COMPONENTS_MERLIN_TRAFFICMATRIX_H
+
+#include <sst/core/elementinfo.h>
+#include <sst/core/subcomponent.h>
+#include <sst/core/interfaces/simpleNetwork.h>
+#include <sst/core/threadsafe.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace SST {
+using namespace SST::Interfaces;
+namespace Merlin {
+
+// Records the (source, destination) traffic matrix and the traffic on
+// each output link.  The matrix is only counted on host ports, so each
+// packet is seen once.  Each inspector keeps only the (window, source,
+// destination) cells that see traffic.  Nothing is locked until
+// finish(), where the cells are collected and the last inspector on
+// the rank sorts them and writes the files.
+class TrafficMatrixInspector : public SimpleNetwork::NetworkInspector {
+
+public:
+
+    SST_ELI_REGISTER_SUBCOMPONENT(
+        TrafficMatrixInspector,
+        "merlin",
+        "traffic_matrix_inspector",
+        SST_ELI_ELEMENT_VERSION(1,0,0),
+        "Records the endpoint to endpoint traffic matrix and per link traffic, optionally in time windows.  "
+        "Parameters are passed through the router as network_inspector:<param>.",
+        "SST::Interfaces::SimpleNetwork::NetworkInspector")
+
+    SST_ELI_DOCUMENT_PARAMS(
+        {"output_file",  "Prefix of the output files.  Writes <prefix>.matrix.csv (or .matrix.bin) and <prefix>.links.csv.  With more than one rank, each rank writes <prefix>.<rank>.*.", "traffic_matrix"},
+        {"format",       "Format of the matrix file [csv | binary].", "csv"},
+        {"window",       "Length of the time windows to bin counts in.  0 records the whole simulation as one window.", "0ns"},
+        {"port_state",   "Set by the router: host if the port connects to an endpoint.", "router"}
+    )
+
+private:
+    struct Count {
+        uint64_t packets;
+        uint64_t bytes;
+    };
+
+    // One cell of the matrix
+    struct Cell {
+        uint64_t window;
+        uint32_t src;
+        uint32_t dest;
+
+        bool operator==(const Cell& other) const {
+            return window == other.window && src == other.src && dest == other.dest;
+        }
+        bool operator<(const Cell& other) const {
+            if ( window != other.window ) return window < other.window;
+            if ( src != other.src ) return src < other.src;
+            return dest < other.dest;
+        }
+    };
+
+    struct CellHash {
+        size_t operator()(const Cell& cell) const {
+            return std::hash<uint64_t>()((cell.window << 40) ^ ((uint64_t)cell.src << 20) ^ cell.dest);
+        }
+    };
+
+    struct LinkRecord {
+        std::string name;
+        std::vector<Count> windows;
+    };
+
+    // Collected at finish()
+    static std::vector<std::pair<Cell, Count> > global_cells;
+    static std::vector<LinkRecord> global_links;
+    static int num_inspectors;
+    static SST::Core::ThreadSafe::Spinlock lock;
+
+    std::string out_file;
+    bool binary;
+    SimTime_t window_ns;
+    bool host_port;
+    bool initialized;
+
+    std::unordered_map<Cell, Count, CellHash> cells;
+    std::string link_name;
+    std::vector<Count> link_windows;
+
+    static void writeOutput(const std::string& out_file, bool binary, SimTime_t window_ns);
+
+public:
+    TrafficMatrixInspector(SST::Component* parent, SST::Params &params);
+
+    void initialize(std::string id);
+    void finish();
+
+    void inspectNetworkData(SimpleNetwork::Request* req);
+};
+
+
+} // namespace Merlin
+} // namespace SST
+#endif
@@ -24,10 +24,12 @@
   get compiled.
  */
 #include "hr_router/xbar_arb_rr.h"
+#include "hr_router/xbar_arb_rr_ref.h"
 #include "hr_router/xbar_arb_lru.h"
 #include "hr_router/xbar_arb_age.h"
 #include "hr_router/xbar_arb_rand.h"
 #include "hr_router/xbar_arb_lru_infx.h"
+#include "hr_router/xbar_arb_bitmask.h"
 
 /*
   Install the python library
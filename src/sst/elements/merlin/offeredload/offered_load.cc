@@ -53,7 +53,7 @@ OfferedLoad::OfferedLoad(ComponentId_t cid, Params& params) :
     }
 
     bool found = false;
-    UnitAlgebra link_bw = params.find<UnitAlgebra>("link_bw",found);
+    link_bw = params.find<UnitAlgebra>("link_bw",found);
     if ( !found ) {
         out.fatal(CALL_INFO, -1, "link_bw must be set!\n");
     }
@@ -84,13 +84,27 @@ OfferedLoad::OfferedLoad(ComponentId_t cid, Params& params) :
     link_if->setNotifyOnReceive(recv_notify_functor);
 
 
-    // Set up the communication pattern generator
-    std::string pattern = params.find<std::string>("pattern",found);
-    if ( !found ) {
+    // Set up the communication pattern generators.  The load schedule
+    // is run once for each pattern.
+    try {
+        params.find_array<std::string>("pattern",patterns);
+    }
+    catch ( std::invalid_argument e ) {
+        std::string pattern = params.find<std::string>("pattern",found);
+        if ( found ) {
+            patterns.push_back(pattern);
+        }
+    }
+
+    if ( patterns.empty() ) {
         out.fatal(CALL_INFO, -1, "pattern must be set!\n");
     }
 
-    packetDestGen = static_cast<TargetGenerator*>(loadSubComponent(pattern, this, params));
+    for ( auto& pattern : patterns ) {
+        patternGens.push_back(static_cast<TargetGenerator*>(loadSubComponent(pattern, this, params)));
+    }
+    packetDestGen = patternGens[0];
+    num_generations = offered_load.size() * patterns.size();
 
     UnitAlgebra warmup_time_ua = params.find<UnitAlgebra>("warmup_time","5us");
     if ( !warmup_time_ua.hasUnits("s") ) {
@@ -106,13 +120,33 @@ OfferedLoad::OfferedLoad(ComponentId_t cid, Params& params) :
     }
     collect_time = (collect_time_ua / UnitAlgebra("1ps")).getRoundedValue();
     end_time = start_time + collect_time;
+    measure_end = end_time;
     
 
     UnitAlgebra drain_time_ua = params.find<UnitAlgebra>("drain_time","50us");
-    if ( !collect_time_ua.hasUnits("s") ) {
+    if ( !drain_time_ua.hasUnits("s") ) {
         out.fatal(CALL_INFO,-1,"drain_time must specified in seconds");
     }
     drain_time = (drain_time_ua / UnitAlgebra("1ps")).getRoundedValue();
+
+    UnitAlgebra latency_bin_size_ua = params.find<UnitAlgebra>("latency_bin_size","2ns");
+    if ( !latency_bin_size_ua.hasUnits("s") ) {
+        out.fatal(CALL_INFO,-1,"latency_bin_size must specified in seconds");
+    }
+    latency_bin_size = (latency_bin_size_ua / UnitAlgebra("1ps")).getRoundedValue();
+    if ( latency_bin_size == 0 ) latency_bin_size = 1;
+
+    // Bins are only stored once a latency falls in them, so by default
+    // cover the longest latency a packet can see: one sent at the start
+    // of a load point and received at the end of its drain.  The extra
+    // bin is overflow.
+    latency_bins = params.find<uint64_t>("latency_bins",0);
+    if ( latency_bins == 0 ) {
+        latency_bins = (warmup_time + collect_time + drain_time) / latency_bin_size + 2;
+    }
+    else if ( latency_bins < 2 ) {
+        out.fatal(CALL_INFO,-1,"latency_bins must be at least 2");
+    }
     
     registerAsPrimaryComponent();
     primaryComponentDoNotEndSim();
@@ -135,6 +169,35 @@ OfferedLoad::OfferedLoad(ComponentId_t cid, Params& params) :
 OfferedLoad::~OfferedLoad()
 {
     delete link_if;
+    for ( auto gen : patternGens ) delete gen;
+    for ( auto ev : complete_event ) delete ev;
+}
+
+
+SST::SimTime_t
+OfferedLoad::latency_percentile(offered_load_complete_event* ev, double pct, bool& overflow)
+{
+    overflow = false;
+    if ( ev->count == 0 ) return 0;
+
+    uint64_t target = (uint64_t)(pct * ev->count);
+    if ( target < 1 ) target = 1;
+
+    uint64_t seen = 0;
+    for ( auto& bin : ev->latency_hist ) {
+        seen += bin.second;
+        if ( seen < target ) continue;
+
+        if ( bin.first == latency_bins - 1 ) {
+            // Landed in the overflow bin, all we know is where it starts
+            overflow = true;
+            return bin.first * latency_bin_size;
+        }
+        // Report the top of the bin, but never more than the max
+        SimTime_t top = (bin.first + 1) * latency_bin_size;
+        return top < ev->max ? top : ev->max;
+    }
+    return ev->max;
 }
 
 
@@ -159,17 +222,32 @@ void OfferedLoad::finish()
         // }
 
 
-        // Now, write out a summary table with just the latencies
+        // Now, write out a saturation curve for each pattern.
+        // Accepted load is the fraction of link bandwidth delivered to
+        // each endpoint during the collection window.  A * marks load
+        // points where the endpoints fell behind the offered load.  A
+        // p99 latency past the last histogram bin is printed as >(start
+        // of that bin).
 
-        out.output("%9s %9s\n","Offered","Average");
-        out.output("%9s %9s\n","Load ","Latency");
+        double window_packets = (double)collect_time / serialization_time.getDoubleValue();
         for ( auto ev : complete_event ) {
-            UnitAlgebra average = UnitAlgebra("1ps") * ev->sum / ev->count;
-            out.output("%9.2f %15s",offered_load[ev->generation],average.toStringBestSI().c_str());
+            int load_index = ev->generation % offered_load.size();
+            if ( load_index == 0 ) {
+                out.output("Pattern: %s\n",patterns[ev->generation / offered_load.size()].c_str());
+                out.output("%9s %9s %15s %15s\n","Offered","Accepted","Average","p99");
+                out.output("%9s %9s %15s %15s\n","Load ","Load ","Latency","Latency");
+            }
+            double accepted = ((double)ev->recd_bits / packet_size) / (window_packets * num_peers);
+            UnitAlgebra average = ev->count == 0 ? UnitAlgebra("0s") : UnitAlgebra("1ps") * ev->sum / ev->count;
+            bool overflow;
+            UnitAlgebra p99 = UnitAlgebra("1ps") * latency_percentile(ev, 0.99, overflow);
+            std::string p99_str = (overflow ? ">" : "") + p99.toStringBestSI();
+            out.output("%9.2f %9.3f %15s %15s",offered_load[load_index],accepted,
+                       average.toStringBestSI().c_str(),p99_str.c_str());
             if ( ev->backup > 0 ) out.output("*\n");
             else out.output("\n");
+            if ( load_index == (int)offered_load.size() - 1 ) out.output("\n");
         }
-        out.output("\n");
         
     }
 }
@@ -194,7 +272,7 @@ OfferedLoad::init(unsigned int phase) {
     link_if->init(phase);
     if ( id == -1 && link_if->isNetworkInitialized() ) {
         id = link_if->getEndpointID();
-        packetDestGen->initialize(id, num_peers);
+        for ( auto gen : patternGens ) gen->initialize(id, num_peers);
     }
         
 }
@@ -214,6 +292,12 @@ OfferedLoad::complete(unsigned int phase) {
             complete_event[generation]->max = ev->max > complete_event[generation]->max ? ev->max : complete_event[generation]->max;
             complete_event[generation]->count += ev->count;
             complete_event[generation]->backup += ev->backup;
+            complete_event[generation]->recd_bits += ev->recd_bits;
+            for ( auto& bin : ev->latency_hist ) {
+                complete_event[generation]->latency_hist[bin.first] += bin.second;
+            }
+            delete ev;
+            delete req;
             
             req = link_if->recvUntimedData();
         }
@@ -221,7 +305,7 @@ OfferedLoad::complete(unsigned int phase) {
     else {
         if ( phase == 0 ) {
             for ( auto ev : complete_event ) {
-                link_if->sendUntimedData(new SimpleNetwork::Request(0,id,0,true,true,ev));
+                link_if->sendUntimedData(new SimpleNetwork::Request(0,id,0,true,true,ev->clone()));
             }
         }
     }
@@ -249,6 +333,16 @@ OfferedLoad::handle_receives(int vn)
             complete_event[generation]->min = latency < complete_event[generation]->min ? latency : complete_event[generation]->min;
             complete_event[generation]->max = latency > complete_event[generation]->max ? latency : complete_event[generation]->max;
             complete_event[generation]->count++;
+
+            SimTime_t bin = latency / latency_bin_size;
+            if ( bin >= latency_bins ) bin = latency_bins - 1;
+            complete_event[generation]->latency_hist[bin]++;
+
+            // Only count bits received during the collection window
+            // toward the accepted load
+            if ( current_time < measure_end ) {
+                complete_event[generation]->recd_bits += req->size_in_bits;
+            }
         }
         delete req;
     }
@@ -332,7 +426,7 @@ OfferedLoad::end_handler(Event* ev) {
     }
 
     // See if we are done
-    if ( complete_event.size() == offered_load.size() ) {
+    if ( (int)complete_event.size() == num_generations ) {
         primaryComponentOKToEndSim();
     }
     else {
@@ -343,11 +437,14 @@ OfferedLoad::end_handler(Event* ev) {
         // Add a new complete_event entry and increment generation
         // count
         complete_event.push_back(new offered_load_complete_event(++generation));
+
+        // Move to the next pattern once the load schedule is done
+        packetDestGen = patternGens[generation / offered_load.size()];
         
         // Compute the new send interval based on the new
         // offered_load.  We do this by computing time to serialize
         // one packet and dividing by the offered_load
-        UnitAlgebra interval = serialization_time / offered_load[generation];
+        UnitAlgebra interval = serialization_time / offered_load[generation % offered_load.size()];
         send_interval = interval.getRoundedValue();
 
         // Compute the next time to send a packet.  We'll wait for
@@ -357,6 +454,7 @@ OfferedLoad::end_handler(Event* ev) {
         // Compute the new start_time for recording values (after the
         // warm up period)
         start_time = next_time + warmup_time;
+        measure_end = start_time + collect_time;
 
         // Need to send the next event to end this round.  The total
         // time to the next ending is drain_time + warmup_time +
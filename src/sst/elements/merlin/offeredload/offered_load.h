@@ -37,6 +37,9 @@
 
 #include "sst/elements/merlin/target_generator/target_generator.h"
 
+#include <map>
+#include <vector>
+
 namespace SST {
 namespace Merlin {
 
@@ -73,6 +76,10 @@ public:
     SimTime_t max;
     uint64_t  count;
     SimTime_t backup;
+    uint64_t  recd_bits;
+    // Number of latencies that fell in each occupied bin, the last
+    // bin (latency_bins - 1) is overflow
+    std::map<uint64_t,uint64_t> latency_hist;
     
     offered_load_complete_event(int generation) :
         Event(),
@@ -81,7 +88,9 @@ public:
         sum_of_squares(0),
         min(MAX_SIMTIME_T),
         max(0),
-        count(0)
+        count(0),
+        backup(0),
+        recd_bits(0)
         {}
 
     virtual ~offered_load_complete_event() {  }
@@ -101,6 +110,8 @@ public:
         ser & max;
         ser & count;
         ser & backup;
+        ser & recd_bits;
+        ser & latency_hist;
     }
 
 private:
@@ -122,7 +133,9 @@ public:
         "merlin",
         "offered_load",
         SST_ELI_ELEMENT_VERSION(0,0,1),
-        "Pattern-based traffic generator to study latency versus offered load.",
+        "Pattern-based traffic generator to study latency versus offered load.  Steps through each "
+        "load point for each pattern in one simulation and prints the accepted throughput and mean "
+        "and p99 latency of each.",
         COMPONENT_CATEGORY_NETWORK)
     
     SST_ELI_DOCUMENT_PARAMS(
@@ -131,11 +144,13 @@ public:
         {"linkcontrol",      "SimpleNetwork object to use as interface to network.","merlin.linkcontrol"},
         {"buffer_size",      "Size of input and output buffers.","1kB"},
         {"packet_size",      "Packet size specified in either b or B (can include SI prefix).","32B"},
-        {"pattern",          "Traffic pattern to use.","merlin.targetgen.uniform"},
-        {"offered_load",     "Load to be offered to network.  Valid range: 0 < offered_load <= 1.0."},
-        {"warmup_time",      "Time to wait before recording latencies","1us"},
+        {"pattern",          "Traffic pattern to use.  Can be an array, in which case the offered_load schedule is run for each pattern.","merlin.targetgen.uniform"},
+        {"offered_load",     "Load to be offered to network.  Valid range: 0 < offered_load <= 1.0.  Can be an array of load points."},
+        {"warmup_time",      "Time to wait before recording latencies","5us"},
         {"collect_time",     "Time to collect data after warmup","20us"},        
         {"drain_time",       "Time to drain network before stating next round","50us"},
+        {"latency_bin_size", "Width of the latency histogram bins used to compute p99 latency","2ns"},
+        {"latency_bins",     "Number of latency histogram bins.  0 sizes the histogram to cover the longest latency a packet can have (warmup_time + collect_time + drain_time).  A p99 past the last bin is reported as >(start of the last bin).","0"},
     )
 
     SST_ELI_DOCUMENT_PORTS(
@@ -147,6 +162,7 @@ public:
 private:
 
     std::vector<double> offered_load;
+    std::vector<std::string> patterns;
     UnitAlgebra link_bw;
 
     UnitAlgebra serialization_time;
@@ -156,12 +172,20 @@ private:
 
     SimTime_t start_time;
     SimTime_t end_time;
+    // End of the current collection window, used for throughput
+    SimTime_t measure_end;
 
     SimTime_t drain_time;
     SimTime_t warmup_time;
     SimTime_t collect_time;
+
+    SimTime_t latency_bin_size;
+    uint64_t latency_bins;
     
+    // Each generation is one (pattern, offered_load) pair, with the
+    // offered_load schedule run for each pattern in turn
     int generation;
+    int num_generations;
     
     TimeConverter* base_tc;
 
@@ -171,6 +195,7 @@ private:
 
 
     TargetGenerator *packetDestGen;
+    std::vector<TargetGenerator*> patternGens;
     
     Output out;
     int id;
@@ -206,6 +231,8 @@ private:
     void progress_messages(SimTime_t current_time);
 
     void end_handler(Event* ev);
+
+    SimTime_t latency_percentile(offered_load_complete_event* ev, double pct, bool& overflow);
     
 };
 
@@ -107,7 +107,8 @@ PortControl::recv(int vc)
 	// Need to update vc_heads
 	if ( input_buf[vc].empty() ) {
 	    vc_heads[vc] = NULL;
-	    parent->dec_vcs_with_data();
+	    active_vcs.clear(vc);
+	    parent->dec_vcs_with_data(port_number, active_vcs.empty());
 	}
 	else {
 	    vc_heads[vc] = input_buf[vc].front();
@@ -142,7 +143,7 @@ PortControl::PortControl(Router* rif, int rtr_id, std::string link_port_name,
                          SimTime_t input_latency_cycles, std::string input_latency_timebase,
                          SimTime_t output_latency_cycles, std::string output_latency_timebase,
                          const UnitAlgebra& in_buf_size, const UnitAlgebra& out_buf_size,
-                         std::vector<std::string>& inspector_names,
+                         std::vector<std::string>& inspector_names, Params& inspector_params,
 						 const float dlink_thresh, bool oql_track_port, bool oql_track_remote) :
     rtr_id(rtr_id),
     num_vcs(-1),
@@ -251,10 +252,12 @@ PortControl::PortControl(Router* rif, int rtr_id, std::string link_port_name,
 	max_link_width = 4;
 	cur_link_width = max_link_width;
 
-    // Create any NetworkInspectors
+    // Create any NetworkInspectors.  They get the router's
+    // network_inspector: params plus whether this is a host port.
+    Params ni_params(inspector_params);
+    ni_params.insert("port_state", host_port ? "host" : "router");
     for ( unsigned int i = 0; i < inspector_names.size(); i++ ) {
-        Params empty;
-        SimpleNetwork::NetworkInspector* ni = dynamic_cast<SimpleNetwork::NetworkInspector*>(rif->loadSubComponent(inspector_names[i], rif, empty));
+        SimpleNetwork::NetworkInspector* ni = dynamic_cast<SimpleNetwork::NetworkInspector*>(rif->loadSubComponent(inspector_names[i], rif, ni_params));
         if ( ni == NULL ) {
             merlin_abort.fatal(CALL_INFO,1,"NetworkInspector: %s, not found.\n",inspector_names[i].c_str());
         }
@@ -268,6 +271,7 @@ void
 PortControl::initVCs(int vcs, internal_router_event** vc_heads_in, int* xbar_in_credits_in, int* output_queue_lengths_in)
 {
     vc_heads = vc_heads_in;
+    active_vcs.resize(vcs);
     // If the port is not connected, we still need to initialize
     // vc_heads entries to NULL
     if ( !connected ) {
@@ -739,7 +743,8 @@ PortControl::handle_input_n2r(Event* ev)
 	    // If this becomes vc_head we need to put it into the vc_heads array
 	    if ( vc_heads[curr_vc] == NULL ) {
             vc_heads[curr_vc] = rtr_event;
-            parent->inc_vcs_with_data();
+            active_vcs.set(curr_vc);
+            parent->inc_vcs_with_data(port_number);
 	    }
 	    
 	    if ( event->request->getTraceType() != SST::Interfaces::SimpleNetwork::Request::NONE ) {
@@ -833,7 +838,8 @@ PortControl::handle_input_r2r(Event* ev)
 	    // in the array) we need to put it into the vc_heads array
 	    if ( vc_heads[curr_vc] == NULL ) {
             vc_heads[curr_vc] = event;
-            parent->inc_vcs_with_data();
+            active_vcs.set(curr_vc);
+            parent->inc_vcs_with_data(port_number);
 	    }
         // std::cout << "Got to here 3" << std::endl; 
 	    
@@ -99,6 +99,7 @@ private:
     // head of each of its VC queues into a single array to speed
     // things up.  This is an array passed into the constructor.
     internal_router_event** vc_heads;
+    ActiveMask active_vcs;
     
     int* input_buf_count;
     int* output_buf_count;
@@ -204,6 +205,10 @@ public:
     internal_router_event** getVCHeads() {
     	return vc_heads;
     }
+    // VCs with an event in vc_heads
+    const ActiveMask& getActiveVCs() const {
+        return active_vcs;
+    }
     
     // time_base is a frequency which represents the bandwidth of the link in flits/second.
     PortControl(Router* rif, int rtr_id, std::string link_port_name,
@@ -212,7 +217,7 @@ public:
                 SimTime_t input_latency_cycles, std::string input_latency_timebase,
                 SimTime_t output_latency_cycles, std::string output_latency_timebase,
                 const UnitAlgebra& in_buf_size, const UnitAlgebra& out_buf_size,
-                std::vector<std::string>& inspector_names,
+                std::vector<std::string>& inspector_names, Params& inspector_params,
 				const float dlink_thresh, bool oql_track_port, bool oql_track_remote);
 
     void initVCs(int vcs, internal_router_event** vc_heads, int* xbar_in_credits, int* output_queue_lengths);
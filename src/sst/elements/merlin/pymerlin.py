@@ -34,6 +34,19 @@ class Params(dict):
     
 _params = Params()
 debug = 0
+_native_build = True
+
+def useNativeBuild(enable):
+    """Select whether the torus, mesh, hyperx, fattree and dragonfly2
+    topologies are built by the native builders in the merlin module
+    (the default) or in python.  Both create the same components,
+    params and links, which tests/native_build_test.py checks; the
+    native builders are faster for large networks."""
+    global _native_build
+    _native_build = enable
+
+def _haveNativeBuild(name):
+    return _native_build and name in globals()
 
 class Topo:
     def __init__(self):
@@ -55,6 +68,8 @@ class Topo:
         self._getEndPoint = epFunc
     def setEndPointFunc(self, epFunc):
         self._getEndPoint = epFunc
+    def _buildEndPoint(self, epID):
+        return self._getEndPoint(epID).build(epID, {})
     def build(self):
         pass
         
@@ -96,7 +111,7 @@ class topoTorus(Topo):
     def __init__(self):
         Topo.__init__(self)
         self.topoKeys.extend(["topology", "debug", "num_ports", "flit_size", "link_bw", "xbar_bw", "torus:shape", "torus:width", "torus:local_ports","input_latency","output_latency","input_buf_size","output_buf_size"])
-        self.topoOptKeys.extend(["xbar_arb"])
+        self.topoOptKeys.extend(["xbar_arb", "torus:route_table"])
     def getName(self):
         return "Torus"
     def prepParams(self):
@@ -143,6 +158,12 @@ class topoTorus(Topo):
         return 'x'.join([str(x) for x in arr])
 
     def build(self):
+        if _haveNativeBuild("_buildTorus"):
+            _buildTorus(_params.subset(self.topoKeys, self.topoOptKeys), self.dims, self.dimwidths,
+                        int(_params["torus:local_ports"]), _params["link_lat"], self._buildEndPoint,
+                        self.bundleEndpoints, False)
+            return
+
         def idToLoc(rtr_id):
             foo = list()
             for i in xrange(self.nd-1, 0, -1):
@@ -255,6 +276,12 @@ class topoMesh(Topo):
         return 'x'.join([str(x) for x in arr])
 
     def build(self):
+        if _haveNativeBuild("_buildTorus"):
+            _buildTorus(_params.subset(self.topoKeys, self.topoOptKeys), self.dims, self.dimwidths,
+                        int(_params["mesh:local_ports"]), _params["link_lat"], self._buildEndPoint,
+                        self.bundleEndpoints, True)
+            return
+
         def idToLoc(rtr_id):
             foo = list()
             for i in xrange(self.nd-1, 0, -1):
@@ -325,7 +352,7 @@ class topoHyperX(Topo):
     def __init__(self):
         Topo.__init__(self)
         self.topoKeys = ["topology", "debug", "num_ports", "flit_size", "link_bw", "xbar_bw", "hyperx:shape", "hyperx:width", "hyperx:local_ports","input_latency","output_latency","input_buf_size","output_buf_size"]
-        self.topoOptKeys = ["xbar_arb"]
+        self.topoOptKeys = ["xbar_arb", "hyperx:algorithm", "hyperx:route_table"]
     def getName(self):
         return "HyperX"
     def prepParams(self):
@@ -374,6 +401,12 @@ class topoHyperX(Topo):
         return 'x'.join([str(x) for x in arr])
 
     def build(self):
+        if _haveNativeBuild("_buildHyperX"):
+            _buildHyperX(_params.subset(self.topoKeys, self.topoOptKeys), self.dims, self.dimwidths,
+                         int(_params["hyperx:local_ports"]), _params["link_lat"], self._buildEndPoint,
+                         self.bundleEndpoints)
+            return
+
         def idToLoc(rtr_id):
             foo = list()
             for i in xrange(self.nd-1, 0, -1):
@@ -448,7 +481,7 @@ class topoFatTree(Topo):
     def __init__(self):
         Topo.__init__(self)
         self.topoKeys = ["topology", "debug", "flit_size", "link_bw", "xbar_bw","input_latency","output_latency","input_buf_size","output_buf_size", "fattree:shape"]
-        self.topoOptKeys = ["xbar_arb", "fattree:routing_alg", "fattree:adaptive_threshold"]
+        self.topoOptKeys = ["xbar_arb", "fattree:routing_alg", "fattree:adaptive_threshold", "fattree:route_table"]
         self.nicKeys = ["link_bw"]
         self.ups = []
         self.downs = []
@@ -583,6 +616,12 @@ class topoFatTree(Topo):
     
     def build(self):
 #        print "build()"
+        if _haveNativeBuild("_buildFatTree"):
+            _buildFatTree(_params.subset(self.topoKeys, self.topoOptKeys), self.downs, self.ups,
+                          self.routers_per_level, self.groups_per_level, self.start_ids,
+                          _params["link_lat"], self._buildEndPoint, self.bundleEndpoints)
+            return
+
         level = len(self.ups)
         if self.ups: # True for all cases except for single level
             #  Create the router links
@@ -881,7 +920,7 @@ class topoDragonFly2(Topo):
     def __init__(self):
         Topo.__init__(self)
         self.topoKeys = ["topology", "debug", "num_ports", "flit_size", "link_bw", "xbar_bw", "dragonfly:hosts_per_router", "dragonfly:routers_per_group", "dragonfly:intergroup_per_router", "dragonfly:num_groups","dragonfly:intergroup_links","input_latency","output_latency","input_buf_size","output_buf_size","dragonfly:global_route_mode"]
-        self.topoOptKeys = ["xbar_arb","link_bw:host","link_bw:group","link_bw:global","input_latency:host","input_latency:group","input_latency:global","output_latency:host","output_latency:group","output_latency:global","input_buf_size:host","input_buf_size:group","input_buf_size:global","output_buf_size:host","output_buf_size:group","output_buf_size:global"]
+        self.topoOptKeys = ["xbar_arb","link_bw:host","link_bw:group","link_bw:global","input_latency:host","input_latency:group","input_latency:global","output_latency:host","output_latency:group","output_latency:global","input_buf_size:host","input_buf_size:group","input_buf_size:global","output_buf_size:host","output_buf_size:group","output_buf_size:global","dragonfly:route_table"]
         self.global_link_map = None
         self.global_routes = "absolute"
 
@@ -961,6 +1000,13 @@ class topoDragonFly2(Topo):
         #print self.global_link_map
 
         # End set global link map with default
+
+        if _haveNativeBuild("_buildDragonFly2"):
+            _buildDragonFly2(_params.subset(self.topoKeys, self.topoOptKeys),
+                             _params["dragonfly:hosts_per_router"], rpg, _params["dragonfly:num_groups"], igpr,
+                             self.global_link_map, self.global_routes == "relative",
+                             _params["link_lat"], self._buildEndPoint, self.bundleEndpoints)
+            return
             
 
         # g is group number
@@ -1043,6 +1089,33 @@ class topoDragonFly2(Topo):
 
 
 
+class topoFlow(Topo):
+    """Replaces the routers of another topology with a single
+    merlin.flow_network component.  Endpoints must use
+    merlin.flow_linkcontrol as their link control."""
+    def __init__(self, topo):
+        Topo.__init__(self)
+        self.topo = topo
+    def getName(self):
+        return "Flow model of " + self.topo.getName()
+    def prepParams(self):
+        self.topo.prepParams()
+    def build(self):
+        net = sst.Component("flow_network", "merlin.flow_network")
+        net.addParams(_params.subset(self.topo.topoKeys, self.topo.topoOptKeys))
+        if "hop_latency" in _params:
+            net.addParam("hop_latency", _params["hop_latency"])
+        glm = getattr(self.topo, "global_link_map", None)
+        if glm is not None:
+            net.addParam("dragonfly:global_link_map", "[" + ",".join([str(x) for x in glm]) + "]")
+
+        for l in xrange(int(_params["num_peers"])):
+            ep = self._getEndPoint(l).build(l, {})
+            if ep:
+                link = sst.Link("flowlink:%d"%l)
+                link.connect(ep, (net, "port%d"%l, _params["link_lat"]) )
+
+
 
 ############################################################################
 
@@ -1128,7 +1201,7 @@ class Pt2ptEndPoint(EndPoint):
         #self.enableAllStats = False;
         #self.statInterval = "0"
         self.epKeys.extend(["link_bw", "packet_size", "packets_to_send", "buffer_size", "src", "dest"])
-        self.epOptKeys.extend(["linkcontrol"])
+        self.epOptKeys.extend(["linkcontrol", "packet_sizes"])
 
     def getName(self):
         return "pt2pt Test End Point"
@@ -1159,7 +1232,7 @@ class OfferedLoadEndPoint(EndPoint):
         #self.enableAllStats = False;
         #self.statInterval = "0"
         self.epKeys.extend(["offered_load", "num_peers", "link_bw", "message_size", "buffer_size", "pattern"])
-        self.epOptKeys.extend(["linkcontrol"])
+        self.epOptKeys.extend(["linkcontrol", "warmup_time", "collect_time", "drain_time", "latency_bin_size", "latency_bins"])
 
     def getName(self):
         return "Offered Load End Point"
@@ -16,17 +16,742 @@
 #include <sst_config.h>
 #include <Python.h>
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "pymodule.h"
 
 static char pymerlin[] = {
 #include "pymerlin.inc"
     0x00};
 
+
+/*
+ * Native topology builders.  These create the same components, links
+ * and names as the build() methods of the pymerlin topologies, but do
+ * the loops in C and give every router the same params dict instead of
+ * building one per router.  Endpoints are still built by calling back
+ * into python.
+ */
+
+#define NAME_LEN 256
+
+typedef struct {
+    PyObject* component;    // sst.Component
+    PyObject* link;         // sst.Link
+    PyObject* links;        // dict of links created so far, by name
+    PyObject* params;       // params shared by all routers
+    PyObject* link_lat;
+    PyObject* ep_func;      // ep_func(node_id) returns endpoint tuple or None
+    int bundle;
+} BuildContext;
+
+static int initContext(BuildContext* ctx, PyObject* params, PyObject* link_lat, PyObject* ep_func, int bundle)
+{
+    memset(ctx, 0, sizeof(BuildContext));
+    PyObject* sst = PyImport_ImportModule("sst");
+    if ( sst == NULL ) return -1;
+    ctx->component = PyObject_GetAttrString(sst, "Component");
+    ctx->link = PyObject_GetAttrString(sst, "Link");
+    Py_DECREF(sst);
+    ctx->links = PyDict_New();
+    ctx->params = params;
+    ctx->link_lat = link_lat;
+    ctx->ep_func = ep_func;
+    ctx->bundle = bundle;
+    if ( ctx->component == NULL || ctx->link == NULL || ctx->links == NULL ) return -1;
+    return 0;
+}
+
+static void freeContext(BuildContext* ctx)
+{
+    Py_XDECREF(ctx->component);
+    Py_XDECREF(ctx->link);
+    Py_XDECREF(ctx->links);
+}
+
+// Returns a new reference to a router with the shared params and id set
+static PyObject* newRouter(BuildContext* ctx, const char* name, long id)
+{
+    PyObject* rtr = PyObject_CallFunction(ctx->component, "ss", name, "merlin.hr_router");
+    if ( rtr == NULL ) return NULL;
+    PyObject* ret = PyObject_CallMethod(rtr, "addParams", "O", ctx->params);
+    if ( ret == NULL ) goto fail;
+    Py_DECREF(ret);
+    ret = PyObject_CallMethod(rtr, "addParam", "sl", "id", id);
+    if ( ret == NULL ) goto fail;
+    Py_DECREF(ret);
+    return rtr;
+
+fail:
+    Py_DECREF(rtr);
+    return NULL;
+}
+
+// Returns a new reference to a new link
+static PyObject* newLink(BuildContext* ctx, const char* name)
+{
+    return PyObject_CallFunction(ctx->link, "s", name);
+}
+
+// Returns a borrowed reference to the link called name, creating it on
+// first use
+static PyObject* getLink(BuildContext* ctx, const char* name)
+{
+    PyObject* link = PyDict_GetItemString(ctx->links, name);
+    if ( link != NULL ) return link;
+    link = newLink(ctx, name);
+    if ( link == NULL ) return NULL;
+    if ( PyDict_SetItemString(ctx->links, name, link) < 0 ) {
+        Py_DECREF(link);
+        return NULL;
+    }
+    Py_DECREF(link);
+    return link;
+}
+
+static int addLink(BuildContext* ctx, PyObject* rtr, PyObject* link, int port)
+{
+    char port_name[32];
+    snprintf(port_name, sizeof(port_name), "port%d", port);
+    PyObject* ret = PyObject_CallMethod(rtr, "addLink", "OsO", link, port_name, ctx->link_lat);
+    if ( ret == NULL ) return -1;
+    Py_DECREF(ret);
+    return 0;
+}
+
+// Returns a new reference to the endpoint tuple for node_id, which may
+// be None
+static PyObject* buildEndPoint(BuildContext* ctx, long node_id)
+{
+    return PyObject_CallFunction(ctx->ep_func, "l", node_id);
+}
+
+// Builds endpoint node_id and connects it to port of rtr with a link
+// called link_name
+static int connectEndPoint(BuildContext* ctx, long node_id, PyObject* rtr, int port, const char* link_name)
+{
+    PyObject* ep = buildEndPoint(ctx, node_id);
+    if ( ep == NULL ) return -1;
+    if ( !PyObject_IsTrue(ep) ) {
+        Py_DECREF(ep);
+        return 0;
+    }
+
+    int rc = -1;
+    char port_name[32];
+    PyObject* ret;
+    PyObject* link = newLink(ctx, link_name);
+    if ( link == NULL ) goto done;
+    if ( ctx->bundle ) {
+        ret = PyObject_CallMethod(link, "setNoCut", NULL);
+        if ( ret == NULL ) goto done;
+        Py_DECREF(ret);
+    }
+    snprintf(port_name, sizeof(port_name), "port%d", port);
+    ret = PyObject_CallMethod(link, "connect", "O(OsO)", ep, rtr, port_name, ctx->link_lat);
+    if ( ret == NULL ) goto done;
+    Py_DECREF(ret);
+    rc = 0;
+
+done:
+    Py_XDECREF(link);
+    Py_DECREF(ep);
+    return rc;
+}
+
+// Copies a python sequence of ints into a new array
+static long* toLongArray(PyObject* seq, int* size)
+{
+    PyObject* fast = PySequence_Fast(seq, "expected a sequence of ints");
+    if ( fast == NULL ) return NULL;
+    Py_ssize_t n = PySequence_Fast_GET_SIZE(fast);
+    long* array = (long*)malloc((n > 0 ? n : 1) * sizeof(long));
+    if ( array == NULL ) {
+        Py_DECREF(fast);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    for ( Py_ssize_t i = 0; i < n; i++ ) {
+        array[i] = PyLong_AsLong(PySequence_Fast_GET_ITEM(fast, i));
+    }
+    Py_DECREF(fast);
+    if ( PyErr_Occurred() ) {
+        free(array);
+        return NULL;
+    }
+    *size = (int)n;
+    return array;
+}
+
+// Same format as formatShape() in pymerlin: "x" separated coordinates
+static void formatShape(char* buf, const long* loc, int nd)
+{
+    int len = 0;
+    for ( int i = 0; i < nd; i++ ) {
+        len += snprintf(buf + len, NAME_LEN - len, i == 0 ? "%ld" : "x%ld", loc[i]);
+    }
+}
+
+static void idToLoc(long id, const long* dims, int nd, long* loc)
+{
+    for ( int i = 0; i < nd; i++ ) {
+        loc[i] = id % dims[i];
+        id /= dims[i];
+    }
+}
+
+
+// _buildTorus(params, shape, width, local_ports, link_lat, ep_func, bundle, mesh)
+static PyObject* buildTorus(PyObject* self, PyObject* args)
+{
+    PyObject *params, *shape, *width, *link_lat, *ep_func;
+    long local_ports;
+    int bundle, mesh;
+    if ( !PyArg_ParseTuple(args, "OOOlOOii", &params, &shape, &width, &local_ports, &link_lat, &ep_func, &bundle, &mesh) ) {
+        return NULL;
+    }
+
+    int nd, nw;
+    long* dims = toLongArray(shape, &nd);
+    if ( dims == NULL ) return NULL;
+    long* widths = toLongArray(width, &nw);
+    if ( widths == NULL ) { free(dims); return NULL; }
+
+    BuildContext ctx;
+    PyObject* result = NULL;
+    long* mydims = (long*)malloc((nd > 0 ? nd : 1) * sizeof(long));
+    long* theirdims = (long*)malloc((nd > 0 ? nd : 1) * sizeof(long));
+    char myloc[NAME_LEN], theirloc[NAME_LEN], name[3 * NAME_LEN];
+
+    if ( initContext(&ctx, params, link_lat, ep_func, bundle) < 0 ) goto done;
+    if ( mydims == NULL || theirdims == NULL ) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    long num_routers = 1;
+    for ( int i = 0; i < nd; i++ ) num_routers *= dims[i];
+
+    for ( long i = 0; i < num_routers; i++ ) {
+        idToLoc(i, dims, nd, mydims);
+        formatShape(myloc, mydims, nd);
+
+        snprintf(name, sizeof(name), "rtr.%s", myloc);
+        PyObject* rtr = newRouter(&ctx, name, i);
+        if ( rtr == NULL ) goto done;
+
+        int port = 0;
+        for ( int dim = 0; dim < nd; dim++ ) {
+            memcpy(theirdims, mydims, nd * sizeof(long));
+
+            // Positive direction
+            if ( !mesh || mydims[dim] + 1 < dims[dim] ) {
+                theirdims[dim] = (mydims[dim] + 1) % dims[dim];
+                formatShape(theirloc, theirdims, nd);
+                for ( long num = 0; num < widths[dim]; num++ ) {
+                    snprintf(name, sizeof(name), "link.%s:%s:%ld", myloc, theirloc, num);
+                    PyObject* link = getLink(&ctx, name);
+                    if ( link == NULL || addLink(&ctx, rtr, link, port) < 0 ) { Py_DECREF(rtr); goto done; }
+                    port++;
+                }
+            }
+            else {
+                port += widths[dim];
+            }
+
+            // Negative direction
+            if ( !mesh || mydims[dim] > 0 ) {
+                theirdims[dim] = ((mydims[dim] - 1) + dims[dim]) % dims[dim];
+                formatShape(theirloc, theirdims, nd);
+                for ( long num = 0; num < widths[dim]; num++ ) {
+                    snprintf(name, sizeof(name), "link.%s:%s:%ld", theirloc, myloc, num);
+                    PyObject* link = getLink(&ctx, name);
+                    if ( link == NULL || addLink(&ctx, rtr, link, port) < 0 ) { Py_DECREF(rtr); goto done; }
+                    port++;
+                }
+            }
+            else {
+                port += widths[dim];
+            }
+        }
+
+        for ( long n = 0; n < local_ports; n++ ) {
+            snprintf(name, sizeof(name), "nic.%ld:%ld", i, n);
+            if ( connectEndPoint(&ctx, local_ports * i + n, rtr, port, name) < 0 ) { Py_DECREF(rtr); goto done; }
+            port++;
+        }
+        Py_DECREF(rtr);
+    }
+
+    Py_INCREF(Py_None);
+    result = Py_None;
+
+done:
+    freeContext(&ctx);
+    free(dims);
+    free(widths);
+    free(mydims);
+    free(theirdims);
+    return result;
+}
+
+
+// _buildHyperX(params, shape, width, local_ports, link_lat, ep_func, bundle)
+static PyObject* buildHyperX(PyObject* self, PyObject* args)
+{
+    PyObject *params, *shape, *width, *link_lat, *ep_func;
+    long local_ports;
+    int bundle;
+    if ( !PyArg_ParseTuple(args, "OOOlOOi", &params, &shape, &width, &local_ports, &link_lat, &ep_func, &bundle) ) {
+        return NULL;
+    }
+
+    int nd, nw;
+    long* dims = toLongArray(shape, &nd);
+    if ( dims == NULL ) return NULL;
+    long* widths = toLongArray(width, &nw);
+    if ( widths == NULL ) { free(dims); return NULL; }
+
+    BuildContext ctx;
+    PyObject* result = NULL;
+    long* mydims = (long*)malloc((nd > 0 ? nd : 1) * sizeof(long));
+    long* theirdims = (long*)malloc((nd > 0 ? nd : 1) * sizeof(long));
+    char myloc[NAME_LEN], theirloc[NAME_LEN], name[3 * NAME_LEN];
+
+    if ( initContext(&ctx, params, link_lat, ep_func, bundle) < 0 ) goto done;
+    if ( mydims == NULL || theirdims == NULL ) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    long num_routers = 1;
+    for ( int i = 0; i < nd; i++ ) num_routers *= dims[i];
+
+    for ( long i = 0; i < num_routers; i++ ) {
+        idToLoc(i, dims, nd, mydims);
+        formatShape(myloc, mydims, nd);
+
+        snprintf(name, sizeof(name), "rtr.%s", myloc);
+        PyObject* rtr = newRouter(&ctx, name, i);
+        if ( rtr == NULL ) goto done;
+
+        // Connect to all routers that only differ in one location index
+        int port = 0;
+        for ( int dim = 0; dim < nd; dim++ ) {
+            memcpy(theirdims, mydims, nd * sizeof(long));
+            for ( long router = 0; router < dims[dim]; router++ ) {
+                if ( router == mydims[dim] ) continue;
+                theirdims[dim] = router;
+                formatShape(theirloc, theirdims, nd);
+                // Names are sorted so both ends find the same link
+                int mine_first = strcmp(myloc, theirloc) < 0;
+                for ( long num = 0; num < widths[dim]; num++ ) {
+                    snprintf(name, sizeof(name), "link.%s:%s:%ld",
+                             mine_first ? myloc : theirloc, mine_first ? theirloc : myloc, num);
+                    PyObject* link = getLink(&ctx, name);
+                    if ( link == NULL || addLink(&ctx, rtr, link, port) < 0 ) { Py_DECREF(rtr); goto done; }
+                    port++;
+                }
+            }
+        }
+
+        for ( long n = 0; n < local_ports; n++ ) {
+            snprintf(name, sizeof(name), "nic.%ld:%ld", i, n);
+            if ( connectEndPoint(&ctx, local_ports * i + n, rtr, port, name) < 0 ) { Py_DECREF(rtr); goto done; }
+            port++;
+        }
+        Py_DECREF(rtr);
+    }
+
+    Py_INCREF(Py_None);
+    result = Py_None;
+
+done:
+    freeContext(&ctx);
+    free(dims);
+    free(widths);
+    free(mydims);
+    free(theirdims);
+    return result;
+}
+
+
+typedef struct {
+    BuildContext ctx;
+    long* downs;
+    long* ups;
+    long* routers_per_level;
+    long* groups_per_level;
+    long* start_ids;
+} FatTreeContext;
+
+static int addFatTreeRouter(FatTreeContext* ft, const char* name, long id, long num_ports, PyObject** links, int num_links)
+{
+    PyObject* rtr = newRouter(&ft->ctx, name, id);
+    if ( rtr == NULL ) return -1;
+    int rc = -1;
+    PyObject* ret = PyObject_CallMethod(rtr, "addParam", "sl", "num_ports", num_ports);
+    if ( ret == NULL ) goto done;
+    Py_DECREF(ret);
+    for ( int l = 0; l < num_links; l++ ) {
+        if ( addLink(&ft->ctx, rtr, links[l], l) < 0 ) goto done;
+    }
+    rc = 0;
+
+done:
+    Py_DECREF(rtr);
+    return rc;
+}
+
+// Creates the down links of a group.  rtr_links[i] gets the down links
+// of router i, and group_links[j] the links down to subgroup j.
+static int makeDownLinks(FatTreeContext* ft, int level, long group, long rtrs_in_group,
+                         PyObject*** rtr_links, PyObject*** group_links)
+{
+    char name[NAME_LEN];
+    long downs = ft->downs[level];
+    for ( long i = 0; i < rtrs_in_group; i++ ) {
+        for ( long j = 0; j < downs; j++ ) {
+            snprintf(name, sizeof(name), "link_l%d_g%ld_r%ld_p%ld", level, group, i, j);
+            PyObject* link = newLink(&ft->ctx, name);
+            if ( link == NULL ) return -1;
+            rtr_links[i][j] = link;
+            group_links[j][i] = link;
+        }
+    }
+    return 0;
+}
+
+// Returns NULL with a python exception set if out of memory
+static PyObject*** newLinkTable(long rows, long cols)
+{
+    PyObject*** table = (PyObject***)calloc(rows > 0 ? rows : 1, sizeof(PyObject**));
+    if ( table == NULL ) {
+        PyErr_NoMemory();
+        return NULL;
+    }
+    for ( long i = 0; i < rows; i++ ) {
+        table[i] = (PyObject**)calloc(cols > 0 ? cols : 1, sizeof(PyObject*));
+        if ( table[i] == NULL ) {
+            for ( long j = 0; j < i; j++ ) free(table[j]);
+            free(table);
+            PyErr_NoMemory();
+            return NULL;
+        }
+    }
+    return table;
+}
+
+static void freeLinkTable(PyObject*** table, long rows, long cols, int owned)
+{
+    if ( table == NULL ) return;
+    for ( long i = 0; i < rows; i++ ) {
+        if ( owned ) {
+            for ( long j = 0; j < cols; j++ ) Py_XDECREF(table[i][j]);
+        }
+        free(table[i]);
+    }
+    free(table);
+}
+
+// Same recursion as fattree_rb() in pymerlin.  links are the up links
+// of this group.
+static int fatTreeBuildGroup(FatTreeContext* ft, int level, long group, PyObject** links, long num_links)
+{
+    char name[NAME_LEN];
+    long id = ft->start_ids[level] + group * (ft->routers_per_level[level] / ft->groups_per_level[level]);
+
+    if ( level == 0 ) {
+        // Create all the nodes
+        long downs = ft->downs[0];
+        PyObject** host_links = (PyObject**)calloc(downs > 0 ? downs : 1, sizeof(PyObject*));
+        if ( host_links == NULL ) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        int num_host_links = 0;
+        int rc = -1;
+        for ( long i = 0; i < downs; i++ ) {
+            long node_id = id * downs + i;
+            PyObject* ep = buildEndPoint(&ft->ctx, node_id);
+            if ( ep == NULL ) goto host_done;
+            if ( PyObject_IsTrue(ep) ) {
+                snprintf(name, sizeof(name), "hostlink_%ld", node_id);
+                PyObject* hlink = newLink(&ft->ctx, name);
+                PyObject* ret;
+                if ( hlink == NULL ) { Py_DECREF(ep); goto host_done; }
+                host_links[num_host_links++] = hlink;
+                if ( ft->ctx.bundle ) {
+                    ret = PyObject_CallMethod(hlink, "setNoCut", NULL);
+                    if ( ret == NULL ) { Py_DECREF(ep); goto host_done; }
+                    Py_DECREF(ret);
+                }
+                // ep[0].addLink(hlink, ep[1], ep[2])
+                PyObject* comp = PySequence_GetItem(ep, 0);
+                PyObject* port = PySequence_GetItem(ep, 1);
+                PyObject* lat = PySequence_GetItem(ep, 2);
+                ret = NULL;
+                if ( comp != NULL && port != NULL && lat != NULL ) {
+                    ret = PyObject_CallMethod(comp, "addLink", "OOO", hlink, port, lat);
+                }
+                Py_XDECREF(comp);
+                Py_XDECREF(port);
+                Py_XDECREF(lat);
+                if ( ret == NULL ) { Py_DECREF(ep); goto host_done; }
+                Py_DECREF(ret);
+            }
+            Py_DECREF(ep);
+        }
+
+        // Create the edge router.  Up links start after all the down
+        // ports, even if some hosts were not built.
+        {
+            snprintf(name, sizeof(name), "rtr_l0_g%ld_r0", group);
+            int ok = 0;
+            PyObject* rtr = newRouter(&ft->ctx, name, id);
+            if ( rtr != NULL ) {
+                PyObject* ret = PyObject_CallMethod(rtr, "addParam", "sl", "num_ports", ft->ups[0] + downs);
+                ok = ret != NULL;
+                Py_XDECREF(ret);
+                for ( int l = 0; ok && l < num_host_links; l++ ) {
+                    ok = addLink(&ft->ctx, rtr, host_links[l], l) == 0;
+                }
+                for ( long l = 0; ok && l < num_links; l++ ) {
+                    ok = addLink(&ft->ctx, rtr, links[l], l + downs) == 0;
+                }
+                Py_DECREF(rtr);
+            }
+            if ( ok ) rc = 0;
+        }
+
+    host_done:
+        for ( int l = 0; l < num_host_links; l++ ) Py_DECREF(host_links[l]);
+        free(host_links);
+        return rc;
+    }
+
+    long rtrs_in_group = ft->routers_per_level[level] / ft->groups_per_level[level];
+    long downs = ft->downs[level];
+    int rc = -1;
+
+    // Down links, plus room for this router's share of the up links
+    long max_links = downs + (num_links + rtrs_in_group - 1) / rtrs_in_group;
+    PyObject*** rtr_links = newLinkTable(rtrs_in_group, max_links);
+    PyObject*** group_links = newLinkTable(downs, rtrs_in_group);
+    long* rtr_num_links = (long*)calloc(rtrs_in_group > 0 ? rtrs_in_group : 1, sizeof(long));
+    if ( rtr_links == NULL || group_links == NULL ) goto done;
+    if ( rtr_num_links == NULL ) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    if ( makeDownLinks(ft, level, group, rtrs_in_group, rtr_links, group_links) < 0 ) goto done;
+    for ( long i = 0; i < rtrs_in_group; i++ ) rtr_num_links[i] = downs;
+
+    for ( long i = 0; i < downs; i++ ) {
+        if ( fatTreeBuildGroup(ft, level - 1, group * downs + i, group_links[i], rtrs_in_group) < 0 ) goto done;
+    }
+
+    // Create the routers in this level.  Start by adding up links to
+    // rtr_links
+    for ( long i = 0; i < num_links; i++ ) {
+        long r = i % rtrs_in_group;
+        Py_INCREF(links[i]);
+        rtr_links[r][rtr_num_links[r]++] = links[i];
+    }
+
+    for ( long i = 0; i < rtrs_in_group; i++ ) {
+        snprintf(name, sizeof(name), "rtr_l%d_g%ld_r%ld", level, group, i);
+        if ( addFatTreeRouter(ft, name, id + i, ft->ups[level] + downs, rtr_links[i], rtr_num_links[i]) < 0 ) goto done;
+    }
+    rc = 0;
+
+done:
+    freeLinkTable(rtr_links, rtrs_in_group, max_links, 1);
+    freeLinkTable(group_links, downs, rtrs_in_group, 0);
+    free(rtr_num_links);
+    return rc;
+}
+
+// _buildFatTree(params, downs, ups, routers_per_level, groups_per_level, start_ids, link_lat, ep_func, bundle)
+static PyObject* buildFatTree(PyObject* self, PyObject* args)
+{
+    PyObject *params, *downs, *ups, *rpl, *gpl, *start_ids, *link_lat, *ep_func;
+    int bundle;
+    if ( !PyArg_ParseTuple(args, "OOOOOOOOi", &params, &downs, &ups, &rpl, &gpl, &start_ids, &link_lat, &ep_func, &bundle) ) {
+        return NULL;
+    }
+
+    FatTreeContext ft;
+    int num_downs, num_ups, n;
+    memset(&ft, 0, sizeof(ft));
+    PyObject* result = NULL;
+
+    ft.downs = toLongArray(downs, &num_downs);
+    ft.ups = toLongArray(ups, &num_ups);
+    ft.routers_per_level = toLongArray(rpl, &n);
+    ft.groups_per_level = toLongArray(gpl, &n);
+    ft.start_ids = toLongArray(start_ids, &n);
+    if ( ft.downs == NULL || ft.ups == NULL || ft.routers_per_level == NULL ||
+         ft.groups_per_level == NULL || ft.start_ids == NULL ) goto done;
+
+    if ( initContext(&ft.ctx, params, link_lat, ep_func, bundle) < 0 ) goto done;
+
+    // Single level trees have no routers built, same as pymerlin
+    if ( num_ups > 0 ) {
+        int level = num_ups;
+        long rtrs_in_group = ft.routers_per_level[level] / ft.groups_per_level[level];
+        long radix = ft.downs[level];
+        PyObject*** rtr_links = newLinkTable(rtrs_in_group, radix);
+        PyObject*** group_links = newLinkTable(radix, rtrs_in_group);
+        char name[NAME_LEN];
+        int ok = rtr_links != NULL && group_links != NULL &&
+            makeDownLinks(&ft, level, 0, rtrs_in_group, rtr_links, group_links) == 0;
+
+        for ( long i = 0; ok && i < radix; i++ ) {
+            ok = fatTreeBuildGroup(&ft, level - 1, i, group_links[i], rtrs_in_group) == 0;
+        }
+
+        // Create the routers in this level
+        for ( long i = 0; ok && i < ft.routers_per_level[level]; i++ ) {
+            snprintf(name, sizeof(name), "rtr_l%d_g0_r%ld", level, i);
+            ok = addFatTreeRouter(&ft, name, ft.start_ids[level] + i, radix, rtr_links[i], radix) == 0;
+        }
+
+        freeLinkTable(rtr_links, rtrs_in_group, radix, 1);
+        freeLinkTable(group_links, radix, rtrs_in_group, 0);
+        if ( !ok ) goto done;
+    }
+
+    Py_INCREF(Py_None);
+    result = Py_None;
+
+done:
+    freeContext(&ft.ctx);
+    free(ft.downs);
+    free(ft.ups);
+    free(ft.routers_per_level);
+    free(ft.groups_per_level);
+    free(ft.start_ids);
+    return result;
+}
+
+
+// _buildDragonFly2(params, hosts_per_router, routers_per_group, num_groups,
+//                  intergroup_per_router, global_link_map, relative, link_lat, ep_func, bundle)
+static PyObject* buildDragonFly2(PyObject* self, PyObject* args)
+{
+    PyObject *params, *glm_obj, *link_lat, *ep_func;
+    long hpr, rpg, num_groups, igpr;
+    int relative, bundle;
+    if ( !PyArg_ParseTuple(args, "OllllOiOOi", &params, &hpr, &rpg, &num_groups, &igpr,
+                           &glm_obj, &relative, &link_lat, &ep_func, &bundle) ) {
+        return NULL;
+    }
+
+    int glm_size;
+    long* glm = toLongArray(glm_obj, &glm_size);
+    if ( glm == NULL ) return NULL;
+    if ( glm_size < rpg * igpr ) {
+        free(glm);
+        PyErr_SetString(PyExc_ValueError, "global_link_map is smaller than routers_per_group * intergroup_per_router");
+        return NULL;
+    }
+
+    BuildContext ctx;
+    PyObject* result = NULL;
+    char name[NAME_LEN];
+    long ng = num_groups - 1;   // don't count my group
+    long router_num = 0;
+    long nic_num = 0;
+
+    if ( initContext(&ctx, params, link_lat, ep_func, bundle) < 0 ) goto done;
+
+    for ( long g = 0; g < num_groups; g++ ) {
+        for ( long r = 0; r < rpg; r++ ) {
+            snprintf(name, sizeof(name), "rtr:G%ldR%ld", g, r);
+            PyObject* rtr = newRouter(&ctx, name, router_num);
+            if ( rtr == NULL ) goto done;
+            if ( router_num == 0 ) {
+                PyObject* ret = PyObject_CallMethod(rtr, "addParam", "sO", "dragonfly:global_link_map", glm_obj);
+                if ( ret == NULL ) { Py_DECREF(rtr); goto done; }
+                Py_DECREF(ret);
+            }
+
+            int port = 0;
+            for ( long p = 0; p < hpr; p++ ) {
+                snprintf(name, sizeof(name), "link:g%ldr%ldh%ld", g, r, p);
+                if ( connectEndPoint(&ctx, nic_num, rtr, port, name) < 0 ) { Py_DECREF(rtr); goto done; }
+                nic_num++;
+                port++;
+            }
+
+            for ( long p = 0; p < rpg; p++ ) {
+                if ( p == r ) continue;
+                snprintf(name, sizeof(name), "link:g%ldr%ldr%ld", g, p < r ? p : r, p < r ? r : p);
+                PyObject* link = getLink(&ctx, name);
+                if ( link == NULL || addLink(&ctx, rtr, link, port) < 0 ) { Py_DECREF(rtr); goto done; }
+                port++;
+            }
+
+            for ( long p = 0; p < igpr; p++ ) {
+                long raw_dest = glm[r * igpr + p];
+                if ( raw_dest != -1 ) {
+                    long link_num = raw_dest / ng;
+                    long dest_grp = raw_dest - link_num * ng;
+                    if ( relative ) {
+                        dest_grp = (dest_grp + g + 1) % (ng + 1);
+                    }
+                    else if ( dest_grp >= g ) {
+                        dest_grp = dest_grp + 1;
+                    }
+                    snprintf(name, sizeof(name), "link:g%ldg%ldr%ld",
+                             dest_grp < g ? dest_grp : g, dest_grp < g ? g : dest_grp, link_num);
+                    PyObject* link = getLink(&ctx, name);
+                    if ( link == NULL || addLink(&ctx, rtr, link, port) < 0 ) { Py_DECREF(rtr); goto done; }
+                }
+                port++;
+            }
+
+            Py_DECREF(rtr);
+            router_num++;
+        }
+    }
+
+    Py_INCREF(Py_None);
+    result = Py_None;
+
+done:
+    freeContext(&ctx);
+    free(glm);
+    return result;
+}
+
+
+static PyMethodDef builderMethods[] = {
+    { "_buildTorus", buildTorus, METH_VARARGS, "Native build of a torus or mesh" },
+    { "_buildHyperX", buildHyperX, METH_VARARGS, "Native build of a hyperx" },
+    { "_buildFatTree", buildFatTree, METH_VARARGS, "Native build of a fattree" },
+    { "_buildDragonFly2", buildDragonFly2, METH_VARARGS, "Native build of a dragonfly2" },
+    { NULL, NULL, 0, NULL }
+};
+
+
 void* genMerlinPyModule(void)
 {
     // Must return a PyObject
 
     PyObject *code = Py_CompileString(pymerlin, "pymerlin", Py_file_input);
-    return PyImport_ExecCodeModule("sst.merlin", code);
-}
+    PyObject *module = PyImport_ExecCodeModule("sst.merlin", code);
+    if ( module == NULL ) return NULL;
 
+    // Add the native builders.  pymerlin looks them up when build() is
+    // called.
+    for ( PyMethodDef* def = builderMethods; def->ml_name != NULL; def++ ) {
+        PyObject* func = PyCFunction_NewEx(def, NULL, NULL);
+        if ( func == NULL || PyModule_AddObject(module, def->ml_name, func) < 0 ) return NULL;
+    }
+    return module;
+}
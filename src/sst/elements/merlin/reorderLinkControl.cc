@@ -34,10 +34,20 @@ ReorderLinkControl::ReorderLinkControl(Component* parent, Params &params) :
 {
     std::string networkIF = params.find<std::string>("rlc:networkIF", "merlin.linkcontrol");
     link_control = static_cast<SST::Interfaces::SimpleNetwork*>(loadSubComponent(networkIF, params));
+
+    first_seq = params.find<uint32_t>("rlc:first_seq", 0);
+
+    int num_peers = params.find<int>("rlc:num_peers", 0);
+    if ( num_peers > 0 ) dense_info.resize(num_peers, ReorderInfo(first_seq));
 }
 
 ReorderLinkControl::~ReorderLinkControl() {
     delete [] input_buf;
+    for ( auto& info : dense_info ) info.clear();
+    for ( auto& entry : reorder_info ) {
+        entry.second->clear();
+        delete entry.second;
+    }
 }
 
 bool
@@ -53,6 +63,9 @@ ReorderLinkControl::initialize(const std::string& port_name, const UnitAlgebra&
 
     // Initialize link_control
     link_control->initialize(port_name, link_bw_in, vns, in_buf_size, out_buf_size);
+
+    reorder_depth = registerStatistic<uint64_t>("reorder_depth");
+    reorder_stall_time = registerStatistic<uint64_t>("reorder_stall_time");
     
     return true;
 }
@@ -93,7 +106,8 @@ void ReorderLinkControl::finish(void)
     //     }
     // }
 
-    // TODO: Need to delete reordered data as well
+    for ( auto& info : dense_info ) info.clear();
+    for ( auto& entry : reorder_info ) entry.second->clear();
     
     link_control->finish();
 }
@@ -110,12 +124,7 @@ bool ReorderLinkControl::send(SimpleNetwork::Request* req, int vn) {
     
     // Need to put in the sequence number
     
-    // See if we already have reorder_info for this dest
-    if ( reorder_info.find(my_req->dest) == reorder_info.end() ) {
-        ReorderInfo* info = new ReorderInfo();
-        reorder_info[my_req->dest] = info;
-    }
-    ReorderInfo* info = reorder_info[my_req->dest];
+    ReorderInfo* info = getReorderInfo(my_req->dest);
     my_req->seq = info->send++;
 
     // // To test, just going to switch order
@@ -190,26 +199,26 @@ bool ReorderLinkControl::handle_event(int vn) {
 
     // std::cout << id << ": recieved packet with sequence number " << my_req->seq << std::endl;
     
-    if ( reorder_info.find(my_req->src) == reorder_info.end() ) {
-        ReorderInfo* info = new ReorderInfo();
-        reorder_info[my_req->src] = info;
-    }
-
-    ReorderInfo* info = reorder_info[my_req->src];
+    ReorderInfo* info = getReorderInfo(my_req->src);
 
     // See if this is the expected sequence number, if not, put it
-    // into the ReorderInfo.queue.
+    // into the reorder window.
     if ( my_req->seq == info->recv ) {
+        bool stalled = info->count != 0;
         input_buf[my_req->vn].push(my_req);
         info->recv++;
         // Need to also see if we have any other fragments which are
         // now ready to be delivered
-        my_req = info->queue.top();
-        while ( my_req->seq == info->recv ) {
+        while ( (my_req = info->next()) != NULL ) {
             input_buf[my_req->vn].push(my_req);
-            info->queue.pop();
-            my_req = info->queue.top();
-            info->recv++;
+        }
+
+        // The gap is filled.  If packets are still held, there is a
+        // new gap starting now.
+        if ( stalled ) {
+            SimTime_t now = parent->getCurrentSimTimeNano();
+            reorder_stall_time->addData(now - info->stall_start);
+            info->stall_start = now;
         }
 
         // If there is a recv functor, need to notify parent
@@ -224,7 +233,9 @@ bool ReorderLinkControl::handle_event(int vn) {
         
     }
     else {
-        info->queue.push(my_req);
+        if ( info->count == 0 ) info->stall_start = parent->getCurrentSimTimeNano();
+        info->insert(my_req);
+        reorder_depth->addData(info->count);
     }
 
     return true;
@@ -29,6 +29,7 @@
 
 #include <queue>
 #include <unordered_map>
+#include <vector>
 
 namespace SST {
 
@@ -65,19 +66,6 @@ public:
 
     ~ReorderRequest() {}
 
-    
-    // This is here just for the priority_queue insertion, so is
-    // sorting based on what comes out of queue first (i.e. lowest
-    // number, which makes this look backwards)
-    class Priority {
-    public:
-        bool operator()(ReorderRequest* const& lhs, ReorderRequest* const& rhs) {
-            return lhs->seq > rhs->seq;
-        }    
-    };
-
-    typedef std::priority_queue<ReorderRequest*, std::vector<ReorderRequest*>, Priority> PriorityQueue;
-
     void serialize_order(SST::Core::Serialization::serializer &ser)  override {
         SST::Interfaces::SimpleNetwork::Request::serialize_order(ser);
         ser & seq;
@@ -89,29 +77,66 @@ private:
 
 
 
+// Sequence state for one peer.  Packets that arrive ahead of recv are
+// held in a circular window indexed by sequence number, which doubles
+// in size when a packet lands past its end.  Sequence numbers are
+// compared as distances from recv, so they can wrap.
 struct ReorderInfo {
     uint32_t send;
     uint32_t recv;
-    ReorderRequest::PriorityQueue queue;
-
-    ReorderInfo() :
-        send(0),
-        recv(0)
-    {
-        // Put a dummy entry into queue to avoid checks for NULL later
-        // on when looking for fragments to deliver.  This does mean
-        // we can't handle more than 4 billion fragments to each host
-        // with overflow.
-        ReorderRequest* req = new ReorderRequest();
-        req->seq = 0xffffffff;
-        queue.push(req);
+    uint32_t count;                     // Packets held in window
+    SimTime_t stall_start;              // When the current gap at recv opened
+    std::vector<ReorderRequest*> window;
+
+    ReorderInfo(uint32_t first_seq = 0) :
+        send(first_seq),
+        recv(first_seq),
+        count(0),
+        stall_start(0)
+    {}
+
+    void insert(ReorderRequest* req) {
+        uint32_t dist = req->seq - recv;
+        if ( dist >= window.size() ) grow(dist + 1);
+        window[req->seq & (window.size() - 1)] = req;
+        count++;
+    }
+
+    // Returns the packet with sequence number recv and advances recv,
+    // or NULL if it hasn't arrived
+    ReorderRequest* next() {
+        if ( count == 0 ) return NULL;
+        ReorderRequest*& slot = window[recv & (window.size() - 1)];
+        ReorderRequest* req = slot;
+        if ( req == NULL ) return NULL;
+        slot = NULL;
+        count--;
+        recv++;
+        return req;
+    }
+
+    void clear() {
+        for ( auto req : window ) delete req;
+        window.clear();
+        count = 0;
+    }
+
+private:
+    void grow(uint32_t min_size) {
+        size_t size = window.empty() ? 16 : window.size();
+        while ( size < min_size ) size *= 2;
+
+        std::vector<ReorderRequest*> new_window(size, NULL);
+        for ( auto req : window ) {
+            if ( req != NULL ) new_window[req->seq & (size - 1)] = req;
+        }
+        window.swap(new_window);
     }
 };
 
 // Version of LinkControl that will allow out of order receive, but
 // will make things appear in order to NIC.  The current version will
-// have essentially infinite resources and is here just to get
-// functionality working.
+// have essentially infinite resources.
 class ReorderLinkControl : public SST::Interfaces::SimpleNetwork {
 public:
 
@@ -124,7 +149,14 @@ public:
         "SST::Interfaces::SimpleNetwork")
     
     SST_ELI_DOCUMENT_PARAMS(
-        {"rlc:networkIF","SimpleNetwork subcomponent to be used for connecting to network", "merlin.linkcontrol"}
+        {"rlc:networkIF","SimpleNetwork subcomponent to be used for connecting to network", "merlin.linkcontrol"},
+        {"rlc:num_peers","Number of endpoints in the network.  If set, per peer state is kept in an array instead of a hash map.", "0"},
+        {"rlc:first_seq","Sequence number of the first packet to each peer.  Only useful for testing sequence number wraparound.", "0"}
+    )
+
+    SST_ELI_DOCUMENT_STATISTICS(
+        { "reorder_depth", "Number of packets held for a peer, sampled when an out of order packet arrives", "packets", 1},
+        { "reorder_stall_time", "Time from a gap opening in a peer's sequence until it is filled", "ns", 1}
     )
 
     
@@ -138,7 +170,14 @@ private:
     UnitAlgebra link_bw;
     int id;
 
+    // Per peer state, dense when rlc:num_peers is given.  Peers
+    // outside the dense range use the map.
+    std::vector<ReorderInfo> dense_info;
     std::unordered_map<SST::Interfaces::SimpleNetwork::nid_t, ReorderInfo*> reorder_info;
+    uint32_t first_seq;
+
+    Statistic<uint64_t>* reorder_depth;
+    Statistic<uint64_t>* reorder_stall_time;
     
     // One buffer for each virtual network.  At the NIC level, we just
     // provide a virtual channel abstraction.  Don't need output
@@ -197,6 +236,13 @@ public:
     
 private:
 
+    inline ReorderInfo* getReorderInfo(SST::Interfaces::SimpleNetwork::nid_t nid) {
+        if ( nid >= 0 && (size_t)nid < dense_info.size() ) return &dense_info[nid];
+        ReorderInfo*& info = reorder_info[nid];
+        if ( info == NULL ) info = new ReorderInfo(first_seq);
+        return info;
+    }
+
     bool handle_event(int vn);
 };
 
@@ -27,6 +27,11 @@
 #include <sst/core/unitAlgebra.h>
 #include <sst/core/interfaces/simpleNetwork.h>
 
+#include <stdint.h>
+#include <vector>
+
+#include "sst/elements/merlin/eventPool.h"
+
 using namespace SST;
 
 namespace SST {
@@ -38,6 +43,63 @@ const int INIT_BROADCAST_ADDR = -1;
 
 class TopologyEvent;
     
+// Bitmask of the ports (or VCs) that have data waiting.  Set bits can
+// be visited in ascending order without looking at the idle entries:
+//   for ( int i = mask.next(0); i != -1; i = mask.next(i+1) )
+class ActiveMask {
+public:
+    ActiveMask() : count(0), bits(0) {}
+
+    void resize(int size) {
+        bits = size;
+        words.assign((size + 63) / 64, 0);
+        count = 0;
+    }
+
+    inline void set(int i) {
+        uint64_t& word = words[i >> 6];
+        uint64_t bit = (uint64_t)1 << (i & 63);
+        if ( !(word & bit) ) {
+            word |= bit;
+            count++;
+        }
+    }
+
+    inline void clear(int i) {
+        uint64_t& word = words[i >> 6];
+        uint64_t bit = (uint64_t)1 << (i & 63);
+        if ( word & bit ) {
+            word &= ~bit;
+            count--;
+        }
+    }
+
+    inline bool test(int i) const { return words[i >> 6] & ((uint64_t)1 << (i & 63)); }
+    inline bool empty() const { return count == 0; }
+    inline int size() const { return count; }
+
+    // Raw 64-bit words, bit i of the mask is bit (i & 63) of word (i >> 6)
+    inline int numWords() const { return words.size(); }
+    inline uint64_t getWord(int w) const { return words[w]; }
+
+    // Returns the first set bit at or after i, or -1 if there is none
+    inline int next(int i) const {
+        if ( i >= bits ) return -1;
+        int w = i >> 6;
+        uint64_t word = words[w] & (~(uint64_t)0 << (i & 63));
+        while ( word == 0 ) {
+            if ( ++w == (int)words.size() ) return -1;
+            word = words[w];
+        }
+        return (w << 6) + __builtin_ctzll(word);
+    }
+
+private:
+    std::vector<uint64_t> words;
+    int count;
+    int bits;
+};
+
 class Router : public Component {
 private:
     bool requestNotifyOnEvent;
@@ -53,6 +115,7 @@ protected:
     { requestNotifyOnEvent = state; }
 
     int vcs_with_data;
+    ActiveMask active_ports;
     
 public:
 
@@ -68,9 +131,14 @@ public:
    
     virtual void notifyEvent() {}
 
-    inline void inc_vcs_with_data() { vcs_with_data++; }
-    inline void dec_vcs_with_data() { vcs_with_data--; }
+    // Called by PortControl when a VC gains or loses its head event
+    inline void inc_vcs_with_data(int port) { vcs_with_data++; active_ports.set(port); }
+    inline void dec_vcs_with_data(int port, bool port_idle) {
+        vcs_with_data--;
+        if ( port_idle ) active_ports.clear(port);
+    }
     inline int get_vcs_with_data() { return vcs_with_data; }
+    inline const ActiveMask& getActivePorts() const { return active_ports; }
 
     virtual int const* getOutputBufferCredits() = 0;
     virtual void sendTopologyEvent(int port, TopologyEvent* ev) = 0;
@@ -90,6 +158,11 @@ public:
 
     inline RtrEventType getType() const { return type; }
 
+    // Router events (packets, credits and the internal events the
+    // topologies create for every hop) come from per-thread pools
+    static void* operator new(size_t size) { return EventPool::allocate(size); }
+    static void operator delete(void* ptr, size_t size) { EventPool::release(ptr, size); }
+
     void serialize_order(SST::Core::Serialization::serializer &ser)  override {
         Event::serialize_order(ser);
         ser & type;
@@ -386,19 +459,27 @@ class PortControl;
 class XbarArbitration : public SubComponent {
 public:
     XbarArbitration(Component* parent) :
-        SubComponent(parent)
+        SubComponent(parent),
+        active_ports(NULL)
     {}
     virtual ~XbarArbitration() {}
 
+    // progress_vc entries are -1 on entry and only need to be set for
+    // ports with data
 #if VERIFY_DECLOCKING
     virtual void arbitrate(PortControl** ports, int* port_busy, int* out_port_busy, int* progress_vc, bool clocking) = 0;
 #else
     virtual void arbitrate(PortControl** ports, int* port_busy, int* out_port_busy, int* progress_vc) = 0;
 #endif
     virtual void setPorts(int num_ports, int num_vcs) = 0;
+    // Ports with data waiting, arbiters only need to look at these
+    void setActivePorts(const ActiveMask* mask) { active_ports = mask; }
     virtual bool isOkayToPauseClock() { return true; }
     virtual void reportSkippedCycles(Cycle_t cycles) {};
     virtual void dumpState(std::ostream& stream) {};
+
+protected:
+    const ActiveMask* active_ports;
 	
 };
 
@@ -44,6 +44,18 @@ pt2pt_test::pt2pt_test(ComponentId_t cid, Params& params) :
     }
     if ( packet_size_ua.hasUnits("B") ) packet_size_ua *= UnitAlgebra("8b/B");
     packet_size = packet_size_ua.getRoundedValue();
+
+    std::vector<std::string> sizes;
+    params.find_array<std::string>("packet_sizes", sizes);
+    for ( size_t i = 0; i < sizes.size(); i++ ) {
+        UnitAlgebra size(sizes[i]);
+        if ( !size.hasUnits("b") && !size.hasUnits("B") ) {
+            merlin_abort.fatal(CALL_INFO,-1,"packet_sizes must be specified in either "
+                               "bits or bytes: %s\n",size.toStringBestSI().c_str());
+        }
+        if ( size.hasUnits("B") ) size *= UnitAlgebra("8b/B");
+        packet_sizes.push_back(size.getRoundedValue());
+    }
     
     packets_to_send = params.find<int>("packets_to_send",100);
     packets_recd = 0;
@@ -52,8 +64,10 @@ pt2pt_test::pt2pt_test(ComponentId_t cid, Params& params) :
 
     if ( buffer_size.hasUnits("B") ) buffer_size *= UnitAlgebra("8b/B");
 
-    if ( packet_size > buffer_size.getRoundedValue() ) {
-        merlin_abort.fatal(CALL_INFO,-1,"buffer_size must be greater than or equal to packet_size\n");
+    for ( int i = 0; i < packets_to_send && i < (int)std::max<size_t>(packet_sizes.size(), 1); i++ ) {
+        if ( sizeOfPacket(i) > buffer_size.getRoundedValue() ) {
+            merlin_abort.fatal(CALL_INFO,-1,"buffer_size must be greater than or equal to packet_size\n");
+        }
     }
     
     std::string link_control_name = params.find<std::string>("linkcontrol","merlin.linkcontrol");
@@ -100,24 +114,36 @@ void pt2pt_test::finish()
     // Compute bandwidths and write out report
     for ( auto& x : my_recvs ) {
         // Compute bandwidth in bits/core time quantum
-        UnitAlgebra bits_sent = UnitAlgebra("1b") * packets_to_send * packet_size;
+        uint64_t total_bits = 0;
+        for ( int i = 0; i < packets_to_send; i++ ) total_bits += sizeOfPacket(i);
+        UnitAlgebra bits_sent = UnitAlgebra("1b") * total_bits;
         UnitAlgebra start_time = Simulation::getSimulation()->getTimeLord()->getTimeBase() * x.second.first_arrival;
         UnitAlgebra end_time = Simulation::getSimulation()->getTimeLord()->getTimeBase() * x.second.end_arrival;
         // TODO: Still need to tweak to account for serialization latency of the last packet
         UnitAlgebra total_time = Simulation::getSimulation()->getTimeLord()->getTimeBase() * (x.second.end_arrival - x.second.first_arrival);
-        
-        UnitAlgebra bw = bits_sent / total_time;
+
+        // No time between first and last arrival with a single packet
+        std::string bw_str("n/a");
+        if ( x.second.end_arrival > x.second.first_arrival ) {
+            UnitAlgebra bw = bits_sent / total_time;
+            bw_str = bw.toStringBestSI() + " (" + (bw / UnitAlgebra("8 b/B")).toStringBestSI() + ")";
+        }
 
         Simulation::getSimulationOutput().output(
             "For src = %d and dest = %d:\n"
             "  First packet received at: %s\n"
             "  Last packet received at: %s\n"
-            "  Bandwidth: %s (%s)\n\n",
+            "  Bandwidth: %s\n\n",
             x.first, id,
             start_time.toStringBestSI().c_str(),
             end_time.toStringBestSI().c_str(),
-            bw.toStringBestSI().c_str(), (bw / UnitAlgebra("8 b/B")).toStringBestSI().c_str());
-        
+            bw_str.c_str());
+
+        if ( !packet_sizes.empty() ) {
+            Simulation::getSimulationOutput().output(
+                "  Packets received out of order: %d\n\n", x.second.out_of_order);
+        }
+
     }
 }
 
@@ -127,16 +153,7 @@ void pt2pt_test::setup()
 
     if ( my_dest != -1 ) {
         link_control->setNotifyOnSend(new SimpleNetwork::Handler<pt2pt_test>(this,&pt2pt_test::send_handler));
-        while ( link_control->spaceToSend(0,packet_size) && packets_sent < packets_to_send ) {
-            SimpleNetwork::Request* req = new SimpleNetwork::Request();
-
-            req->dest = my_dest;
-            req->src = id;
-            req->vn = 0;
-            req->size_in_bits = packet_size;
-            link_control->send(req,0);
-            ++packets_sent;
-        }
+        sendPackets();
     }
 
     if ( !my_recvs.empty() ) {
@@ -178,6 +195,7 @@ pt2pt_test::init(unsigned int phase)
         for ( int i = 0; i < dest.size(); ++i ) {
             if ( dest[i] == id ) {
                 my_recvs[src[i]].packets_recd = 0;
+                my_recvs[src[i]].out_of_order = 0;
             }
         }
 
@@ -188,16 +206,22 @@ pt2pt_test::init(unsigned int phase)
     }
 }
 
+int
+pt2pt_test::sizeOfPacket(int packet) const {
+    if ( packet_sizes.empty() ) return packet_size;
+    return packet_sizes[packet % packet_sizes.size()];
+}
+
 bool
-pt2pt_test::send_handler(int vn) {
+pt2pt_test::sendPackets() {
     // TraceFunction trace(CALL_INFO);
-    while ( link_control->spaceToSend(0,packet_size) && packets_sent < packets_to_send ) {
+    while ( packets_sent < packets_to_send && link_control->spaceToSend(0,sizeOfPacket(packets_sent)) ) {
         SimpleNetwork::Request* req = new SimpleNetwork::Request();
         
         req->dest = my_dest;
         req->src = id;
         req->vn = 0;
-        req->size_in_bits = packet_size;
+        req->size_in_bits = sizeOfPacket(packets_sent);
 
         // req->setTraceType(SimpleNetwork::Request::FULL);
         req->setTraceID(id * 100 + packets_sent);
@@ -206,8 +230,12 @@ pt2pt_test::send_handler(int vn) {
         // std::cout << id << ": Sending packet to: " << my_dest << " at " << Simulation::getSimulation()->getCurrentSimCycle() << std::endl;
         ++packets_sent;
     }
+    return packets_sent == packets_to_send;
+}
 
-    if ( packets_sent == packets_to_send ) {
+bool
+pt2pt_test::send_handler(int vn) {
+    if ( sendPackets() ) {
         primaryComponentOKToEndSim();
         return false; // remove myself from the handler list
     }
@@ -229,6 +257,10 @@ pt2pt_test::recv_handler(int vn) {
     }
     
     recv_data& data = data_it->second;
+    // Packets are numbered in their trace ids as they are sent
+    if ( req->getTraceID() != src * 100 + data.packets_recd ) {
+        data.out_of_order++;
+    }
     if ( data.packets_recd == 0 ) {
         data.first_arrival = Simulation::getSimulation()->getCurrentSimCycle();
     }
@@ -51,7 +51,8 @@ public:
         {"buffer_size",      "Size of input and output buffers specified in b or B (can include SI prefix)."},
         {"src",              "Array of IDs of NICs that will send data."},
         {"dest",             "Array of IDs of NICs to send data to."},
-        {"linkcontrol",      "SimpleNetwork class to use to talk to network."}
+        {"linkcontrol",      "SimpleNetwork class to use to talk to network."},
+        {"packet_sizes",     "Array of packet sizes in b or B, used in turn in place of packet_size.  Receivers then also report packets that arrived out of order.", ""}
     )
 
     SST_ELI_DOCUMENT_PORTS(
@@ -67,6 +68,7 @@ private:
         SimTime_t first_arrival;
         SimTime_t end_arrival;
         int packets_recd;
+        int out_of_order;
     };
     
     int id;
@@ -86,6 +88,7 @@ private:
     
     int packets_to_send;
     int packet_size;
+    std::vector<int> packet_sizes;
     UnitAlgebra buffer_size;
     
     SST::Interfaces::SimpleNetwork* link_control;
@@ -104,6 +107,8 @@ private:
     // bool clock_handler(Cycle_t cycle);
     // void handle_complete(Event* ev);
 
+    int sizeOfPacket(int packet) const;
+    bool sendPackets();
     bool send_handler(int vn);
     bool recv_handler(int vn); 
 
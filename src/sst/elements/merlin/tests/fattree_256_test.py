@@ -11,6 +11,7 @@
 # information, see the LICENSE file in the top level directory of the
 # distribution.
 
+import sys
 import sst
 from sst.merlin import *
 
@@ -35,6 +36,10 @@ if __name__ == "__main__":
     #sst.merlin._params["checkerboard"] = "1"
     sst.merlin._params["xbar_arb"] = "merlin.xbar_arb_lru"
 
+    # route_table_check.py runs this with --model-options=--route_table
+    if "--route_table" in sys.argv:
+        sst.merlin._params["fattree:route_table"] = "1"
+
     topo.prepParams()
     endPoint.prepParams()
     topo.setEndPoint(endPoint)
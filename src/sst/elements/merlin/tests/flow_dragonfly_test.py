@@ -0,0 +1,66 @@
+#!/usr/bin/env python
+#
+# Copyright 2009-2018 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2018, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+# Flow model of a dragonfly with 3 groups of 2 routers, 2 hosts per
+# router (router r has hosts 2r and 2r+1) and 1 link between each pair
+# of groups, one 1500B (12000b) message per flow, all injected at 10ns.
+# With the default global link map, router 0 of group 0 (router 0) has
+# the link to group 1, which lands on router 0 of group 1 (router 2).
+#
+#   A: 0 -> 4  global g0-g1, 2 routers
+#   B: 2 -> 4  local r1-r0, global g0-g1, 3 routers
+#   C: 1 -> 6  global g0-g1, local r2-r3, 3 routers
+#   D: 5 -> 7  local r2-r3, 2 routers
+#
+# Max-min rates with 8Gb/s links: A, B and C share the global link,
+# 8/3 Gb/s each.  D shares r2-r3 with C and gets the rest, 16/3 Gb/s.
+# D finishes at 10ns + 2.25us = 2.26us.  A, B and C are still held by
+# the global link and finish at 10ns + 4.5us = 4.51us.  Each message
+# arrives 20ns per router plus 10ns of link latency later.
+
+import sst
+from sst.merlin import *
+
+sst.merlin._params["flit_size"] = "8B"
+sst.merlin._params["link_bw"] = "1GB/s"
+sst.merlin._params["xbar_bw"] = "1GB/s"
+sst.merlin._params["input_latency"] = "0ns"
+sst.merlin._params["output_latency"] = "0ns"
+sst.merlin._params["input_buf_size"] = "1KB"
+sst.merlin._params["output_buf_size"] = "1KB"
+sst.merlin._params["link_lat"] = "10ns"
+sst.merlin._params["hop_latency"] = "20ns"
+
+sst.merlin._params["dragonfly:hosts_per_router"] = 2
+sst.merlin._params["dragonfly:routers_per_group"] = 2
+sst.merlin._params["dragonfly:intergroup_links"] = 1
+sst.merlin._params["dragonfly:num_groups"] = 3
+sst.merlin._params["dragonfly:algorithm"] = "minimal"
+
+topo = topoFlow(topoDragonFly2())
+topo.prepParams()
+
+sst.merlin._params["linkcontrol"] = "merlin.flow_linkcontrol"
+sst.merlin._params["packet_size"] = "1500B"
+sst.merlin._params["buffer_size"] = "1500B"
+sst.merlin._params["packets_to_send"] = 1
+
+sst.merlin._params["src"] = "[0, 2, 1, 5]"
+sst.merlin._params["dest"] = "[4, 4, 6, 7]"
+
+endPoint = Pt2ptEndPoint()
+endPoint.prepParams()
+
+topo.setEndPoint(endPoint)
+topo.build()
+
@@ -0,0 +1,61 @@
+#!/usr/bin/env python
+#
+# Copyright 2009-2018 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2018, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+# Flow model of a 2 level fattree with 4 edge routers of 4 hosts (edge
+# router e has hosts 4e to 4e+3) and 2 up links each, one 1500B (12000b)
+# message per flow, all injected at 10ns.  The up (and down) links of
+# an edge router are modeled as one 16Gb/s link.
+#
+#   A: 0 -> 4  up from edge 0, down to edge 1, 3 routers
+#   B: 1 -> 5  up from edge 0, down to edge 1, 3 routers
+#   C: 2 -> 6  up from edge 0, down to edge 1, 3 routers
+#   D: 7 -> 4  within edge 1, 1 router
+#
+# Max-min rates with 8Gb/s host links: A and D share host 4's link,
+# 4Gb/s each.  B and C split what A leaves of edge 0's up links, 6Gb/s
+# each.  B and C finish at 10ns + 2us = 2.01us, A and D at 10ns + 3us =
+# 3.01us.  Each message arrives 20ns per router plus 10ns of link
+# latency later.
+
+import sst
+from sst.merlin import *
+
+sst.merlin._params["flit_size"] = "8B"
+sst.merlin._params["link_bw"] = "1GB/s"
+sst.merlin._params["xbar_bw"] = "1GB/s"
+sst.merlin._params["input_latency"] = "0ns"
+sst.merlin._params["output_latency"] = "0ns"
+sst.merlin._params["input_buf_size"] = "1KB"
+sst.merlin._params["output_buf_size"] = "1KB"
+sst.merlin._params["link_lat"] = "10ns"
+sst.merlin._params["hop_latency"] = "20ns"
+
+sst.merlin._params["fattree:shape"] = "4,2:4"
+
+topo = topoFlow(topoFatTree())
+topo.prepParams()
+
+sst.merlin._params["linkcontrol"] = "merlin.flow_linkcontrol"
+sst.merlin._params["packet_size"] = "1500B"
+sst.merlin._params["buffer_size"] = "1500B"
+sst.merlin._params["packets_to_send"] = 1
+
+sst.merlin._params["src"] = "[0, 1, 2, 7]"
+sst.merlin._params["dest"] = "[4, 5, 6, 4]"
+
+endPoint = Pt2ptEndPoint()
+endPoint.prepParams()
+
+topo.setEndPoint(endPoint)
+topo.build()
+
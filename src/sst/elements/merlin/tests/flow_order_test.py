@@ -0,0 +1,59 @@
+#!/usr/bin/env python
+#
+# Copyright 2009-2018 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2018, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+# Flow model delivery order.  Endpoint 0 sends a 1500B (12000b) message
+# and then a 64B (512b) message to endpoint 1 on the same router, both
+# injected at 10ns.
+#
+# The two share the 8Gb/s endpoint links, 4Gb/s each.  The short one
+# finishes at 10ns + 128ns, after which the long one gets the whole link
+# and finishes its remaining 11488b at 138ns + 1.436us = 1.574us.  The
+# short message is held until the long one is delivered, so both arrive
+# at 1.574us + 20ns for the router + 10ns of link latency = 1.604us, in
+# the order they were sent.
+
+import sst
+from sst.merlin import *
+
+sst.merlin._params["flit_size"] = "8B"
+sst.merlin._params["link_bw"] = "1GB/s"
+sst.merlin._params["xbar_bw"] = "1GB/s"
+sst.merlin._params["input_latency"] = "0ns"
+sst.merlin._params["output_latency"] = "0ns"
+sst.merlin._params["input_buf_size"] = "1KB"
+sst.merlin._params["output_buf_size"] = "1KB"
+sst.merlin._params["link_lat"] = "10ns"
+sst.merlin._params["hop_latency"] = "20ns"
+
+sst.merlin._params["num_dims"] = 1
+sst.merlin._params["torus:shape"] = "4"
+sst.merlin._params["torus:width"] = "1"
+sst.merlin._params["torus:local_ports"] = 2
+
+topo = topoFlow(topoTorus())
+topo.prepParams()
+
+sst.merlin._params["linkcontrol"] = "merlin.flow_linkcontrol"
+sst.merlin._params["packet_size"] = "1500B"
+sst.merlin._params["packet_sizes"] = "[1500B, 64B]"
+sst.merlin._params["buffer_size"] = "2KB"
+sst.merlin._params["packets_to_send"] = 2
+
+sst.merlin._params["src"] = "[0]"
+sst.merlin._params["dest"] = "[1]"
+
+endPoint = Pt2ptEndPoint()
+endPoint.prepParams()
+
+topo.setEndPoint(endPoint)
+topo.build()
@@ -0,0 +1,63 @@
+#!/usr/bin/env python
+#
+# Copyright 2009-2018 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2018, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+# Flow model of a 4 router torus ring with 2 endpoints per router
+# (router r has endpoints 2r and 2r+1), one 1500B (12000b) message per
+# flow, all injected at 10ns.
+#
+#   A: 0 -> 4  links r0+ r1+, 3 routers
+#   B: 5 -> 4  no router links, 1 router
+#   C: 6 -> 4  link r3- (shorter way round), 2 routers
+#   E: 3 -> 7  links r1+ r2+, 3 routers
+#
+# Max-min rates with 8Gb/s links: A, B and C share endpoint 4's link,
+# 8/3 Gb/s each.  E shares r1+ with A and gets the rest, 16/3 Gb/s.
+# E finishes at 10ns + 2.25us = 2.26us.  A, B and C are still held by
+# endpoint 4's link and finish at 10ns + 4.5us = 4.51us.  Each message
+# arrives 20ns per router plus 10ns of link latency later.
+
+import sst
+from sst.merlin import *
+
+sst.merlin._params["flit_size"] = "8B"
+sst.merlin._params["link_bw"] = "1GB/s"
+sst.merlin._params["xbar_bw"] = "1GB/s"
+sst.merlin._params["input_latency"] = "0ns"
+sst.merlin._params["output_latency"] = "0ns"
+sst.merlin._params["input_buf_size"] = "1KB"
+sst.merlin._params["output_buf_size"] = "1KB"
+sst.merlin._params["link_lat"] = "10ns"
+sst.merlin._params["hop_latency"] = "20ns"
+
+sst.merlin._params["num_dims"] = 1
+sst.merlin._params["torus:shape"] = "4"
+sst.merlin._params["torus:width"] = "1"
+sst.merlin._params["torus:local_ports"] = 2
+
+topo = topoFlow(topoTorus())
+topo.prepParams()
+
+sst.merlin._params["linkcontrol"] = "merlin.flow_linkcontrol"
+sst.merlin._params["packet_size"] = "1500B"
+sst.merlin._params["buffer_size"] = "1500B"
+sst.merlin._params["packets_to_send"] = 1
+
+sst.merlin._params["src"] = "[0, 5, 6, 3]"
+sst.merlin._params["dest"] = "[4, 4, 4, 7]"
+
+endPoint = Pt2ptEndPoint()
+endPoint.prepParams()
+
+topo.setEndPoint(endPoint)
+topo.build()
+
@@ -0,0 +1,55 @@
+#!/usr/bin/env python
+#
+# Copyright 2009-2018 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2018, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+# A 4x4x4 hyperx with one endpoint per router.  There is no refFile;
+# route_table_check.py compares runs with and without
+# --model-options=--route_table for each routing algorithm, given as
+# --model-options=--algorithm=<alg>.
+
+import sys
+import sst
+from sst.merlin import *
+
+if __name__ == "__main__":
+
+    topo = topoHyperX()
+    endPoint = TestEndPoint()
+
+
+    sst.merlin._params["hyperx:shape"] = "4x4x4"
+    sst.merlin._params["hyperx:width"] = "1x1x1"
+    sst.merlin._params["hyperx:local_ports"] = "1"
+    sst.merlin._params["num_dims"] = "3"
+    sst.merlin._params["hyperx:algorithm"] = "DOR"
+    for arg in sys.argv:
+        if arg.startswith("--algorithm="):
+            sst.merlin._params["hyperx:algorithm"] = arg.split("=", 1)[1]
+
+    sst.merlin._params["link_bw"] = "4GB/s"
+    sst.merlin._params["link_lat"] = "20ns"
+    sst.merlin._params["flit_size"] = "8B"
+    sst.merlin._params["xbar_bw"] = "4GB/s"
+    sst.merlin._params["input_latency"] = "20ns"
+    sst.merlin._params["output_latency"] = "20ns"
+    sst.merlin._params["input_buf_size"] = "4kB"
+    sst.merlin._params["output_buf_size"] = "4kB"
+
+    sst.merlin._params["xbar_arb"] = "merlin.xbar_arb_lru"
+
+    if "--route_table" in sys.argv:
+        sst.merlin._params["hyperx:route_table"] = "1"
+
+    topo.prepParams()
+    endPoint.prepParams()
+    topo.setEndPoint(endPoint)
+    topo.build()
@@ -0,0 +1,190 @@
+#!/usr/bin/env python
+#
+# Copyright 2009-2018 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2018, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+# Checks that the native topology builders in the merlin module create
+# the same components, params and links as the python build() methods.
+#
+# sst.Component and sst.Link are swapped for stand-ins that record
+# every call made on them.  Each topology is built both ways (with
+# endpoints bundled with their routers and not, and some endpoints
+# missing) and the two records compared.  The real classes are then
+# put back and torus_64_test is built with the native builder and run,
+# so the output is the comparison followed by torus_64_test's output.
+# A difference makes the config exit with an error.
+
+import sys
+import sst
+from sst.merlin import *
+
+merlin = sst.merlin
+
+record = []
+
+class RecordingComponent:
+    def __init__(self, name, type):
+        self.name = name
+        record.append(("component", name, type))
+    def addParams(self, params):
+        record.append(("params", self.name, tuple(sorted((k, str(v)) for k, v in params.items()))))
+    def addParam(self, key, value):
+        record.append(("param", self.name, key, str(value)))
+    def addLink(self, link, port, lat):
+        record.append(("addLink", self.name, link.name, port, lat))
+
+class RecordingLink:
+    def __init__(self, name):
+        self.name = name
+        record.append(("link", name))
+    def setNoCut(self):
+        record.append(("nocut", self.name))
+    def connect(self, a, b):
+        record.append(("connect", self.name, a[0].name, a[1], a[2], b[0].name, b[1], b[2]))
+
+class SparseEndPoint(EndPoint):
+    # Leaves every seventh endpoint out to check empty ports are handled
+    def build(self, nID, extraKeys):
+        if nID % 7 == 3:
+            return None
+        nic = sst.Component("nic.%d"%nID, "merlin.test_nic")
+        return (nic, "rtr", "10ns")
+
+def torus():
+    merlin._params["num_dims"] = 3
+    merlin._params["torus:shape"] = "4x3x2"
+    merlin._params["torus:width"] = "2x1x1"
+    merlin._params["torus:local_ports"] = 2
+    return topoTorus()
+
+def mesh():
+    merlin._params["num_dims"] = 2
+    merlin._params["mesh:shape"] = "4x3"
+    merlin._params["mesh:width"] = "1x2"
+    merlin._params["mesh:local_ports"] = 3
+    return topoMesh()
+
+def hyperx():
+    merlin._params["num_dims"] = 3
+    merlin._params["hyperx:shape"] = "3x4x2"
+    merlin._params["hyperx:width"] = "1x2x1"
+    merlin._params["hyperx:local_ports"] = 2
+    return topoHyperX()
+
+def fattree(shape):
+    def make():
+        merlin._params["fattree:shape"] = shape
+        return topoFatTree()
+    return make
+
+def dragonfly(groups, links, routers, relative):
+    def make():
+        merlin._params["dragonfly:hosts_per_router"] = 2
+        merlin._params["dragonfly:routers_per_group"] = routers
+        merlin._params["dragonfly:intergroup_links"] = links
+        merlin._params["dragonfly:num_groups"] = groups
+        merlin._params["dragonfly:algorithm"] = "minimal"
+        topo = topoDragonFly2()
+        if relative:
+            topo.setRoutingModeRelative()
+        return topo
+    return make
+
+topologies = [
+    ("torus", torus),
+    ("mesh", mesh),
+    ("hyperx", hyperx),
+    ("fattree 4,2:4", fattree("4,2:4")),
+    ("fattree 4,2:4,2:4", fattree("4,2:4,2:4")),
+    ("fattree 2,4:3,3:6", fattree("2,4:3,3:6")),
+    ("dragonfly2 absolute", dragonfly(5, 2, 4, False)),
+    ("dragonfly2 relative", dragonfly(5, 2, 4, True)),
+    ("dragonfly2 7 groups", dragonfly(7, 1, 4, False)),
+    ("dragonfly2 1 group", dragonfly(1, 1, 3, False)),
+]
+
+def build(make, native, bundle):
+    merlin._params.clear()
+    del record[:]
+    topo = make()
+    merlin._params["link_lat"] = "10ns"
+    merlin._params["link_bw"] = "1GB/s"
+    merlin._params["flit_size"] = "8B"
+    merlin._params["xbar_bw"] = "1GB/s"
+    merlin._params["input_latency"] = "10ns"
+    merlin._params["output_latency"] = "10ns"
+    merlin._params["input_buf_size"] = "1kB"
+    merlin._params["output_buf_size"] = "1kB"
+    topo.prepParams()
+    topo.setEndPoint(SparseEndPoint())
+    if not bundle:
+        topo.keepEndPointsWithRouter()
+    useNativeBuild(native)
+    topo.build()
+    return list(record)
+
+realComponent = sst.Component
+realLink = sst.Link
+sst.Component = RecordingComponent
+sst.Link = RecordingLink
+
+failed = False
+for name, make in topologies:
+    for bundle in (True, False):
+        python = build(make, False, bundle)
+        native = build(make, True, bundle)
+        desc = "%s, %s" % (name, "bundled" if bundle else "endpoints with routers")
+        if python == native:
+            print("%s: same (%d calls)" % (desc, len(python)))
+            continue
+        failed = True
+        print("%s: DIFFERENT" % desc)
+        for i in range(min(len(python), len(native))):
+            if python[i] != native[i]:
+                print("  first difference at call %d:\n    python %s\n    native %s" % (i, python[i], native[i]))
+                break
+        if len(python) != len(native):
+            print("  python made %d calls, native %d" % (len(python), len(native)))
+sys.stdout.flush()
+
+sst.Component = realComponent
+sst.Link = realLink
+merlin._params.clear()
+
+if failed:
+    sys.exit("Native and python topology builds differ")
+
+# torus_64_test, built natively
+useNativeBuild(True)
+
+topo = topoTorus()
+endPoint = TestEndPoint()
+
+merlin._params["torus:shape"] = "4x4x4"
+merlin._params["torus:width"] = "1x1x1"
+merlin._params["torus:local_ports"] = "1"
+merlin._params["num_dims"] = "3"
+
+merlin._params["link_bw"] = "4GB/s"
+merlin._params["link_lat"] = "20ns"
+merlin._params["flit_size"] = "8B"
+merlin._params["xbar_bw"] = "4GB/s"
+merlin._params["input_latency"] = "20ns"
+merlin._params["output_latency"] = "20ns"
+merlin._params["input_buf_size"] = "4kB"
+merlin._params["output_buf_size"] = "4kB"
+
+merlin._params["xbar_arb"] = "merlin.xbar_arb_lru"
+
+topo.prepParams()
+endPoint.prepParams()
+topo.setEndPoint(endPoint)
+topo.build()
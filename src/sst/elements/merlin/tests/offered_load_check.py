@@ -0,0 +1,110 @@
+#!/usr/bin/env python
+#
+# Copyright 2009-2018 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2018, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+# Checks the saturation curves offered_load prints, using
+# offered_load_test.py: one table per pattern with a row per load point,
+# accepted load following offered load while the network keeps up, and
+# a p99 latency no less than the average and inside the histogram.
+# Then reruns with a two bin histogram, where every p99 must be reported
+# as past the last bin (">2 ns") and everything else must be unchanged.
+#
+# Usage: offered_load_check.py [sst]  (from any directory)
+# Exits non-zero on failure.
+
+import os
+import re
+import subprocess
+import sys
+
+sstBin = sys.argv[1] if len(sys.argv) > 1 else "sst"
+testDir = os.path.dirname(os.path.abspath(__file__))
+
+patterns = ["merlin.targetgen.uniform", "merlin.targetgen.bit_complement"]
+loads = [0.1, 0.5, 1.0]
+# warmup_time + collect_time + drain_time in offered_load_test.py
+maxLatency = 32e6
+
+units = {"ps": 1.0, "ns": 1e3, "us": 1e6, "ms": 1e9, "s": 1e12}
+rowRe = re.compile(r"^\s*([0-9.]+)\s+([0-9.]+)\s+([0-9.]+)\s*(ps|ns|us|ms|s)\s+(>?)([0-9.]+)\s*(ps|ns|us|ms|s)(\*?)\s*$")
+
+failed = False
+
+def fail(msg):
+    global failed
+    print("FAIL: " + msg)
+    failed = True
+
+def run(options):
+    cmd = [sstBin, os.path.join(testDir, "offered_load_test.py")]
+    if options:
+        cmd.append("--model-options=" + options)
+    out = subprocess.check_output(cmd, cwd=testDir, universal_newlines=True)
+
+    # {pattern: [(offered, accepted, average ps, p99 overflow, p99 ps, behind)]}
+    tables = {}
+    order = []
+    current = None
+    for line in out.splitlines():
+        # Strip the component name offered_load prefixes its output with
+        line = line.split(": ", 1)[1] if line.startswith("offered_load.") else line
+        if line.startswith("Pattern: "):
+            current = line[len("Pattern: "):].strip()
+            order.append(current)
+            tables[current] = []
+            continue
+        m = rowRe.match(line)
+        if current is not None and m:
+            tables[current].append((float(m.group(1)), float(m.group(2)),
+                                    float(m.group(3)) * units[m.group(4)], m.group(5) == ">",
+                                    float(m.group(6)) * units[m.group(7)], m.group(8) == "*"))
+    return order, tables
+
+order, tables = run("")
+if order != patterns:
+    fail("patterns reported %s, expected %s" % (order, patterns))
+for pattern in order:
+    rows = tables[pattern]
+    offered = [row[0] for row in rows]
+    if offered != loads:
+        fail("%s: load points %s, expected %s" % (pattern, offered, loads))
+        continue
+    for (load, accepted, average, overflow, p99, behind) in rows:
+        desc = "%s at load %.2f" % (pattern, load)
+        if accepted > load * 1.05 + 0.01:
+            fail("%s: accepted load %.3f is more than offered" % (desc, accepted))
+        if not behind and accepted < load * 0.9:
+            fail("%s: accepted load %.3f without falling behind" % (desc, accepted))
+        if overflow or p99 > maxLatency:
+            fail("%s: p99 %.0fps is past the histogram" % (desc, p99))
+        if p99 < average:
+            fail("%s: p99 %.0fps is less than the average %.0fps" % (desc, p99, average))
+    if rows[0][5]:
+        fail("%s: fell behind at load %.2f" % (pattern, rows[0][0]))
+if not failed:
+    print("PASS: %d saturation curves of %d load points" % (len(order), len(loads)))
+
+smallOrder, smallTables = run("--latency_bins=2")
+if smallOrder != order:
+    fail("patterns reported %s with two bins, %s with the default" % (smallOrder, order))
+else:
+    for pattern in order:
+        for row, small in zip(tables[pattern], smallTables[pattern]):
+            if small[3:5] != (True, 2000.0):
+                fail("%s at load %.2f: p99 with two bins is %s%.0fps, expected >2000ps" %
+                     (pattern, row[0], ">" if small[3] else "", small[4]))
+            if small[:3] + small[5:] != row[:3] + row[5:]:
+                fail("%s at load %.2f: histogram size changed more than the p99" % (pattern, row[0]))
+if not failed:
+    print("PASS: p99 past the last histogram bin reported as overflow")
+
+sys.exit(1 if failed else 0)
@@ -0,0 +1,56 @@
+#!/usr/bin/env python
+#
+# Copyright 2009-2018 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2018, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+# Offered load sweep over a 4x4 torus with one endpoint per router, for
+# offered_load_check.py.  Two patterns at three load points each.  A
+# histogram size can be given with --model-options=--latency_bins=<n>.
+
+import sys
+import sst
+from sst.merlin import *
+
+if __name__ == "__main__":
+
+    topo = topoTorus()
+    endPoint = OfferedLoadEndPoint()
+
+    sst.merlin._params["torus:shape"] = "4x4"
+    sst.merlin._params["torus:width"] = "1x1"
+    sst.merlin._params["torus:local_ports"] = "1"
+    sst.merlin._params["num_dims"] = "2"
+
+    sst.merlin._params["link_bw"] = "4GB/s"
+    sst.merlin._params["link_lat"] = "20ns"
+    sst.merlin._params["flit_size"] = "8B"
+    sst.merlin._params["xbar_bw"] = "4GB/s"
+    sst.merlin._params["input_latency"] = "20ns"
+    sst.merlin._params["output_latency"] = "20ns"
+    sst.merlin._params["input_buf_size"] = "4kB"
+    sst.merlin._params["output_buf_size"] = "4kB"
+    sst.merlin._params["xbar_arb"] = "merlin.xbar_arb_lru"
+
+    sst.merlin._params["offered_load"] = "[0.1, 0.5, 1.0]"
+    sst.merlin._params["pattern"] = "[merlin.targetgen.uniform, merlin.targetgen.bit_complement]"
+    sst.merlin._params["message_size"] = "64B"
+    sst.merlin._params["buffer_size"] = "1kB"
+    sst.merlin._params["warmup_time"] = "2us"
+    sst.merlin._params["collect_time"] = "10us"
+    sst.merlin._params["drain_time"] = "20us"
+    for arg in sys.argv:
+        if arg.startswith("--latency_bins="):
+            sst.merlin._params["latency_bins"] = arg.split("=", 1)[1]
+
+    topo.prepParams()
+    endPoint.prepParams()
+    topo.setEndPoint(endPoint)
+    topo.build()
@@ -0,0 +1,73 @@
+#!/usr/bin/env python
+#
+# Copyright 2009-2018 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2018, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+# Checks merlin.reorderlinkcontrol with reorder_test.py, which sends
+# shift traffic over an adaptively routed fattree.  Runs with the per
+# peer state in the hash map and in the dense array (rlc:num_peers),
+# each starting at sequence number 0 and starting close enough to 2^32
+# that every peer's sequence numbers wrap.  In every run each nic must
+# receive all of its packets with none out of order, and the sorted
+# receive lines must match refFiles/test_merlin_reorder_test.out.
+#
+# Usage: reorder_check.py [sst]  (from any directory)
+# Exits non-zero on failure.
+
+import os
+import subprocess
+import sys
+
+sstBin = sys.argv[1] if len(sys.argv) > 1 else "sst"
+testDir = os.path.dirname(os.path.abspath(__file__))
+refFile = os.path.join(testDir, "refFiles", "test_merlin_reorder_test.out")
+
+# 100 packets per peer, so starting 20 below 2^32 wraps part way through
+wrapSeq = 2**32 - 20
+
+runs = [
+    ("hash map", []),
+    ("hash map, wrapping", ["--first_seq=%d" % wrapSeq]),
+    ("dense", ["--num_peers"]),
+    ("dense, wrapping", ["--num_peers", "--first_seq=%d" % wrapSeq]),
+]
+
+failed = False
+
+def fail(msg):
+    global failed
+    print("FAIL: " + msg)
+    failed = True
+
+with open(refFile) as f:
+    expected = f.read().splitlines()
+
+for desc, options in runs:
+    cmd = [sstBin, os.path.join(testDir, "reorder_test.py")]
+    if options:
+        cmd.append("--model-options=%s" % " ".join(options))
+    p = subprocess.Popen(cmd, cwd=testDir, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    out = p.communicate()[0]
+    if p.returncode != 0:
+        fail("%s run failed:\n%s" % (desc, out))
+        continue
+
+    lines = out.splitlines()
+    ooo = [line for line in lines if "out of order packets" in line]
+    if ooo:
+        fail("%s run delivered packets out of order:\n%s" % (desc, "\n".join(ooo)))
+    received = sorted(line.strip() for line in lines if "Received all packets" in line)
+    if received != expected:
+        fail("%s run differs from %s:\n%s" % (desc, os.path.basename(refFile), "\n".join(received)))
+    if not ooo and received == expected:
+        print("PASS: %s run matches %s" % (desc, os.path.basename(refFile)))
+
+sys.exit(1 if failed else 0)
@@ -0,0 +1,58 @@
+#!/usr/bin/env python
+#
+# Copyright 2009-2018 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2018, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+# Shift traffic through merlin.reorderlinkcontrol on a fattree with
+# adaptive routing, so packets to a peer take different paths and
+# arrive out of order.  reorder_check.py runs it with
+# --model-options="--num_peers --first_seq=<n>" to use the dense per
+# peer state and to start the sequence numbers near wraparound.
+
+import sys
+import sst
+from sst.merlin import *
+
+if __name__ == "__main__":
+
+    topo = topoFatTree()
+    endPoint = ShiftEndPoint()
+
+    sst.merlin._params["fattree:shape"] = "4,4:4,4:8"
+    sst.merlin._params["fattree:routing_alg"] = "adaptive"
+
+    sst.merlin._params["link_bw"] = "4GB/s"
+    sst.merlin._params["link_lat"] = "20ns"
+    sst.merlin._params["flit_size"] = "8B"
+    sst.merlin._params["xbar_bw"] = "4GB/s"
+    sst.merlin._params["input_latency"] = "20ns"
+    sst.merlin._params["output_latency"] = "20ns"
+    sst.merlin._params["input_buf_size"] = "1kB"
+    sst.merlin._params["output_buf_size"] = "1kB"
+
+    # Every endpoint sends to the one half the machine away, through
+    # the top of the tree
+    sst.merlin._params["num_peers"] = 128
+    sst.merlin._params["shift"] = 64
+    sst.merlin._params["packets_to_send"] = 100
+    sst.merlin._params["packet_size"] = "256B"
+
+    endPoint.epOptKeys.extend(["rlc:num_peers", "rlc:first_seq"])
+    for arg in sys.argv:
+        if arg == "--num_peers":
+            sst.merlin._params["rlc:num_peers"] = 128
+        elif arg.startswith("--first_seq="):
+            sst.merlin._params["rlc:first_seq"] = arg.split("=", 1)[1]
+
+    topo.prepParams()
+    endPoint.prepParams()
+    topo.setEndPoint(endPoint)
+    topo.build()
@@ -0,0 +1,64 @@
+#!/usr/bin/env python
+#
+# Copyright 2009-2018 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2018, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+# Checks that the precomputed routing tables (<topology>:route_table)
+# route exactly as the computed path.  Each torus, fattree and dragonfly
+# test is run with the table enabled and its output compared with the
+# test's refFile.  There is no hyperx refFile, so hyperx_64_test.py is
+# run with and without the table for each routing algorithm and the two
+# outputs compared.
+#
+# Usage: route_table_check.py [sst]  (from any directory)
+# Exits non-zero on failure.
+
+import os
+import subprocess
+import sys
+
+sstBin = sys.argv[1] if len(sys.argv) > 1 else "sst"
+testDir = os.path.dirname(os.path.abspath(__file__))
+
+refTests = ["torus_64_test", "torus_128_test", "fattree_128_test", "fattree_256_test",
+            "dragon_72_test", "dragon_128_test"]
+hyperxAlgorithms = ["DOR", "DOR-ND", "MIN-A", "DOAL", "valiant"]
+
+failed = False
+
+def run(test, options):
+    cmd = [sstBin, os.path.join(testDir, test + ".py"), "--model-options=" + " ".join(options)]
+    out = subprocess.check_output(cmd, cwd=testDir, universal_newlines=True)
+    return sorted(line.rstrip() for line in out.splitlines() if line.strip())
+
+def compare(desc, expected, result):
+    global failed
+    if result != expected:
+        print("FAIL: %s" % desc)
+        for line in sorted(set(expected).symmetric_difference(result))[:20]:
+            print("  " + line)
+        failed = True
+    else:
+        print("%s: same (%d lines)" % (desc, len(expected)))
+
+for test in refTests:
+    refFile = os.path.join(testDir, "refFiles", "test_merlin_%s.out" % test)
+    with open(refFile) as f:
+        expected = sorted(line.rstrip() for line in f if line.strip())
+    compare("%s with route table vs %s" % (test, os.path.basename(refFile)),
+            expected, run(test, ["--route_table"]))
+
+for alg in hyperxAlgorithms:
+    option = "--algorithm=" + alg
+    compare("hyperx_64_test %s with route table vs computed" % alg,
+            run("hyperx_64_test", [option]), run("hyperx_64_test", [option, "--route_table"]))
+
+sys.exit(1 if failed else 0)
@@ -0,0 +1,82 @@
+#!/usr/bin/env python
+#
+# Copyright 2009-2018 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2018, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+# Checks the traffic matrix inspector with traffic_matrix_test.py.  The
+# matrix file must match refFiles/test_merlin_traffic_matrix_test.out.
+# The links file must list the links sorted by name, whatever order the
+# inspectors finished in, and its host ports (port4 and port5 of each
+# router) must carry every packet.  The run is repeated with two threads
+# and both files must be the same as the single thread run.
+#
+# Usage: traffic_matrix_check.py [sst]  (from any directory)
+# Exits non-zero on failure.
+
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+sstBin = sys.argv[1] if len(sys.argv) > 1 else "sst"
+testDir = os.path.dirname(os.path.abspath(__file__))
+refFile = os.path.join(testDir, "refFiles", "test_merlin_traffic_matrix_test.out")
+
+# 8 endpoints each sending 3 packets to every endpoint
+totalPackets = 8 * 8 * 3
+
+failed = False
+
+def fail(msg):
+    global failed
+    print("FAIL: " + msg)
+    failed = True
+
+def run(threads):
+    runDir = tempfile.mkdtemp(prefix="traffic_matrix_check")
+    try:
+        cmd = [sstBin, "--num_threads=%d" % threads, os.path.join(testDir, "traffic_matrix_test.py")]
+        subprocess.check_output(cmd, cwd=runDir, universal_newlines=True)
+        with open(os.path.join(runDir, "traffic_matrix_test.matrix.csv")) as f:
+            matrix = f.read()
+        with open(os.path.join(runDir, "traffic_matrix_test.links.csv")) as f:
+            links = f.read()
+    finally:
+        shutil.rmtree(runDir)
+    return matrix, links
+
+with open(refFile) as f:
+    expected = f.read()
+
+matrix, links = run(1)
+if matrix != expected:
+    fail("matrix differs from %s:\n%s" % (os.path.basename(refFile), matrix))
+
+rows = [line.split(",") for line in links.splitlines()[1:]]
+names = [row[0] for row in rows]
+if names != sorted(names):
+    fail("links are not sorted by name: %s" % names)
+hostPackets = sum(int(row[2]) for row in rows if row[0].endswith(":port4") or row[0].endswith(":port5"))
+if hostPackets != totalPackets:
+    fail("host ports carried %d packets, expected %d" % (hostPackets, totalPackets))
+if not failed:
+    print("PASS: matrix matches %s, %d links sorted" % (os.path.basename(refFile), len(names)))
+
+threadedMatrix, threadedLinks = run(2)
+if threadedMatrix != matrix:
+    fail("matrix differs with two threads")
+if threadedLinks != links:
+    fail("links file differs with two threads")
+if not failed:
+    print("PASS: two thread run writes the same files")
+
+sys.exit(1 if failed else 0)
@@ -0,0 +1,50 @@
+#!/usr/bin/env python
+#
+# Copyright 2009-2018 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2018, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+# Every endpoint of a 2x2 torus with two endpoints per router sends
+# three 64 bit packets to every endpoint, itself included, with the
+# traffic matrix inspector on every router port.  The matrix does not
+# depend on timing.  Run by traffic_matrix_check.py.
+
+import sst
+from sst.merlin import *
+
+if __name__ == "__main__":
+
+    topo = topoTorus()
+    endPoint = TestEndPoint()
+
+    sst.merlin._params["torus:shape"] = "2x2"
+    sst.merlin._params["torus:width"] = "1x1"
+    sst.merlin._params["torus:local_ports"] = "2"
+    sst.merlin._params["num_dims"] = "2"
+
+    sst.merlin._params["link_bw"] = "4GB/s"
+    sst.merlin._params["link_lat"] = "20ns"
+    sst.merlin._params["flit_size"] = "8B"
+    sst.merlin._params["xbar_bw"] = "4GB/s"
+    sst.merlin._params["input_latency"] = "20ns"
+    sst.merlin._params["output_latency"] = "20ns"
+    sst.merlin._params["input_buf_size"] = "4kB"
+    sst.merlin._params["output_buf_size"] = "4kB"
+    sst.merlin._params["xbar_arb"] = "merlin.xbar_arb_lru"
+    sst.merlin._params["num_messages"] = "3"
+
+    sst.merlin._params["network_inspectors"] = "merlin.traffic_matrix_inspector"
+    sst.merlin._params["network_inspector:output_file"] = "traffic_matrix_test"
+    topo.topoOptKeys.extend(["network_inspectors", "network_inspector:output_file"])
+
+    topo.prepParams()
+    endPoint.prepParams()
+    topo.setEndPoint(endPoint)
+    topo.build()
@@ -0,0 +1,63 @@
+#!/usr/bin/env python
+#
+# Copyright 2009-2018 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2018, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+# A single 70 port router with every endpoint sending randomly
+# sized packets to random destinations for ~100k router cycles.  Used by
+# xbar_arb_check.py to compare crossbar arbitration units:
+#   sst xbar_arb_70_test.py --model-options="--xbar_arb=merlin.xbar_arb_rr"
+
+import sys
+import sst
+from sst.merlin import *
+
+xbarArb = "merlin.xbar_arb_bitmask"
+for arg in sys.argv:
+    if arg.startswith("--xbar_arb="):
+        xbarArb = arg.split("=", 1)[1]
+
+sst.setStatisticLoadLevel(3)
+
+sst.merlin._params["router_radix"] = 70
+sst.merlin._params["xbar_arb"] = xbarArb
+sst.merlin._params["flit_size"] = "8B"
+sst.merlin._params["link_bw"] = "4.0GB/s"
+sst.merlin._params["xbar_bw"] = "4.0GB/s"
+sst.merlin._params["input_latency"] = "0.0ns"
+sst.merlin._params["output_latency"] = "0.0ns"
+sst.merlin._params["input_buf_size"] = "256B"
+sst.merlin._params["output_buf_size"] = "256B"
+sst.merlin._params["link_lat"] = "20ns"
+
+topo = topoSimple()
+topo.prepParams()
+
+sst.merlin._params["PacketDest:pattern"] = "Uniform"
+sst.merlin._params["PacketSize:pattern"] = "Uniform"
+sst.merlin._params["PacketSize:RangeMin"] = "8.0B"
+sst.merlin._params["PacketSize:RangeMax"] = "64.0B"
+# Required by pymerlin
+sst.merlin._params["packet_size"] = "0KB"
+sst.merlin._params["PacketDelay:pattern"] = "Uniform"
+sst.merlin._params["PacketDelay:RangeMin"] = "2.0ns"
+sst.merlin._params["PacketDelay:RangeMax"] = "10.0ns"
+# Required by pymerlin
+sst.merlin._params["message_rate"] = "1GHz"
+sst.merlin._params["packets_to_send"] = 20000
+
+endPoint = TrafficGenEndPoint()
+endPoint.prepParams()
+
+topo.setEndPoint(endPoint)
+topo.build()
+
+sst.enableAllStatisticsForAllComponents({"type":"sst.AccumulatorStatistic","rate":"0ns"})
@@ -0,0 +1,50 @@
+#!/usr/bin/env python
+#
+# Copyright 2009-2018 NTESS. Under the terms
+# of Contract DE-NA0003525 with NTESS, the U.S.
+# Government retains certain rights in this software.
+#
+# Copyright (c) 2009-2018, NTESS
+# All rights reserved.
+#
+# This file is part of the SST software package. For license
+# information, see the LICENSE file in the top level directory of the
+# distribution.
+
+# Check that xbar_arb_rr and xbar_arb_bitmask make the same grants as
+# xbar_arb_rr_ref, the original round robin arbiter, by running
+# xbar_arb_70_test.py with each and comparing the simulated time and
+# every statistic (router stalls and per port packet/bit counts,
+# endpoint latencies), which all diverge if any grant differs.
+#
+# Usage: xbar_arb_check.py [sst]  (from any directory)
+# Exits non-zero on failure.
+
+import os
+import subprocess
+import sys
+
+sstBin = sys.argv[1] if len(sys.argv) > 1 else "sst"
+reference = "merlin.xbar_arb_rr_ref"
+candidates = ["merlin.xbar_arb_rr", "merlin.xbar_arb_bitmask"]
+testDir = os.path.dirname(os.path.abspath(__file__))
+
+def run(arb):
+    cmd = [sstBin, os.path.join(testDir, "xbar_arb_70_test.py"), "--model-options=--xbar_arb=" + arb]
+    out = subprocess.check_output(cmd, cwd=testDir, universal_newlines=True)
+    return sorted(line.strip() for line in out.splitlines()
+                  if " : Accumulator : " in line or line.startswith("Simulation is complete"))
+
+expected = run(reference)
+failed = False
+for arb in candidates:
+    result = run(arb)
+    if result != expected:
+        print("FAIL: %s differs from %s" % (arb, reference))
+        for line in sorted(set(expected).symmetric_difference(result))[:20]:
+            print("  " + line)
+        failed = True
+    else:
+        print("%s matches %s (%d statistics)" % (arb, reference, len(expected) - 1))
+
+sys.exit(1 if failed else 0)
@@ -77,6 +77,8 @@ topo_dragonfly2::topo_dragonfly2(Component* comp, Params &p) :
     std::string route_algo = p.find<std::string>("dragonfly:algorithm", "minimal");
 
     adaptive_threshold = p.find<double>("dragonfly:adaptive_threshold",2.0);
+
+    use_route_table = p.find<bool>("dragonfly:route_table",false);
     
     // Get the global link map
     std::vector<int64_t> global_link_map;
@@ -159,6 +161,31 @@ topo_dragonfly2::~topo_dragonfly2()
 {
 }
 
+void topo_dragonfly2::setup()
+{
+    // The global link map in the shared region is only complete once
+    // init is done, so the tables are built here rather than in the
+    // constructor.
+    if ( !use_route_table ) return;
+
+    std::vector<uint16_t> routers(params.a);
+    for ( uint32_t r = 0; r < params.a; r++ ) {
+        if ( r == router_id ) continue;
+        routers[r] = port_for_router(r);
+    }
+
+    std::vector<uint16_t> groups(params.g * params.n);
+    for ( uint32_t g = 0; g < params.g; g++ ) {
+        if ( g == group_id ) continue;
+        for ( uint32_t s = 0; s < params.n; s++ ) {
+            groups[g * params.n + s] = port_for_group(g, s);
+        }
+    }
+
+    router_port_table.swap(routers);
+    group_port_table.swap(groups);
+}
+
 
 void topo_dragonfly2::route(int port, int vc, internal_router_event* ev)
 {
@@ -570,6 +597,8 @@ uint32_t topo_dragonfly2::router_to_group(uint32_t group)
 /* returns local router port if group can't be reached from this router */
 uint32_t topo_dragonfly2::port_for_group(uint32_t group, uint32_t slice, int id)
 {
+    if ( !group_port_table.empty() ) return group_port_table[group * params.n + slice];
+
     // Look up global port to use
     switch ( global_route_mode ) {
     case ABSOLUTE:
@@ -600,6 +629,8 @@ uint32_t topo_dragonfly2::port_for_group(uint32_t group, uint32_t slice, int id)
 
 uint32_t topo_dragonfly2::port_for_router(uint32_t router)
 {
+    if ( !router_port_table.empty() ) return router_port_table[router];
+
     uint32_t tgt = params.p + router;
     if ( router > router_id ) tgt--;
     return tgt;
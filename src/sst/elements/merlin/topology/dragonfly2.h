@@ -25,6 +25,8 @@
 #include <sst/core/params.h>
 #include <sst/core/rng/sstrng.h>
 
+#include <vector>
+
 #include "sst/elements/merlin/router.h"
 
 
@@ -89,6 +91,7 @@ public:
         {"dragonfly:adaptive_threshold",    "Threshold to use when make adaptive routing decisions.", "2.0"},
         {"dragonfly:global_link_map",       "Array specifying connectivity of global links in each dragonfly group."},
         {"dragonfly:global_route_mode",     "Mode for intepreting global link map [absolute (default) | relative].","absolute"},
+        {"dragonfly:route_table",           "Precompute the port to use toward each group and router at setup instead of looking it up for each packet.  Uses 2 bytes per global link slice in the network.","false"},
     )
 
     /* Assumed connectivity of each router:
@@ -128,6 +131,12 @@ public:
     enum global_route_mode_t { ABSOLUTE, RELATIVE };
     global_route_mode_t global_route_mode;
 
+    // Port tables built at setup if dragonfly:route_table is set.
+    // group_port_table is indexed by group * n + global slice.
+    bool use_route_table;
+    std::vector<uint16_t> group_port_table;
+    std::vector<uint16_t> router_port_table;
+
 public:
     struct dgnfly2Addr {
         uint32_t group;
@@ -140,6 +149,7 @@ public:
     topo_dragonfly2(Component* comp, Params& p);
     ~topo_dragonfly2();
 
+    virtual void setup();
     virtual void route(int port, int vc, internal_router_event* ev);
     virtual void reroute(int port, int vc, internal_router_event* ev);
     virtual internal_router_event* process_input(RtrEvent* ev);
@@ -74,6 +74,7 @@ topo_fattree::topo_fattree(Component* comp, Params& params) :
     }
 
     adaptive_threshold = params.find<double>("fattree:adaptive_threshold", 0.5);
+    use_route_table = params.find<bool>("fattree:route_table", false);
     // std::cout << "routing_alg: " << routing_alg << std::endl;
     // std::cout << "adaptive_threshold: " << adaptive_threshold << std::endl;
     
@@ -88,7 +89,7 @@ topo_fattree::topo_fattree(Component* comp, Params& params) :
     //     cout << "Level " << i << ": down = " << downs[i] << ", up = " << ups[i] << endl;
     // }
 
-    int total_hosts = 1;
+    total_hosts = 1;
     for ( int i = 0; i < levels; i++ ) {
         total_hosts *= downs[i];
     }
@@ -154,8 +155,27 @@ topo_fattree::~topo_fattree()
 {
 }
 
+void topo_fattree::setup()
+{
+    if ( !use_route_table ) return;
+
+    route_table.resize(total_hosts);
+    for ( int dest = 0; dest < total_hosts; dest++ ) {
+        if ( dest >= low_host && dest <= high_host ) {
+            route_table[dest] = (dest - low_host) / down_route_factor;
+        }
+        else {
+            route_table[dest] = down_ports + ((dest/down_route_factor) % up_ports);
+        }
+    }
+}
+
 void topo_fattree::route(int port, int vc, internal_router_event* ev)  {
     int dest = ev->getDest();
+    if ( !route_table.empty() ) {
+        ev->setNextPort(route_table[dest]);
+        return;
+    }
     // Down routes
     if ( dest >= low_host && dest <= high_host ) {
         ev->setNextPort((dest - low_host) / down_route_factor);
@@ -24,6 +24,8 @@
 #include <sst/core/link.h>
 #include <sst/core/params.h>
 
+#include <vector>
+
 #include "sst/elements/merlin/router.h"
 
 namespace SST {
@@ -44,7 +46,8 @@ public:
     SST_ELI_DOCUMENT_PARAMS(
         {"fattree:shape",               "Shape of the fattree"},
         {"fattree:routing_alg",         "Routing algorithm to use. [deterministic | adaptive]","deterministic"},
-        {"fattree:adaptive_threshold",  "Threshold used to determine if a packet will adaptively route."}
+        {"fattree:adaptive_threshold",  "Threshold used to determine if a packet will adaptively route."},
+        {"fattree:route_table",         "Precompute the output port for every host at setup instead of computing it for each packet.  Uses 2 bytes per host in the network.", "false"}
     )
 
     
@@ -69,6 +72,12 @@ private:
     int* thresholds;
     bool allow_adaptive;
     double adaptive_threshold;
+
+    // Output port for each destination host, built at setup if
+    // fattree:route_table is set
+    bool use_route_table;
+    int total_hosts;
+    std::vector<uint16_t> route_table;
     
     void parseShape(const std::string &shape, int *downs, int *ups) const;
 
@@ -77,6 +86,7 @@ public:
     topo_fattree(Component* comp, Params& params);
     ~topo_fattree();
 
+    virtual void setup();
     virtual void route(int port, int vc, internal_router_event* ev);
     virtual void reroute(int port, int vc, internal_router_event* ev);
     virtual internal_router_event* process_input(RtrEvent* ev);
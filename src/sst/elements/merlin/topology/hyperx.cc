@@ -119,7 +119,8 @@ topo_hyperx::topo_hyperx(Component* comp, Params& params) :
     for (int i = 0; i < dimensions; ++i ) {
         total_routers *= dim_size[i];
     }
-    
+
+    use_route_table = params.find<bool>("hyperx:route_table", false);
 }
 
 topo_hyperx::~topo_hyperx()
@@ -130,6 +131,40 @@ topo_hyperx::~topo_hyperx()
     delete [] port_start;
 }
 
+void
+topo_hyperx::setup()
+{
+    if ( !use_route_table ) return;
+
+    // Minimal ports by coordinate.  The entry for this router's own
+    // coordinate is never used.
+    minimal_ports_start.resize(dimensions);
+    int entries = 0;
+    for ( int dim = 0; dim < dimensions; ++dim ) {
+        minimal_ports_start[dim] = entries;
+        entries += dim_size[dim];
+    }
+    std::vector<uint16_t> ports(entries);
+    for ( int dim = 0; dim < dimensions; ++dim ) {
+        for ( int coord = 0; coord < dim_size[dim]; ++coord ) {
+            if ( coord == id_loc[dim] ) continue;
+            ports[minimal_ports_start[dim] + coord] = minimal_port(dim, coord);
+        }
+    }
+    minimal_ports.swap(ports);
+
+    // DOR next hop by router
+    dor_table.resize(total_routers);
+    int* loc = new int[dimensions];
+    for ( int rtr = 0; rtr < total_routers; ++rtr ) {
+        if ( rtr == router_id ) continue;
+        idToLocation(rtr, loc);
+        std::pair<int,int> next_port = routeDORBase(loc);
+        dor_table[rtr] = choose_multipath(next_port.second,dim_width[next_port.first]);
+    }
+    delete [] loc;
+}
+
 void
 topo_hyperx::route(int port, int vc, internal_router_event* ev)
 {
@@ -394,10 +429,7 @@ topo_hyperx::routeDORBase(int* dest_loc) {
     for ( int dim = 0 ; dim < dimensions ; ++dim ) {
         // Find first unaligned dimension and route to align it
         if ( dest_loc[dim] != id_loc[dim] ) {
-            // Get offset to the first unaligned dimension
-            int offset = dest_loc[dim] - ((dest_loc[dim] > id_loc[dim]) ? 1 : 0);
-            offset *= dim_width[dim];
-            return std::make_pair(dim,port_start[dim] + offset);
+            return std::make_pair(dim,minimal_port(dim,dest_loc[dim]));
         }
     }
     return std::make_pair(-1,-1);
@@ -405,6 +437,13 @@ topo_hyperx::routeDORBase(int* dest_loc) {
 
 void
 topo_hyperx::routeDOR(int port, int vc, topo_hyperx_event* ev) {
+    if ( !dor_table.empty() ) {
+        int dest_router = get_dest_router(ev->getDest());
+        if ( dest_router == router_id ) ev->setNextPort(get_dest_local_port(ev->getDest()));
+        else ev->setNextPort(dor_table[dest_router]);
+        ev->setVC(vc);
+        return;
+    }
     std::pair<int,int> next_port = routeDORBase(ev->dest_loc);
 
     if ( next_port.first == -1 ) {
@@ -501,15 +540,14 @@ topo_hyperx::routeDOAL(int port, int vc, topo_hyperx_event* ev) {
             // adaptively routed, if so, then we have to go direct for
             // this dimension
             if ( (vc & 0x1) == 1 ) {
-                // Get offset in the dimension
-                int offset = ev->dest_loc[dim] - ((ev->dest_loc[dim] > id_loc[dim]) ? 1 : 0);
-                offset *= dim_width[dim];
+                // Get the first minimal port in the dimension
+                int offset = minimal_port(dim,ev->dest_loc[dim]);
                 
                 // Choose the least loaded route to the next router
                 int min = 0x7FFFFFFF;
                 int min_port;
                 
-                for ( int p = port_start[dim] + offset; p < port_start[dim] + offset + dim_width[dim]; ++p ) {
+                for ( int p = offset; p < offset + dim_width[dim]; ++p ) {
                     int weight = output_queue_lengths[p * num_vcs + vc];
                     if ( weight < min ) {
                         min = weight;
@@ -534,14 +572,8 @@ topo_hyperx::routeDOAL(int port, int vc, topo_hyperx_event* ev) {
                 for ( int curr_port = port_start[dim]; curr_port < port_start[dim] + ((dim_size[dim] - 1) * dim_width[dim]); ++curr_port  ) {
                     // See if this is a minimal route
                     
-                    // Compute the base offset in this dimension for
-                    // the minimal route (this is essentially what the
-                    // offset would be if the width in this dimension
-                    // is 1).
-                    int offset = ev->dest_loc[dim] - ((ev->dest_loc[dim] > id_loc[dim]) ? 1 : 0);
-                    
-                    // Now get the actual starting port for the minimal link(s)
-                    offset = port_start[dim] + ( offset * dim_width[dim]);
+                    // Get the starting port for the minimal link(s)
+                    int offset = minimal_port(dim,ev->dest_loc[dim]);
                     if ( curr_port >= offset && curr_port < offset + dim_width[dim] ) {
                         // This is a minimal route.  We would use VC 0
                         // in the VN, which is the VC the packet came
@@ -599,8 +631,7 @@ topo_hyperx::routeMINA(int port, int vc, topo_hyperx_event* ev) {
         if ( ev->dest_loc[dim] == id_loc[dim] ) continue;
 
         // Find the minimum weight, minimally-routed port
-        int offset = ev->dest_loc[dim] - ((ev->dest_loc[dim] > id_loc[dim]) ? 1 : 0);
-        offset = port_start[dim] + (offset * dim_width[dim]);
+        int offset = minimal_port(dim,ev->dest_loc[dim]);
 
         for ( int i = offset; i < offset + dim_width[dim]; ++i ) {
             int weight = output_queue_lengths[(i * num_vcs) + start_vc + 1];
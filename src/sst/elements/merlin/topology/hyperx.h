@@ -159,7 +159,8 @@ public:
         {"hyperx:shape",        "Shape of the mesh specified as the number of routers in each dimension, where each dimension is separated by a colon.  For example, 4x4x2x2.  Any number of dimensions is supported."},
         {"hyperx:width",        "Number of links between routers in each dimension, specified in same manner as for shape.  For example, 2x2x1 denotes 2 links in the x and y dimensions and one in the z dimension."},
         {"hyperx:local_ports",  "Number of endpoints attached to each router."},
-        {"hyperx:algorithm",    "Routing algorithm to use.", "DOR"}
+        {"hyperx:algorithm",    "Routing algorithm to use.", "DOR"},
+        {"hyperx:route_table",  "Precompute the minimal ports toward each router coordinate, and the DOR next hop to every router, at setup instead of computing them for each packet.  Uses 2 bytes per router in the network.", "false"}
     )
 
     enum RouteAlgo {
@@ -193,10 +194,21 @@ private:
     RNG::SSTRandom* rng;
     RNGFunc* rng_func;
 
+    // Tables built at setup if hyperx:route_table is set.
+    // minimal_ports holds the first of the dim_width[dim] minimal
+    // ports toward each coordinate of each dimension, starting at
+    // minimal_ports_start[dim].  dor_table holds the DOR port to each
+    // router.
+    bool use_route_table;
+    std::vector<int> minimal_ports_start;
+    std::vector<uint16_t> minimal_ports;
+    std::vector<uint16_t> dor_table;
+
 public:
     topo_hyperx(Component* comp, Params& params);
     ~topo_hyperx();
 
+    virtual void setup();
     virtual void route(int port, int vc, internal_router_event* ev);
     virtual void reroute(int port, int vc, internal_router_event* ev);
     virtual internal_router_event* process_input(RtrEvent* ev);
@@ -220,6 +232,14 @@ private:
     int get_dest_router(int dest_id) const;
     int get_dest_local_port(int dest_id) const;
 
+    // First minimal port toward coord in dim, coord must not be this
+    // router's coordinate
+    inline int minimal_port(int dim, int coord) const {
+        if ( !minimal_ports.empty() ) return minimal_ports[minimal_ports_start[dim] + coord];
+        int offset = coord - ((coord > id_loc[dim]) ? 1 : 0);
+        return port_start[dim] + (offset * dim_width[dim]);
+    }
+
     std::pair<int,int> routeDORBase(int* dest_loc);
     void routeDOR(int port, int vc, topo_hyperx_event* ev);
     void routeDORND(int port, int vc, topo_hyperx_event* ev);
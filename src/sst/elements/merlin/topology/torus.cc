@@ -88,6 +88,8 @@ topo_torus::topo_torus(Component* comp, Params& params) :
 
     id_loc = new int[dimensions];
     idToLocation(router_id, id_loc);
+
+    use_route_table = params.find<bool>("torus:route_table", false);
 }
 
 topo_torus::~topo_torus()
@@ -98,12 +100,57 @@ topo_torus::~topo_torus()
     delete [] port_start;
 }
 
+void
+topo_torus::setup()
+{
+    if ( !use_route_table ) return;
+
+    int num_routers = 1;
+    for ( int i = 0; i < dimensions; i++ ) num_routers *= dim_size[i];
+
+    // Same decision route() makes for a packet to each router
+    route_table.resize(num_routers);
+    int* loc = new int[dimensions];
+    for ( int rtr = 0; rtr < num_routers; rtr++ ) {
+        if ( rtr == router_id ) continue;
+        idToLocation(rtr, loc);
+        int dim = 0;
+        while ( loc[dim] == id_loc[dim] ) dim++;
+
+        int dist_neg = id_loc[dim] - loc[dim];
+        if ( dist_neg < 0 ) dist_neg += dim_size[dim];
+        int dist_pos = loc[dim] - id_loc[dim];
+        if ( dist_pos < 0 ) dist_pos += dim_size[dim];
+        int go_pos = (dist_pos <= dist_neg);
+
+        route_table[rtr].port = choose_multipath(port_start[dim][(go_pos) ? 0 : 1],
+                                                 dim_width[dim],
+                                                 (go_pos)? dist_pos : dist_neg);
+        route_table[rtr].dim = dim;
+        route_table[rtr].dateline = (id_loc[dim] == 0);
+    }
+    delete [] loc;
+}
+
 void
 topo_torus::route(int port, int vc, internal_router_event* ev)
 {
     int dest_router = get_dest_router(ev->getDest());
     if ( dest_router == router_id ) {
         ev->setNextPort(get_dest_local_port(ev->getDest()));
+    } else if ( !route_table.empty() ) {
+        topo_torus_event *tt_ev = static_cast<topo_torus_event*>(ev);
+        const route_entry& entry = route_table[dest_router];
+
+        // Dimensions before entry.dim are aligned
+        if ( entry.dim > tt_ev->routing_dim ) {
+            tt_ev->routing_dim = entry.dim;
+            tt_ev->setVC(vc & (~1)); // Reset the VC
+        }
+        tt_ev->setNextPort(entry.port);
+        if ( entry.dateline && port < local_port_start ) { // Crossing dateline
+            tt_ev->setVC(vc ^ 1); // Toggle VC
+        }
     } else {
         topo_torus_event *tt_ev = static_cast<topo_torus_event*>(ev);
 
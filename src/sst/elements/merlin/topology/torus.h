@@ -25,6 +25,7 @@
 #include <sst/core/params.h>
 
 #include <string.h>
+#include <vector>
 
 #include "sst/elements/merlin/router.h"
 
@@ -85,6 +86,7 @@ public:
         {"torus:shape",        "Shape of the torus specified as the number of routers in each dimension, where each dimension is separated by an x.  For example, 4x4x2x2.  Any number of dimensions is supported."},
         {"torus:width",        "Number of links between routers in each dimension, specified in same manner as for shape.  For example, 2x2x1 denotes 2 links in the x and y dimensions and one in the z dimension."},
         {"torus:local_ports",  "Number of endpoints attached to each router."},
+        {"torus:route_table",  "Precompute the next hop to every router at setup instead of computing it for each packet.  Uses 4 bytes per router in the network.", "false"}
     )
 
     
@@ -101,10 +103,21 @@ private:
     int num_local_ports;
     int local_port_start;
 
+    // Next hop to each destination router, built at setup if
+    // torus:route_table is set
+    struct route_entry {
+        uint16_t port;
+        uint8_t dim;        // First unaligned dimension
+        uint8_t dateline;   // Leaving this router in dim crosses the dateline
+    };
+    bool use_route_table;
+    std::vector<route_entry> route_table;
+
 public:
     topo_torus(Component* comp, Params& params);
     ~topo_torus();
 
+    virtual void setup();
     virtual void route(int port, int vc, internal_router_event* ev);
     virtual internal_router_event* process_input(RtrEvent* ev);
 